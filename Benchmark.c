@@ -0,0 +1,497 @@
+/**
+    \file Benchmark.c
+    \brief Measures the throughput of the solvers on several distributions of coefficients
+*/
+
+#include "Quadratic_Equation.h"
+#include "Simd_Solver.h"
+#include "Parallel_Solver.h"
+#include "Precise_Solver.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#if defined (__x86_64__) || defined (__i386__)
+#include <x86intrin.h>
+#define Read_Cycles() __rdtsc ()
+#else
+#define Read_Cycles() 0ULL
+#endif
+
+#define DEFAULT_BENCH_SIZE (1 << 20)    ///The number of equations of every distribution
+#define DEFAULT_THRESHOLD 10.0          ///Slowdowns greater than this number of percents are reported
+#define N_REPETITIONS 5                 ///Every measurement is repeated this number of times, the best one is taken
+#define MIN_RUN_TIME 0.05               ///Every repetition runs the kernel until this number of seconds has passed
+#define MAX_NAME_LENGTH 32              ///The maximal length of the names of kernels and distributions
+#define MAX_BASELINE_ENTRIES 256        ///The maximal number of lines of a baseline file
+
+///Distributions of coefficients, each of them exercises its own branches of the solvers
+enum Distribution
+{
+    Two_Roots,      ///< Every equation has two different roots
+    Linear,         ///< Coefficient "a" is 0
+    Mixed,          ///< Random coefficients, a quarter of them with a = 0
+    Near_Zero_D,    ///< Discriminant is within a few EPSILON of 0
+    N_Distributions ///< The number of distributions
+};
+
+///Names of the distributions
+static const char *Distribution_Names[N_Distributions] = {"two_roots", "linear", "mixed", "near_zero_d"};
+
+///One solver that is measured
+struct Bench_Kernel
+{
+    const char *Name;       ///< The name that is printed and saved in the baseline
+    Batch_Solver Solver;    ///< The function that solves a batch
+    bool Needs_Quadratic;   ///< True if the kernel cannot solve equations with a = 0
+    enum Simd_Level Level;  ///< The instruction set the kernel needs (Simd_None if it runs everywhere)
+};
+
+///One line of a baseline file
+struct Baseline_Entry
+{
+    char Kernel[MAX_NAME_LENGTH];       ///< The name of the kernel
+    char Distribution[MAX_NAME_LENGTH]; ///< The name of the distribution
+    double Ns_Per_Equation;             ///< The time of one equation in nanoseconds
+};
+
+///Settings of the benchmark
+struct Bench_Options
+{
+    size_t Size;            ///< The number of equations of every distribution
+    const char *Baseline;   ///< The name of the baseline file (NULL means no comparison)
+    double Threshold;       ///< Slowdowns greater than this number of percents are reported
+    bool Update;            ///< Overwrite the baseline with the new results
+};
+
+/**
+    \brief Returns the next pseudo-random number (xorshift64*)
+
+    \param [in] state {Pointer on the state of the generator, not 0}
+    \return A pseudo-random 64-bit number
+*/
+static uint64_t Next_Random (uint64_t *state)
+{
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+    \brief Returns a pseudo-random number from an interval
+
+    \param [in] state {Pointer on the state of the generator}
+    \param [in] min {The lower end of the interval}
+    \param [in] max {The upper end of the interval}
+    \return A number uniformly distributed in [min, max)
+*/
+static double Random_Double (uint64_t *state, const double min, const double max)
+{
+    return min + (max - min) * (double)(Next_Random (state) >> 11) * 0x1p-53;
+}
+
+/**
+    \brief Fills arrays of coefficients according to a distribution
+
+    \param [in] distribution {The distribution}
+    \param [out] a {Array of quadratic coefficients}
+    \param [out] b {Array of linear coefficients}
+    \param [out] c {Array of free terms}
+    \param [in] n_equations {The number of equations in every array}
+*/
+static void Generate_Coefficients (const enum Distribution distribution, double *a, double *b, double *c,
+                                   const size_t n_equations)
+{
+    uint64_t state = 0x9E3779B97F4A7C15ULL + (uint64_t)distribution;
+
+    for (size_t i = 0; i < n_equations; i++)
+    {
+        double x_1 = Random_Double (&state, -100.0, 100.0);
+        double x_2 = Random_Double (&state, -100.0, 100.0);
+        double scale = Random_Double (&state, 1.0, 10.0);
+
+        switch (distribution)
+        {
+            case Two_Roots:
+                a[i] = scale;
+                b[i] = -scale * (x_1 + x_2);
+                c[i] = scale * x_1 * x_2;
+                break;
+
+            case Linear:
+                a[i] = 0.0;
+                b[i] = scale;
+                c[i] = x_1;
+                break;
+
+            case Mixed:
+                a[i] = (Next_Random (&state) % 4 == 0) ? 0.0 : Random_Double (&state, -10.0, 10.0);
+                b[i] = Random_Double (&state, -10.0, 10.0);
+                c[i] = Random_Double (&state, -10.0, 10.0);
+                break;
+
+            default:
+                a[i] = scale;
+                b[i] = -2 * scale * x_1 / 100;
+                c[i] = scale * (x_1 / 100) * (x_1 / 100) + Random_Double (&state, -2.0, 2.0) * EPSILON / (4 * scale);
+                break;
+        }
+    }
+}
+
+/**
+    \brief Solves every equation with Get_Number_Of_Roots_And_Solve_Equation ()
+
+    Has the signature of Batch_Solver, so it is measured the same way as the batch kernels.
+*/
+static void Bench_Scalar (const double *a, const double *b, const double *c,
+                          double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    for (size_t i = 0; i < n_equations; i++)
+        n_roots[i] = Get_Number_Of_Roots_And_Solve_Equation (a[i], b[i], c[i], &x_1[i], &x_2[i]);
+}
+
+/**
+    \brief Solves every equation with Solve_Quadratic_Equation (), "a" should not be 0
+*/
+static void Bench_Quadratic (const double *a, const double *b, const double *c,
+                             double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    for (size_t i = 0; i < n_equations; i++)
+        n_roots[i] = Solve_Quadratic_Equation (a[i], b[i], c[i], &x_1[i], &x_2[i]);
+}
+
+/**
+    \brief Solves b * x + c = 0 for every equation with Solve_Linear_Equation ()
+*/
+static void Bench_Linear (const double *a, const double *b, const double *c,
+                          double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    (void)a;
+    (void)x_2;
+
+    for (size_t i = 0; i < n_equations; i++)
+        n_roots[i] = Solve_Linear_Equation (b[i], c[i], &x_1[i]);
+}
+
+/**
+    \brief Compares "a" with "c" for every equation with Compare_Double ()
+*/
+static void Bench_Compare (const double *a, const double *b, const double *c,
+                           double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    (void)b;
+    (void)x_1;
+    (void)x_2;
+
+    for (size_t i = 0; i < n_equations; i++)
+        n_roots[i] = (enum N_Roots)Compare_Double (a[i], c[i]);
+}
+
+/**
+    \brief Solves the batch with Solve_Batch_Parallel () on all the cores
+*/
+static void Bench_Parallel (const double *a, const double *b, const double *c,
+                            double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    Solve_Batch_Parallel (a, b, c, x_1, x_2, n_roots, n_equations, 0, 0, NULL);
+}
+
+/**
+    \brief Finds only the numbers of roots with Classify_Batch ()
+*/
+static void Bench_Classify (const double *a, const double *b, const double *c,
+                            double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    (void)x_1;
+    (void)x_2;
+
+    Classify_Batch (a, b, c, n_roots, n_equations);
+}
+
+/**
+    \brief Finds only the numbers of roots with Classify_Batch_Simd ()
+*/
+static void Bench_Classify_Simd (const double *a, const double *b, const double *c,
+                                 double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    (void)x_1;
+    (void)x_2;
+
+    Classify_Batch_Simd (a, b, c, n_roots, n_equations);
+}
+
+/**
+    \brief Returns the time of a monotonic clock
+
+    \return The time in seconds
+*/
+static double Get_Time (void)
+{
+    struct timespec now = {0};
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec + (double)now.tv_nsec * 1E-9;
+}
+
+/**
+    \brief Measures one kernel on one batch
+
+    The kernel is run until MIN_RUN_TIME has passed, N_REPETITIONS times; the fastest repetition is taken.
+    Cycles are read from the time-stamp counter, so they are reference cycles, not core cycles.
+
+    \param [in] kernel {The kernel}
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] x_1 {Array for the first roots}
+    \param [out] x_2 {Array for the second roots}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+    \param [out] cycles_per_equation {Pointer on the variable in which the function puts the cycles of one equation}
+    \return The time of one equation in nanoseconds
+*/
+static double Measure_Kernel (const struct Bench_Kernel *kernel, const double *a, const double *b, const double *c,
+                              double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations,
+                              double *cycles_per_equation)
+{
+    double best_time = INFINITY, best_cycles = INFINITY;
+
+    for (int repetition = 0; repetition < N_REPETITIONS; repetition++)
+    {
+        size_t n_runs = 0;
+        double start = Get_Time (), elapsed = 0.0;
+        unsigned long long start_cycles = Read_Cycles ();
+
+        do
+        {
+            kernel->Solver (a, b, c, x_1, x_2, n_roots, n_equations);
+            n_runs++;
+            elapsed = Get_Time () - start;
+        }
+        while (elapsed < MIN_RUN_TIME);
+
+        double cycles = (double)(Read_Cycles () - start_cycles);
+
+        if (elapsed / (double)n_runs < best_time)
+        {
+            best_time   = elapsed / (double)n_runs;
+            best_cycles = cycles / (double)n_runs;
+        }
+    }
+
+    *cycles_per_equation = best_cycles / (double)n_equations;
+
+    return best_time * 1E9 / (double)n_equations;
+}
+
+/**
+    \brief Reads a baseline file
+
+    Every line is "kernel distribution ns_per_equation".
+
+    \param [in] path {The name of the file}
+    \param [out] entries {Array of at least MAX_BASELINE_ENTRIES entries}
+    \return The number of entries that have been read or -1 if the file cannot be opened
+*/
+static int Read_Baseline (const char *path, struct Baseline_Entry *entries)
+{
+    FILE *file = fopen (path, "r");
+    if (file == NULL)
+        return -1;
+
+    int n_entries = 0;
+
+    while (n_entries < MAX_BASELINE_ENTRIES &&
+           fscanf (file, "%31s %31s %lf", entries[n_entries].Kernel, entries[n_entries].Distribution,
+                   &entries[n_entries].Ns_Per_Equation) == 3)
+        n_entries++;
+
+    fclose (file);
+
+    return n_entries;
+}
+
+/**
+    \brief Finds the time of a kernel on a distribution in the baseline
+
+    \param [in] entries {Array of entries}
+    \param [in] n_entries {The number of entries}
+    \param [in] kernel {The name of the kernel}
+    \param [in] distribution {The name of the distribution}
+    \return The time of one equation in nanoseconds or NAN if there is no such entry
+*/
+static double Find_Baseline (const struct Baseline_Entry *entries, const int n_entries,
+                             const char *kernel, const char *distribution)
+{
+    for (int i = 0; i < n_entries; i++)
+        if (strcmp (entries[i].Kernel, kernel) == 0 && strcmp (entries[i].Distribution, distribution) == 0)
+            return entries[i].Ns_Per_Equation;
+
+    return NAN;
+}
+
+/**
+    \brief Parses the command line of the benchmark
+
+    \param [in] argc {The number of command line arguments}
+    \param [in] argv {Array of command line arguments}
+    \param [out] options {Pointer on the structure in which the function puts the settings}
+    \return 0 if the command line is correct
+    \return -1 otherwise
+*/
+static int Parse_Bench_Options (const int argc, char *argv[], struct Bench_Options *options)
+{
+    options->Size      = DEFAULT_BENCH_SIZE;
+    options->Baseline  = NULL;
+    options->Threshold = DEFAULT_THRESHOLD;
+    options->Update    = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp (argv[i], "--update") == 0)
+            options->Update = true;
+        else if (i + 1 < argc && strcmp (argv[i], "--baseline") == 0)
+            options->Baseline = argv[++i];
+        else if (i + 1 < argc && strcmp (argv[i], "--threshold") == 0)
+            options->Threshold = strtod (argv[++i], NULL);
+        else if (i + 1 < argc && strcmp (argv[i], "--size") == 0)
+            options->Size = strtoul (argv[++i], NULL, 10);
+        else
+        {
+            fprintf (stderr, "Usage: %s [--size <n>] [--baseline <file>] [--threshold <percents>] [--update]\n",
+                     argv[0]);
+            return -1;
+        }
+    }
+
+    return (options->Size > 0 && options->Threshold >= 0) ? 0 : -1;
+}
+
+/**
+    \brief Runs every kernel on every distribution and compares the results with the baseline
+
+    If the baseline file does not exist or "--update" is given, the new results are saved in it.
+
+    \return 0 if there are no slowdowns greater than the threshold
+    \return 1 if there are
+    \return 2 if the command line is incorrect or there is not enough memory
+*/
+int main (int argc, char *argv[])
+{
+    struct Bench_Options options = {0};
+    if (Parse_Bench_Options (argc, argv, &options) != 0)
+        return 2;
+
+    struct Bench_Kernel kernels[] =
+    {
+        {"compare",   Bench_Compare,       false, Simd_None  },
+        {"linear",    Bench_Linear,        false, Simd_None  },
+        {"quadratic", Bench_Quadratic,     true,  Simd_None  },
+        {"scalar",    Bench_Scalar,        false, Simd_None  },
+        {"batch",     Solve_Batch,         false, Simd_None  },
+        {"sse2",      Solve_Batch_SSE2,    false, Simd_SSE2  },
+        {"avx2",      Solve_Batch_AVX2,    false, Simd_AVX2  },
+        {"avx512",    Solve_Batch_AVX512,  false, Simd_AVX512},
+        {"precise",   Solve_Batch_Precise, false, Simd_None  },
+        {"scaled",    Solve_Batch_Scaled_Simd, false, Simd_None},
+        {"parallel",  Bench_Parallel,      false, Simd_None  },
+        {"classify",  Bench_Classify,      false, Simd_None  },
+        {"cls_simd",  Bench_Classify_Simd, false, Simd_None  }
+    };
+    const int n_kernels = sizeof (kernels) / sizeof (kernels[0]);
+
+    struct Baseline_Entry *baseline = calloc (MAX_BASELINE_ENTRIES, sizeof (struct Baseline_Entry));
+    struct Baseline_Entry *results  = calloc (MAX_BASELINE_ENTRIES, sizeof (struct Baseline_Entry));
+    double *a   = calloc (options.Size, sizeof (double));
+    double *b   = calloc (options.Size, sizeof (double));
+    double *c   = calloc (options.Size, sizeof (double));
+    double *x_1 = calloc (options.Size, sizeof (double));
+    double *x_2 = calloc (options.Size, sizeof (double));
+    enum N_Roots *n_roots = calloc (options.Size, sizeof (enum N_Roots));
+    int status = 0;
+
+    if (baseline == NULL || results == NULL || a == NULL || b == NULL || c == NULL ||
+        x_1 == NULL || x_2 == NULL || n_roots == NULL)
+    {
+        fprintf (stderr, "Not enough memory\n");
+        status = 2;
+    }
+    else
+    {
+        int n_baseline = (options.Baseline != NULL) ? Read_Baseline (options.Baseline, baseline) : -1;
+        int n_results = 0;
+
+        printf ("%-10s %-12s %10s %12s %10s %10s\n", "kernel", "distribution", "ns/eq", "eq/s", "cycles/eq", "change");
+
+        for (int distribution = 0; distribution < N_Distributions; distribution++)
+        {
+            Generate_Coefficients (distribution, a, b, c, options.Size);
+
+            for (int kernel = 0; kernel < n_kernels; kernel++)
+            {
+                if ((kernels[kernel].Needs_Quadratic && (distribution == Linear || distribution == Mixed)) ||
+                    kernels[kernel].Level > Get_Simd_Level ())
+                    continue;
+
+                double cycles = 0.0;
+                double ns = Measure_Kernel (&kernels[kernel], a, b, c, x_1, x_2, n_roots, options.Size, &cycles);
+                double old_ns = (n_baseline > 0) ? Find_Baseline (baseline, n_baseline, kernels[kernel].Name,
+                                                                  Distribution_Names[distribution]) : NAN;
+                double change = (ns / old_ns - 1) * 100;
+
+                printf ("%-10s %-12s %10.3f %12.4g %10.2f", kernels[kernel].Name, Distribution_Names[distribution],
+                        ns, 1E9 / ns, cycles);
+                if (IsNAN (change))
+                    printf (" %10s\n", "-");
+                else
+                    printf (" %+9.1f%%%s\n", change, (change > options.Threshold) ? "  SLOWDOWN" : "");
+
+                if (change > options.Threshold)
+                    status = 1;
+
+                if (n_results < MAX_BASELINE_ENTRIES)
+                {
+                    snprintf (results[n_results].Kernel, MAX_NAME_LENGTH, "%s", kernels[kernel].Name);
+                    snprintf (results[n_results].Distribution, MAX_NAME_LENGTH, "%s", Distribution_Names[distribution]);
+                    results[n_results++].Ns_Per_Equation = ns;
+                }
+            }
+        }
+
+        if (options.Baseline != NULL && (n_baseline < 0 || options.Update))
+        {
+            FILE *file = fopen (options.Baseline, "w");
+
+            if (file == NULL)
+            {
+                fprintf (stderr, "Cannot write \"%s\"\n", options.Baseline);
+                status = 2;
+            }
+            else
+            {
+                for (int i = 0; i < n_results; i++)
+                    fprintf (file, "%s %s %.3f\n", results[i].Kernel, results[i].Distribution,
+                             results[i].Ns_Per_Equation);
+                fclose (file);
+                printf ("The baseline has been saved in \"%s\"\n", options.Baseline);
+            }
+        }
+        else if (status == 1)
+            printf ("Some kernels are more than %.1f%% slower than the baseline\n", options.Threshold);
+    }
+
+    free (baseline);
+    free (results);
+    free (a);
+    free (b);
+    free (c);
+    free (x_1);
+    free (x_2);
+    free (n_roots);
+
+    return status;
+}
@@ -0,0 +1,503 @@
+#include "Binary_Mode.h"
+#include "Stream_Mode.h"
+#include "Parallel_Solver.h"
+#include "Chunked_Mode.h"
+#include "Result_Store.h"
+
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#if defined (__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "The binary mode reads and writes little-endian data in place"
+#endif
+
+_Static_assert (sizeof (struct Root_Record) == 24, "struct Root_Record should be packed into 24 bytes");
+
+/**
+    \brief Finds the value of a key in the header of an .npy file
+
+    \param [in] header {The header: a dictionary written as a Python literal}
+    \param [in] key {The key with quotes, e.g. "'shape'"}
+    \return Pointer on the first symbol of the value or NULL if there is no such key
+*/
+static const char *Find_Npy_Value (const char *header, const char *key)
+{
+    const char *value = strstr (header, key);
+
+    if (value == NULL)
+        return NULL;
+
+    value += strlen (key);
+    while (*value == ' ')
+        value++;
+    if (*value++ != ':')
+        return NULL;
+    while (*value == ' ')
+        value++;
+
+    return value;
+}
+
+/**
+    \brief Parses the header of an .npy file
+
+    Only arrays of little-endian numbers of the "double" type with shape (N, 3) are accepted.
+
+    \param [in] file {The beginning of the file}
+    \param [in] n_bytes {The number of bytes of the file "file" points on, the whole header should be among them}
+    \param [in] file_size {The size of the file in bytes (SIZE_MAX if it is not known)}
+    \param [out] input {Pointer on the structure in which the function puts the number of equations,
+                        the layout and the beginning of the data}
+    \return 0 if the file is an appropriate .npy file
+    \return -1 otherwise
+*/
+int Parse_Npy_Header (const char *file, const size_t n_bytes, const size_t file_size, struct Binary_Input *input)
+{
+    size_t header_begin = 0, header_length = 0;
+
+    if (n_bytes >= 10 && file[NPY_MAGIC_LENGTH] == 1)
+    {
+        header_begin  = 10;
+        header_length = (unsigned char)file[8] | (size_t)(unsigned char)file[9] << 8;
+    }
+    else if (n_bytes >= 12 && (file[NPY_MAGIC_LENGTH] == 2 || file[NPY_MAGIC_LENGTH] == 3))
+    {
+        header_begin  = 12;
+        header_length = (unsigned char)file[8]                  | (size_t)(unsigned char)file[9]  << 8 |
+                        (size_t)(unsigned char)file[10] << 16   | (size_t)(unsigned char)file[11] << 24;
+    }
+    else
+        return -1;
+
+    size_t data_offset = header_begin + header_length;
+    if (data_offset > n_bytes || data_offset % sizeof (double) != 0)
+        return -1;
+
+    char *header = calloc (header_length + 1, 1);
+    if (header == NULL)
+        return -1;
+    memcpy (header, file + header_begin, header_length);
+
+    const char *descr   = Find_Npy_Value (header, "'descr'");
+    const char *fortran = Find_Npy_Value (header, "'fortran_order'");
+    const char *shape   = Find_Npy_Value (header, "'shape'");
+    unsigned long long n_rows = 0;
+    unsigned n_columns = 0;
+    int status = -1;
+
+    if (descr != NULL && fortran != NULL && shape != NULL &&
+        strncmp (descr, "'<f8'", 5) == 0 &&
+        sscanf (shape, "( %llu , %u )", &n_rows, &n_columns) == 2 && n_columns == 3 &&
+        (file_size - data_offset) / (3 * sizeof (double)) >= n_rows)
+    {
+        input->Data        = (const double *)(file + data_offset);
+        input->N_Equations = n_rows;
+        input->Layout      = (strncmp (fortran, "True", 4) == 0) ? Packed_Columns : Packed_Triples;
+        status = 0;
+    }
+
+    free (header);
+
+    return status;
+}
+
+/**
+    \brief Maps a binary file of coefficients into memory
+
+    Calls Parse_Npy_Header () if the file starts with NPY_MAGIC.
+    Any other file should consist of packed (a, b, c) triples of the "double" type.
+
+    \param [in] path {The name of the file}
+    \param [out] input {Pointer on the structure that describes the mapping}
+    \return 0 if the file has been mapped
+    \return -1 if the file cannot be opened or its format is wrong (the reason is printed to stderr)
+*/
+int Map_Binary_Input (const char *path, struct Binary_Input *input)
+{
+    assert (path  != NULL);
+    assert (input != NULL);
+
+    memset (input, 0, sizeof (*input));
+
+    int fd = open (path, O_RDONLY);
+    struct stat info = {0};
+
+    if (fd == -1 || fstat (fd, &info) == -1)
+    {
+        fprintf (stderr, "Cannot open \"%s\"\n", path);
+        if (fd != -1)
+            close (fd);
+        return -1;
+    }
+
+    input->Mapping_Size = (size_t)info.st_size;
+    input->Layout = Packed_Triples;
+
+    if (input->Mapping_Size > 0)
+    {
+        input->Mapping = mmap (NULL, input->Mapping_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (input->Mapping == MAP_FAILED)
+        {
+            fprintf (stderr, "Cannot map \"%s\" into memory\n", path);
+            input->Mapping = NULL;
+            close (fd);
+            return -1;
+        }
+        madvise (input->Mapping, input->Mapping_Size, MADV_SEQUENTIAL);
+    }
+
+    close (fd);
+
+    if (input->Mapping_Size >= NPY_MAGIC_LENGTH && memcmp (input->Mapping, NPY_MAGIC, NPY_MAGIC_LENGTH) == 0)
+    {
+        if (Parse_Npy_Header (input->Mapping, input->Mapping_Size, input->Mapping_Size, input) != 0)
+        {
+            fprintf (stderr, "\"%s\" is not an .npy array of shape (N, 3) and type '<f8'\n", path);
+            Unmap_Binary_Input (input);
+            return -1;
+        }
+    }
+    else if (input->Mapping_Size % (3 * sizeof (double)) != 0)
+    {
+        fprintf (stderr, "The size of \"%s\" is not a multiple of the size of three numbers of the \"double\" type\n", path);
+        Unmap_Binary_Input (input);
+        return -1;
+    }
+    else
+    {
+        input->Data        = input->Mapping;
+        input->N_Equations = input->Mapping_Size / (3 * sizeof (double));
+    }
+
+    return 0;
+}
+
+/**
+    \brief Unmaps a binary file of coefficients
+
+    \param [in] input {Pointer on the structure that describes the mapping}
+*/
+void Unmap_Binary_Input (struct Binary_Input *input)
+{
+    assert (input != NULL);
+
+    if (input->Mapping != NULL)
+        munmap (input->Mapping, input->Mapping_Size);
+
+    input->Mapping = NULL;
+    input->Data    = NULL;
+}
+
+/**
+    \brief Writes the header of an .npy file with a one-dimensional array
+
+    \param [out] header {Array of at least NPY_MAX_HEADER symbols}
+    \param [in] descr {The type of the elements: NPY_RECORD_DESCR or NPY_COUNT_DESCR}
+    \param [in] n_equations {The number of elements}
+    \return The size of the header in bytes (a multiple of NPY_ALIGNMENT)
+*/
+size_t Make_Npy_Header (char *header, const char *descr, const size_t n_equations)
+{
+    int dict_length = snprintf (header + 10, NPY_MAX_HEADER - 10,
+                                "{'descr': %s, 'fortran_order': False, 'shape': (%zu,), }", descr, n_equations);
+    size_t header_size = (10 + (size_t)dict_length + 1 + NPY_ALIGNMENT - 1) / NPY_ALIGNMENT * NPY_ALIGNMENT;
+    size_t header_length = header_size - 10;
+
+    memcpy (header, NPY_MAGIC, NPY_MAGIC_LENGTH);
+    header[6] = 1;
+    header[7] = 0;
+    header[8] = (char)(header_length & 0xFF);
+    header[9] = (char)(header_length >> 8);
+    memset (header + 10 + dict_length, ' ', header_size - 10 - (size_t)dict_length - 1);
+    header[header_size - 1] = '\n';
+
+    return header_size;
+}
+
+/**
+    \brief Checks if a name of a file ends with ".npy"
+
+    \param [in] path {The name of the file}
+    \return True if it does
+*/
+bool Is_Npy_Name (const char *path)
+{
+    size_t length = strlen (path);
+
+    return length >= 4 && strcmp (path + length - 4, ".npy") == 0;
+}
+
+/**
+    \brief Gets the coefficients of a block of equations of a mapped binary file
+
+    Packed triples are split into the arrays of the block; the columns of an .npy array in Fortran order
+             are used right in the mapping.
+
+    \param [in] input {Pointer on the input}
+    \param [in] block {Pointer on the block the triples are split into}
+    \param [in] first {Index of the first equation of the block}
+    \param [in] count {The number of equations in the block}
+    \param [out] a {Pointer on the variable in which the function puts the array of quadratic coefficients}
+    \param [out] b {Pointer on the variable in which the function puts the array of linear coefficients}
+    \param [out] c {Pointer on the variable in which the function puts the array of free terms}
+*/
+static void Get_Binary_Block (const struct Binary_Input *input, const struct Equation_Block *block,
+                              const size_t first, const size_t count,
+                              const double **a, const double **b, const double **c)
+{
+    if (input->Layout == Packed_Columns)
+    {
+        *a = input->Data + first;
+        *b = input->Data + input->N_Equations + first;
+        *c = input->Data + 2 * input->N_Equations + first;
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        block->A[i] = input->Data[3 * (first + i)];
+        block->B[i] = input->Data[3 * (first + i) + 1];
+        block->C[i] = input->Data[3 * (first + i) + 2];
+    }
+
+    *a = block->A;
+    *b = block->B;
+    *c = block->C;
+}
+
+/**
+    \brief Finds the numbers of roots of the equations of a mapped binary file
+
+    Calls Get_Binary_Block () and Classify_Block () for blocks of BINARY_BLOCK_SIZE equations.
+    With "--totals" only Write_Class_Totals () is written (to stdout if there is no -o file);
+             otherwise the output is one signed byte per equation, with an .npy header if its name ends with ".npy".
+
+    \param [in] options {Pointer on the settings}
+    \param [in] input {Pointer on the input}
+    \return 0 if all the equations have been classified
+    \return 2 if the output cannot be opened or written
+*/
+static int Classify_Binary_Input (const struct Options *options, const struct Binary_Input *input)
+{
+    char header[NPY_MAX_HEADER] = "";
+    size_t header_size = (!options->Totals && Is_Npy_Name (options->Output)) ?
+                         Make_Npy_Header (header, NPY_COUNT_DESCR, input->N_Equations) : 0;
+    size_t output_size = options->Totals ? 0 : header_size + input->N_Equations;
+
+    int fd = -1;
+    char *output = NULL;
+
+    if (!options->Totals &&
+        ((fd = open (options->Output, O_RDWR | O_CREAT | O_TRUNC, 0644)) == -1 || ftruncate (fd, (off_t)output_size) == -1 ||
+         (output_size > 0 && (output = mmap (NULL, output_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED)))
+    {
+        fprintf (stderr, "Cannot open \"%s\"\n", options->Output);
+        if (fd != -1)
+            close (fd);
+        return 2;
+    }
+
+    if (fd != -1)
+        close (fd);
+
+    struct Equation_Block block = {0};
+    if (Allocate_Equation_Block (&block, BINARY_BLOCK_SIZE) != 0)
+    {
+        fprintf (stderr, "Not enough memory\n");
+        Free_Equation_Block (&block);
+        if (output != NULL)
+            munmap (output, output_size);
+        return 2;
+    }
+
+    memcpy (output, header, header_size);
+    int8_t *counts = (int8_t *)(output + header_size);
+    size_t totals[4] = {0};
+
+    for (size_t first = 0; first < input->N_Equations; first += BINARY_BLOCK_SIZE)
+    {
+        size_t count = input->N_Equations - first;
+        if (count > BINARY_BLOCK_SIZE)
+            count = BINARY_BLOCK_SIZE;
+
+        const double *a = NULL, *b = NULL, *c = NULL;
+        Get_Binary_Block (input, &block, first, count, &a, &b, &c);
+
+        Classify_Block (a, b, c, block.N_Roots, count, totals);
+
+        for (size_t i = 0; i < count && !options->Totals; i++)
+            counts[first + i] = (int8_t)block.N_Roots[i];
+    }
+
+    Free_Equation_Block (&block);
+    if (output != NULL)
+        munmap (output, output_size);
+
+    if (options->Totals)
+    {
+        FILE *stream = (strcmp (options->Output, "-") == 0) ? stdout : fopen (options->Output, "w");
+        int status = (stream == NULL) ? -1 : Write_Class_Totals (stream, totals);
+
+        if (stream != NULL && stream != stdout)
+            status |= fclose (stream);
+
+        if (status != 0)
+        {
+            fprintf (stderr, "Cannot write to \"%s\"\n", options->Output);
+            return 2;
+        }
+    }
+
+    return 0;
+}
+
+/**
+    \brief Checks if a binary input should be solved by chunks instead of being mapped
+
+    \param [in] options {Pointer on the settings}
+    \return True if "--chunked" has been given, if the input is not a regular file, if the results go to stdout
+             or into a result store or if the input is larger than 1 / BINARY_MAP_SHARE of the physical memory
+*/
+static bool Needs_Chunked_Mode (const struct Options *options)
+{
+    struct stat info = {0};
+
+    if (options->Chunked || strcmp (options->Input, "-") == 0 || (strcmp (options->Output, "-") == 0 && !options->Totals) ||
+        (Is_Store_Name (options->Output) && !options->Totals) ||
+        stat (options->Input, &info) != 0 || !S_ISREG (info.st_mode))
+        return true;
+
+    long n_pages   = sysconf (_SC_PHYS_PAGES);
+    long page_size = sysconf (_SC_PAGESIZE);
+
+    return n_pages > 0 && page_size > 0 && (size_t)info.st_size > (size_t)n_pages / BINARY_MAP_SHARE * (size_t)page_size;
+}
+
+/**
+    \brief Checks if the output file of the binary mode is the input file
+
+    Opening the output truncates it, so the input would be lost before it has been read.
+
+    \param [in] options {Pointer on the settings}
+    \return True if both names (stdin for "-") lead to the same file
+*/
+static bool Is_Output_Input (const struct Options *options)
+{
+    struct stat input = {0}, output = {0};
+
+    if (strcmp (options->Output, "-") == 0 ||
+        ((strcmp (options->Input, "-") == 0) ? fstat (STDIN_FILENO, &input) : stat (options->Input, &input)) != 0 ||
+        stat (options->Output, &output) != 0)
+        return false;
+
+    return input.st_dev == output.st_dev && input.st_ino == output.st_ino;
+}
+
+/**
+    \brief Solves the equations of a mapped binary file and writes the results into a mapped binary file
+
+    Calls Map_Binary_Input (), Get_Binary_Block (), Solve_Block ().
+    Packed triples are split into three arrays by blocks of BINARY_BLOCK_SIZE equations
+             that stay in cache; the columns of an .npy array in Fortran order are solved right in the mapping.
+    The output consists of struct Root_Record, with an .npy header if its name ends with ".npy".
+    With "--classify" or "--totals" calls Classify_Binary_Input () instead.
+    If Needs_Chunked_Mode () says so, calls Run_Chunked_Binary_Mode () instead of mapping the files.
+    An output that Is_Output_Input () is refused before anything is opened.
+
+    \param [in] options {Pointer on the settings}
+    \return 0 if all the equations have been solved
+    \return 2 if the input or the output cannot be opened or they are the same file
+*/
+int Run_Binary_Mode (const struct Options *options)
+{
+    assert (options != NULL);
+
+    if (Is_Output_Input (options))
+    {
+        fprintf (stderr, "The output \"%s\" is the input file\n", options->Output);
+        return 2;
+    }
+
+    if (Needs_Chunked_Mode (options))
+        return Run_Chunked_Binary_Mode (options);
+
+    struct Binary_Input input = {0};
+    if (Map_Binary_Input (options->Input, &input) != 0)
+        return 2;
+
+    if (options->Classify)
+    {
+        int status = Classify_Binary_Input (options, &input);
+        Unmap_Binary_Input (&input);
+        return status;
+    }
+
+    char header[NPY_MAX_HEADER] = "";
+    size_t header_size = Is_Npy_Name (options->Output) ? Make_Npy_Header (header, NPY_RECORD_DESCR, input.N_Equations) : 0;
+    size_t output_size = header_size + input.N_Equations * sizeof (struct Root_Record);
+
+    int fd = open (options->Output, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    char *output = NULL;
+
+    if (fd == -1 || ftruncate (fd, (off_t)output_size) == -1 ||
+        (output_size > 0 && (output = mmap (NULL, output_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED))
+    {
+        fprintf (stderr, "Cannot open \"%s\"\n", options->Output);
+        if (fd != -1)
+            close (fd);
+        Unmap_Binary_Input (&input);
+        return 2;
+    }
+
+    close (fd);
+
+    struct Equation_Block block = {0};
+    struct Root_Cache cache = {0};
+    if (Allocate_Equation_Block (&block, BINARY_BLOCK_SIZE) != 0 ||
+        (options->Cache_Size != 0 && Init_Root_Cache (&cache, options->Cache_Size, true) != 0))
+    {
+        fprintf (stderr, "Not enough memory\n");
+        Free_Equation_Block (&block);
+        Free_Root_Cache (&cache);
+        if (output != NULL)
+            munmap (output, output_size);
+        Unmap_Binary_Input (&input);
+        return 2;
+    }
+
+    memcpy (output, header, header_size);
+    struct Root_Record *records = (struct Root_Record *)(output + header_size);
+
+    for (size_t first = 0; first < input.N_Equations; first += BINARY_BLOCK_SIZE)
+    {
+        size_t count = input.N_Equations - first;
+        if (count > BINARY_BLOCK_SIZE)
+            count = BINARY_BLOCK_SIZE;
+
+        const double *a = NULL, *b = NULL, *c = NULL;
+        Get_Binary_Block (&input, &block, first, count, &a, &b, &c);
+
+        Solve_Block (options, (cache.Entries != NULL) ? &cache : NULL, a, b, c, block.X_1, block.X_2, block.N_Roots, count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            records[first + i].X_1     = block.X_1[i];
+            records[first + i].X_2     = block.X_2[i];
+            records[first + i].N_Roots = block.N_Roots[i];
+        }
+    }
+
+    if (cache.Entries != NULL)
+        Print_Cache_Statistics (stderr, &cache);
+
+    Free_Equation_Block (&block);
+    Free_Root_Cache (&cache);
+    if (output != NULL)
+        munmap (output, output_size);
+    Unmap_Binary_Input (&input);
+
+    return 0;
+}
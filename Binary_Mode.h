@@ -0,0 +1,50 @@
+#ifndef BINARY_MODE_H_INCLUDED
+#define BINARY_MODE_H_INCLUDED
+
+#include "Command_Line.h"
+
+#include <stdint.h>
+
+#define BINARY_BLOCK_SIZE 65536     ///The number of equations that are copied out of the mapping and solved at a time
+#define BINARY_MAP_SHARE 8          ///Inputs larger than this part of the physical memory are solved by chunks instead of being mapped
+#define NPY_MAGIC "\x93NUMPY"   ///The first bytes of every .npy file
+#define NPY_MAGIC_LENGTH 6      ///The length of NPY_MAGIC
+#define NPY_ALIGNMENT 64        ///The data of an .npy file starts at a multiple of this number
+#define NPY_MAX_HEADER 256      ///The maximal size of the header of an .npy file this program writes
+#define NPY_RECORD_DESCR "[('x_1', '<f8'), ('x_2', '<f8'), ('n_roots', '<i8')]"    ///The type of struct Root_Record
+#define NPY_COUNT_DESCR "'|i1'"     ///The type of the numbers of roots written by "--classify"
+
+///One result in the binary output, 24 bytes in little-endian byte order
+struct Root_Record
+{
+    double  X_1;        ///< The first root or NAN
+    double  X_2;        ///< The second root or NAN
+    int64_t N_Roots;    ///< The number of roots (enum N_Roots)
+};
+
+///Layouts of the binary input
+enum Binary_Layout
+{
+    Packed_Triples,     ///< Raw (a, b, c) triples of the "double" type, also an .npy (N, 3) array in C order
+    Packed_Columns      ///< All "a", then all "b", then all "c": an .npy (N, 3) array in Fortran order
+};
+
+///Binary input mapped into memory
+struct Binary_Input
+{
+    void *Mapping;          ///< The beginning of the mapping
+    size_t Mapping_Size;    ///< The size of the mapping in bytes
+    const double *Data;     ///< The first coefficient
+    size_t N_Equations;     ///< The number of equations
+    enum Binary_Layout Layout;  ///< The order of the coefficients
+};
+
+int  Parse_Npy_Header (const char *file, const size_t n_bytes, const size_t file_size, struct Binary_Input *input);
+size_t Make_Npy_Header (char *header, const char *descr, const size_t n_equations);
+bool Is_Npy_Name (const char *path);
+int  Map_Binary_Input (const char *path, struct Binary_Input *input);
+void Unmap_Binary_Input (struct Binary_Input *input);
+int  Run_Binary_Mode (const struct Options *options);
+int  Binary_Unit_Test (void);
+
+#endif
@@ -0,0 +1,560 @@
+#include "Chunked_Mode.h"
+#include "Result_Store.h"
+
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define CHUNKED_HEADER_BYTES 65536  ///The header of an .npy input should be among this number of first bytes
+
+/**
+    \brief Reads from a file until "n_bytes" bytes have been read or the file ends
+
+    \param [in] fd {The file}
+    \param [out] buffer {Array for the bytes}
+    \param [in] n_bytes {The number of bytes to read}
+    \return The number of bytes that have been read or -1 on an error
+*/
+static ssize_t Read_Full (const int fd, unsigned char *buffer, const size_t n_bytes)
+{
+    size_t length = 0;
+
+    while (length < n_bytes)
+    {
+        ssize_t n_read = read (fd, buffer + length, n_bytes - length);
+
+        if (n_read == 0)
+            break;
+        if (n_read == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        length += (size_t)n_read;
+    }
+
+    return (ssize_t)length;
+}
+
+/**
+    \brief Writes all the bytes into a file
+
+    \param [in] fd {The file}
+    \param [in] buffer {The bytes}
+    \param [in] n_bytes {The number of bytes}
+    \return 0 if all the bytes have been written
+    \return -1 otherwise
+*/
+static int Write_Full (const int fd, const unsigned char *buffer, const size_t n_bytes)
+{
+    size_t length = 0;
+
+    while (length < n_bytes)
+    {
+        ssize_t n_written = write (fd, buffer + length, n_bytes - length);
+
+        if (n_written == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        length += (size_t)n_written;
+    }
+
+    return 0;
+}
+
+/**
+    \brief Opens a binary file of coefficients for reading by chunks
+
+    The input has the formats of Map_Binary_Input (). "-" means stdin; a pipe can hold raw triples
+             or an .npy array in C order, an .npy array in Fortran order should be a regular file.
+    The buffer of the source has the size of CHUNKED_BLOCK_SIZE triples whatever the size of the input.
+
+    \param [out] source {Pointer on the source}
+    \param [in] path {The name of the file}
+    \return 0 if the input has been opened
+    \return -1 if it cannot be opened or its format is wrong (the reason is printed to stderr;
+               the source should still be closed with Close_Binary_Source ())
+*/
+int Open_Binary_Source (struct Binary_Source *source, const char *path)
+{
+    assert (source != NULL);
+    assert (path   != NULL);
+
+    *source = (struct Binary_Source){.Fd = -1, .Layout = Packed_Triples, .N_Equations = SIZE_MAX};
+
+    bool is_stdin = (strcmp (path, "-") == 0);
+    struct stat info = {0};
+
+    source->Fd     = is_stdin ? STDIN_FILENO : open (path, O_RDONLY);
+    source->Buffer = malloc (CHUNKED_BLOCK_SIZE * 3 * sizeof (double));
+
+    if (source->Fd == -1 || fstat (source->Fd, &info) == -1 || source->Buffer == NULL)
+    {
+        fprintf (stderr, "Cannot open \"%s\"\n", path);
+        return -1;
+    }
+
+    bool is_file = S_ISREG (info.st_mode);
+    size_t file_size = is_file ? (size_t)info.st_size : SIZE_MAX;
+
+    if (is_file)
+        posix_fadvise (source->Fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    ssize_t length = Read_Full (source->Fd, source->Buffer, CHUNKED_HEADER_BYTES);
+    if (length == -1)
+    {
+        fprintf (stderr, "Cannot read \"%s\"\n", path);
+        return -1;
+    }
+    source->Length = (size_t)length;
+
+    if (source->Length >= NPY_MAGIC_LENGTH && memcmp (source->Buffer, NPY_MAGIC, NPY_MAGIC_LENGTH) == 0)
+    {
+        struct Binary_Input header = {0};
+
+        if (Parse_Npy_Header ((const char *)source->Buffer, source->Length, file_size, &header) != 0)
+        {
+            fprintf (stderr, "\"%s\" is not an .npy array of shape (N, 3) and type '<f8'\n", path);
+            return -1;
+        }
+        if (header.Layout == Packed_Columns && !is_file)
+        {
+            fprintf (stderr, "An .npy array in Fortran order cannot be read from a pipe\n");
+            return -1;
+        }
+
+        size_t data_offset = (size_t)((const unsigned char *)header.Data - source->Buffer);
+
+        source->Layout      = header.Layout;
+        source->N_Equations = header.N_Equations;
+        source->Data_Offset = (off_t)data_offset;
+        source->Length     -= data_offset;
+        memmove (source->Buffer, source->Buffer + data_offset, source->Length);
+    }
+    else if (is_file)
+    {
+        if (file_size % (3 * sizeof (double)) != 0)
+        {
+            fprintf (stderr, "The size of \"%s\" is not a multiple of the size of three numbers of the \"double\" type\n", path);
+            return -1;
+        }
+        source->N_Equations = file_size / (3 * sizeof (double));
+    }
+
+    return 0;
+}
+
+/**
+    \brief Reads the next chunk of a binary source (a Chunk_Reader)
+
+    Packed triples are split into the three arrays; the columns of an .npy array in Fortran order
+             are read right into them.
+
+    \param [in,out] source {Pointer on struct Binary_Source}
+    \param [out] a {Array for quadratic coefficients}
+    \param [out] b {Array for linear coefficients}
+    \param [out] c {Array for free terms}
+    \param [in] max_equations {The size of every array}
+    \return The number of equations that have been read (0 at the end of the input or if "Failed" has been set)
+*/
+size_t Read_Binary_Chunk (void *source, double *a, double *b, double *c, const size_t max_equations)
+{
+    assert (source != NULL);
+
+    struct Binary_Source *input = source;
+    size_t n_equations = input->N_Equations - input->N_Read;
+
+    if (n_equations > max_equations)
+        n_equations = max_equations;
+    if (n_equations > CHUNKED_BLOCK_SIZE)
+        n_equations = CHUNKED_BLOCK_SIZE;
+    if (input->Failed || n_equations == 0)
+        return 0;
+
+    if (input->Layout == Packed_Columns)
+    {
+        double *columns[3] = {a, b, c};
+
+        for (int i = 0; i < 3; i++)
+        {
+            off_t offset = input->Data_Offset + (off_t)((i * input->N_Equations + input->N_Read) * sizeof (double));
+
+            if (pread (input->Fd, columns[i], n_equations * sizeof (double), offset) != (ssize_t)(n_equations * sizeof (double)))
+            {
+                input->Failed = true;
+                return 0;
+            }
+        }
+
+        input->N_Read += n_equations;
+        return n_equations;
+    }
+
+    size_t n_bytes = n_equations * 3 * sizeof (double);
+
+    if (input->Length < n_bytes)
+    {
+        ssize_t length = Read_Full (input->Fd, input->Buffer + input->Length, n_bytes - input->Length);
+
+        if (length == -1)
+        {
+            input->Failed = true;
+            return 0;
+        }
+        input->Length += (size_t)length;
+    }
+
+    if (input->Length < n_bytes)
+    {
+        n_equations = input->Length / (3 * sizeof (double));
+        n_bytes     = n_equations * 3 * sizeof (double);
+
+        if (input->N_Equations != SIZE_MAX || input->Length != n_bytes)
+            input->Failed = true;
+        if (n_equations == 0)
+            return 0;
+    }
+
+    const double *triples = (const double *)input->Buffer;
+
+    for (size_t i = 0; i < n_equations; i++)
+    {
+        a[i] = triples[3 * i];
+        b[i] = triples[3 * i + 1];
+        c[i] = triples[3 * i + 2];
+    }
+
+    input->Length -= n_bytes;
+    memmove (input->Buffer, input->Buffer + n_bytes, input->Length);
+    input->N_Read += n_equations;
+
+    return n_equations;
+}
+
+/**
+    \brief Closes a binary source
+
+    \param [in] source {Pointer on the source}
+*/
+void Close_Binary_Source (struct Binary_Source *source)
+{
+    assert (source != NULL);
+
+    if (source->Fd != -1 && source->Fd != STDIN_FILENO)
+        close (source->Fd);
+    free (source->Buffer);
+
+    source->Fd     = -1;
+    source->Buffer = NULL;
+}
+
+/**
+    \brief Opens a binary output that is written by chunks
+
+    If the name ends with ".npy", an .npy header for "n_equations" elements is written first.
+
+    \param [out] sink {Pointer on the sink}
+    \param [in] path {The name of the file ("-" means stdout)}
+    \param [in] counts_only {Write one signed byte per equation instead of struct Root_Record}
+    \param [in] n_equations {The number of equations (SIZE_MAX if it is not known yet)}
+    \return 0 if the output has been opened
+    \return -1 otherwise (the reason is printed to stderr; the sink should still be closed with Close_Binary_Sink ())
+*/
+int Open_Binary_Sink (struct Binary_Sink *sink, const char *path, const bool counts_only, const size_t n_equations)
+{
+    assert (sink != NULL);
+    assert (path != NULL);
+
+    *sink = (struct Binary_Sink){.Fd = -1, .Counts_Only = counts_only};
+
+    bool is_npy = Is_Npy_Name (path);
+    if (is_npy && n_equations == SIZE_MAX)
+    {
+        fprintf (stderr, "The number of equations of a pipe of raw triples is not known, \"%s\" cannot be an .npy file\n", path);
+        return -1;
+    }
+
+    sink->Fd     = (strcmp (path, "-") == 0) ? STDOUT_FILENO : open (path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    sink->Buffer = malloc (CHUNKED_BLOCK_SIZE * sizeof (struct Root_Record));
+
+    if (sink->Fd == -1 || sink->Buffer == NULL)
+    {
+        fprintf (stderr, "Cannot open \"%s\"\n", path);
+        return -1;
+    }
+
+    if (is_npy)
+    {
+        char header[NPY_MAX_HEADER] = "";
+        size_t header_size = Make_Npy_Header (header, counts_only ? NPY_COUNT_DESCR : NPY_RECORD_DESCR, n_equations);
+
+        if (Write_Full (sink->Fd, (const unsigned char *)header, header_size) != 0)
+        {
+            fprintf (stderr, "Cannot write to \"%s\"\n", path);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+    \brief Writes the results of a chunk into a binary sink (a Chunk_Writer)
+
+    \param [in] sink {Pointer on struct Binary_Sink}
+    \param [in] x_1 {Array of the first roots (not used if the sink writes only the numbers of roots)}
+    \param [in] x_2 {Array of the second roots (the same)}
+    \param [in] n_roots {Array of the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+    \return 0 if the results have been written
+    \return -1 otherwise
+*/
+int Write_Binary_Chunk (void *sink, const double *x_1, const double *x_2, const enum N_Roots *n_roots,
+                        const size_t n_equations)
+{
+    assert (sink    != NULL);
+    assert (n_roots != NULL);
+
+    struct Binary_Sink *output = sink;
+    int status = 0;
+
+    for (size_t first = 0; first < n_equations && status == 0; first += CHUNKED_BLOCK_SIZE)
+    {
+        size_t count = n_equations - first;
+        if (count > CHUNKED_BLOCK_SIZE)
+            count = CHUNKED_BLOCK_SIZE;
+
+        if (output->Counts_Only)
+        {
+            int8_t *counts = (int8_t *)output->Buffer;
+
+            for (size_t i = 0; i < count; i++)
+                counts[i] = (int8_t)n_roots[first + i];
+
+            status = Write_Full (output->Fd, output->Buffer, count);
+        }
+        else
+        {
+            struct Root_Record *records = (struct Root_Record *)output->Buffer;
+
+            for (size_t i = 0; i < count; i++)
+            {
+                records[i].X_1     = x_1[first + i];
+                records[i].X_2     = x_2[first + i];
+                records[i].N_Roots = n_roots[first + i];
+            }
+
+            status = Write_Full (output->Fd, output->Buffer, count * sizeof (struct Root_Record));
+        }
+    }
+
+    return status;
+}
+
+/**
+    \brief Closes a binary sink
+
+    \param [in] sink {Pointer on the sink}
+    \return 0 if the output has been closed
+    \return -1 if its last bytes cannot be written
+*/
+int Close_Binary_Sink (struct Binary_Sink *sink)
+{
+    assert (sink != NULL);
+
+    int status = 0;
+
+    if (sink->Fd != -1 && sink->Fd != STDOUT_FILENO)
+        status = close (sink->Fd);
+    free (sink->Buffer);
+
+    sink->Fd     = -1;
+    sink->Buffer = NULL;
+
+    return status;
+}
+
+/**
+    \brief Solves a chunk with Solve_Batch_Simd () (the Chunk_Solver of Solve_Chunked () by default)
+
+    The time of the chunk goes into the latency histogram of Solver_Stats.h.
+
+    \param [in] context {Not used}
+*/
+static void Solve_Chunk_Simd (void *context, const double *a, const double *b, const double *c,
+                              double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    (void)context;
+
+    uint64_t start = STATS_TIMER_START ();
+    Solve_Batch_Simd (a, b, c, x_1, x_2, n_roots, n_equations);
+    STATS_TIMER_STOP (start, n_equations);
+}
+
+/**
+    \brief Solves equations chunk by chunk in the arrays of a caller-provided arena
+
+    Calls "read" to fill "A", "B" and "C" of the arena, "solve" and then "write" for the results,
+             until "read" returns 0. The arena is the only memory the equations go through.
+
+    \param [in,out] arena {Pointer on the block whose arrays are reused for every chunk}
+    \param [in] read {The function that fills a chunk}
+    \param [in,out] source {The first argument of "read"}
+    \param [in] write {The function that takes the results of a chunk}
+    \param [in,out] sink {The first argument of "write"}
+    \param [in] solve {The function the chunks are solved with (NULL means Solve_Batch_Simd ())}
+    \param [in,out] context {The first argument of "solve"}
+    \return 0 if all the chunks have been written (check the source for errors of reading)
+    \return -1 if "write" has failed
+*/
+int Solve_Chunked (struct Equation_Block *arena, Chunk_Reader read, void *source,
+                   Chunk_Writer write, void *sink, Chunk_Solver solve, void *context)
+{
+    assert (arena != NULL);
+    assert (read  != NULL);
+    assert (write != NULL);
+
+    if (solve == NULL)
+        solve = Solve_Chunk_Simd;
+
+    size_t n_equations = 0;
+
+    while ((n_equations = read (source, arena->A, arena->B, arena->C, arena->Capacity)) > 0)
+    {
+        solve (context, arena->A, arena->B, arena->C, arena->X_1, arena->X_2, arena->N_Roots, n_equations);
+
+        if (write (sink, arena->X_1, arena->X_2, arena->N_Roots, n_equations) != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+///The context of Solve_Binary_Chunk ()
+struct Binary_Chunk_Context
+{
+    const struct Options *Options;  ///< The settings
+    struct Root_Cache *Cache;       ///< The cache or NULL
+    size_t *Totals;                 ///< The numbers of equations of every class in the classification modes
+};
+
+/**
+    \brief Solves or classifies a chunk of Run_Chunked_Binary_Mode () (a Chunk_Solver)
+
+    Calls Classify_Block () with "--classify" or "--totals" and Solve_Block () otherwise.
+
+    \param [in,out] context {Pointer on struct Binary_Chunk_Context}
+*/
+static void Solve_Binary_Chunk (void *context, const double *a, const double *b, const double *c,
+                                double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    const struct Binary_Chunk_Context *chunk = context;
+
+    if (chunk->Options->Classify)
+        Classify_Block (a, b, c, n_roots, n_equations, chunk->Totals);
+    else
+        Solve_Block (chunk->Options, chunk->Cache, a, b, c, x_1, x_2, n_roots, n_equations);
+}
+
+/**
+    \brief Drops the results of a chunk (the Chunk_Writer of "--totals")
+
+    \return 0
+*/
+static int Skip_Chunk (void *sink, const double *x_1, const double *x_2, const enum N_Roots *n_roots,
+                       const size_t n_equations)
+{
+    (void)sink;
+    (void)x_1;
+    (void)x_2;
+    (void)n_roots;
+    (void)n_equations;
+
+    return 0;
+}
+
+/**
+    \brief Solves a binary input of any size in a constant amount of memory
+
+    Calls Open_Binary_Source (), Open_Binary_Sink () and Solve_Chunked () with Solve_Binary_Chunk ()
+             and one arena of CHUNKED_BLOCK_SIZE equations. Unlike Run_Binary_Mode (), nothing is mapped, so the input can be a pipe and the output can be stdout.
+    If the name of the output ends with STORE_EXTENSION, the results go into Open_Store_Writer () instead.
+    With "--totals" only Write_Class_Totals () is written.
+
+    \param [in] options {Pointer on the settings}
+    \return 0 if all the equations have been solved
+    \return 2 if the input or the output cannot be opened, read or written
+*/
+int Run_Chunked_Binary_Mode (const struct Options *options)
+{
+    assert (options != NULL);
+
+    struct Binary_Source source = {0};
+    struct Binary_Sink sink = {.Fd = -1};
+    struct Store_Writer store = {0};
+    struct Equation_Block arena = {0};
+    struct Root_Cache cache = {0};
+    size_t totals[4] = {0};
+    int status = 2;
+
+    const bool to_store = !options->Totals && Is_Store_Name (options->Output);
+    Chunk_Writer write = options->Totals ? Skip_Chunk : to_store ? Write_Store_Chunk : Write_Binary_Chunk;
+    void *output = to_store ? (void *)&store : (void *)&sink;
+
+    if (Open_Binary_Source (&source, options->Input) == 0 &&
+        (options->Totals || (to_store ? Open_Store_Writer (&store, options->Output, options->Classify)
+                                      : Open_Binary_Sink (&sink, options->Output, options->Classify, source.N_Equations)) == 0))
+    {
+        if (Allocate_Equation_Block (&arena, CHUNKED_BLOCK_SIZE) != 0 ||
+            (options->Cache_Size != 0 && Init_Root_Cache (&cache, options->Cache_Size, true) != 0))
+            fprintf (stderr, "Not enough memory\n");
+        else
+        {
+            struct Binary_Chunk_Context context = {options, (cache.Entries != NULL) ? &cache : NULL, totals};
+
+            if (Solve_Chunked (&arena, Read_Binary_Chunk, &source, write, output, Solve_Binary_Chunk, &context) != 0)
+                fprintf (stderr, "Cannot write to \"%s\"\n", options->Output);
+            else if (source.Failed)
+                fprintf (stderr, "Cannot read \"%s\" or it ends in the middle of an equation\n", options->Input);
+            else
+                status = 0;
+        }
+    }
+
+    if (cache.Entries != NULL)
+        Print_Cache_Statistics (stderr, &cache);
+
+    Free_Equation_Block (&arena);
+    Free_Root_Cache (&cache);
+    Close_Binary_Source (&source);
+
+    int close_status = to_store ? Close_Store_Writer (&store) : Close_Binary_Sink (&sink);
+    if (close_status != 0 && status == 0)
+    {
+        fprintf (stderr, "Cannot write to \"%s\"\n", options->Output);
+        status = 2;
+    }
+
+    if (status == 0 && options->Totals)
+    {
+        FILE *stream = (strcmp (options->Output, "-") == 0) ? stdout : fopen (options->Output, "w");
+        status = (stream == NULL) ? -1 : Write_Class_Totals (stream, totals);
+
+        if (stream != NULL && stream != stdout)
+            status |= fclose (stream);
+
+        if (status != 0)
+        {
+            fprintf (stderr, "Cannot write to \"%s\"\n", options->Output);
+            status = 2;
+        }
+    }
+
+    return status;
+}
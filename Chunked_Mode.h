@@ -0,0 +1,62 @@
+#ifndef CHUNKED_MODE_H_INCLUDED
+#define CHUNKED_MODE_H_INCLUDED
+
+#include "Binary_Mode.h"
+#include "Stream_Mode.h"
+
+#include <sys/types.h>
+
+#define CHUNKED_BLOCK_SIZE 65536    ///The number of equations the chunked binary mode reads, solves and writes at a time
+
+/*
+    Chunked processing: the caller owns one struct Equation_Block (the arena) whose size does not depend on the input.
+    A Chunk_Reader fills its arrays "A", "B" and "C", the chunk is solved into "X_1", "X_2" and "N_Roots",
+    and a Chunk_Writer takes the results before the arrays are filled again, so nothing is allocated per equation
+    and the memory used is the same for any number of equations.
+*/
+
+///Puts up to "max_equations" next equations into the arrays and returns their number (0 at the end or on an error)
+typedef size_t (*Chunk_Reader) (void *source, double *a, double *b, double *c, const size_t max_equations);
+
+///Takes the results of a chunk before the arrays are reused; returns 0 if everything is OK
+typedef int (*Chunk_Writer) (void *sink, const double *x_1, const double *x_2, const enum N_Roots *n_roots,
+                             const size_t n_equations);
+
+///Solves a chunk in the arrays of the arena; "context" is the argument of Solve_Chunked () that goes with it
+typedef void (*Chunk_Solver) (void *context, const double *a, const double *b, const double *c,
+                              double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations);
+
+///Binary coefficients read sequentially through a buffer of CHUNKED_BLOCK_SIZE triples
+struct Binary_Source
+{
+    int Fd;                     ///< The input file or stdin
+    enum Binary_Layout Layout;  ///< The order of the coefficients
+    size_t N_Equations;         ///< The number of equations or SIZE_MAX if it is not known (a pipe of raw triples)
+    size_t N_Read;              ///< The number of equations that have been read
+    off_t Data_Offset;          ///< The position of the first coefficient in the file
+    unsigned char *Buffer;      ///< Bytes that have been read but not used yet
+    size_t Length;              ///< The number of bytes in "Buffer"
+    bool Failed;                ///< The input cannot be read or ends in the middle of an equation
+};
+
+///Binary results written sequentially through a buffer of CHUNKED_BLOCK_SIZE records
+struct Binary_Sink
+{
+    int Fd;                     ///< The output file or stdout
+    bool Counts_Only;           ///< Write one signed byte per equation instead of struct Root_Record
+    unsigned char *Buffer;      ///< The results of one chunk in the output format
+};
+
+int    Open_Binary_Source (struct Binary_Source *source, const char *path);
+size_t Read_Binary_Chunk (void *source, double *a, double *b, double *c, const size_t max_equations);
+void   Close_Binary_Source (struct Binary_Source *source);
+int    Open_Binary_Sink (struct Binary_Sink *sink, const char *path, const bool counts_only, const size_t n_equations);
+int    Write_Binary_Chunk (void *sink, const double *x_1, const double *x_2, const enum N_Roots *n_roots,
+                           const size_t n_equations);
+int    Close_Binary_Sink (struct Binary_Sink *sink);
+int    Solve_Chunked (struct Equation_Block *arena, Chunk_Reader read, void *source,
+                      Chunk_Writer write, void *sink, Chunk_Solver solve, void *context);
+int    Run_Chunked_Binary_Mode (const struct Options *options);
+int    Chunked_Unit_Test (void);
+
+#endif
@@ -0,0 +1,610 @@
+#include "Coeff_Reader.h"
+
+#include <stdlib.h>
+#include <float.h>
+
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined (__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "Parse_Eight_Digits () reads digits as a little-endian number"
+#endif
+
+/*
+    The reader works in two passes over every buffer. Index_Buffer () marks the separators and the ends of lines
+    in two bit arrays, 16 bytes per instruction with SSE2; then lines and numbers are found by counting zero bits
+    instead of testing every symbol. Parse_Double () takes the digits eight at a time and converts most numbers
+    exactly without strtod ().
+*/
+
+#define MAX_FAST_DIGITS 19      ///The number of decimal digits that always fit in uint64_t
+#define MAX_FAST_MANTISSA (1ULL << 53)  ///Integers up to this one are exact in the "double" type
+#define MAX_FAST_EXPONENT 22    ///Powers of 10 up to this one are exact in the "double" type
+#define MAX_EXTENDED_EXPONENT 27    ///Powers of 10 up to this one are exact in the 64-bit mantissa of "long double"
+#define MAX_TOKEN_LENGTH 512    ///The maximal length of a number that Parse_Double () passes to strtod ()
+
+///Exact powers of 10 used by the fast path of Parse_Double ()
+static const double Powers_Of_10[MAX_FAST_EXPONENT + 1] =
+{
+    1E0,  1E1,  1E2,  1E3,  1E4,  1E5,  1E6,  1E7,  1E8,  1E9,  1E10, 1E11,
+    1E12, 1E13, 1E14, 1E15, 1E16, 1E17, 1E18, 1E19, 1E20, 1E21, 1E22
+};
+
+///Powers of 10 Parse_Digits () multiplies the mantissa by
+static const uint64_t Integer_Powers_Of_10[8] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
+
+#if LDBL_MANT_DIG == 64
+///Exact powers of 10 used by Convert_Extended ()
+static const long double Extended_Powers_Of_10[MAX_EXTENDED_EXPONENT + 1] =
+{
+    1E0L,  1E1L,  1E2L,  1E3L,  1E4L,  1E5L,  1E6L,  1E7L,  1E8L,  1E9L,  1E10L, 1E11L, 1E12L, 1E13L,
+    1E14L, 1E15L, 1E16L, 1E17L, 1E18L, 1E19L, 1E20L, 1E21L, 1E22L, 1E23L, 1E24L, 1E25L, 1E26L, 1E27L
+};
+#endif
+
+/**
+    \brief Opens a file for Read_Triples ()
+
+    \param [out] reader {Pointer on the reader}
+    \param [in] path {The name of the file ("-" means stdin)}
+    \return 0 if the file has been opened
+    \return -1 if the file cannot be opened or there is no memory for the buffer
+*/
+int Open_Coeff_Reader (struct Coeff_Reader *reader, const char *path)
+{
+    assert (reader != NULL);
+    assert (path   != NULL);
+
+    reader->Stream = (strcmp (path, "-") == 0) ? stdin : fopen (path, "rb");
+    if (reader->Stream == NULL)
+        return -1;
+
+    reader->Buffer         = malloc (READER_BUFFER_SIZE);
+    reader->Separator_Bits = malloc (READER_INDEX_WORDS * sizeof (uint64_t));
+    reader->New_Line_Bits  = malloc (READER_INDEX_WORDS * sizeof (uint64_t));
+    if (reader->Buffer == NULL || reader->Separator_Bits == NULL || reader->New_Line_Bits == NULL)
+    {
+        if (reader->Stream != stdin)
+            fclose (reader->Stream);
+        free (reader->Buffer);
+        free (reader->Separator_Bits);
+        free (reader->New_Line_Bits);
+        return -1;
+    }
+
+    reader->Begin    = 0;
+    reader->End      = 0;
+    reader->Line     = 1;
+    reader->N_Errors = 0;
+    reader->Last_Error_Line = 0;
+    reader->Eof      = false;
+
+    return 0;
+}
+
+/**
+    \brief Closes the file and frees the buffer of the reader
+
+    \param [in] reader {Pointer on the reader}
+*/
+void Close_Coeff_Reader (struct Coeff_Reader *reader)
+{
+    assert (reader != NULL);
+
+    if (reader->Stream != NULL && reader->Stream != stdin)
+        fclose (reader->Stream);
+
+    free (reader->Buffer);
+    free (reader->Separator_Bits);
+    free (reader->New_Line_Bits);
+
+    reader->Stream = NULL;
+    reader->Buffer = NULL;
+    reader->Separator_Bits = NULL;
+    reader->New_Line_Bits  = NULL;
+}
+
+/**
+    \brief Checks if a symbol separates numbers of one line
+
+    \param [in] symbol {The symbol}
+    \return True for ' ', '\\t', '\\r', ',' and ';'
+*/
+static inline bool Is_Separator (const char symbol)
+{
+    return symbol == ' ' || symbol == '\t' || symbol == '\r' || symbol == ',' || symbol == ';';
+}
+
+/**
+    \brief Marks the separators and the ends of lines among 64 symbols
+
+    \param [in] text {Pointer on the first symbol}
+    \param [out] separators {Pointer on the variable in which the function puts the mask of Is_Separator () symbols}
+    \param [out] new_lines {Pointer on the variable in which the function puts the mask of '\\n'}
+*/
+static inline void Index_Block (const char *text, uint64_t *separators, uint64_t *new_lines)
+{
+    uint64_t separator_mask = 0, new_line_mask = 0;
+
+#if defined (__SSE2__)
+    for (int part = 0; part < 4; part++)
+    {
+        __m128i symbols = _mm_loadu_si128 ((const __m128i *)(text + 16 * part));
+        __m128i separator = _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi8 (symbols, _mm_set1_epi8 (' ')),
+                                                        _mm_cmpeq_epi8 (symbols, _mm_set1_epi8 ('\t'))),
+                                          _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi8 (symbols, _mm_set1_epi8 ('\r')),
+                                                                      _mm_cmpeq_epi8 (symbols, _mm_set1_epi8 (','))),
+                                                        _mm_cmpeq_epi8 (symbols, _mm_set1_epi8 (';'))));
+
+        separator_mask |= (uint64_t)(unsigned)_mm_movemask_epi8 (separator) << (16 * part);
+        new_line_mask  |= (uint64_t)(unsigned)_mm_movemask_epi8 (_mm_cmpeq_epi8 (symbols, _mm_set1_epi8 ('\n'))) << (16 * part);
+    }
+#else
+    for (int i = 0; i < 64; i++)
+    {
+        separator_mask |= (uint64_t)Is_Separator (text[i]) << i;
+        new_line_mask  |= (uint64_t)(text[i] == '\n') << i;
+    }
+#endif
+
+    *separators = separator_mask;
+    *new_lines  = new_line_mask;
+}
+
+/**
+    \brief Fills the bit indices of the buffer for the bytes from 0 to "End"
+
+    Calls Index_Block () for every 64 bytes. The bytes after "End" up to a multiple of 64 are filled with '\\n',
+             which does not change the lines: "End" is less than READER_BUFFER_SIZE only at the end of the input.
+
+    \param [in] reader {Pointer on the reader}
+*/
+static void Index_Buffer (struct Coeff_Reader *reader)
+{
+    size_t n_words = (reader->End + 63) / 64;
+
+    memset (reader->Buffer + reader->End, '\n', n_words * 64 - reader->End);
+
+    for (size_t word = 0; word < n_words; word++)
+        Index_Block (reader->Buffer + 64 * word, &reader->Separator_Bits[word], &reader->New_Line_Bits[word]);
+}
+
+/**
+    \brief Finds the first set (or clear) bit of a bit index in a range
+
+    \param [in] bits {The bit index}
+    \param [in] from {Index of the first bit of the range}
+    \param [in] to {Index of the bit after the range}
+    \param [in] flip {0 to look for a set bit, ~0 to look for a clear one}
+    \return Index of the bit or "to" if there is no such bit in the range
+*/
+static inline size_t Find_Next_Bit (const uint64_t *bits, const size_t from, const size_t to, const uint64_t flip)
+{
+    if (from >= to)
+        return to;
+
+    size_t word = from / 64;
+    uint64_t mask = (bits[word] ^ flip) & (~0ULL << (from % 64));
+
+    while (mask == 0)
+    {
+        if (++word * 64 >= to)
+            return to;
+        mask = bits[word] ^ flip;
+    }
+
+    size_t index = word * 64 + (size_t)__builtin_ctzll (mask);
+
+    return (index < to) ? index : to;
+}
+
+/**
+    \brief Moves the unparsed bytes to the beginning of the buffer, reads the input after them and calls Index_Buffer ()
+
+    \param [in] reader {Pointer on the reader}
+*/
+static void Refill_Buffer (struct Coeff_Reader *reader)
+{
+    size_t left = reader->End - reader->Begin;
+
+    memmove (reader->Buffer, reader->Buffer + reader->Begin, left);
+    reader->Begin = 0;
+    reader->End   = left;
+
+    while (!reader->Eof && reader->End < READER_BUFFER_SIZE)
+    {
+        size_t n_read = fread (reader->Buffer + reader->End, 1, READER_BUFFER_SIZE - reader->End, reader->Stream);
+
+        reader->End += n_read;
+        if (n_read == 0)
+            reader->Eof = true;
+    }
+
+    Index_Buffer (reader);
+}
+
+/**
+    \brief Finds the end of the line that starts at "Begin"
+
+    Calls Refill_Buffer () if the line is not in the buffer yet.
+    If the line is longer than the buffer, the function reports it, skips it and looks for the next one.
+
+    \param [in] reader {Pointer on the reader}
+    \param [out] line_end {Pointer on the variable in which the function puts the index of '\\n' or "End"}
+    \return False if there are no lines left
+    \return True otherwise
+*/
+static bool Find_Line (struct Coeff_Reader *reader, size_t *line_end)
+{
+    for (;;)
+    {
+        size_t new_line = Find_Next_Bit (reader->New_Line_Bits, reader->Begin, reader->End, 0);
+
+        if (new_line < reader->End)
+        {
+            *line_end = new_line;
+            return true;
+        }
+        if (reader->Eof)
+        {
+            *line_end = reader->End;
+            return reader->Begin < reader->End;
+        }
+        if (reader->Begin == 0 && reader->End == READER_BUFFER_SIZE)
+        {
+            fprintf (stderr, "Line %zu: the line is too long\n", reader->Line);
+            reader->N_Errors++;
+            reader->Last_Error_Line = reader->Line;
+
+            int symbol = 0;
+            while ((symbol = getc (reader->Stream)) != '\n' && symbol != EOF)
+                ;
+
+            reader->Begin = reader->End;
+            reader->Line++;
+            if (symbol == EOF)
+                reader->Eof = true;
+        }
+
+        Refill_Buffer (reader);
+    }
+}
+
+/**
+    \brief Parses one line of the buffer
+
+    Calls Find_Next_Bit () to skip separators and to find the end of every number, then Parse_Double ().
+    The line is correct if it consists of exactly three numbers separated by Is_Separator () symbols.
+
+    \param [in] reader {Pointer on the reader}
+    \param [in] begin {Index of the first symbol of the line}
+    \param [in] end {Index of the symbol after the last one of the line}
+    \param [out] coeffs {Array of three coefficients}
+    \return The number of numbers in the line (0 for an empty line or a comment that starts with '#')
+    \return -1 if the line is malformed
+*/
+static int Parse_Line (const struct Coeff_Reader *reader, const size_t begin, const size_t end, double coeffs[3])
+{
+    int n_coeffs = 0;
+    size_t position = Find_Next_Bit (reader->Separator_Bits, begin, end, ~0ULL);
+
+    if (position == end || reader->Buffer[position] == '#')
+        return 0;
+
+    while (position < end)
+    {
+        if (n_coeffs == 3)
+            return -1;
+
+        const char *number_end = Parse_Double (reader->Buffer + position, reader->Buffer + end, &coeffs[n_coeffs++]);
+        if (number_end == NULL)
+            return -1;
+
+        position = (size_t)(number_end - reader->Buffer);
+        if (position < end && !(reader->Separator_Bits[position / 64] >> (position % 64) & 1))
+            return -1;
+
+        position = Find_Next_Bit (reader->Separator_Bits, position, end, ~0ULL);
+    }
+
+    return (n_coeffs == 3) ? 3 : -1;
+}
+
+/**
+    \brief Reads coefficient triples
+
+    Calls Find_Line (), Parse_Line ().
+    Every line contains one triple, empty lines and lines that start with '#' are skipped.
+    Malformed lines are reported to stderr with their numbers and skipped.
+
+    \param [in] reader {Pointer on the reader}
+    \param [out] a {Array of at least "max_triples" quadratic coefficients}
+    \param [out] b {Array of at least "max_triples" linear coefficients}
+    \param [out] c {Array of at least "max_triples" free terms}
+    \param [in] max_triples {The maximal number of triples to read}
+    \return The number of triples that have been read (0 at the end of the input)
+*/
+size_t Read_Triples (struct Coeff_Reader *reader, double *a, double *b, double *c, const size_t max_triples)
+{
+    assert (reader != NULL);
+    assert (a != NULL && b != NULL && c != NULL);
+
+    size_t n_triples = 0, line_end = 0;
+
+    while (n_triples < max_triples && Find_Line (reader, &line_end))
+    {
+        double coeffs[3] = {0};
+        int n_coeffs = Parse_Line (reader, reader->Begin, line_end, coeffs);
+
+        if (n_coeffs == 3)
+        {
+            a[n_triples] = coeffs[0];
+            b[n_triples] = coeffs[1];
+            c[n_triples] = coeffs[2];
+            n_triples++;
+        }
+        else if (n_coeffs == -1)
+        {
+            fprintf (stderr, "Line %zu: expected three numbers\n", reader->Line);
+            reader->N_Errors++;
+            reader->Last_Error_Line = reader->Line;
+        }
+
+        reader->Begin = (line_end < reader->End) ? line_end + 1 : line_end;
+        reader->Line++;
+    }
+
+    return n_triples;
+}
+
+/**
+    \brief Passes a number that the fast path cannot convert exactly to strtod ()
+
+    \param [in] begin {Pointer on the first symbol of the number}
+    \param [in] end {Pointer on the symbol after the last one that can belong to the number}
+    \param [out] value {Pointer on the variable in which the function puts the number}
+    \return Pointer on the symbol after the number or NULL if there is no number
+*/
+static const char *Parse_Double_Slow (const char *begin, const char *end, double *value)
+{
+    char token[MAX_TOKEN_LENGTH + 1] = "";
+    size_t length = 0;
+
+    while (begin + length < end && length < MAX_TOKEN_LENGTH && !Is_Separator (begin[length]))
+    {
+        token[length] = begin[length];
+        length++;
+    }
+
+    char *token_end = NULL;
+    *value = strtod (token, &token_end);
+
+    return (token_end == token) ? NULL : begin + (token_end - token);
+}
+
+/**
+    \brief Checks if a symbol is a decimal digit without the locale of isdigit ()
+
+    \param [in] symbol {The symbol}
+    \return True for '0' .. '9'
+*/
+static inline bool Is_Digit (const char symbol)
+{
+    return (unsigned char)(symbol - '0') <= 9;
+}
+
+/**
+    \brief Marks the symbols of a word of eight symbols that are not decimal digits
+
+    A byte is a digit if its high half is 3 and adding 6 does not change it. A byte from 0xFA carries into the next one,
+             but it is not a digit itself, so the first byte that is marked is always the first symbol that is not a digit.
+
+    \param [in] symbols {Eight symbols, the first one in the lowest byte}
+    \return A word whose bytes are not 0 where the symbols are not digits (at least up to the first such byte)
+*/
+static inline uint64_t Get_Non_Digit_Mask (const uint64_t symbols)
+{
+    return ((symbols & 0xF0F0F0F0F0F0F0F0) | (((symbols + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ^
+           0x3333333333333333;
+}
+
+/**
+    \brief Converts eight decimal digits into a number with three multiplications
+
+    Neighbouring digits are merged into numbers of 2, 4 and then 8 digits inside one 64-bit word.
+    Zero bytes count as the digit 0.
+
+    \param [in] symbols {Eight digits, the first one in the lowest byte}
+    \return The number from 0 to 99999999
+*/
+static inline uint64_t Parse_Eight_Digits (uint64_t symbols)
+{
+    symbols = (symbols & 0x0F0F0F0F0F0F0F0F) * 2561 >> 8;
+    symbols = (symbols & 0x00FF00FF00FF00FF) * 6553601 >> 16;
+
+    return (symbols & 0x0000FFFF0000FFFF) * 42949672960001 >> 32;
+}
+
+/**
+    \brief Adds the digits that start at "symbol" to a mantissa
+
+    While eight symbols are left, they are read as one word: Get_Non_Digit_Mask () finds how many of them are digits
+             and Parse_Eight_Digits () converts all of them at once. The last symbols are taken one at a time.
+    The mantissa wraps around after 19 digits, but then Parse_Double () does not use it.
+
+    \param [in] symbol {Pointer on the first symbol}
+    \param [in] end {Pointer on the symbol after the last one that can belong to the number}
+    \param [in,out] mantissa {Pointer on the mantissa}
+    \param [in,out] n_digits {Pointer on the number of digits of the mantissa}
+    \return Pointer on the first symbol that is not a digit
+*/
+static inline const char *Parse_Digits (const char *symbol, const char *end, uint64_t *mantissa, int *n_digits)
+{
+    while (end - symbol >= 8)
+    {
+        uint64_t symbols = 0;
+        memcpy (&symbols, symbol, sizeof (symbols));
+
+        uint64_t non_digits = Get_Non_Digit_Mask (symbols);
+
+        if (non_digits == 0)
+        {
+            *mantissa = *mantissa * 100000000 + Parse_Eight_Digits (symbols);
+            *n_digits += 8;
+            symbol    += 8;
+            continue;
+        }
+
+        int n_leading = __builtin_ctzll (non_digits) / 8;
+
+        if (n_leading > 0)
+        {
+            *mantissa = *mantissa * Integer_Powers_Of_10[n_leading] + Parse_Eight_Digits (symbols << (8 * (8 - n_leading)));
+            *n_digits += n_leading;
+        }
+
+        return symbol + n_leading;
+    }
+
+    for (; symbol < end && Is_Digit (*symbol); symbol++, (*n_digits)++)
+        *mantissa = *mantissa * 10 + (uint64_t)(*symbol - '0');
+
+    return symbol;
+}
+
+#if LDBL_MANT_DIG == 64
+/**
+    \brief Converts mantissa * 10^exponent exactly with one operation in the 64-bit mantissa of "long double"
+
+    The product or the quotient of two exact numbers is rounded only once to 64 bits. Rounding it again to 53 bits
+             gives the correctly rounded number unless it is exactly halfway between two numbers of the "double" type:
+             such a halfway number has 54 bits, so the exact result cannot be on its other side.
+
+    \param [in] mantissa {The decimal mantissa of at most 19 digits}
+    \param [in] exponent {The decimal exponent, at most MAX_EXTENDED_EXPONENT by absolute value}
+    \param [out] value {Pointer on the variable in which the function puts the number}
+    \return True if the number has been converted
+    \return False if the extended result is a halfway case
+*/
+static inline bool Convert_Extended (const uint64_t mantissa, const int exponent, double *value)
+{
+    long double extended = (long double)mantissa;
+
+    if (exponent < 0)
+        extended /= Extended_Powers_Of_10[-exponent];
+    else
+        extended *= Extended_Powers_Of_10[exponent];
+
+    double result = (double)extended;
+
+    if ((long double)result != extended)
+    {
+        double neighbour = nextafter (result, (extended > result) ? INFINITY : -INFINITY);
+
+        if (((long double)result + neighbour) / 2 == extended)
+            return false;
+    }
+
+    *value = result;
+
+    return true;
+}
+#endif
+
+/**
+    \brief Converts decimal text into a number of the "double" type
+
+    Calls Parse_Digits () for the integer and the fractional parts.
+    Numbers with at most 19 significant digits whose mantissa fits in 53 bits and whose
+             decimal exponent is at most 22 by absolute value are converted with one multiplication or
+             division of two exact numbers, so the result is correctly rounded.
+    Other numbers with at most 19 significant digits and a decimal exponent of at most 27 by absolute value
+             are converted by Convert_Extended ().
+    Every other number (and "nan", "inf") is passed to Parse_Double_Slow ().
+
+    \param [in] begin {Pointer on the first symbol of the number}
+    \param [in] end {Pointer on the symbol after the last one that can belong to the number}
+    \param [out] value {Pointer on the variable in which the function puts the number}
+    \return Pointer on the symbol after the number or NULL if there is no number
+*/
+const char *Parse_Double (const char *begin, const char *end, double *value)
+{
+    assert (begin != NULL && end != NULL);
+    assert (value != NULL);
+
+    const char *symbol = begin;
+    bool negative = false;
+
+    if (symbol < end && (*symbol == '-' || *symbol == '+'))
+        negative = (*symbol++ == '-');
+
+    uint64_t mantissa = 0;
+    int n_digits = 0, exponent = 0;
+    const char *digits_begin = symbol;
+
+    while (symbol < end && *symbol == '0')
+        symbol++;
+    symbol = Parse_Digits (symbol, end, &mantissa, &n_digits);
+
+    if (symbol < end && *symbol == '.')
+    {
+        const char *fraction = ++symbol;
+
+        if (n_digits == 0)
+            while (symbol < end && *symbol == '0')
+                symbol++;
+        symbol = Parse_Digits (symbol, end, &mantissa, &n_digits);
+
+        exponent -= (int)(symbol - fraction);
+    }
+
+    if (symbol == digits_begin || (symbol == digits_begin + 1 && *digits_begin == '.'))
+        return Parse_Double_Slow (begin, end, value);
+
+    if (symbol < end && (*symbol == 'e' || *symbol == 'E'))
+    {
+        const char *exp_symbol = symbol + 1;
+        bool exp_negative = false;
+        int exp_value = 0;
+
+        if (exp_symbol < end && (*exp_symbol == '-' || *exp_symbol == '+'))
+            exp_negative = (*exp_symbol++ == '-');
+
+        if (exp_symbol == end || !Is_Digit (*exp_symbol))
+            return Parse_Double_Slow (begin, end, value);
+
+        for (; exp_symbol < end && Is_Digit (*exp_symbol); exp_symbol++)
+            if (exp_value < 100000)
+                exp_value = exp_value * 10 + (*exp_symbol - '0');
+
+        exponent += exp_negative ? -exp_value : exp_value;
+        symbol = exp_symbol;
+    }
+
+    double result = 0.0;
+
+    if (n_digits > MAX_FAST_DIGITS)
+        return Parse_Double_Slow (begin, end, value);
+    else if (mantissa <= MAX_FAST_MANTISSA && exponent >= -MAX_FAST_EXPONENT && exponent <= MAX_FAST_EXPONENT)
+    {
+        result = (double)mantissa;
+
+        if (exponent < 0)
+            result /= Powers_Of_10[-exponent];
+        else
+            result *= Powers_Of_10[exponent];
+    }
+#if LDBL_MANT_DIG == 64
+    else if (exponent < -MAX_EXTENDED_EXPONENT || exponent > MAX_EXTENDED_EXPONENT ||
+             !Convert_Extended (mantissa, exponent, &result))
+        return Parse_Double_Slow (begin, end, value);
+#else
+    else
+        return Parse_Double_Slow (begin, end, value);
+#endif
+
+    *value = negative ? -result : result;
+
+    return symbol;
+}
@@ -0,0 +1,32 @@
+#ifndef COEFF_READER_H_INCLUDED
+#define COEFF_READER_H_INCLUDED
+
+#include "Quadratic_Equation.h"
+
+#include <stdint.h>
+
+#define READER_BUFFER_SIZE (1 << 20)    ///The size of the block that is read from the input at a time (a multiple of 64)
+#define READER_INDEX_WORDS (READER_BUFFER_SIZE / 64)    ///The number of 64-bit words of every bit index of the buffer
+
+///Block-buffered reader of coefficient triples, one triple per line
+struct Coeff_Reader
+{
+    FILE *Stream;       ///< The input
+    char *Buffer;       ///< READER_BUFFER_SIZE bytes of the input
+    size_t Begin;       ///< Index of the first byte that has not been parsed yet
+    size_t End;         ///< Index of the byte after the last one that has been read
+    size_t Line;        ///< The number of the line that starts at "Begin"
+    size_t N_Errors;    ///< The number of malformed lines that have been skipped
+    size_t Last_Error_Line;     ///< The number of the last malformed line (0 if there have been none)
+    uint64_t *Separator_Bits;   ///< Bit i is set if Buffer[i] is a separator of numbers
+    uint64_t *New_Line_Bits;    ///< Bit i is set if Buffer[i] is '\n'
+    bool Eof;           ///< True if the whole input is in the buffer
+};
+
+int    Open_Coeff_Reader  (struct Coeff_Reader *reader, const char *path);
+void   Close_Coeff_Reader (struct Coeff_Reader *reader);
+size_t Read_Triples (struct Coeff_Reader *reader, double *a, double *b, double *c, const size_t max_triples);
+const char *Parse_Double (const char *begin, const char *end, double *value);
+int    Reader_Unit_Test (void);
+
+#endif
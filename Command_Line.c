@@ -0,0 +1,444 @@
+#include "Command_Line.h"
+
+#include <stdlib.h>
+
+/**
+    \brief Gets the argument of an option
+
+    \param [in] argc {The number of command line arguments}
+    \param [in] argv {Array of command line arguments}
+    \param [in] i {Pointer on the index of the option, it is moved to the argument}
+    \return Pointer on the argument or NULL if the option is the last one
+*/
+static const char *Get_Option_Argument (const int argc, char *argv[], int *i)
+{
+    if (*i + 1 >= argc)
+    {
+        fprintf (stderr, "Option \"%s\" needs an argument\n", argv[*i]);
+        return NULL;
+    }
+
+    return argv[++*i];
+}
+
+/**
+    \brief Converts an argument of an option into a not negative number
+
+    \param [in] string {The argument}
+    \param [out] number {Pointer on the variable in which the function puts the number}
+    \return 0 if the argument is a not negative integer number
+    \return -1 otherwise
+*/
+static int Get_Unsigned_Argument (const char *string, unsigned *number)
+{
+    char *end = NULL;
+    unsigned long value = strtoul (string, &end, 10);
+
+    if (end == string || *end != '\0' || *string == '-' || value > 1000000)
+    {
+        fprintf (stderr, "\"%s\" is not a not negative integer number\n", string);
+        return -1;
+    }
+
+    *number = (unsigned)value;
+    return 0;
+}
+
+/**
+    \brief Converts an argument of an option into a positive number of any size
+
+    \param [in] string {The argument}
+    \param [out] number {Pointer on the variable in which the function puts the number}
+    \return 0 if the argument is a positive integer number
+    \return -1 otherwise
+*/
+static int Get_Size_Argument (const char *string, size_t *number)
+{
+    char *end = NULL;
+    unsigned long long value = strtoull (string, &end, 10);
+
+    if (end == string || *end != '\0' || *string == '-' || value == 0)
+    {
+        fprintf (stderr, "\"%s\" is not a positive integer number\n", string);
+        return -1;
+    }
+
+    *number = (size_t)value;
+    return 0;
+}
+
+/**
+    \brief Converts an argument of an option into a finite number of the "double" type
+
+    \param [in] string {The argument}
+    \param [out] number {Pointer on the variable in which the function puts the number}
+    \return 0 if the argument is a finite number
+    \return -1 otherwise
+*/
+static int Get_Double_Argument (const char *string, double *number)
+{
+    char *end = NULL;
+    double value = strtod (string, &end);
+
+    if (end == string || *end != '\0' || !isfinite (value))
+    {
+        fprintf (stderr, "\"%s\" is not a finite number\n", string);
+        return -1;
+    }
+
+    *number = value;
+    return 0;
+}
+
+/**
+    \brief Gets the two bounds of a range option
+
+    The bounds can be "inf" and "-inf"; a range "lo hi" means lo <= x <= hi.
+
+    \param [in] argc {The number of command line arguments}
+    \param [in] argv {Array of command line arguments}
+    \param [in] i {Pointer on the index of the option, it is moved to the second bound}
+    \param [out] range {Array for the lower and the upper bound}
+    \return 0 if there are two numbers and the first one is not greater than the second one
+    \return -1 otherwise
+*/
+static int Get_Range_Arguments (const int argc, char *argv[], int *i, double range[2])
+{
+    for (int n_bound = 0; n_bound < 2; n_bound++)
+    {
+        const char *argument = Get_Option_Argument (argc, argv, i);
+        if (argument == NULL)
+            return -1;
+
+        char *end = NULL;
+        range[n_bound] = strtod (argument, &end);
+
+        if (end == argument || *end != '\0' || isnan (range[n_bound]))
+        {
+            fprintf (stderr, "\"%s\" is not a number\n", argument);
+            return -1;
+        }
+    }
+
+    if (range[0] > range[1])
+    {
+        fprintf (stderr, "The range [%g, %g] is empty\n", range[0], range[1]);
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+    \brief Parses the command line
+
+    Without arguments the program works in the interactive mode.
+
+    \param [in] argc {The number of command line arguments}
+    \param [in] argv {Array of command line arguments}
+    \param [out] options {Pointer on the structure in which the function puts the settings}
+    \return 0 if the command line is correct
+    \return 1 if the user has asked for help
+    \return -1 if the command line is incorrect
+*/
+int Parse_Command_Line (const int argc, char *argv[], struct Options *options)
+{
+    assert (argv    != NULL);
+    assert (options != NULL);
+
+    options->Mode      = Interactive;
+    options->Input     = NULL;
+    options->Output    = "-";
+    options->N_Threads = 1;
+    options->Format    = Shortest_Format;
+    options->Digits    = 0;
+    options->Precise   = false;
+    options->Scaled    = false;
+    options->Verify_Size = 0;
+    options->Cache_Size  = 0;
+    options->Sweep_Steps = 0;
+    options->Stats       = false;
+    options->Classify    = false;
+    options->Totals      = false;
+    options->Chunked     = false;
+    options->Complex     = false;
+    options->Force_Simd  = false;
+    options->Simd_Level  = Simd_None;
+    options->Filter      = (struct Scan_Filter){0};
+
+    bool threads_given = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *argument = NULL;
+
+        if (strcmp (argv[i], "--help") == 0 || strcmp (argv[i], "-h") == 0)
+            return 1;
+        else if (strcmp (argv[i], "--stream") == 0)
+        {
+            if ((argument = Get_Option_Argument (argc, argv, &i)) == NULL)
+                return -1;
+            options->Mode  = Stream;
+            options->Input = argument;
+        }
+        else if (strcmp (argv[i], "--binary") == 0)
+        {
+            if ((argument = Get_Option_Argument (argc, argv, &i)) == NULL)
+                return -1;
+            options->Mode  = Binary;
+            options->Input = argument;
+        }
+        else if (strcmp (argv[i], "--verify") == 0)
+        {
+            if ((argument = Get_Option_Argument (argc, argv, &i)) == NULL ||
+                Get_Size_Argument (argument, &options->Verify_Size) != 0)
+                return -1;
+            options->Mode = Verify;
+        }
+        else if (strcmp (argv[i], "--sweep") == 0)
+        {
+            for (int n_coeff = 0; n_coeff < 6; n_coeff++)
+                if ((argument = Get_Option_Argument (argc, argv, &i)) == NULL ||
+                    Get_Double_Argument (argument, (n_coeff < 3) ? &options->Sweep_Start[n_coeff]
+                                                                  : &options->Sweep_Delta[n_coeff - 3]) != 0)
+                    return -1;
+            if ((argument = Get_Option_Argument (argc, argv, &i)) == NULL ||
+                Get_Size_Argument (argument, &options->Sweep_Steps) != 0)
+                return -1;
+            options->Mode = Sweep;
+        }
+        else if (strcmp (argv[i], "--serve") == 0)
+        {
+            if ((argument = Get_Option_Argument (argc, argv, &i)) == NULL)
+                return -1;
+            options->Mode  = Serve;
+            options->Input = argument;
+        }
+        else if (strcmp (argv[i], "--scan") == 0)
+        {
+            if ((argument = Get_Option_Argument (argc, argv, &i)) == NULL)
+                return -1;
+            options->Mode  = Scan;
+            options->Input = argument;
+        }
+        else if (strcmp (argv[i], "--class") == 0)
+        {
+            long n_roots = 0;
+            char *end = NULL;
+
+            if ((argument = Get_Option_Argument (argc, argv, &i)) == NULL)
+                return -1;
+
+            n_roots = strtol (argument, &end, 10);
+            if (end == argument || *end != '\0' || n_roots < Infinite || n_roots > Two)
+            {
+                fprintf (stderr, "\"%s\" is not a number of roots: use -1, 0, 1 or 2\n", argument);
+                return -1;
+            }
+
+            options->Filter.By_Class = true;
+            options->Filter.Class    = (enum N_Roots)n_roots;
+        }
+        else if (strcmp (argv[i], "--roots-in") == 0)
+        {
+            if (Get_Range_Arguments (argc, argv, &i, options->Filter.Root_Range) != 0)
+                return -1;
+            options->Filter.By_Root = true;
+        }
+        else if (strcmp (argv[i], "--x1-in") == 0)
+        {
+            if (Get_Range_Arguments (argc, argv, &i, options->Filter.X_1_Range) != 0)
+                return -1;
+            options->Filter.By_X_1 = true;
+        }
+        else if (strcmp (argv[i], "--x2-in") == 0)
+        {
+            if (Get_Range_Arguments (argc, argv, &i, options->Filter.X_2_Range) != 0)
+                return -1;
+            options->Filter.By_X_2 = true;
+        }
+        else if (strcmp (argv[i], "--shm") == 0)
+        {
+            if ((argument = Get_Option_Argument (argc, argv, &i)) == NULL)
+                return -1;
+            options->Mode  = Shared_Memory;
+            options->Input = argument;
+        }
+        else if (strcmp (argv[i], "--output") == 0 || strcmp (argv[i], "-o") == 0)
+        {
+            if ((argument = Get_Option_Argument (argc, argv, &i)) == NULL)
+                return -1;
+            options->Output = argument;
+        }
+        else if (strcmp (argv[i], "--threads") == 0)
+        {
+            if ((argument = Get_Option_Argument (argc, argv, &i)) == NULL ||
+                Get_Unsigned_Argument (argument, &options->N_Threads) != 0)
+                return -1;
+            threads_given = true;
+        }
+        else if (strcmp (argv[i], "--digits") == 0)
+        {
+            unsigned digits = 0;
+
+            if ((argument = Get_Option_Argument (argc, argv, &i)) == NULL ||
+                Get_Unsigned_Argument (argument, &digits) != 0)
+                return -1;
+            if (digits > MAX_FIXED_DIGITS)
+            {
+                fprintf (stderr, "There can be at most %d digits after the decimal point\n", MAX_FIXED_DIGITS);
+                return -1;
+            }
+            options->Format = Fixed_Format;
+            options->Digits = (int)digits;
+        }
+        else if (strcmp (argv[i], "--precise") == 0)
+            options->Precise = true;
+        else if (strcmp (argv[i], "--chunked") == 0)
+            options->Chunked = true;
+        else if (strcmp (argv[i], "--isa") == 0)
+        {
+            if ((argument = Get_Option_Argument (argc, argv, &i)) == NULL)
+                return -1;
+
+            options->Force_Simd = false;
+
+            for (enum Simd_Level level = Simd_None; level <= Simd_AVX512; level++)
+                if (strcmp (argument, Get_Simd_Level_Name (level)) == 0)
+                {
+                    options->Force_Simd = true;
+                    options->Simd_Level = level;
+                }
+
+            if (!options->Force_Simd)
+            {
+                fprintf (stderr, "Unknown instruction set \"%s\": use none, sse2, avx2 or avx512\n", argument);
+                return -1;
+            }
+        }
+        else if (strcmp (argv[i], "--scaled") == 0)
+            options->Scaled = true;
+        else if (strcmp (argv[i], "--complex") == 0)
+            options->Complex = true;
+        else if (strcmp (argv[i], "--classify") == 0)
+            options->Classify = true;
+        else if (strcmp (argv[i], "--totals") == 0)
+        {
+            options->Classify = true;
+            options->Totals   = true;
+        }
+        else if (strcmp (argv[i], "--stats") == 0)
+        {
+#ifdef SOLVER_STATS
+            options->Stats = true;
+#else
+            fprintf (stderr, "The program has been built without statistics, rebuild it with make STATS=1\n");
+            return -1;
+#endif
+        }
+        else if (strcmp (argv[i], "--cache") == 0)
+        {
+            if ((argument = Get_Option_Argument (argc, argv, &i)) == NULL ||
+                Get_Size_Argument (argument, &options->Cache_Size) != 0)
+                return -1;
+        }
+        else
+        {
+            fprintf (stderr, "Unknown option \"%s\"\n", argv[i]);
+            return -1;
+        }
+    }
+
+    if (options->Precise && options->Cache_Size != 0)
+    {
+        fprintf (stderr, "Options \"--precise\" and \"--cache\" cannot be used together\n");
+        return -1;
+    }
+    if (options->Classify && (options->Precise || options->Cache_Size != 0))
+    {
+        fprintf (stderr, "Options \"--classify\" and \"--totals\" cannot be used with \"--precise\" or \"--cache\"\n");
+        return -1;
+    }
+    if ((options->Filter.By_Class || options->Filter.By_Root || options->Filter.By_X_1 || options->Filter.By_X_2) &&
+        options->Mode != Scan)
+    {
+        fprintf (stderr, "Options \"--class\", \"--roots-in\", \"--x1-in\" and \"--x2-in\" can be used only with \"--scan\"\n");
+        return -1;
+    }
+    if (options->Scaled && (options->Precise || options->Cache_Size != 0 || options->Classify || options->Complex))
+    {
+        fprintf (stderr, "Option \"--scaled\" cannot be used with \"--precise\", \"--cache\", \"--classify\", "
+                         "\"--totals\" or \"--complex\"\n");
+        return -1;
+    }
+    if (options->Mode == Sweep && (options->Precise || options->Scaled || threads_given ||
+                                   options->Cache_Size != 0 || options->Classify))
+    {
+        fprintf (stderr, "Option \"--sweep\" cannot be used with \"--precise\", \"--scaled\", \"--threads\", "
+                         "\"--cache\", \"--classify\" or \"--totals\"\n");
+        return -1;
+    }
+    if (options->Complex && (options->Mode != Stream || options->Classify || options->Precise || options->Cache_Size != 0))
+    {
+        fprintf (stderr, "Option \"--complex\" can be used only with \"--stream\" and without \"--classify\", "
+                         "\"--totals\", \"--precise\" or \"--cache\"\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+    \brief Prints the list of options
+
+    \param [in] program_name {The name the program has been run with}
+*/
+void Print_Usage (const char *program_name)
+{
+    assert (program_name != NULL);
+
+    printf ("Usage: %s [options]\n"
+            "Without options the program asks for coefficients interactively\n\n"
+            "  --stream <file>     solve coefficient triples from <file> (\"-\" means stdin), one triple per line\n"
+            "  --binary <file>     solve packed little-endian (a, b, c) triples of doubles or an .npy (N, 3)\n"
+            "                      float64 array from <file>; results are (x_1, x_2, n_roots) records of\n"
+            "                      24 bytes written to the -o file (an .npy structured array if it ends with .npy)\n"
+            "                      (a result store if it ends with .qrs: 2 bits per equation and only the\n"
+            "                      roots of equations that have them)\n"
+            "  --scan <file.qrs>   write the results of a result store as \"n_roots x_1 x_2\" lines\n"
+            "  --class <n>         with --scan: only equations with <n> roots (-1, 0, 1 or 2)\n"
+            "  --roots-in <lo> <hi>  with --scan: only equations with x_1 or x_2 from <lo> to <hi>\n"
+            "  --x1-in <lo> <hi>   with --scan: only equations with x_1 from <lo> to <hi> (--x2-in for x_2);\n"
+            "                      matches are written with their numbers first, --totals counts them\n"
+            "  --chunked           read and write the binary files by chunks in a constant amount of memory\n"
+            "                      instead of mapping them (always done for pipes, stdout and huge inputs)\n"
+            "  --sweep <a> <b> <c> <da> <db> <dc> <n>\n"
+            "                      solve n equations (a + k da) x^2 + (b + k db) x + c + k dc = 0, k = 0 .. n - 1,\n"
+            "                      refining the roots of every step from the previous one\n"
+            "  --serve <address>   answer length-prefixed batches of (a, b, c) triples sent to the Unix-domain\n"
+            "                      socket <address> or to 127.0.0.1:<port> if <address> is tcp:<port>\n"
+            "  --shm <name>        create the POSIX shared-memory queue <name> (for example /quadratic) and solve\n"
+            "                      the requests other processes put into its slots with Solve_Shm_Batch ()\n"
+            "  --verify <n>        run the unit tests and check every solver against a high-precision\n"
+            "                      reference on <n> random and edge-case equations\n"
+            "  -o, --output <file> write results to <file> instead of stdout\n"
+            "  --digits <n>        write roots with <n> digits after the decimal point; by default the\n"
+            "                      shortest form that is read back as the same number is written\n"
+            "  --precise           re-solve ill-conditioned equations in double-double arithmetic\n"
+            "  --cache <n>         keep the roots of <n> normalized triples and of all small integer triples,\n"
+            "                      solve in one thread and print the hit rate to stderr\n"
+            "  --scaled            scale every equation by powers of two before solving, so coefficients\n"
+            "                      from 1e-300 to 1e300 give finite roots and \"a\" is compared with \"b\" and \"c\"\n"
+            "  --complex           write \"n_roots re_1 im_1 re_2 im_2\" in the stream mode: a negative\n"
+            "                      discriminant gives the complex pair instead of nan\n"
+            "  --classify          find only the numbers of roots: one per line in the stream mode,\n"
+            "                      one byte per equation in the binary mode (an .npy int8 array if -o ends with .npy)\n"
+            "  --totals            write only the numbers of equations with -1, 0, 1 and 2 roots\n"
+            "  --stats             print counters of the solver and a histogram of batch times as JSON to stderr\n"
+            "                      (only in a build with make STATS=1)\n"
+            "  --isa <set>         solve with the kernels of <set> (none, sse2, avx2 or avx512) instead of\n"
+            "                      the widest ones the processor supports, to compare them\n"
+            "  --threads <n>       the number of solver threads (0 means one per core), 1 by default\n"
+            "  -h, --help          print this message\n",
+            program_name);
+}
@@ -0,0 +1,63 @@
+#ifndef COMMAND_LINE_H_INCLUDED
+#define COMMAND_LINE_H_INCLUDED
+
+#include "Quadratic_Equation.h"
+#include "Root_Formatter.h"
+#include "Simd_Solver.h"
+
+///Ways the program can work in
+enum Mode
+{
+    Interactive,    ///< Asks for coefficients and prints roots with prompts
+    Stream,         ///< Reads coefficient triples from a file or a pipe without any prompts
+    Binary,         ///< Solves a memory-mapped binary file of coefficient triples
+    Verify,         ///< Checks every solver against a high-precision reference
+    Sweep,          ///< Solves a family of equations whose coefficients change linearly
+    Serve,          ///< Answers batches of equations sent over a socket
+    Shared_Memory,  ///< Solves requests that other processes put into a shared-memory queue
+    Scan            ///< Writes the results of a result store as text
+};
+
+///Conditions an equation of a result store has to meet to be written by "--scan"
+struct Scan_Filter
+{
+    bool By_Class;          ///< Only equations with "Class" roots
+    enum N_Roots Class;     ///< The number of roots given by "--class"
+    bool By_Root;           ///< Only equations whose x_1 or x_2 is in "Root_Range"
+    double Root_Range[2];   ///< The bounds given by "--roots-in"
+    bool By_X_1;            ///< Only equations whose x_1 is in "X_1_Range"
+    double X_1_Range[2];    ///< The bounds given by "--x1-in"
+    bool By_X_2;            ///< Only equations whose x_2 is in "X_2_Range"
+    double X_2_Range[2];    ///< The bounds given by "--x2-in"
+};
+
+///Settings obtained from the command line
+struct Options
+{
+    enum Mode Mode;         ///< The way the program works in
+    const char *Input;      ///< The input file ("-" means stdin) or result store, the address of the service or the name of the queue
+    const char *Output;     ///< The name of the output file ("-" means stdout)
+    unsigned N_Threads;     ///< The number of solver threads (0 means the number of cores)
+    enum Root_Format Format;    ///< The way roots are written in
+    int Digits;             ///< The number of digits after the decimal point in the fixed format
+    bool Precise;           ///< Solve with Solve_Batch_Precise () instead of the vectorized kernels
+    bool Scaled;            ///< Solve with Solve_Batch_Scaled_Simd (), so coefficients of any size give finite roots
+    size_t Verify_Size;     ///< The number of random equations in the verification mode
+    size_t Cache_Size;      ///< The number of entries of the root cache (0 means no cache)
+    double Sweep_Start[3];  ///< Coefficients "a", "b" and "c" of the first equation of the sweep
+    double Sweep_Delta[3];  ///< Changes of the coefficients per step of the sweep
+    size_t Sweep_Steps;     ///< The number of equations of the sweep
+    bool Stats;             ///< Print the counters of Solver_Stats.h as JSON to stderr at the end
+    bool Classify;          ///< Find only the numbers of roots
+    bool Totals;            ///< Write only the numbers of equations of every class (implies Classify)
+    bool Chunked;           ///< Solve the binary input by chunks in a constant amount of memory instead of mapping it
+    bool Complex;           ///< Write the real and imaginary parts of the roots, so a negative discriminant gives a complex pair
+    bool Force_Simd;        ///< Use the kernels of "Simd_Level" instead of the widest ones the processor supports
+    enum Simd_Level Simd_Level;     ///< The instruction set given by "--isa"
+    struct Scan_Filter Filter;      ///< The query of "--scan"
+};
+
+int  Parse_Command_Line (const int argc, char *argv[], struct Options *options);
+void Print_Usage (const char *program_name);
+
+#endif
@@ -0,0 +1,11 @@
+#include "Generic_Solver.h"
+
+/*
+    External definitions of the inline float and long double solvers of Generic_Solver.h
+    and their batch solvers, all generated from the templates of Quadratic_Solver.h.
+*/
+DECLARE_QUADRATIC_SOLVER_EXTERN (_F, float,       Compare_F, Solve_Equation_F)
+DECLARE_QUADRATIC_SOLVER_EXTERN (_L, long double, Compare_L, Solve_Equation_L)
+
+DEFINE_QUADRATIC_BATCH_SOLVER (_F, float,       Solve_Equation_F)
+DEFINE_QUADRATIC_BATCH_SOLVER (_L, long double, Solve_Equation_L)
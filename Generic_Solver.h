@@ -0,0 +1,48 @@
+#ifndef GENERIC_SOLVER_H_INCLUDED
+#define GENERIC_SOLVER_H_INCLUDED
+
+#include "Quadratic_Equation.h"
+
+#define FLOAT_EPSILON       1E-4F   ///Is used to compare numbers of the "float" type (about 1000 * FLT_EPSILON)
+#define LONG_DOUBLE_EPSILON 1E-9L   ///Is used to compare numbers of the "long double" type
+
+/*
+    The float and long double solvers are generated from DEFINE_QUADRATIC_SOLVER () of Quadratic_Solver.h,
+    the template the double solver is generated from:
+        Compare_F (), Solve_Linear_Equation_F (), Solve_Quadratic_Equation_F (), Solve_Equation_F () and Solve_Batch_F ()
+    for float and the same names with _L for long double.
+*/
+DEFINE_QUADRATIC_SOLVER (_F, float,       FLOAT_EPSILON,       sqrtf, fabsf, Compare_F, Solve_Equation_F)
+DEFINE_QUADRATIC_SOLVER (_L, long double, LONG_DOUBLE_EPSILON, sqrtl, fabsl, Compare_L, Solve_Equation_L)
+
+void Solve_Batch_F (const float *a, const float *b, const float *c,
+                    float *x_1, float *x_2, enum N_Roots *n_roots, const size_t n_equations);
+void Solve_Batch_L (const long double *a, const long double *b, const long double *c,
+                    long double *x_1, long double *x_2, enum N_Roots *n_roots, const size_t n_equations);
+
+///The double names are the double instance of the same template in Quadratic_Solver.h
+#define Compare_D                   Compare_Double
+#define Solve_Linear_Equation_D     Solve_Linear_Equation
+#define Solve_Quadratic_Equation_D  Solve_Quadratic_Equation
+#define Solve_Equation_D            Get_Number_Of_Roots_And_Solve_Equation
+#define Solve_Batch_D               Solve_Batch
+
+///Compares two numbers with the tolerance of their type
+#define Compare_Generic(first, second)                                          \
+    _Generic ((first), float: Compare_F, long double: Compare_L, default: Compare_D) (first, second)
+
+///Solves one equation in the type of its first root
+#define Solve_Equation_Generic(a, b, c, first_root, second_root)                \
+    _Generic ((first_root), float *: Solve_Equation_F,                          \
+                            long double *: Solve_Equation_L,                    \
+                            double *: Solve_Equation_D) (a, b, c, first_root, second_root)
+
+///Solves a batch of equations in the type of its arrays of roots
+#define Solve_Batch_Generic(a, b, c, x_1, x_2, n_roots, n_equations)           \
+    _Generic ((x_1), float *: Solve_Batch_F,                                    \
+                     long double *: Solve_Batch_L,                              \
+                     double *: Solve_Batch_D) (a, b, c, x_1, x_2, n_roots, n_equations)
+
+int Generic_Unit_Test (void);
+
+#endif
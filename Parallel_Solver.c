@@ -0,0 +1,281 @@
+#include "Parallel_Solver.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+
+///Chunks of one worker. Other workers take chunks from here when they run out of their own ones
+struct Worker_Queue
+{
+    _Alignas (64) atomic_size_t Next;   ///< Index of the next chunk that has not been taken yet
+    size_t End;                         ///< Index of the chunk after the last one of this worker
+};
+
+///Data shared by all the workers
+struct Parallel_Job
+{
+    const double *A;    ///< Array of quadratic coefficients
+    const double *B;    ///< Array of linear coefficients
+    const double *C;    ///< Array of free terms
+    double *X_1;        ///< Array for the first roots
+    double *X_2;        ///< Array for the second roots
+    enum N_Roots *N_Roots;  ///< Array for the numbers of roots
+    size_t N_Equations;     ///< The number of equations in every array
+    size_t Chunk_Size;      ///< The number of equations in one chunk
+    Batch_Solver Solver;    ///< The kernel every chunk is solved with
+    unsigned N_Workers;     ///< The number of workers
+    struct Worker_Queue *Queues;    ///< Array of queues, one per worker
+};
+
+///Threads that are started once and then solve the jobs of Solve_Batch_Parallel () together with the caller
+struct Worker_Pool
+{
+    pthread_mutex_t Busy;       ///< Is held by the caller whose job the pool is solving
+    pthread_mutex_t Lock;       ///< Protects the fields below
+    pthread_cond_t Job_Posted;  ///< Is broadcast when "Generation" grows
+    pthread_cond_t Job_Done;    ///< Is signaled when "N_Running" becomes 0
+    unsigned N_Threads;         ///< The number of threads that have been started
+    unsigned N_Running;         ///< The number of threads that have not finished the current job
+    unsigned long Generation;   ///< The number of jobs that have been posted
+    struct Parallel_Job *Job;   ///< The current job or NULL between the jobs
+};
+
+///The pool of the process
+static struct Worker_Pool Pool =
+{
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0, 0, NULL
+};
+
+/**
+    \brief Returns the number of processors that are online
+
+    \return The number of processors (1 if it cannot be found)
+*/
+unsigned Get_Number_Of_Cores (void)
+{
+    long n_cores = sysconf (_SC_NPROCESSORS_ONLN);
+
+    return (n_cores > 0) ? (unsigned)n_cores : 1;
+}
+
+/**
+    \brief Takes one chunk from a queue
+
+    \param [in] queue {Pointer on the queue}
+    \param [out] chunk {Pointer on the variable in which the function puts the index of the chunk}
+    \return True if a chunk has been taken
+    \return False if the queue is empty
+*/
+static bool Take_Chunk (struct Worker_Queue *queue, size_t *chunk)
+{
+    if (atomic_load_explicit (&queue->Next, memory_order_relaxed) >= queue->End)
+        return false;
+
+    *chunk = atomic_fetch_add_explicit (&queue->Next, 1, memory_order_relaxed);
+
+    return *chunk < queue->End;
+}
+
+/**
+    \brief Solves one chunk of equations
+
+    \param [in] job {Data shared by all the workers}
+    \param [in] chunk {Index of the chunk}
+*/
+static void Solve_Chunk (const struct Parallel_Job *job, const size_t chunk)
+{
+    size_t first = chunk * job->Chunk_Size;
+    size_t count = job->N_Equations - first;
+
+    if (count > job->Chunk_Size)
+        count = job->Chunk_Size;
+
+    job->Solver (job->A + first, job->B + first, job->C + first,
+                 (job->X_1 != NULL) ? job->X_1 + first : NULL, (job->X_2 != NULL) ? job->X_2 + first : NULL,
+                 job->N_Roots + first, count);
+}
+
+/**
+    \brief Solves chunks of its own queue and then steals chunks from the queues of other workers
+
+    Calls Take_Chunk (), Solve_Chunk () and Merge_Thread_Stats () at the end.
+    Stealing goes round the queues starting from the next one, so thieves spread over the victims.
+
+    \param [in] job {Data shared by all the workers}
+    \param [in] id {Index of the queue of this worker}
+*/
+static void Worker (struct Parallel_Job *job, const unsigned id)
+{
+    size_t chunk = 0;
+
+    while (Take_Chunk (&job->Queues[id], &chunk))
+        Solve_Chunk (job, chunk);
+
+    for (unsigned shift = 1; shift < job->N_Workers; shift++)
+    {
+        struct Worker_Queue *victim = &job->Queues[(id + shift) % job->N_Workers];
+
+        while (Take_Chunk (victim, &chunk))
+            Solve_Chunk (job, chunk);
+    }
+
+    Merge_Thread_Stats ();
+}
+
+/**
+    \brief Waits for the jobs of the pool and calls Worker () for the ones it takes part in
+
+    A thread is started right before a job that needs it is posted, so if there is a job when it starts,
+             the job is its first one. The thread never ends.
+
+    \param [in] arg {The index of the queue of this thread (1 .. N_Threads) cast to a pointer}
+    \return NULL (never)
+*/
+static void *Pool_Thread (void *arg)
+{
+    const unsigned id = (unsigned)(uintptr_t)arg;
+
+    pthread_mutex_lock (&Pool.Lock);
+    unsigned long seen = Pool.Generation - (Pool.Job != NULL);
+
+    for (;;)
+    {
+        while (Pool.Generation == seen)
+            pthread_cond_wait (&Pool.Job_Posted, &Pool.Lock);
+
+        seen = Pool.Generation;
+        struct Parallel_Job *job = Pool.Job;
+
+        if (id >= job->N_Workers)
+            continue;
+
+        pthread_mutex_unlock (&Pool.Lock);
+        Worker (job, id);
+        pthread_mutex_lock (&Pool.Lock);
+
+        if (--Pool.N_Running == 0)
+            pthread_cond_signal (&Pool.Job_Done);
+    }
+
+    return NULL;
+}
+
+/**
+    \brief Starts the threads of the pool that a job of "n_workers" workers needs and are not running yet
+
+    Must be called by the holder of Pool.Busy when there is no job.
+
+    \param [in] n_workers {The number of workers including the calling thread}
+    \return The number of workers the pool can give (less than "n_workers" if a thread cannot be created)
+*/
+static unsigned Grow_Pool (const unsigned n_workers)
+{
+    while (Pool.N_Threads + 1 < n_workers)
+    {
+        pthread_t thread;
+
+        if (pthread_create (&thread, NULL, Pool_Thread, (void *)(uintptr_t)(Pool.N_Threads + 1)) != 0)
+            break;
+
+        pthread_detach (thread);
+        Pool.N_Threads++;
+    }
+
+    return (Pool.N_Threads + 1 < n_workers) ? Pool.N_Threads + 1 : n_workers;
+}
+
+/**
+    \brief Solves a batch of equations with a pool of threads
+
+    Calls Worker () in "n_threads" - 1 threads of the pool and in the calling one.
+    The threads are started by the first call that needs them and then wait for the next batch
+             on a condition variable, so a call costs a wake-up instead of creating and joining threads.
+    The array is split into chunks of "chunk_size" equations and each worker gets an equal range of them.
+    A worker that has finished its range steals the chunks that are left in the ranges of the others,
+             so a range of slow equations does not keep the other cores idle.
+    Every chunk is solved with "solver" (Solve_Batch_Simd () if it is NULL).
+    If a thread cannot be created, fewer workers share the chunks. If another thread is using the pool,
+             the batch is solved in the calling thread alone.
+    Nothing is solved if an array of coefficients or the array for the numbers of roots is NULL;
+             NULL arrays for the roots are passed to "solver" like in Solve_Batch ().
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] x_1 {Array for the first roots}
+    \param [out] x_2 {Array for the second roots}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+    \param [in] n_threads {The number of threads (0 means the number of cores)}
+    \param [in] chunk_size {The number of equations in one chunk (0 means DEFAULT_CHUNK_SIZE)}
+    \param [in] solver {The kernel every chunk is solved with (NULL means the one of Get_Active_Simd_Level ())}
+    \return The number of threads that have been used (0 if nothing has been solved)
+*/
+int Solve_Batch_Parallel (const double *a, const double *b, const double *c,
+                          double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations,
+                          unsigned n_threads, size_t chunk_size, Batch_Solver solver)
+{
+    if (a == NULL || b == NULL || c == NULL || n_roots == NULL)
+        return 0;
+
+    if (n_threads == 0)
+        n_threads = Get_Number_Of_Cores ();
+    if (chunk_size == 0)
+        chunk_size = DEFAULT_CHUNK_SIZE;
+    if (solver == NULL)
+        solver = Get_Simd_Batch_Solver (Get_Active_Simd_Level ());
+
+    size_t n_chunks = (n_equations + chunk_size - 1) / chunk_size;
+
+    if (n_threads > n_chunks)
+        n_threads = (n_chunks > 0) ? (unsigned)n_chunks : 1;
+
+    if (n_threads == 1 || pthread_mutex_trylock (&Pool.Busy) != 0)
+    {
+        solver (a, b, c, x_1, x_2, n_roots, n_equations);
+        return 1;
+    }
+
+    n_threads = Grow_Pool (n_threads);
+
+    struct Worker_Queue *queues = aligned_alloc (_Alignof (struct Worker_Queue),
+                                                 n_threads * sizeof (struct Worker_Queue));
+
+    if (n_threads == 1 || queues == NULL)
+    {
+        pthread_mutex_unlock (&Pool.Busy);
+        free (queues);
+        solver (a, b, c, x_1, x_2, n_roots, n_equations);
+        return 1;
+    }
+
+    struct Parallel_Job job = {a, b, c, x_1, x_2, n_roots, n_equations, chunk_size, solver, n_threads, queues};
+
+    for (unsigned id = 0; id < n_threads; id++)
+    {
+        atomic_init (&queues[id].Next, n_chunks * id / n_threads);
+        queues[id].End = n_chunks * (id + 1) / n_threads;
+    }
+
+    pthread_mutex_lock (&Pool.Lock);
+    Pool.Job       = &job;
+    Pool.N_Running = n_threads - 1;
+    Pool.Generation++;
+    pthread_cond_broadcast (&Pool.Job_Posted);
+    pthread_mutex_unlock (&Pool.Lock);
+
+    Worker (&job, 0);
+
+    pthread_mutex_lock (&Pool.Lock);
+    while (Pool.N_Running != 0)
+        pthread_cond_wait (&Pool.Job_Done, &Pool.Lock);
+    Pool.Job = NULL;
+    pthread_mutex_unlock (&Pool.Lock);
+
+    pthread_mutex_unlock (&Pool.Busy);
+    free (queues);
+
+    return (int)n_threads;
+}
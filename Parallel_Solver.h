@@ -0,0 +1,15 @@
+#ifndef PARALLEL_SOLVER_H_INCLUDED
+#define PARALLEL_SOLVER_H_INCLUDED
+
+#include "Quadratic_Equation.h"
+#include "Simd_Solver.h"
+
+#define DEFAULT_CHUNK_SIZE 16384    ///The number of equations one worker takes at a time
+
+unsigned Get_Number_Of_Cores (void);
+int Solve_Batch_Parallel (const double *a, const double *b, const double *c,
+                          double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations,
+                          unsigned n_threads, size_t chunk_size, Batch_Solver solver);
+int Parallel_Unit_Test (void);
+
+#endif
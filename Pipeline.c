@@ -0,0 +1,499 @@
+#include "Pipeline.h"
+#include "Parallel_Solver.h"
+
+#include <stdlib.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#define N_SPINS 64      ///The number of failed attempts before a thread starts to give up its processor
+#define N_YIELDS 16     ///The number of times a thread gives up its processor before it sleeps in futex ()
+
+/*
+    The reader thread parses chunks of triples, solver workers solve them and the calling thread writes them.
+    Chunks go round three rings: "Free" (writer -> reader), "Filled" (reader -> workers) and "Solved"
+    (workers -> writer). There are only N_Chunks chunks, so a stage that runs ahead waits for a free chunk
+    and the throughput is the one of the slowest stage. The workers finish chunks in any order;
+    the writer keeps them in "Pending" until all the chunks before them have been written.
+    A stage that cannot push or pop spins, then yields, then sleeps in futex () on "Changes" of the ring
+    until another stage pushes or pops, so an idle pipeline (a slow input, a slow output) does not use a core.
+*/
+
+///Data shared by all the stages
+struct Pipeline
+{
+    struct Coeff_Reader *Reader;    ///< The input
+    struct Root_Cache *Cache;       ///< The cache of the only worker or NULL
+    Batch_Solver Solver;            ///< The kernel the workers solve chunks with if there is no cache
+    struct Pipeline_Chunk *Chunks;  ///< All the chunks
+    size_t N_Chunks;                ///< The number of chunks
+    unsigned N_Workers;             ///< The number of worker threads that have been started
+    struct Block_Ring Free;         ///< Chunks the reader can fill
+    struct Block_Ring Filled;       ///< Chunks with coefficients, NULL tells a worker to stop
+    struct Block_Ring Solved;       ///< Chunks with results
+    atomic_size_t N_Read;           ///< The number of chunks in the input (SIZE_MAX while it is being read)
+};
+
+/**
+    \brief Allocates a ring
+
+    \param [out] ring {Pointer on the ring}
+    \param [in] capacity {The minimal number of chunks in the ring, it is rounded up to a power of two}
+    \return 0 if the ring has been allocated
+    \return -1 otherwise
+*/
+int Init_Block_Ring (struct Block_Ring *ring, const size_t capacity)
+{
+    assert (ring != NULL);
+
+    size_t n_cells = 1;
+    while (n_cells < capacity)
+        n_cells *= 2;
+
+    ring->Cells = malloc (n_cells * sizeof (struct Ring_Cell));
+    ring->Mask  = n_cells - 1;
+    atomic_init (&ring->Head, 0);
+    atomic_init (&ring->Tail, 0);
+    atomic_init (&ring->Changes, 0);
+    atomic_init (&ring->N_Waiting, 0);
+
+    if (ring->Cells == NULL)
+        return -1;
+
+    for (size_t i = 0; i < n_cells; i++)
+    {
+        atomic_init (&ring->Cells[i].Sequence, i);
+        ring->Cells[i].Chunk = NULL;
+    }
+
+    return 0;
+}
+
+/**
+    \brief Frees a ring
+
+    \param [in] ring {Pointer on the ring}
+*/
+void Free_Block_Ring (struct Block_Ring *ring)
+{
+    assert (ring != NULL);
+
+    free (ring->Cells);
+    ring->Cells = NULL;
+}
+
+/**
+    \brief Tells the threads that wait for a ring that it has changed
+
+    Increases "Changes" and calls futex () only if somebody sleeps on it.
+
+    \param [in] ring {Pointer on the ring}
+*/
+static void Signal_Ring (struct Block_Ring *ring)
+{
+    atomic_fetch_add (&ring->Changes, 1);
+
+    if (atomic_load (&ring->N_Waiting) != 0)
+        syscall (SYS_futex, &ring->Changes, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+/**
+    \brief Puts a chunk into a ring (the bounded queue of D. Vyukov)
+
+    \param [in] ring {Pointer on the ring}
+    \param [in] chunk {Pointer on the chunk (may be NULL)}
+    \return True if the chunk has been put
+    \return False if the ring is full
+*/
+bool Push_Chunk (struct Block_Ring *ring, struct Pipeline_Chunk *chunk)
+{
+    assert (ring != NULL);
+
+    size_t position = atomic_load_explicit (&ring->Tail, memory_order_relaxed);
+    struct Ring_Cell *cell = NULL;
+
+    for (;;)
+    {
+        cell = &ring->Cells[position & ring->Mask];
+
+        size_t sequence = atomic_load_explicit (&cell->Sequence, memory_order_acquire);
+        ptrdiff_t difference = (ptrdiff_t)(sequence - position);
+
+        if (difference == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit (&ring->Tail, &position, position + 1,
+                                                       memory_order_relaxed, memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+            return false;
+        else
+            position = atomic_load_explicit (&ring->Tail, memory_order_relaxed);
+    }
+
+    cell->Chunk = chunk;
+    atomic_store_explicit (&cell->Sequence, position + 1, memory_order_release);
+    Signal_Ring (ring);
+
+    return true;
+}
+
+/**
+    \brief Takes a chunk from a ring
+
+    \param [in] ring {Pointer on the ring}
+    \param [out] chunk {Pointer on the variable in which the function puts the chunk}
+    \return True if a chunk has been taken
+    \return False if the ring is empty
+*/
+bool Pop_Chunk (struct Block_Ring *ring, struct Pipeline_Chunk **chunk)
+{
+    assert (ring  != NULL);
+    assert (chunk != NULL);
+
+    size_t position = atomic_load_explicit (&ring->Head, memory_order_relaxed);
+    struct Ring_Cell *cell = NULL;
+
+    for (;;)
+    {
+        cell = &ring->Cells[position & ring->Mask];
+
+        size_t sequence = atomic_load_explicit (&cell->Sequence, memory_order_acquire);
+        ptrdiff_t difference = (ptrdiff_t)(sequence - (position + 1));
+
+        if (difference == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit (&ring->Head, &position, position + 1,
+                                                       memory_order_relaxed, memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+            return false;
+        else
+            position = atomic_load_explicit (&ring->Head, memory_order_relaxed);
+    }
+
+    *chunk = cell->Chunk;
+    atomic_store_explicit (&cell->Sequence, position + ring->Mask + 1, memory_order_release);
+    Signal_Ring (ring);
+
+    return true;
+}
+
+/**
+    \brief Waits after a failed attempt to push or pop
+
+    Does nothing for the first N_SPINS attempts in a row, gives up the processor for the next N_YIELDS ones
+             and then sleeps in futex () until "Changes" of the ring is not "changes" any more.
+    The caller has to read "changes" before its attempt; "N_Waiting" is increased before "Changes" is checked
+             for the last time, so Signal_Ring () cannot miss the sleeper.
+
+    \param [in] ring {Pointer on the ring the caller waits for}
+    \param [in] changes {The value of "Changes" the caller has read before its attempt}
+    \param [in,out] n_spins {The number of failed attempts in a row}
+*/
+static void Back_Off (struct Block_Ring *ring, const unsigned changes, unsigned *n_spins)
+{
+    if (++*n_spins < N_SPINS)
+        return;
+    if (*n_spins < N_SPINS + N_YIELDS)
+    {
+        sched_yield ();
+        return;
+    }
+
+    atomic_fetch_add (&ring->N_Waiting, 1);
+    if (atomic_load (&ring->Changes) == changes)
+        syscall (SYS_futex, &ring->Changes, FUTEX_WAIT_PRIVATE, changes, NULL, NULL, 0);
+    atomic_fetch_sub (&ring->N_Waiting, 1);
+}
+
+/**
+    \brief Takes a chunk from a ring and waits while the ring is empty
+
+    \param [in] ring {Pointer on the ring}
+    \return The chunk
+*/
+static struct Pipeline_Chunk *Pop_Chunk_Waiting (struct Block_Ring *ring)
+{
+    struct Pipeline_Chunk *chunk = NULL;
+    unsigned n_spins = 0;
+
+    for (;;)
+    {
+        unsigned changes = atomic_load (&ring->Changes);
+
+        if (Pop_Chunk (ring, &chunk))
+            return chunk;
+
+        Back_Off (ring, changes, &n_spins);
+    }
+}
+
+/**
+    \brief Puts a chunk into a ring and waits while the ring is full
+
+    \param [in] ring {Pointer on the ring}
+    \param [in] chunk {Pointer on the chunk (may be NULL)}
+*/
+static void Push_Chunk_Waiting (struct Block_Ring *ring, struct Pipeline_Chunk *chunk)
+{
+    unsigned n_spins = 0;
+
+    for (;;)
+    {
+        unsigned changes = atomic_load (&ring->Changes);
+
+        if (Push_Chunk (ring, chunk))
+            return;
+
+        Back_Off (ring, changes, &n_spins);
+    }
+}
+
+/**
+    \brief Solves one chunk with the cache or with the kernel of the pipeline
+
+    \param [in] pipeline {Data shared by all the stages}
+    \param [in] chunk {Pointer on the chunk}
+*/
+static void Solve_Pipeline_Chunk (const struct Pipeline *pipeline, struct Pipeline_Chunk *chunk)
+{
+    struct Equation_Block *block = &chunk->Block;
+    uint64_t start = STATS_TIMER_START ();
+
+    if (pipeline->Cache != NULL)
+        Solve_Batch_Cached (pipeline->Cache, block->A, block->B, block->C, block->X_1, block->X_2, block->N_Roots, chunk->Count);
+    else
+        pipeline->Solver (block->A, block->B, block->C, block->X_1, block->X_2, block->N_Roots, chunk->Count);
+
+    STATS_TIMER_STOP (start, chunk->Count);
+}
+
+/**
+    \brief Returns the ring the writer waits for when it has nothing to do
+
+    \param [in] pipeline {Data shared by all the stages}
+    \return "Solved" or "Filled" if there are no worker threads and the writer solves the chunks itself
+*/
+static struct Block_Ring *Get_Writer_Ring (struct Pipeline *pipeline)
+{
+    return (pipeline->N_Workers == 0) ? &pipeline->Filled : &pipeline->Solved;
+}
+
+/**
+    \brief Reads chunks of triples until the input ends
+
+    Calls Read_Triples () for every free chunk. At the end N_Read gets the number of chunks,
+             the writer is woken up and every worker gets NULL.
+
+    \param [in] arg {Pointer on struct Pipeline}
+    \return NULL
+*/
+static void *Reader_Stage (void *arg)
+{
+    struct Pipeline *pipeline = arg;
+    size_t index = 0;
+
+    for (;;)
+    {
+        struct Pipeline_Chunk *chunk = Pop_Chunk_Waiting (&pipeline->Free);
+        struct Equation_Block *block = &chunk->Block;
+
+        chunk->Count = Read_Triples (pipeline->Reader, block->A, block->B, block->C, PIPELINE_CHUNK_SIZE);
+        if (chunk->Count == 0)
+        {
+            Push_Chunk_Waiting (&pipeline->Free, chunk);
+            break;
+        }
+
+        chunk->Index = index++;
+        Push_Chunk_Waiting (&pipeline->Filled, chunk);
+    }
+
+    atomic_store_explicit (&pipeline->N_Read, index, memory_order_release);
+    Signal_Ring (Get_Writer_Ring (pipeline));
+
+    for (unsigned i = 0; i < pipeline->N_Workers; i++)
+        Push_Chunk_Waiting (&pipeline->Filled, NULL);
+
+    return NULL;
+}
+
+/**
+    \brief Solves chunks until it gets NULL
+
+    \param [in] arg {Pointer on struct Pipeline}
+    \return NULL
+*/
+static void *Worker_Stage (void *arg)
+{
+    struct Pipeline *pipeline = arg;
+    struct Pipeline_Chunk *chunk = NULL;
+
+    while ((chunk = Pop_Chunk_Waiting (&pipeline->Filled)) != NULL)
+    {
+        Solve_Pipeline_Chunk (pipeline, chunk);
+        Push_Chunk_Waiting (&pipeline->Solved, chunk);
+    }
+
+    Merge_Thread_Stats ();
+
+    return NULL;
+}
+
+/**
+    \brief Writes solved chunks in the order of the input and gives them back to the reader
+
+    If there are no worker threads, the writer solves the chunks itself.
+    When it has nothing to do, it waits for the ring Get_Writer_Ring () gives; the reader wakes it up
+             after it has set N_Read.
+
+    \param [in] pipeline {Data shared by all the stages}
+    \param [in] output {The output buffer}
+    \param [in] pending {Array of N_Chunks pointers on chunks that have come before their turn}
+    \return 0 if everything has been written
+    \return Not 0 if writing has failed
+*/
+static int Writer_Stage (struct Pipeline *pipeline, struct Output_Buffer *output, struct Pipeline_Chunk **pending)
+{
+    struct Block_Ring *ring = Get_Writer_Ring (pipeline);
+    int status = 0;
+    unsigned n_spins = 0;
+
+    for (size_t next = 0; ; )
+    {
+        unsigned changes = atomic_load (&ring->Changes);     // read before N_Read, so the last wake-up is not missed
+
+        if (next == atomic_load_explicit (&pipeline->N_Read, memory_order_acquire))
+            break;
+
+        struct Pipeline_Chunk *chunk = pending[next % pipeline->N_Chunks];
+
+        if (chunk != NULL)
+        {
+            for (size_t i = 0; i < chunk->Count; i++)
+                status |= Write_Result (output, chunk->Block.N_Roots[i], chunk->Block.X_1[i], chunk->Block.X_2[i]);
+
+            pending[next % pipeline->N_Chunks] = NULL;
+            Push_Chunk_Waiting (&pipeline->Free, chunk);
+            next++;
+            n_spins = 0;
+        }
+        else if (Pop_Chunk (&pipeline->Solved, &chunk))
+            pending[chunk->Index % pipeline->N_Chunks] = chunk;
+        else if (pipeline->N_Workers == 0 && Pop_Chunk (&pipeline->Filled, &chunk) && chunk != NULL)
+        {
+            Solve_Pipeline_Chunk (pipeline, chunk);
+            pending[chunk->Index % pipeline->N_Chunks] = chunk;
+        }
+        else
+            Back_Off (ring, changes, &n_spins);
+    }
+
+    return status;
+}
+
+/**
+    \brief Frees the chunks and the rings of a pipeline
+
+    \param [in] pipeline {Pointer on the pipeline}
+*/
+static void Free_Pipeline (struct Pipeline *pipeline)
+{
+    if (pipeline->Chunks != NULL)
+        for (size_t i = 0; i < pipeline->N_Chunks; i++)
+            Free_Equation_Block (&pipeline->Chunks[i].Block);
+
+    free (pipeline->Chunks);
+    Free_Block_Ring (&pipeline->Free);
+    Free_Block_Ring (&pipeline->Filled);
+    Free_Block_Ring (&pipeline->Solved);
+}
+
+/**
+    \brief Reads, solves and writes all the triples of the input in three stages that run at the same time
+
+    Calls Reader_Stage () in a new thread, Worker_Stage () in options->N_Threads threads (one per core if it is 0,
+             one if there is a cache) and Writer_Stage () in the calling thread.
+    The results are written in the order of the input, like the ones of Run_Stream_Mode ().
+
+    \param [in] options {Pointer on the settings}
+    \param [in] reader {The input}
+    \param [in] output {The output buffer}
+    \param [in] cache {Pointer on the cache or NULL}
+    \param [out] write_status {Pointer on the variable in which the function puts 0 if everything has been written}
+    \return 0 if the pipeline has run
+    \return -1 if it cannot be started (not enough memory or no threads); nothing has been read then
+*/
+int Run_Pipeline (const struct Options *options, struct Coeff_Reader *reader, struct Output_Buffer *output,
+                  struct Root_Cache *cache, int *write_status)
+{
+    assert (options != NULL);
+    assert (reader  != NULL);
+    assert (output  != NULL);
+    assert (write_status != NULL);
+
+    unsigned n_workers = (options->N_Threads == 0) ? Get_Number_Of_Cores () : options->N_Threads;
+    if (cache != NULL)
+        n_workers = 1;
+
+    struct Pipeline pipeline = {0};
+
+    pipeline.Reader   = reader;
+    pipeline.Cache    = cache;
+    pipeline.Solver   = Get_Batch_Solver (options);
+    pipeline.N_Chunks = PIPELINE_CHUNKS_PER_WORKER * (size_t)n_workers + 2;
+    pipeline.Chunks   = calloc (pipeline.N_Chunks, sizeof (struct Pipeline_Chunk));
+    atomic_init (&pipeline.N_Read, SIZE_MAX);
+
+    if (pipeline.Solver == NULL)
+        pipeline.Solver = Solve_Batch_Simd;
+
+    pthread_t *threads = malloc (n_workers * sizeof (pthread_t));
+    struct Pipeline_Chunk **pending = calloc (pipeline.N_Chunks, sizeof (struct Pipeline_Chunk *));
+    int status = (pipeline.Chunks == NULL || threads == NULL || pending == NULL) ? -1 : 0;
+
+    status |= Init_Block_Ring (&pipeline.Free, pipeline.N_Chunks);
+    status |= Init_Block_Ring (&pipeline.Filled, pipeline.N_Chunks + n_workers);
+    status |= Init_Block_Ring (&pipeline.Solved, pipeline.N_Chunks);
+
+    for (size_t i = 0; status == 0 && i < pipeline.N_Chunks; i++)
+    {
+        status |= Allocate_Equation_Block (&pipeline.Chunks[i].Block, PIPELINE_CHUNK_SIZE);
+        Push_Chunk (&pipeline.Free, &pipeline.Chunks[i]);
+    }
+
+    pthread_t reader_thread;
+
+    if (status == 0)
+    {
+        while (pipeline.N_Workers < n_workers &&
+               pthread_create (&threads[pipeline.N_Workers], NULL, Worker_Stage, &pipeline) == 0)
+            pipeline.N_Workers++;
+
+        if (pthread_create (&reader_thread, NULL, Reader_Stage, &pipeline) != 0)
+        {
+            for (unsigned i = 0; i < pipeline.N_Workers; i++)
+                Push_Chunk_Waiting (&pipeline.Filled, NULL);
+            status = -1;
+        }
+        else
+        {
+            *write_status = Writer_Stage (&pipeline, output, pending);
+            pthread_join (reader_thread, NULL);
+        }
+
+        for (unsigned i = 0; i < pipeline.N_Workers; i++)
+            pthread_join (threads[i], NULL);
+    }
+
+    free (threads);
+    free (pending);
+    Free_Pipeline (&pipeline);
+
+    return status;
+}
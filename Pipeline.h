@@ -0,0 +1,47 @@
+#ifndef PIPELINE_H_INCLUDED
+#define PIPELINE_H_INCLUDED
+
+#include "Stream_Mode.h"
+#include "Coeff_Reader.h"
+#include "Root_Formatter.h"
+
+#include <stdatomic.h>
+
+#define PIPELINE_CHUNK_SIZE 8192        ///The number of equations in one chunk of the pipeline
+#define PIPELINE_CHUNKS_PER_WORKER 2    ///The number of chunks in flight per solver worker (two more are added)
+
+///One chunk of equations that goes from the reader to a worker and from the worker to the writer
+struct Pipeline_Chunk
+{
+    struct Equation_Block Block;    ///< The coefficients and the results
+    size_t Index;                   ///< The number of the chunk in the input
+    size_t Count;                   ///< The number of equations in the chunk
+};
+
+///Cell of Block_Ring
+struct Ring_Cell
+{
+    atomic_size_t Sequence;         ///< The position the cell is ready for
+    struct Pipeline_Chunk *Chunk;   ///< The chunk in the cell
+};
+
+///Bounded lock-free queue of chunks for any number of producers and consumers
+struct Block_Ring
+{
+    _Alignas (64) atomic_size_t Head;   ///< The position of the next chunk to pop
+    _Alignas (64) atomic_size_t Tail;   ///< The position of the next chunk to push
+    struct Ring_Cell *Cells;            ///< Array of Mask + 1 cells
+    size_t Mask;                        ///< The number of cells minus 1
+    _Alignas (64) atomic_uint Changes;  ///< Increased after every push and pop; waiting threads sleep on it in futex ()
+    atomic_uint N_Waiting;              ///< The number of threads that sleep on "Changes"
+};
+
+int  Init_Block_Ring (struct Block_Ring *ring, const size_t capacity);
+void Free_Block_Ring (struct Block_Ring *ring);
+bool Push_Chunk (struct Block_Ring *ring, struct Pipeline_Chunk *chunk);
+bool Pop_Chunk  (struct Block_Ring *ring, struct Pipeline_Chunk **chunk);
+int  Run_Pipeline (const struct Options *options, struct Coeff_Reader *reader, struct Output_Buffer *output,
+                   struct Root_Cache *cache, int *write_status);
+int  Pipeline_Unit_Test (void);
+
+#endif
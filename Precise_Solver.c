@@ -0,0 +1,318 @@
+#include "Precise_Solver.h"
+
+#include <float.h>
+
+#define UNIT_ROUNDOFF (DBL_EPSILON / 2)     ///The maximal relative error of one operation on numbers of the "double" type
+
+/*
+    The fast tier computes the discriminant with the FMA trick of Kahan and the roots with the formula
+        q = -(b + sign (b) * sqrt (D)) / 2,   x = q / a,   x = c / q
+    that never subtracts close numbers. Only equations whose error bound exceeds PRECISE_TOLERANCE
+    (nearly equal roots and discriminants near the borders of Compare_Double ()) are re-solved
+    in double-double arithmetic.
+*/
+
+/**
+    \brief Adds two numbers and finds the rounding error of the sum (the algorithm of Knuth)
+
+    \param [in] a {The first addend}
+    \param [in] b {The second addend}
+    \return a + b as a double-double number
+*/
+static struct Double_Double Two_Sum (const double a, const double b)
+{
+    double sum = a + b;
+    double b_virtual = sum - a;
+    double error = (a - (sum - b_virtual)) + (b - b_virtual);
+
+    return (struct Double_Double){sum, error};
+}
+
+/**
+    \brief Multiplies two numbers and finds the rounding error of the product with fma ()
+
+    \param [in] a {The first factor}
+    \param [in] b {The second factor}
+    \return a * b as a double-double number
+*/
+static struct Double_Double Two_Prod (const double a, const double b)
+{
+    double product = a * b;
+
+    return (struct Double_Double){product, fma (a, b, -product)};
+}
+
+/**
+    \brief Adds two double-double numbers
+
+    \param [in] x {The first addend}
+    \param [in] y {The second addend}
+    \return x + y
+*/
+static struct Double_Double DD_Add (const struct Double_Double x, const struct Double_Double y)
+{
+    struct Double_Double sum = Two_Sum (x.Hi, y.Hi);
+    struct Double_Double low = Two_Sum (x.Lo, y.Lo);
+
+    sum.Lo += low.Hi;
+    sum = Two_Sum (sum.Hi, sum.Lo);
+    sum.Lo += low.Lo;
+
+    return Two_Sum (sum.Hi, sum.Lo);
+}
+
+/**
+    \brief Finds the square root of a double-double number with one step of the method of Newton
+
+    \param [in] x {The number}
+    \return sqrt (x) or 0 if x is not positive
+*/
+static struct Double_Double DD_Sqrt (const struct Double_Double x)
+{
+    if (x.Hi <= 0.0)
+        return (struct Double_Double){0.0, 0.0};
+
+    double root = sqrt (x.Hi);
+    struct Double_Double square = Two_Prod (root, root);
+    double correction = ((x.Hi - square.Hi) - square.Lo + x.Lo) / (2.0 * root);
+
+    return Two_Sum (root, correction);
+}
+
+/**
+    \brief Divides a double-double number by a number of the "double" type and rounds the result
+
+    \param [in] x {The dividend}
+    \param [in] y {The divisor}
+    \return x / y
+*/
+static double DD_Div_Double (const struct Double_Double x, const double y)
+{
+    double quotient = x.Hi / y;
+    struct Double_Double product = Two_Prod (quotient, y);
+
+    return quotient + ((x.Hi - product.Hi) - product.Lo + x.Lo) / y;
+}
+
+/**
+    \brief Divides a number of the "double" type by a double-double number and rounds the result
+
+    \param [in] x {The dividend}
+    \param [in] y {The divisor}
+    \return x / y
+*/
+static double Double_Div_DD (const double x, const struct Double_Double y)
+{
+    double quotient = x / y.Hi;
+    struct Double_Double product = Two_Prod (quotient, y.Hi);
+
+    return quotient + ((x - product.Hi) - product.Lo - quotient * y.Lo) / y.Hi;
+}
+
+/**
+    \brief Calculates discriminant of a quadratic equation with compensation of rounding errors
+
+    b * b and 4 * a * c are computed with their rounding errors (with fma ()),
+             so the only errors left come from three additions.
+
+    \param [in] a - quadratic coefficient
+    \param [in] b - linear coefficient
+    \param [in] c - free term
+    \param [out] *error_bound - pointer on the variable in which the function puts the bound of the absolute error
+                                (may be NULL)
+    \return The value of discriminant
+*/
+double Calc_Discriminant_Compensated (const double a, const double b, const double c, double *error_bound)
+{
+    struct Double_Double b_square = Two_Prod (b, b);
+    struct Double_Double four_ac  = Two_Prod (4 * a, c);
+
+    double main_part  = b_square.Hi - four_ac.Hi;
+    double error_part = b_square.Lo - four_ac.Lo;
+    double D = main_part + error_part;
+
+    if (error_bound != NULL)
+        *error_bound = 2 * UNIT_ROUNDOFF * (fabs (main_part) + fabs (error_part) + fabs (D));
+
+    return D;
+}
+
+/**
+    \brief Calculates roots from the discriminant with the formula that does not subtract close numbers
+
+    The roots are put in the same order as Calc_Roots_Of_Quadratic_Equation () does: (-b - sqrt_D) / 2a first.
+
+    \param [in] a - quadratic coefficient
+    \param [in] b - linear coefficient
+    \param [in] c - free term
+    \param [in] sqrt_D - square root of discriminant as a double-double number
+    \param [out] *first_root - pointer on the variable that contains the value of the first root
+    \param [out] *second_root - pointer on the variable that contains the value of the second root
+*/
+static void Calc_Stable_Roots (const double a, const double b, const double c, const struct Double_Double sqrt_D,
+                               double *first_root, double *second_root)
+{
+    struct Double_Double sum = DD_Add ((struct Double_Double){b, 0.0},
+                                       signbit (b) ? (struct Double_Double){-sqrt_D.Hi, -sqrt_D.Lo} : sqrt_D);
+    struct Double_Double q = {-sum.Hi / 2, -sum.Lo / 2};
+
+    double root_from_a = DD_Div_Double (q, a);
+    double root_from_c = (q.Hi == 0.0) ? root_from_a : Double_Div_DD (c, q);
+
+    if (signbit (b))
+    {
+        *first_root  = root_from_c;
+        *second_root = root_from_a;
+    }
+    else
+    {
+        *first_root  = root_from_a;
+        *second_root = root_from_c;
+    }
+}
+
+/**
+    \brief Finds the power of two that keeps b * b and 4 * a * c of an equation from overflowing
+
+    \param [in] a - quadratic coefficient
+    \param [in] b - linear coefficient
+    \param [in] c - free term
+    \return 0 if b * b and 4 * a * c are finite or a coefficient is not finite
+    \return The largest binary exponent of the coefficients otherwise, so that the largest of them divided by
+             2 to this power is in [1, 2)
+*/
+static int Find_Overflow_Shift (const double a, const double b, const double c)
+{
+    if (isfinite (b * b) && isfinite (4 * a * c))
+        return 0;
+    if (!isfinite (a) || !isfinite (b) || !isfinite (c))
+        return 0;
+
+    return ilogb (fmax (fabs (a), fmax (fabs (b), fabs (c))));
+}
+
+/**
+    \brief Solves quadratic equation accurately, paying for double-double arithmetic only when needed
+
+    Calls Calc_Discriminant_Compensated (), Compare_Double (), Calc_Stable_Roots ().
+    The number of roots is found the same way Solve_Quadratic_Equation () does, but from a more accurate discriminant.
+    If the error bound of the discriminant can change the number of roots or
+             makes the relative error of the roots greater than PRECISE_TOLERANCE,
+             the discriminant and the roots are computed again in double-double arithmetic.
+    If b * b or 4 * a * c overflows, the equation is divided by a power of two first: the roots do not change,
+             and the discriminant is multiplied back by the square of it before it is compared with 0.
+    If discriminant is less than 0, both root-variables will still have NAN value.
+
+    \param [in] a - quadratic coefficient
+    \param [in] b - linear coefficient
+    \param [in] c - free term
+    \param [out] *first_root - pointer on the variable that contains the value of the first root
+    \param [out] *second_root - pointer on the variable that contains the value of the second root
+    \param [out] *escalated - pointer on the variable that is set to true if double-double arithmetic has been used
+                              (may be NULL)
+    \return 0 (Zero) if the equation has no roots
+    \return 1 (One) if the equation has only one root or both roots are equal
+    \return 2 (Two) if the equation has only two different roots
+*/
+enum N_Roots Solve_Quadratic_Equation_Precise (const double a, const double b, const double c,
+                                               double *first_root, double *second_root, bool *escalated)
+{
+    assert (first_root  != NULL);
+    assert (second_root != NULL);
+
+    const int shift = Find_Overflow_Shift (a, b, c);
+    const double a_s = ldexp (a, -shift), b_s = ldexp (b, -shift), c_s = ldexp (c, -shift);
+    const double epsilon = ldexp (EPSILON, -2 * shift);
+
+    double error_bound = 0.0;
+    double D = Calc_Discriminant_Compensated (a_s, b_s, c_s, &error_bound);
+    struct Double_Double sqrt_D = {sqrt (fmax (D, 0.0)), 0.0};
+
+    bool near_border = fabs (D - epsilon) <= error_bound || fabs (D + epsilon) <= error_bound;
+    bool ill_conditioned = error_bound > PRECISE_TOLERANCE * 2 * sqrt_D.Hi * (fabs (b_s) + sqrt_D.Hi);
+
+    if (near_border || (ill_conditioned && D >= -epsilon))
+    {
+        struct Double_Double D_dd = DD_Add (Two_Prod (b_s, b_s), Two_Prod (-4 * a_s, c_s));
+
+        D = D_dd.Hi;
+        sqrt_D = DD_Sqrt (D_dd);
+
+        if (escalated != NULL)
+            *escalated = true;
+    }
+    else if (escalated != NULL)
+        *escalated = false;
+
+    D = ldexp (D, 2 * shift);
+
+    if (Compare_Double (D, 0.0) == Less)
+        return STATS_ROOTS (Zero);
+
+    Calc_Stable_Roots (a_s, b_s, c_s, sqrt_D, first_root, second_root);
+
+    if (Compare_Double (D, 0.0) == Equal)
+        return STATS_ADD (N_Near_Degenerate, 1), STATS_ROOTS (One);
+    else
+        return STATS_ROOTS (Two);
+}
+
+/**
+    \brief Calls the functions that solve quadratic or linear equation accurately
+
+    If coefficient "a" is equal to 0, this function calls Solve_Linear_Equation ().
+    If coefficient "a" is not equal to 0, this function calls Solve_Quadratic_Equation_Precise ().
+
+    \param [in] a {Quadratic coefficient}
+    \param [in] b {Linear coefficient}
+    \param [in] c {Free term}
+    \param [out] *first_root {Pointer on the variable that contains the value of the first root}
+    \param [out] *second_root {Pointer on the variable that contains the value of the second root}
+    \return The number of roots as Get_Number_Of_Roots_And_Solve_Equation () returns it
+*/
+enum N_Roots Get_Number_Of_Roots_And_Solve_Equation_Precise (const double a, const double b, const double c,
+                                                             double *first_root, double *second_root)
+{
+    assert (first_root  != NULL);
+    assert (second_root != NULL);
+
+    if (Compare_Double (a, 0.0) == Equal)
+        return Solve_Linear_Equation (b, c, first_root);
+    else
+        return Solve_Quadratic_Equation_Precise (a, b, c, first_root, second_root, NULL);
+}
+
+/**
+    \brief Solves a batch of equations stored as structure of arrays accurately
+
+    Calls Get_Number_Of_Roots_And_Solve_Equation_Precise () for every triple.
+    Root-variables that do not get a value keep NAN value.
+    Nothing is solved if an array of coefficients or the array for the numbers of roots is NULL;
+             the arrays for the roots may be NULL if the roots are not needed.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] x_1 {Array for the first roots}
+    \param [out] x_2 {Array for the second roots}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+void Solve_Batch_Precise (const double *a, const double *b, const double *c,
+                          double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (a == NULL || b == NULL || c == NULL || n_roots == NULL)
+        return;
+
+    for (size_t i = 0; i < n_equations; i++)
+    {
+        double first_root = NAN, second_root = NAN;
+
+        n_roots[i] = Get_Number_Of_Roots_And_Solve_Equation_Precise (a[i], b[i], c[i], &first_root, &second_root);
+
+        if (x_1 != NULL)
+            x_1[i] = first_root;
+        if (x_2 != NULL)
+            x_2[i] = second_root;
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef PRECISE_SOLVER_H_INCLUDED
+#define PRECISE_SOLVER_H_INCLUDED
+
+#include "Quadratic_Equation.h"
+
+#define PRECISE_TOLERANCE 1E-15     ///Roots whose relative error bound is greater than this are re-solved in double-double
+
+///A number of the "double-double" type: Hi + Lo where |Lo| <= ulp (Hi) / 2
+struct Double_Double
+{
+    double Hi;  ///< The main part
+    double Lo;  ///< The rounding error of the main part
+};
+
+double Calc_Discriminant_Compensated (const double a, const double b, const double c, double *error_bound);
+enum N_Roots Solve_Quadratic_Equation_Precise (const double a, const double b, const double c,
+                                               double *first_root, double *second_root, bool *escalated);
+enum N_Roots Get_Number_Of_Roots_And_Solve_Equation_Precise (const double a, const double b, const double c,
+                                                             double *first_root, double *second_root);
+void Solve_Batch_Precise (const double *a, const double *b, const double *c,
+                          double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations);
+int  Precise_Unit_Test (void);
+
+#endif
@@ -1,13 +1,12 @@
 #include "Quadratic_Equation.h"
 
-const double EPSILON = 10E-7; /// Is used to compare numbers of the "double" type
-
 /**
     \brief Runs one unit test
 
     Calls Compare_Double ().
     Tests Solve_Linear_Equation () if coefficient "a" is equal to 0.
     Tests Solve_Quadratic_Equation () if coefficient "a" is not equal to 0.
+    The test fails if the number of roots or the roots (in any order) differ from the expected ones.
     If a test fails, the function puts the number of this test,
              actual roots and number of roots and expected roots and number of roots on the screen.
 
@@ -32,8 +31,10 @@ int Unit_Test (const int n_test, enum N_Roots n_roots_ref, const double a,
     else
         n_roots = Solve_Quadratic_Equation (a, b, c, &x_1, &x_2);
 
-    if (n_roots != n_roots_ref && ((Compare_Double (x_1, x_1_ref) != Equal && Compare_Double (x_2, x_2_ref) != Equal)
-                                || (Compare_Double (x_1, x_2_ref) != Equal && Compare_Double (x_2, x_1_ref) != Equal)))
+    bool same_order    = Compare_Double (x_1, x_1_ref) == Equal && Compare_Double (x_2, x_2_ref) == Equal;
+    bool swapped_order = Compare_Double (x_1, x_2_ref) == Equal && Compare_Double (x_2, x_1_ref) == Equal;
+
+    if (n_roots != n_roots_ref || !(same_order || swapped_order))
     {
         printf ("Test %d FAILED\n"
                 "x_1 = %f, x_2 =  %f, n_roots = %d\n"
@@ -45,139 +46,6 @@ int Unit_Test (const int n_test, enum N_Roots n_roots_ref, const double a,
         return 1;
 }
 
-/**
-    \brief Calls the functions that solve quadratic or linear equation
-
-    If coefficient "a" is equal to 0, this function calls Solve_Linear_Equation ().
-    If coefficient "a" is not equal to 0, this function calls Solve_Quadratic_Equation ().
-
-    \param [in] a {Quadratic coefficient}
-    \param [in] b {Linear coefficient}
-    \param [in] c {Free term}
-    \param [out] *first_root {Pointer on the variable that contains the value of the first root}
-    \param [out] *second_root {Pointer on the variable that contains the value of the second root}
-    \return -1 (Infinite) if the equation has infinite number of roots
-    \return 0 (Zero) if the equation has no roots
-    \return 1 (One) if the equation has only one root or both roots are equal
-    \return 2 (Two) if the equation has only two different roots
-*/
-enum N_Roots Get_Number_Of_Roots_And_Solve_Equation (const double a, const double b, const double c,
-                                                     double *first_root, double *second_root)
-{
-    assert (first_root  != NULL);
-    assert (second_root != NULL);
-
-    if (Compare_Double (a, 0.0) == Equal)
-        return Solve_Linear_Equation (b, c, first_root);
-    else
-        return Solve_Quadratic_Equation (a, b, c, first_root, second_root);
-}
-
-/**
-    \brief Solves quadratic equation
-
-    Calls Calculate_Discriminant (), Compare_Double ().
-    If discriminant is less than 0, both root-variables will still have NAN value.
-    If discriminant is equal to 0, both roots will be calculated and will be equal.
-
-    \param [in] a - quadratic coefficient
-    \param [in] b - linear coefficient
-    \param [in] c - free term
-    \param [out] *first_root - pointer on the variable that contains the value of the first root
-    \param [out] *second_root - pointer on the variable that contains the value of the second root
-    \return 0 (Zero) if the equation has no roots
-    \return 1 (One) if the equation has only one root or both roots are equal
-    \return 2 (Two) if the equation has only two different roots
-*/
-enum N_Roots Solve_Quadratic_Equation (const double a, const double b, const double c,
-                                       double *first_root, double *second_root)
-{
-    assert (first_root != NULL);
-    assert (second_root != NULL);
-
-    double D = Calc_Discriminant (a, b, c);
-
-    if (Compare_Double (D, 0.0) == Less)
-        return Zero;
-    else
-    {
-        double sqrt_D = sqrt (D);
-        Calc_Roots_Of_Quadratic_Equation (a, b, sqrt_D, first_root, second_root);
-
-        if (Compare_Double (D, 0.0) == Equal)
-            return One;
-        else
-            return Two;
-    }
-}
-
-/**
-    \brief Calculates discriminant of a quadratic equation
-    \param [in] a - quadratic coefficient
-    \param [in] b - linear coefficient
-    \param [in] c - free term
-    \return The value of discriminant
-*/
-inline double Calc_Discriminant (const double a, const double b, const double c)
-{
-    return b * b - 4 * a * c;
-}
-
-/**
-    \brief Calculates roots of a quadratic equation
-    \param [in] a - quadratic coefficient
-    \param [in] b - linear coefficient
-    \param [in] c - free term
-    \param [in] sqrt_D - square root of discriminant
-    \param [out] *first_root - pointer on the variable that contains the value of the first root
-    \param [out] *second_root - pointer on the variable that contains the value of the second root
-*/
-void Calc_Roots_Of_Quadratic_Equation (const double a, const double b, const double sqrt_D,
-                                       double *first_root, double *second_root)
-{
-    assert (a != 0);
-    assert (first_root != NULL);
-    assert (second_root != NULL);
-
-    double double_a = 2 * a;
-    *first_root  = (-b - sqrt_D) / double_a;
-    *second_root = (-b + sqrt_D) / double_a;
-}
-
-/**
-    \brief Solves a linear equation
-
-    Calls Compare_Double ().
-    Runs when quadratic coefficient ("a") is equal to 0.
-    If there are infinite roots, both root-variables will still have NAN value.
-    If there are no roots, both root-variables will still have NAN value.
-    If there is only one root, x_1 from main will change the value and x_2 from main will still have NAN value.
-
-    \param [in] b {Linear coefficient}
-    \param [in] c {Free term}
-    \param [out] *root {Pointer on the variable that contains the value of the first root}
-    \return -1 (Infinite) if the equation has infinite number of roots
-    \return 0 (Zero) if the equation has no roots
-    \return 1 (One) if the equation has only one root or both roots are equal
-*/
-enum N_Roots Solve_Linear_Equation (const double b, const double c, double *root)
-{
-    assert (root != NULL);
-
-    if (Compare_Double (b, 0.0) == Equal)
-    {
-        if (Compare_Double (c, 0.0) == Equal)
-            return Infinite;
-        else
-            return Zero;
-    }
-    else
-    {
-        *root = -c / b;
-        return One;
-    }
-}
-
 /**
     \brief Gets three coefficients
 
@@ -345,45 +213,6 @@ int Get_Not_Negative_Int (void)
     return input_number;
 }
 
-/**
-    \brief Compares two numbers of the "double" type
-    \param [in] first {The number that is on the left of the comparison sign}
-    \param [in] second {The number that is on the right of the comparison sign}
-    \return 1 (Greater) if "first" is greater than "second"
-    \return 0 (Equal) if the numbers are equal (even if both of them are NAN), -1 (Less) if "first" is less than "second"
-    \return -1 (Less) if "first" is less than "second"
-    \return -2 (Not_Equal) if only one number is NAN
-*/
-enum Compare Compare_Double (const double first, const double second)
-{
-    if (IsNAN (first) && IsNAN (second))
-        return Equal;
-
-    else if (IsNAN (first) ^ IsNAN (second))
-        return Not_Equal;
-
-    else
-    {
-        double absolute_value = fabs (first - second);
-
-        if (absolute_value > EPSILON)
-            return (first > second) ? Greater : Less;
-        else
-            return Equal;
-    }
-}
-
-/**
-    \brief Checks if a number of the "double" type is equal to NAN
-    \param [in] value {A number of the "double" type}
-    \return 0 if a number is not equal to NAN
-    \return 1 if a number is equal to NAN
-*/
-inline int IsNAN (const double value)
-{
-    return (value != value) ? 1 : 0;
-}
-
 /**
     \brief Prints roots of the equation
 
@@ -0,0 +1,341 @@
+#include "Quadratic_Solver.h"
+
+#include <float.h>
+
+const double EPSILON = SOLVER_EPSILON; /// Is used to compare numbers of the "double" type
+
+/*
+    External definitions of the inline functions of Quadratic_Solver.h.
+    They are used when a call is not inlined and when the address of a function is taken.
+*/
+extern inline int IsNAN (const double value);
+DECLARE_QUADRATIC_SOLVER_EXTERN (, double, Compare_Double, Get_Number_Of_Roots_And_Solve_Equation)
+extern inline enum N_Roots Classify_Equation (const double a, const double b, const double c);
+extern inline enum N_Roots Solve_Equation_Complex (const double a, const double b, const double c,
+                                                   double *re_1, double *im_1, double *re_2, double *im_2);
+
+/*
+    Solve_Batch (): Get_Number_Of_Roots_And_Solve_Equation () for every triple, see DEFINE_QUADRATIC_BATCH_SOLVER ().
+*/
+DEFINE_QUADRATIC_BATCH_SOLVER (, double, Get_Number_Of_Roots_And_Solve_Equation)
+
+/**
+    \brief Calculates the roots of a quadratic equation with the formula that does not subtract close numbers
+
+    q = -(b + sign (b) * sqrt (D)) / 2, the roots are q / a and c / q (both q / a if q is 0).
+    q is found as (b + sign (b) * sqrt (D)) * -0.5, the way the vector kernels find it, so that even
+             the sign of NAN is the same.
+    The roots are put in the same order as Calc_Roots_Of_Quadratic_Equation () does: (-b - sqrt_D) / 2a first.
+
+    \param [in] a - quadratic coefficient
+    \param [in] b - linear coefficient
+    \param [in] c - free term
+    \param [out] *first_root - pointer on the variable that contains the value of the first root
+    \param [out] *second_root - pointer on the variable that contains the value of the second root
+*/
+static void Calc_Stable_Roots_Of_Quadratic_Equation (const double a, const double b, const double c,
+                                                     double *first_root, double *second_root)
+{
+    double D = Calc_Discriminant (a, b, c);
+    double sqrt_D = sqrt ((D < 0.0) ? 0.0 : D);
+    double q = (b + copysign (sqrt_D, b)) * -0.5;
+
+    double root_from_a = q / a;
+    double root_from_c = (q == 0.0) ? root_from_a : c / q;
+
+    *first_root  = signbit (b) ? root_from_c : root_from_a;
+    *second_root = signbit (b) ? root_from_a : root_from_c;
+}
+
+/**
+    \brief Solves a batch of equations stored as structure of arrays without losing the smaller root
+
+    Makes the decisions of Solve_Batch (), so the numbers of roots are the same, but the roots of a quadratic
+             equation come from Calc_Stable_Roots_Of_Quadratic_Equation (): the textbook formula loses
+             all the digits of the smaller root if 4ac is much less than b^2 (1E-20 x^2 + x + 1 = 0 gives 0
+             instead of -1). Is used for the scaled equations of Solve_Batch_Scaled ().
+    Nothing is solved if an array of coefficients or the array for the numbers of roots is NULL;
+             the arrays for the roots may be NULL if the roots are not needed.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] x_1 {Array for the first roots}
+    \param [out] x_2 {Array for the second roots}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+void Solve_Batch_Stable (const double *a, const double *b, const double *c,
+                         double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (a == NULL || b == NULL || c == NULL || n_roots == NULL)
+        return;
+
+    for (size_t i = 0; i < n_equations; i++)
+    {
+        double first_root = NAN, second_root = NAN;
+
+        if (Compare_Double (a[i], 0.0) == Equal)
+            n_roots[i] = Solve_Linear_Equation (b[i], c[i], &first_root);
+        else if ((n_roots[i] = Solve_Quadratic_Equation (a[i], b[i], c[i], NULL, NULL)) != Zero)
+            Calc_Stable_Roots_Of_Quadratic_Equation (a[i], b[i], c[i], &first_root, &second_root);
+
+        if (x_1 != NULL)
+            x_1[i] = first_root;
+        if (x_2 != NULL)
+            x_2[i] = second_root;
+    }
+}
+
+/**
+    \brief Solves a batch of equations stored as structure of arrays and gives complex roots
+
+    Calls Solve_Equation_Complex () for every triple.
+    Nothing is solved if an array of coefficients or the array for the numbers of roots is NULL;
+             the arrays for the roots may be NULL if the roots are not needed.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] re_1 {Array for the real parts of the first roots}
+    \param [out] im_1 {Array for the imaginary parts of the first roots}
+    \param [out] re_2 {Array for the real parts of the second roots}
+    \param [out] im_2 {Array for the imaginary parts of the second roots}
+    \param [out] n_roots {Array for the numbers of real roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+void Solve_Batch_Complex (const double *a, const double *b, const double *c,
+                          double *re_1, double *im_1, double *re_2, double *im_2,
+                          enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (a == NULL || b == NULL || c == NULL || n_roots == NULL)
+        return;
+
+    for (size_t i = 0; i < n_equations; i++)
+        n_roots[i] = Solve_Equation_Complex (a[i], b[i], c[i], (re_1 != NULL) ? re_1 + i : NULL, (im_1 != NULL) ? im_1 + i : NULL,
+                                             (re_2 != NULL) ? re_2 + i : NULL, (im_2 != NULL) ? im_2 + i : NULL);
+}
+
+/**
+    \brief Finds the powers of two Scale_Coefficients () applies to one equation
+
+    The unknown is replaced by x = 2^k y, so the roots of a 2^2k y^2 + b 2^k y + c = 0 are not larger than about 2:
+             k = max (E(b) - E(a), floor ((E(c) - E(a)) / 2)), where E () is the binary exponent ilogb () gives;
+             if "a" is 0, k = E(c) - E(b) brings the root -c / b close to 1.
+    Then the equation is divided by 2^s, where s is the largest exponent of the new coefficients,
+             so the largest of them is in [1, 2) and the discriminant can neither overflow nor underflow.
+    Coefficients equal to 0 do not take part; if a coefficient is not finite, k = s = 0.
+
+    \param [in] a {Quadratic coefficient}
+    \param [in] b {Linear coefficient}
+    \param [in] c {Free term}
+    \param [out] shift {s}
+    \return k
+*/
+static int Find_Scale_Exponents (const double a, const double b, const double c, int *shift)
+{
+    *shift = 0;
+
+    if (!isfinite (a) || !isfinite (b) || !isfinite (c) || (a == 0.0 && b == 0.0 && c == 0.0))
+        return 0;
+
+    int k = 0;
+
+    if (a != 0.0 && b != 0.0)
+        k = ilogb (b) - ilogb (a);
+    if (a != 0.0 && c != 0.0)
+    {
+        int half = (int)floor ((ilogb (c) - ilogb (a)) / 2.0);
+        k = (b == 0.0 || half > k) ? half : k;
+    }
+    if (a == 0.0 && b != 0.0 && c != 0.0)
+        k = ilogb (c) - ilogb (b);
+
+    int s = (a != 0.0) ? ilogb (a) + 2 * k : (b != 0.0) ? ilogb (b) + k : ilogb (c);
+
+    if (b != 0.0 && ilogb (b) + k > s)
+        s = ilogb (b) + k;
+    if (c != 0.0 && ilogb (c) > s)
+        s = ilogb (c);
+
+    *shift = s;
+
+    return k;
+}
+
+/**
+    \brief Scales equations by powers of two, so that their discriminants do not overflow or underflow
+
+    Calls Find_Scale_Exponents () and ldexp () for every triple, so the scaled coefficients are exact
+             (a coefficient smaller than 2^-1074 of the largest one becomes 0). The roots of the scaled equation
+             multiplied by 2^exponent are the roots of the original one.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] scaled_a {Array for the scaled quadratic coefficients}
+    \param [out] scaled_b {Array for the scaled linear coefficients}
+    \param [out] scaled_c {Array for the scaled free terms}
+    \param [out] exponent {Array for the powers of two the roots have to be multiplied by}
+    \param [in] n_equations {The number of equations in every array}
+*/
+void Scale_Coefficients (const double *a, const double *b, const double *c,
+                         double *scaled_a, double *scaled_b, double *scaled_c, int *exponent, const size_t n_equations)
+{
+    for (size_t i = 0; i < n_equations; i++)
+    {
+        int s = 0;
+        int k = Find_Scale_Exponents (a[i], b[i], c[i], &s);
+
+        scaled_a[i] = ldexp (a[i], 2 * k - s);
+        scaled_b[i] = ldexp (b[i], k - s);
+        scaled_c[i] = ldexp (c[i], -s);
+        exponent[i] = k;
+    }
+}
+
+/**
+    \brief Multiplies the roots of scaled equations by the powers of two Scale_Coefficients () has found
+
+    ldexp () rounds only a root that becomes subnormal and gives infinity only for a root that is too large
+             for the "double" type. The arrays for the roots may be NULL.
+
+    \param [in,out] x_1 {Array of the first roots}
+    \param [in,out] x_2 {Array of the second roots}
+    \param [in] exponent {Array of the powers of two}
+    \param [in] n_equations {The number of equations in every array}
+*/
+void Unscale_Roots (double *x_1, double *x_2, const int *exponent, const size_t n_equations)
+{
+    for (size_t i = 0; i < n_equations; i++)
+    {
+        if (x_1 != NULL)
+            x_1[i] = ldexp (x_1[i], exponent[i]);
+        if (x_2 != NULL)
+            x_2[i] = ldexp (x_2[i], exponent[i]);
+    }
+}
+
+/**
+    \brief Finds again the smaller roots that the scaled equations have lost to underflow
+
+    Scale_Coefficients () makes the larger root about 1, so if the roots differ by more than about 2^1020,
+             the scaled free term is subnormal or 0 and the root c / q of the scaled equation loses its digits
+             (x^2 + 1E200 x + 1 = 0 would give 0 instead of -1E-200).
+    Such a root is found from the original coefficients and the other root with the theorem of Vieta:
+             x = c / (a * x_other), where a * x_other is q of the original equation. The condition depends only
+             on the scaled free term, so it is the same for equations that differ by powers of two.
+    If q overflows (|b| is about DBL_MAX), x = (c / a) / x_other.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [in] scaled_c {Array of the free terms Scale_Coefficients () has given}
+    \param [in,out] x_1 {Array of the first roots after Unscale_Roots ()}
+    \param [in,out] x_2 {Array of the second roots after Unscale_Roots ()}
+    \param [in] n_roots {Array of the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+void Refine_Underflowed_Roots (const double *a, const double *b, const double *c, const double *scaled_c,
+                               double *x_1, double *x_2, const enum N_Roots *n_roots, const size_t n_equations)
+{
+    for (size_t i = 0; i < n_equations; i++)
+    {
+        if ((n_roots[i] != One && n_roots[i] != Two) || c[i] == 0.0 || !(fabs (scaled_c[i]) < 4 * DBL_MIN))
+            continue;
+
+        double *root_from_c = signbit (b[i]) ? x_1 + i : x_2 + i;
+        double x_other = signbit (b[i]) ? x_2[i] : x_1[i];
+        double q = a[i] * x_other;
+
+        if (isfinite (q) && q != 0.0)
+            *root_from_c = c[i] / q;
+        else if (isinf (q) && isfinite (x_other))
+            *root_from_c = c[i] / a[i] / x_other;
+    }
+}
+
+/**
+    \brief Solves a batch of equations whose coefficients may be of any size
+
+    Calls Scale_Coefficients (), Solve_Batch_Stable (), Unscale_Roots () and Refine_Underflowed_Roots ()
+             for blocks of SCALED_BLOCK_SIZE equations.
+    The decisions of Compare_Double () are made for the scaled equation, so EPSILON is compared with numbers
+             relative to the largest coefficient: "a" is treated as 0 only if it is 0, and a tiny equation
+             like 1E-200 x^2 + 3E-200 x + 2E-200 = 0 or a huge one like 1E200 x^2 - 3E200 x + 2E200 = 0
+             has the roots -2, -1 or 1, 2, and x^2 + 1E200 x + 1 = 0 has -1E200 and -1E-200. Scaling an equation or its roots by a power of two scales the results exactly.
+    Nothing is solved if an array of coefficients or the array for the numbers of roots is NULL;
+             the arrays for the roots may be NULL if the roots are not needed.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] x_1 {Array for the first roots}
+    \param [out] x_2 {Array for the second roots}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+void Solve_Batch_Scaled (const double *a, const double *b, const double *c,
+                         double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (a == NULL || b == NULL || c == NULL || n_roots == NULL)
+        return;
+
+    double scaled_a[SCALED_BLOCK_SIZE], scaled_b[SCALED_BLOCK_SIZE], scaled_c[SCALED_BLOCK_SIZE];
+    double unused_1[SCALED_BLOCK_SIZE], unused_2[SCALED_BLOCK_SIZE];    // the roots the caller does not need
+    int exponent[SCALED_BLOCK_SIZE];
+
+    for (size_t i = 0; i < n_equations; i += SCALED_BLOCK_SIZE)
+    {
+        size_t count = (n_equations - i < SCALED_BLOCK_SIZE) ? n_equations - i : SCALED_BLOCK_SIZE;
+        double *root_1 = (x_1 != NULL) ? x_1 + i : unused_1;
+        double *root_2 = (x_2 != NULL) ? x_2 + i : unused_2;
+
+        Scale_Coefficients (a + i, b + i, c + i, scaled_a, scaled_b, scaled_c, exponent, count);
+        Solve_Batch_Stable (scaled_a, scaled_b, scaled_c, root_1, root_2, n_roots + i, count);
+        Unscale_Roots (root_1, root_2, exponent, count);
+        Refine_Underflowed_Roots (a + i, b + i, c + i, scaled_c, root_1, root_2, n_roots + i, count);
+    }
+}
+
+/**
+    \brief Finds the numbers of roots of a batch of equations stored as structure of arrays
+
+    Calls Classify_Equation () for every triple, so the results are the same as the ones of Solve_Batch ().
+    Nothing is done if an array is NULL.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+void Classify_Batch (const double *a, const double *b, const double *c, enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (a == NULL || b == NULL || c == NULL || n_roots == NULL)
+        return;
+
+    for (size_t i = 0; i < n_equations; i++)
+        n_roots[i] = Classify_Equation (a[i], b[i], c[i]);
+}
+
+/**
+    \brief Adds up the numbers of equations of every class
+
+    \param [in] n_roots {Array of numbers of roots}
+    \param [in] n_equations {The number of elements of the array}
+    \param [in,out] totals {The numbers of equations with Infinite, Zero, One and Two roots; they are increased}
+*/
+void Count_Root_Classes (const enum N_Roots *n_roots, const size_t n_equations, size_t totals[4])
+{
+    if (n_roots == NULL || totals == NULL)
+        return;
+
+    size_t counts[4] = {0};
+
+    for (size_t i = 0; i < n_equations; i++)
+        counts[n_roots[i] - Infinite]++;
+
+    for (int i = 0; i < 4; i++)
+        totals[i] += counts[i];
+}
@@ -0,0 +1,320 @@
+#ifndef QUADRATIC_SOLVER_H_INCLUDED
+#define QUADRATIC_SOLVER_H_INCLUDED
+
+/*
+    The solver part of the project without any input or output. The hot path is defined here
+    as C99 "inline" functions, so every translation unit that includes this header can inline it;
+    Quadratic_Solver.c provides the external definitions for the calls that are not inlined.
+    All functions are reentrant: they use no global state except the constant EPSILON
+    and the thread-local counters of Solver_Stats.h (only if SOLVER_STATS is defined),
+    they ask for nothing and they never stop the program. Output pointers may be NULL
+    if a root is not needed.
+*/
+
+#include <math.h>
+#include <stddef.h>
+#include "Solver_Stats.h"
+
+#define SOLVER_EPSILON 10E-7    ///The value of EPSILON that the inline functions can fold
+#define SCALED_BLOCK_SIZE 256   ///The number of equations the scaled solvers scale, solve and unscale at a time
+
+extern const double EPSILON;
+
+///Possible results of comparison
+enum Compare
+{
+    Not_Equal = -2,  ///< For comparing NAN and an ordinary double
+    Less,   ///< Is used as synonym of -1 in operations of comparison
+    Equal,  ///< Is used as synonym of 0 in operations of comparison
+    Greater     ///< Is used as synonym of 1 in operations of comparison
+};
+
+///Possible number of roots of a quadratic equation
+enum N_Roots
+{
+    Infinite = -1,  ///< For infinite number of roots
+    Zero,   ///< For no roots
+    One,    ///< For only one root or only two equal roots
+    Two     ///< For only two different roots
+};
+
+/**
+    \brief Checks if a number of the "double" type is equal to NAN
+    \param [in] value {A number of the "double" type}
+    \return 0 if a number is not equal to NAN
+    \return 1 if a number is equal to NAN
+*/
+inline int IsNAN (const double value)
+{
+    return (value != value) ? 1 : 0;
+}
+
+/**
+    \brief Defines the solver of one floating-point type as "inline" functions
+
+    This template is the only definition of the solver: the double solver below is generated from it,
+             and Generic_Solver.h generates the float and long double ones, so they cannot drift apart.
+    For suffix _F it defines compare_name (), Calc_Discriminant_F (), Calc_Roots_Of_Quadratic_Equation_F (),
+             Solve_Linear_Equation_F (), Solve_Quadratic_Equation_F () and solve_name ().
+    Comparisons of compare_name () with 0 decide everything, root pointers may be NULL,
+             and the counters of Solver_Stats.h are changed as for the double solver.
+    The external definitions are made by DECLARE_QUADRATIC_SOLVER_EXTERN () in one translation unit.
+
+    \param suffix {The suffix of the names of the functions (empty for double)}
+    \param type {The floating-point type}
+    \param tolerance {Numbers that differ by not more than this are equal}
+    \param sqrt_function {The square root of the type: sqrt, sqrtf or sqrtl}
+    \param fabs_function {The absolute value of the type: fabs, fabsf or fabsl}
+    \param compare_name {The name of the comparison function}
+    \param solve_name {The name of the function that solves any equation}
+*/
+#define DEFINE_QUADRATIC_SOLVER(suffix, type, tolerance, sqrt_function, fabs_function, compare_name, solve_name)        \
+                                                                                                                        \
+/**                                                                                                                     \
+    \brief Compares two numbers with the tolerance of their type                                                        \
+    \return 1 (Greater) if "first" is greater than "second"                                                             \
+    \return 0 (Equal) if the numbers are equal within the tolerance (even if both of them are NAN)                      \
+    \return -1 (Less) if "first" is less than "second"                                                                  \
+    \return -2 (Not_Equal) if only one number is NAN                                                                    \
+*/                                                                                                                      \
+inline enum Compare compare_name (const type first, const type second)                                                  \
+{                                                                                                                       \
+    if (IsNAN (first) && IsNAN (second))                                                                                \
+        return STATS_ADD (N_NAN_Compares, 1), Equal;                                                                    \
+                                                                                                                        \
+    else if (IsNAN (first) ^ IsNAN (second))                                                                            \
+        return STATS_ADD (N_NAN_Compares, 1), Not_Equal;                                                                \
+                                                                                                                        \
+    else                                                                                                                \
+    {                                                                                                                   \
+        type absolute_value = fabs_function (first - second);                                                           \
+                                                                                                                        \
+        if (absolute_value > (tolerance))                                                                               \
+            return (first > second) ? Greater : Less;                                                                   \
+        else                                                                                                            \
+            return Equal;                                                                                               \
+    }                                                                                                                   \
+}                                                                                                                       \
+                                                                                                                        \
+/** \brief Calculates the discriminant b * b - 4 * a * c of a quadratic equation */                                     \
+inline type Calc_Discriminant##suffix (const type a, const type b, const type c)                                        \
+{                                                                                                                       \
+    return b * b - 4 * a * c;                                                                                           \
+}                                                                                                                       \
+                                                                                                                        \
+/**                                                                                                                     \
+    \brief Calculates (-b - sqrt_D) / 2a and (-b + sqrt_D) / 2a into the pointers that are not NULL                     \
+                                                                                                                        \
+    If "a" is 0, the roots are infinite or NAN: the caller has to solve a linear equation instead.                      \
+*/                                                                                                                      \
+inline void Calc_Roots_Of_Quadratic_Equation##suffix (const type a, const type b, const type sqrt_D,                    \
+                                                      type *first_root, type *second_root)                              \
+{                                                                                                                       \
+    type double_a = 2 * a;                                                                                              \
+                                                                                                                        \
+    if (first_root != NULL)                                                                                             \
+        *first_root  = (-b - sqrt_D) / double_a;                                                                        \
+    if (second_root != NULL)                                                                                            \
+        *second_root = (-b + sqrt_D) / double_a;                                                                        \
+}                                                                                                                       \
+                                                                                                                        \
+/**                                                                                                                     \
+    \brief Solves a linear equation b * x + c = 0                                                                       \
+                                                                                                                        \
+    \return -1 (Infinite), 0 (Zero) or 1 (One); the root-variable keeps its value if there is no single root            \
+*/                                                                                                                      \
+inline enum N_Roots Solve_Linear_Equation##suffix (const type b, const type c, type *root)                              \
+{                                                                                                                       \
+    STATS_ADD (N_Linear, 1);                                                                                            \
+                                                                                                                        \
+    if (compare_name (b, 0) == Equal)                                                                                   \
+    {                                                                                                                   \
+        if (compare_name (c, 0) == Equal)                                                                               \
+            return STATS_ROOTS (Infinite);                                                                              \
+        else                                                                                                            \
+            return STATS_ROOTS (Zero);                                                                                  \
+    }                                                                                                                   \
+    else                                                                                                                \
+    {                                                                                                                   \
+        if (root != NULL)                                                                                               \
+            *root = -c / b;                                                                                             \
+        return STATS_ROOTS (One);                                                                                       \
+    }                                                                                                                   \
+}                                                                                                                       \
+                                                                                                                        \
+/**                                                                                                                     \
+    \brief Solves a quadratic equation whose "a" is not 0                                                               \
+                                                                                                                        \
+    A discriminant that is negative but equal to 0 within the tolerance is treated as 0,                                \
+             and both roots are calculated and equal then. If it is less than 0, both root-variables keep their values. \
+                                                                                                                        \
+    \return 0 (Zero), 1 (One) if the roots are equal or 2 (Two)                                                         \
+*/                                                                                                                      \
+inline enum N_Roots Solve_Quadratic_Equation##suffix (const type a, const type b, const type c,                         \
+                                                      type *first_root, type *second_root)                              \
+{                                                                                                                       \
+    type D = Calc_Discriminant##suffix (a, b, c);                                                                       \
+                                                                                                                        \
+    if (compare_name (D, 0) == Less)                                                                                    \
+        return STATS_ROOTS (Zero);                                                                                      \
+    else                                                                                                                \
+    {                                                                                                                   \
+        type sqrt_D = sqrt_function ((D < 0) ? 0 : D);    /* D can be a bit below 0 within the tolerance */             \
+        Calc_Roots_Of_Quadratic_Equation##suffix (a, b, sqrt_D, first_root, second_root);                               \
+                                                                                                                        \
+        if (compare_name (D, 0) == Equal)                                                                               \
+            return STATS_ADD (N_Near_Degenerate, 1), STATS_ROOTS (One);                                                 \
+        else                                                                                                            \
+            return STATS_ROOTS (Two);                                                                                   \
+    }                                                                                                                   \
+}                                                                                                                       \
+                                                                                                                        \
+/**                                                                                                                     \
+    \brief Calls Solve_Linear_Equation () if "a" is equal to 0 and Solve_Quadratic_Equation () otherwise                \
+                                                                                                                        \
+    \return -1 (Infinite), 0 (Zero), 1 (One) or 2 (Two)                                                                 \
+*/                                                                                                                      \
+inline enum N_Roots solve_name (const type a, const type b, const type c, type *first_root, type *second_root)          \
+{                                                                                                                       \
+    if (compare_name (a, 0) == Equal)                                                                                   \
+        return Solve_Linear_Equation##suffix (b, c, first_root);                                                        \
+    else                                                                                                                \
+        return Solve_Quadratic_Equation##suffix (a, b, c, first_root, second_root);                                     \
+}
+
+/**
+    \brief Makes the external definitions of the functions of DEFINE_QUADRATIC_SOLVER ()
+
+    They are used when a call is not inlined and when the address of a function is taken.
+*/
+#define DECLARE_QUADRATIC_SOLVER_EXTERN(suffix, type, compare_name, solve_name)                                         \
+extern inline enum Compare compare_name (const type first, const type second);                                          \
+extern inline type Calc_Discriminant##suffix (const type a, const type b, const type c);                                \
+extern inline void Calc_Roots_Of_Quadratic_Equation##suffix (const type a, const type b, const type sqrt_D,             \
+                                                             type *first_root, type *second_root);                      \
+extern inline enum N_Roots Solve_Linear_Equation##suffix (const type b, const type c, type *root);                      \
+extern inline enum N_Roots Solve_Quadratic_Equation##suffix (const type a, const type b, const type c,                  \
+                                                             type *first_root, type *second_root);                      \
+extern inline enum N_Roots solve_name (const type a, const type b, const type c, type *first_root, type *second_root);
+
+/**
+    \brief Defines Solve_Batch##suffix (), which solves a batch of equations stored as structure of arrays
+
+    Calls solve_name () for every triple, so the results are the same as the ones of one equation.
+    Root-variables that do not get a value keep NAN value.
+    Nothing is solved if an array of coefficients or the array for the numbers of roots is NULL;
+             the arrays for the roots may be NULL if the roots are not needed.
+*/
+#define DEFINE_QUADRATIC_BATCH_SOLVER(suffix, type, solve_name)                                                         \
+void Solve_Batch##suffix (const type *a, const type *b, const type *c,                                                  \
+                          type *x_1, type *x_2, enum N_Roots *n_roots, const size_t n_equations)                        \
+{                                                                                                                       \
+    if (a == NULL || b == NULL || c == NULL || n_roots == NULL)                                                         \
+        return;                                                                                                         \
+                                                                                                                        \
+    for (size_t i = 0; i < n_equations; i++)                                                                            \
+    {                                                                                                                   \
+        type first_root = NAN, second_root = NAN;                                                                       \
+                                                                                                                        \
+        n_roots[i] = solve_name (a[i], b[i], c[i], &first_root, &second_root);                                          \
+                                                                                                                        \
+        if (x_1 != NULL)                                                                                                \
+            x_1[i] = first_root;                                                                                        \
+        if (x_2 != NULL)                                                                                                \
+            x_2[i] = second_root;                                                                                       \
+    }                                                                                                                   \
+}
+
+/*
+    The double solver: Compare_Double (), Calc_Discriminant (), Calc_Roots_Of_Quadratic_Equation (),
+    Solve_Linear_Equation (), Solve_Quadratic_Equation () and Get_Number_Of_Roots_And_Solve_Equation ().
+*/
+DEFINE_QUADRATIC_SOLVER (, double, SOLVER_EPSILON, sqrt, fabs, Compare_Double, Get_Number_Of_Roots_And_Solve_Equation)
+
+/**
+    \brief Finds the number of roots of an equation without computing the roots
+
+    Makes the same decisions as Get_Number_Of_Roots_And_Solve_Equation () with the comparisons
+             Compare_Double (x, 0.0) == Equal <=> |x| <= EPSILON and Compare_Double (D, 0.0) == Less <=> D < -EPSILON,
+             so the result is the same, but there are no square roots, divisions or jumps.
+    The counters of Solver_Stats.h are not changed.
+
+    \param [in] a {Quadratic coefficient}
+    \param [in] b {Linear coefficient}
+    \param [in] c {Free term}
+    \return The number of roots as Get_Number_Of_Roots_And_Solve_Equation () returns it
+*/
+inline enum N_Roots Classify_Equation (const double a, const double b, const double c)
+{
+    double D = Calc_Discriminant (a, b, c);
+
+    enum N_Roots quadratic = (D < -SOLVER_EPSILON) ? Zero : (fabs (D) <= SOLVER_EPSILON) ? One : Two;
+    enum N_Roots linear    = (fabs (b) > SOLVER_EPSILON || IsNAN (b)) ? One : (fabs (c) <= SOLVER_EPSILON) ? Infinite : Zero;
+
+    return (fabs (a) <= SOLVER_EPSILON) ? linear : quadratic;
+}
+
+/**
+    \brief Solves an equation and gives the complex roots instead of NAN if the discriminant is less than 0
+
+    Makes the decisions of Classify_Equation () and finds the roots with one formula for every sign of
+             the discriminant: s = sqrt (|D|) is put into the real parts if D >= 0 and into the imaginary parts
+             if D < -EPSILON, so there are no jumps and a vector kernel needs no special lanes.
+    Real roots are the same bit for bit as the ones of Get_Number_Of_Roots_And_Solve_Equation (),
+             their imaginary parts are 0. If D < -EPSILON, the roots are (-b -+ i s) / 2a and 0 (Zero) is returned
+             as the solver does, so the number of real roots does not change.
+    A root that does not exist (the second root of a linear equation or both roots if "a" and "b" are 0)
+             is NAN in both parts. The counters of Solver_Stats.h are not changed.
+
+    \param [in] a {Quadratic coefficient}
+    \param [in] b {Linear coefficient}
+    \param [in] c {Free term}
+    \param [out] *re_1 {Pointer on the real part of the first root (may be NULL)}
+    \param [out] *im_1 {Pointer on the imaginary part of the first root (may be NULL)}
+    \param [out] *re_2 {Pointer on the real part of the second root (may be NULL)}
+    \param [out] *im_2 {Pointer on the imaginary part of the second root (may be NULL)}
+    \return The number of real roots as Get_Number_Of_Roots_And_Solve_Equation () returns it
+*/
+inline enum N_Roots Solve_Equation_Complex (const double a, const double b, const double c,
+                                            double *re_1, double *im_1, double *re_2, double *im_2)
+{
+    double D         = Calc_Discriminant (a, b, c);
+    double sqrt_D    = sqrt (fabs (D));
+    double double_a  = 2 * a;
+    double real_part = (D < 0.0) ? 0.0 : copysign (sqrt_D, D);    // -0.0 and NAN stay as sqrt () gives them
+    double imag_part = sqrt_D / double_a;
+
+    int D_less = D < -SOLVER_EPSILON;
+    int a_zero = fabs (a) <= SOLVER_EPSILON;
+    int b_zero = fabs (b) <= SOLVER_EPSILON;
+
+    if (re_1 != NULL)
+        *re_1 = a_zero ? (b_zero ? NAN : -c / b) : (-b - real_part) / double_a;
+    if (im_1 != NULL)
+        *im_1 = a_zero ? (b_zero ? NAN : 0.0) : D_less ? -imag_part : 0.0;
+    if (re_2 != NULL)
+        *re_2 = a_zero ? NAN : (-b + real_part) / double_a;
+    if (im_2 != NULL)
+        *im_2 = a_zero ? NAN : D_less ? imag_part : 0.0;
+
+    return Classify_Equation (a, b, c);
+}
+
+void Solve_Batch (const double *a, const double *b, const double *c,
+                  double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations);
+void Solve_Batch_Stable (const double *a, const double *b, const double *c,
+                         double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations);
+void Solve_Batch_Complex (const double *a, const double *b, const double *c,
+                          double *re_1, double *im_1, double *re_2, double *im_2,
+                          enum N_Roots *n_roots, const size_t n_equations);
+void Scale_Coefficients (const double *a, const double *b, const double *c,
+                         double *scaled_a, double *scaled_b, double *scaled_c, int *exponent, const size_t n_equations);
+void Unscale_Roots (double *x_1, double *x_2, const int *exponent, const size_t n_equations);
+void Refine_Underflowed_Roots (const double *a, const double *b, const double *c, const double *scaled_c,
+                               double *x_1, double *x_2, const enum N_Roots *n_roots, const size_t n_equations);
+void Solve_Batch_Scaled (const double *a, const double *b, const double *c,
+                         double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations);
+void Classify_Batch (const double *a, const double *b, const double *c, enum N_Roots *n_roots, const size_t n_equations);
+void Count_Root_Classes (const enum N_Roots *n_roots, const size_t n_equations, size_t totals[4]);
+
+#endif
@@ -0,0 +1,709 @@
+#include "Result_Store.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+    \brief Finds the number of bytes the classes of a block take
+
+    \param [in] n_equations {The number of equations in the block}
+    \return The number of bytes, 2 bits per equation rounded up to 8 bytes
+*/
+static size_t Get_Classes_Size (const size_t n_equations)
+{
+    return ((n_equations + 3) / 4 + 7) & ~(size_t)7;
+}
+
+/**
+    \brief Checks if results should be written as a result store
+
+    \param [in] path {The name of the output}
+    \return True if the name ends with STORE_EXTENSION
+*/
+bool Is_Store_Name (const char *path)
+{
+    assert (path != NULL);
+
+    size_t length = strlen (path), extension_length = strlen (STORE_EXTENSION);
+
+    return length > extension_length && strcmp (path + length - extension_length, STORE_EXTENSION) == 0;
+}
+
+/**
+    \brief Writes bytes into the store and counts them
+
+    \param [in] writer {Pointer on the writer}
+    \param [in] data {The bytes}
+    \param [in] n_bytes {The number of bytes}
+    \return 0 if everything has been written
+    \return -1 otherwise
+*/
+static int Write_Store_Bytes (struct Store_Writer *writer, const void *data, const size_t n_bytes)
+{
+    if (n_bytes > 0 && fwrite (data, 1, n_bytes, writer->Stream) != n_bytes)
+        return -1;
+
+    writer->Offset += n_bytes;
+
+    return 0;
+}
+
+/**
+    \brief Opens a result store for writing and writes its header
+
+    \param [out] writer {Pointer on the writer}
+    \param [in] path {The name of the file ("-" means stdout)}
+    \param [in] classes_only {Write only the classes of the equations ("--classify")}
+    \return 0 if the store has been opened
+    \return -1 otherwise (the reason is printed to stderr; the writer should still be closed with Close_Store_Writer ())
+*/
+int Open_Store_Writer (struct Store_Writer *writer, const char *path, const bool classes_only)
+{
+    assert (writer != NULL);
+    assert (path != NULL);
+
+    *writer = (struct Store_Writer){.Flags = classes_only ? STORE_CLASSES_ONLY : 0};
+
+    writer->Stream  = (strcmp (path, "-") == 0) ? stdout : fopen (path, "wb");
+    writer->Classes = calloc (Get_Classes_Size (STORE_BLOCK_SIZE), 1);
+    if (!classes_only)
+    {
+        writer->X_1 = malloc (STORE_BLOCK_SIZE * sizeof (double));
+        writer->X_2 = malloc (STORE_BLOCK_SIZE * sizeof (double));
+    }
+
+    if (writer->Stream == NULL || writer->Classes == NULL || (!classes_only && (writer->X_1 == NULL || writer->X_2 == NULL)))
+    {
+        fprintf (stderr, "Cannot open \"%s\"\n", path);
+        return -1;
+    }
+
+    struct Store_Header header = {.Block_Size = STORE_BLOCK_SIZE, .Flags = writer->Flags};
+    memcpy (header.Magic, STORE_MAGIC, STORE_MAGIC_LENGTH);
+
+    if (Write_Store_Bytes (writer, &header, sizeof (header)) != 0)
+    {
+        fprintf (stderr, "Cannot write to \"%s\"\n", path);
+        return -1;
+    }
+
+    writer->Current.Offset = writer->Offset;
+
+    return 0;
+}
+
+/**
+    \brief Finds the smallest and the largest numbers of a column
+
+    \param [in] column {The numbers}
+    \param [in] n_values {The number of numbers}
+    \param [out] min {Pointer on the smallest number (INFINITY if there are none but NAN)}
+    \param [out] max {Pointer on the largest number (-INFINITY if there are none but NAN)}
+*/
+static void Find_Column_Range (const double *column, const size_t n_values, double *min, double *max)
+{
+    double smallest = INFINITY, largest = -INFINITY;
+
+    for (size_t i = 0; i < n_values; i++)
+    {
+        smallest = (column[i] < smallest) ? column[i] : smallest;
+        largest  = (column[i] > largest)  ? column[i] : largest;
+    }
+
+    *min = smallest;
+    *max = largest;
+}
+
+/**
+    \brief Writes the current block and adds it to the index
+
+    The smallest and the largest roots of the block are put into its index entry for Block_May_Match ().
+
+    \param [in] writer {Pointer on the writer}
+    \return 0 if everything is OK
+    \return -1 if the block cannot be written or there is not enough memory
+*/
+static int Flush_Store_Block (struct Store_Writer *writer)
+{
+    struct Store_Block_Index *entry = &writer->Current;
+
+    if (writer->N_Blocks == writer->Index_Capacity)
+    {
+        size_t capacity = (writer->Index_Capacity == 0) ? 64 : 2 * writer->Index_Capacity;
+        struct Store_Block_Index *index = realloc (writer->Index, capacity * sizeof (struct Store_Block_Index));
+
+        if (index == NULL)
+            return -1;
+
+        writer->Index = index;
+        writer->Index_Capacity = capacity;
+    }
+
+    if (Write_Store_Bytes (writer, writer->Classes, Get_Classes_Size (entry->N_Equations)) != 0 ||
+        Write_Store_Bytes (writer, writer->X_1, entry->N_Roots * sizeof (double)) != 0 ||
+        Write_Store_Bytes (writer, writer->X_2, entry->N_Roots * sizeof (double)) != 0)
+        return -1;
+
+    Find_Column_Range (writer->X_1, entry->N_Roots, &entry->Min_X_1, &entry->Max_X_1);
+    Find_Column_Range (writer->X_2, entry->N_Roots, &entry->Min_X_2, &entry->Max_X_2);
+
+    writer->Index[writer->N_Blocks++] = *entry;
+    writer->N_Equations += entry->N_Equations;
+
+    memset (writer->Classes, 0, Get_Classes_Size (STORE_BLOCK_SIZE));
+    *entry = (struct Store_Block_Index){.Offset = writer->Offset};
+
+    return 0;
+}
+
+/**
+    \brief Adds the results of a chunk to a result store (a Chunk_Writer)
+
+    The classes are packed by 2 bits; the roots are copied into the columns without branches
+             and the position in the columns moves only for equations with One or Two roots.
+
+    \param [in] writer {Pointer on struct Store_Writer}
+    \param [in] x_1 {Array of the first roots (not used if the store has only classes)}
+    \param [in] x_2 {Array of the second roots (the same)}
+    \param [in] n_roots {Array of the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+    \return 0 if everything is OK
+    \return -1 if a block cannot be written
+*/
+int Write_Store_Chunk (void *writer, const double *x_1, const double *x_2, const enum N_Roots *n_roots,
+                       const size_t n_equations)
+{
+    assert (writer  != NULL);
+    assert (n_roots != NULL);
+
+    struct Store_Writer *store = writer;
+    struct Store_Block_Index *entry = &store->Current;
+    const bool with_roots = (store->Flags & STORE_CLASSES_ONLY) == 0;
+
+    for (size_t i = 0; i < n_equations; i++)
+    {
+        unsigned code = (unsigned)(n_roots[i] - Infinite) & 3;
+        uint32_t j = entry->N_Equations++;
+
+        store->Classes[j / 4] |= (uint8_t)(code << (2 * (j % 4)));
+        entry->Totals[code]++;
+
+        if (with_roots)
+        {
+            store->X_1[entry->N_Roots] = x_1[i];
+            store->X_2[entry->N_Roots] = x_2[i];
+            entry->N_Roots += (code >= One - Infinite);
+        }
+
+        if (entry->N_Equations == STORE_BLOCK_SIZE && Flush_Store_Block (store) != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+/**
+    \brief Writes the last block, the index and the footer and closes the store
+
+    \param [in] writer {Pointer on the writer}
+    \return 0 if everything has been written
+    \return -1 otherwise
+*/
+int Close_Store_Writer (struct Store_Writer *writer)
+{
+    assert (writer != NULL);
+
+    int status = 0;
+
+    if (writer->Stream != NULL)
+    {
+        if (writer->Current.N_Equations > 0)
+            status = Flush_Store_Block (writer);
+
+        struct Store_Footer footer = {writer->Offset, writer->N_Blocks, writer->N_Equations, ""};
+        memcpy (footer.Magic, STORE_MAGIC, STORE_MAGIC_LENGTH);
+
+        if (status == 0)
+            status = Write_Store_Bytes (writer, writer->Index, writer->N_Blocks * sizeof (struct Store_Block_Index));
+        if (status == 0)
+            status = Write_Store_Bytes (writer, &footer, sizeof (footer));
+
+        if (writer->Stream == stdout)
+            status |= fflush (stdout);
+        else
+            status |= fclose (writer->Stream);
+    }
+
+    free (writer->Classes);
+    free (writer->X_1);
+    free (writer->X_2);
+    free (writer->Index);
+    *writer = (struct Store_Writer){0};
+
+    return (status == 0) ? 0 : -1;
+}
+
+/**
+    \brief Checks the header, the footer and every entry of the index of a mapped store
+
+    \param [in] reader {Pointer on the reader whose "Mapping" and "Mapping_Size" have been set}
+    \return 0 if the store is correct
+    \return -1 otherwise
+*/
+static int Check_Store (struct Store_Reader *reader)
+{
+    const unsigned char *file = reader->Mapping;
+    size_t size = reader->Mapping_Size;
+
+    if (size < sizeof (struct Store_Header) + sizeof (struct Store_Footer))
+        return -1;
+
+    reader->Header = (const struct Store_Header *)file;
+    reader->Footer = (const struct Store_Footer *)(file + size - sizeof (struct Store_Footer));
+
+    const struct Store_Header *header = reader->Header;
+    const struct Store_Footer *footer = reader->Footer;
+
+    if (memcmp (header->Magic, STORE_MAGIC, STORE_MAGIC_LENGTH) != 0 ||
+        memcmp (footer->Magic, STORE_MAGIC, STORE_MAGIC_LENGTH) != 0 ||
+        header->Block_Size == 0 || (header->Flags & ~(uint32_t)STORE_CLASSES_ONLY) != 0 ||
+        footer->Index_Offset < sizeof (struct Store_Header) || footer->Index_Offset % sizeof (uint64_t) != 0 ||
+        footer->Index_Offset > size - sizeof (struct Store_Footer) ||
+        footer->N_Blocks > (size - sizeof (struct Store_Footer) - footer->Index_Offset) / sizeof (struct Store_Block_Index) ||
+        footer->Index_Offset + footer->N_Blocks * sizeof (struct Store_Block_Index) + sizeof (struct Store_Footer) != size)
+        return -1;
+
+    reader->Index = (const struct Store_Block_Index *)(file + footer->Index_Offset);
+
+    const bool with_roots = (header->Flags & STORE_CLASSES_ONLY) == 0;
+    uint64_t offset = sizeof (struct Store_Header), n_equations = 0;
+
+    for (uint64_t n_block = 0; n_block < footer->N_Blocks; n_block++)
+    {
+        const struct Store_Block_Index *entry = &reader->Index[n_block];
+        uint64_t n_roots = with_roots ? (uint64_t)entry->Totals[One - Infinite] + entry->Totals[Two - Infinite] : 0;
+
+        if (entry->Offset != offset || entry->N_Equations == 0 || entry->N_Equations > header->Block_Size ||
+            (entry->N_Equations != header->Block_Size && n_block + 1 != footer->N_Blocks) || entry->N_Roots != n_roots ||
+            (uint64_t)entry->Totals[0] + entry->Totals[1] + entry->Totals[2] + entry->Totals[3] != entry->N_Equations)
+            return -1;
+
+        offset += Get_Classes_Size (entry->N_Equations) + 2 * n_roots * sizeof (double);
+        n_equations += entry->N_Equations;
+    }
+
+    return (offset == footer->Index_Offset && n_equations == footer->N_Equations) ? 0 : -1;
+}
+
+/**
+    \brief Maps a result store and checks it
+
+    \param [out] reader {Pointer on the reader}
+    \param [in] path {The name of the file}
+    \return 0 if the store can be read
+    \return -1 if the file cannot be mapped or is not a correct result store
+*/
+int Open_Store_Reader (struct Store_Reader *reader, const char *path)
+{
+    assert (reader != NULL);
+    assert (path != NULL);
+
+    *reader = (struct Store_Reader){0};
+
+    int fd = open (path, O_RDONLY);
+    if (fd == -1)
+        return -1;
+
+    struct stat info = {0};
+    if (fstat (fd, &info) == -1 || info.st_size <= 0)
+    {
+        close (fd);
+        return -1;
+    }
+
+    reader->Mapping_Size = (size_t)info.st_size;
+    reader->Mapping = mmap (NULL, reader->Mapping_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close (fd);
+
+    if (reader->Mapping == MAP_FAILED)
+    {
+        *reader = (struct Store_Reader){0};
+        return -1;
+    }
+
+    madvise (reader->Mapping, reader->Mapping_Size, MADV_SEQUENTIAL);
+
+    if (Check_Store (reader) != 0)
+    {
+        Close_Store_Reader (reader);
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+    \brief Unmaps a result store
+
+    \param [in] reader {Pointer on the reader}
+*/
+void Close_Store_Reader (struct Store_Reader *reader)
+{
+    assert (reader != NULL);
+
+    if (reader->Mapping != NULL)
+        munmap (reader->Mapping, reader->Mapping_Size);
+
+    *reader = (struct Store_Reader){0};
+}
+
+/**
+    \brief Finds the arrays of a block in the mapping
+
+    \param [in] reader {Pointer on the reader}
+    \param [in] n_block {The number of the block}
+    \param [out] block {Pointer on the block}
+    \return 0 if everything is OK
+    \return -1 if there is no such block
+*/
+int Get_Store_Block (const struct Store_Reader *reader, const size_t n_block, struct Store_Block *block)
+{
+    assert (reader != NULL);
+    assert (block  != NULL);
+
+    if (n_block >= reader->Footer->N_Blocks)
+        return -1;
+
+    const struct Store_Block_Index *entry = &reader->Index[n_block];
+    const unsigned char *classes = (const unsigned char *)reader->Mapping + entry->Offset;
+    const double *x_1 = (const double *)(classes + Get_Classes_Size (entry->N_Equations));
+    const bool with_roots = (reader->Header->Flags & STORE_CLASSES_ONLY) == 0;
+
+    block->Classes = classes;
+    block->X_1     = with_roots ? x_1 : NULL;
+    block->X_2     = with_roots ? x_1 + entry->N_Roots : NULL;
+    block->Entry   = entry;
+    block->First   = (uint64_t)n_block * reader->Header->Block_Size;
+
+    return 0;
+}
+
+/**
+    \brief Unpacks a block into arrays of the results of all its equations
+
+    \param [in] block {Pointer on the block}
+    \param [out] x_1 {Array for the first roots or NULL (NAN where there are none)}
+    \param [out] x_2 {Array for the second roots or NULL}
+    \param [out] n_roots {Array for the numbers of roots}
+*/
+void Decode_Store_Block (const struct Store_Block *block, double *x_1, double *x_2, enum N_Roots *n_roots)
+{
+    assert (block   != NULL);
+    assert (n_roots != NULL);
+
+    const size_t n_equations = block->Entry->N_Equations;
+    size_t n_root = 0;
+
+    for (size_t i = 0; i < n_equations; i++)
+    {
+        unsigned code = (block->Classes[i / 4] >> (2 * (i % 4))) & 3;
+        bool has_roots = (code >= One - Infinite) && block->X_1 != NULL;
+
+        n_roots[i] = (enum N_Roots)((int)code + Infinite);
+        if (x_1 != NULL)
+            x_1[i] = has_roots ? block->X_1[n_root] : NAN;
+        if (x_2 != NULL)
+            x_2[i] = has_roots ? block->X_2[n_root] : NAN;
+        n_root += has_roots;
+    }
+}
+
+/**
+    \brief Adds up the numbers of equations of every class from the block index
+
+    \param [in] reader {Pointer on the reader}
+    \param [out] totals {The numbers of equations with n_roots - Infinite = 0, 1, 2 and 3}
+*/
+void Get_Store_Totals (const struct Store_Reader *reader, size_t totals[4])
+{
+    assert (reader != NULL);
+    assert (totals != NULL);
+
+    for (int code = 0; code < 4; code++)
+        totals[code] = 0;
+
+    for (uint64_t n_block = 0; n_block < reader->Footer->N_Blocks; n_block++)
+        for (int code = 0; code < 4; code++)
+            totals[code] += reader->Index[n_block].Totals[code];
+}
+
+/**
+    \brief Checks if a number is in a range
+
+    \param [in] value {The number}
+    \param [in] range {The lower and the upper bound}
+    \return True if range[0] <= value <= range[1] (false for NAN)
+*/
+static inline bool Is_In_Range (const double value, const double range[2])
+{
+    return range[0] <= value && value <= range[1];
+}
+
+/**
+    \brief Checks if the columns of a block can have a number in a range
+
+    \param [in] min {The smallest number of the column}
+    \param [in] max {The largest number of the column}
+    \param [in] range {The lower and the upper bound}
+    \return False if the range and [min, max] do not overlap
+*/
+static inline bool Ranges_Overlap (const double min, const double max, const double range[2])
+{
+    return range[0] <= max && min <= range[1];
+}
+
+/**
+    \brief Checks if a block can have equations that meet the conditions of a query
+
+    Uses only the index entry: the numbers of equations of every class and the ranges of the columns.
+
+    \param [in] entry {Pointer on the index entry of the block}
+    \param [in] filter {Pointer on the conditions}
+    \return False if the block can be skipped
+*/
+bool Block_May_Match (const struct Store_Block_Index *entry, const struct Scan_Filter *filter)
+{
+    assert (entry  != NULL);
+    assert (filter != NULL);
+
+    if (filter->By_Class && entry->Totals[filter->Class - Infinite] == 0)
+        return false;
+    if (filter->By_X_1 && !Ranges_Overlap (entry->Min_X_1, entry->Max_X_1, filter->X_1_Range))
+        return false;
+    if (filter->By_X_2 && !Ranges_Overlap (entry->Min_X_2, entry->Max_X_2, filter->X_2_Range))
+        return false;
+    if (filter->By_Root && !Ranges_Overlap (entry->Min_X_1, entry->Max_X_1, filter->Root_Range) &&
+                           !Ranges_Overlap (entry->Min_X_2, entry->Max_X_2, filter->Root_Range))
+        return false;
+
+    return true;
+}
+
+/**
+    \brief Checks if an equation meets the conditions of a query
+
+    \param [in] filter {Pointer on the conditions}
+    \param [in] n_roots {The number of roots}
+    \param [in] x_1 {The first root or NAN}
+    \param [in] x_2 {The second root or NAN}
+    \return True if it does
+*/
+static inline bool Equation_Matches (const struct Scan_Filter *filter, const enum N_Roots n_roots, const double x_1, const double x_2)
+{
+    return (!filter->By_Class || n_roots == filter->Class) &&
+           (!filter->By_X_1 || Is_In_Range (x_1, filter->X_1_Range)) &&
+           (!filter->By_X_2 || Is_In_Range (x_2, filter->X_2_Range)) &&
+           (!filter->By_Root || Is_In_Range (x_1, filter->Root_Range) || Is_In_Range (x_2, filter->Root_Range));
+}
+
+/**
+    \brief Finds the equations of a result store that meet the conditions of a query
+
+    The blocks Block_May_Match () rejects are not read at all, so the time depends on the number of blocks
+             that can have matches rather than on the size of the store.
+
+    \param [in] reader {Pointer on the reader}
+    \param [in] filter {Pointer on the conditions}
+    \param [in,out] block {Arrays "X_1", "X_2" and "N_Roots" of at least "Block_Size" equations the blocks are unpacked into}
+    \param [in] write {The function that takes every match}
+    \param [in,out] sink {The first argument of "write"}
+    \param [out] n_read_blocks {Pointer on the number of blocks that have been unpacked or NULL}
+    \return 0 if everything is OK
+    \return -1 if "write" has failed
+*/
+int Query_Store (const struct Store_Reader *reader, const struct Scan_Filter *filter, struct Equation_Block *block,
+                 Match_Writer write, void *sink, size_t *n_read_blocks)
+{
+    assert (reader != NULL);
+    assert (filter != NULL);
+    assert (block  != NULL);
+    assert (write  != NULL);
+    assert (block->Capacity >= reader->Header->Block_Size);
+
+    struct Store_Block store_block = {0};
+    size_t n_read = 0;
+
+    for (size_t n_block = 0; Get_Store_Block (reader, n_block, &store_block) == 0; n_block++)
+    {
+        if (!Block_May_Match (store_block.Entry, filter))
+            continue;
+
+        size_t n_equations = store_block.Entry->N_Equations;
+        Decode_Store_Block (&store_block, block->X_1, block->X_2, block->N_Roots);
+        n_read++;
+
+        for (size_t i = 0; i < n_equations; i++)
+            if (Equation_Matches (filter, block->N_Roots[i], block->X_1[i], block->X_2[i]) &&
+                write (sink, store_block.First + i, block->N_Roots[i], block->X_1[i], block->X_2[i]) != 0)
+                return -1;
+    }
+
+    if (n_read_blocks != NULL)
+        *n_read_blocks = n_read;
+
+    return 0;
+}
+
+///The output of Run_Scan_Mode ()
+struct Scan_Sink
+{
+    struct Output_Buffer *Output;   ///< The buffer the lines go into
+    bool Numbered;                  ///< Write the number of the equation first
+    bool Counts_Only;               ///< Write only the number of roots
+    size_t Totals[4];               ///< The numbers of matches with n_roots - Infinite = 0, 1, 2 and 3
+};
+
+/**
+    \brief Writes a match as a line of text (a Match_Writer)
+
+    \param [in] sink {Pointer on struct Scan_Sink}
+    \param [in] number {The number of the equation}
+    \param [in] n_roots {The number of roots}
+    \param [in] x_1 {The first root}
+    \param [in] x_2 {The second root}
+    \return 0 if everything is OK
+    \return -1 if writing has failed
+*/
+static int Write_Scan_Line (void *sink, const uint64_t number, const enum N_Roots n_roots, const double x_1, const double x_2)
+{
+    struct Scan_Sink *scan = sink;
+    int status = 0;
+
+    if (scan->Numbered)
+        status |= Write_Equation_Number (scan->Output, number);
+
+    status |= scan->Counts_Only ? Write_Root_Count (scan->Output, n_roots) : Write_Result (scan->Output, n_roots, x_1, x_2);
+
+    return status;
+}
+
+/**
+    \brief Counts a match by its class (a Match_Writer)
+
+    \param [in] sink {Pointer on struct Scan_Sink}
+    \param [in] number {The number of the equation (not used)}
+    \param [in] n_roots {The number of roots}
+    \param [in] x_1 {The first root (not used)}
+    \param [in] x_2 {The second root (not used)}
+    \return 0
+*/
+static int Count_Scan_Match (void *sink, const uint64_t number, const enum N_Roots n_roots, const double x_1, const double x_2)
+{
+    (void)number;
+    (void)x_1;
+    (void)x_2;
+
+    ((struct Scan_Sink *)sink)->Totals[n_roots - Infinite]++;
+
+    return 0;
+}
+
+/**
+    \brief Writes the results of a result store as text or answers a query over them
+
+    Without conditions writes one line "n_roots x_1 x_2" per equation like in the stream mode (only the number
+             of roots if the store has only classes or "--classify" is given). With "--class", "--roots-in", "--x1-in"
+             or "--x2-in" only the matches are written, every line starts with the number of the equation,
+             and the number of blocks that have been read is printed to stderr.
+    With "--totals" only Write_Class_Totals () of the matches is written; without conditions on the roots
+             it is found from the block index without reading the blocks.
+
+    \param [in] options {Pointer on the settings, options->Input is the store}
+    \return 0 if everything has been written
+    \return 2 if the store cannot be read, the query needs roots the store does not have
+             or the output cannot be written
+*/
+int Run_Scan_Mode (const struct Options *options)
+{
+    assert (options != NULL);
+
+    const struct Scan_Filter *filter = &options->Filter;
+    const bool by_roots = filter->By_Root || filter->By_X_1 || filter->By_X_2;
+    const bool numbered = filter->By_Class || by_roots;
+
+    struct Store_Reader reader = {0};
+    if (Open_Store_Reader (&reader, options->Input) != 0)
+    {
+        fprintf (stderr, "Cannot read \"%s\" or it is not a result store\n", options->Input);
+        return 2;
+    }
+
+    const bool classes_only = (reader.Header->Flags & STORE_CLASSES_ONLY) != 0;
+    if (by_roots && classes_only)
+    {
+        fprintf (stderr, "\"%s\" has only the numbers of roots\n", options->Input);
+        Close_Store_Reader (&reader);
+        return 2;
+    }
+
+    FILE *stream = (strcmp (options->Output, "-") == 0) ? stdout : fopen (options->Output, "w");
+    struct Output_Buffer output = {0};
+    struct Equation_Block block = {0};
+    struct Scan_Sink sink = {&output, numbered, options->Classify || classes_only, {0}};
+    size_t n_read_blocks = 0;
+    int status = 0;
+
+    if (stream == NULL)
+    {
+        fprintf (stderr, "Cannot open \"%s\"\n", options->Output);
+        Close_Store_Reader (&reader);
+        return 2;
+    }
+
+    if (options->Totals && !by_roots)
+    {
+        Get_Store_Totals (&reader, sink.Totals);
+
+        for (int code = 0; code < 4 && filter->By_Class; code++)
+            if (code != filter->Class - Infinite)
+                sink.Totals[code] = 0;
+    }
+    else if ((!options->Totals && Init_Output_Buffer (&output, stream, options->Format, options->Digits) != 0) ||
+             Allocate_Equation_Block (&block, reader.Header->Block_Size) != 0)
+    {
+        fprintf (stderr, "Not enough memory\n");
+        if (stream != stdout)
+            fclose (stream);
+        Free_Output_Buffer (&output);
+        Free_Equation_Block (&block);
+        Close_Store_Reader (&reader);
+        return 2;
+    }
+    else
+    {
+        status = Query_Store (&reader, filter, &block, options->Totals ? Count_Scan_Match : Write_Scan_Line, &sink, &n_read_blocks);
+
+        if (!options->Totals)
+            status |= Flush_Output_Buffer (&output);
+        if (numbered || options->Totals)
+            fprintf (stderr, "scan: %zu of %llu blocks have been read\n",
+                     n_read_blocks, (unsigned long long)reader.Footer->N_Blocks);
+    }
+
+    if (options->Totals && status == 0)
+        status = Write_Class_Totals (stream, sink.Totals);
+
+    if (status != 0)
+        fprintf (stderr, "Cannot write to \"%s\"\n", options->Output);
+
+    if (stream != stdout)
+        status |= fclose (stream);
+    Free_Output_Buffer (&output);
+    Free_Equation_Block (&block);
+    Close_Store_Reader (&reader);
+
+    return (status == 0) ? 0 : 2;
+}
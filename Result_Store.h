@@ -0,0 +1,119 @@
+#ifndef RESULT_STORE_H_INCLUDED
+#define RESULT_STORE_H_INCLUDED
+
+#include "Command_Line.h"
+#include "Stream_Mode.h"
+
+#include <stdint.h>
+
+#define STORE_BLOCK_SIZE 65536      ///The number of equations in every block of a result store but the last one
+#define STORE_MAGIC "QRSTORE2"      ///The first and the last 8 bytes of a result store
+#define STORE_MAGIC_LENGTH 8        ///The length of STORE_MAGIC
+#define STORE_EXTENSION ".qrs"      ///Binary results are written as a result store if the output name ends with it
+#define STORE_CLASSES_ONLY 1        ///Flag of struct Store_Header: the blocks have no roots ("--classify")
+
+/*
+    Result store: a columnar file of solved equations that is written block by block and read by mapping it.
+
+        struct Store_Header
+        block 0, block 1, ...   every block has STORE_BLOCK_SIZE equations but the last one
+        struct Store_Block_Index for every block
+        struct Store_Footer
+
+    A block is the classes of its equations, 2 bits per equation (n_roots - Infinite, the first equation
+             in the lowest bits), padded to 8 bytes, followed by the column "x_1" and the column "x_2" of the equations
+             that have roots (One or Two) in their order. Equations with Zero or Infinite roots take only 2 bits;
+             their roots are read back as NAN.
+    The footer is written last, so the store can be written to a pipe; the index tells where every block starts,
+             how many equations of every class it has and the smallest and the largest numbers of its columns,
+             so a reader finds any block without reading the others and a query skips the blocks that cannot match.
+    All the numbers are in little-endian byte order.
+*/
+
+///The beginning of a result store
+struct Store_Header
+{
+    char Magic[STORE_MAGIC_LENGTH];     ///< STORE_MAGIC
+    uint32_t Block_Size;                ///< STORE_BLOCK_SIZE
+    uint32_t Flags;                     ///< STORE_CLASSES_ONLY or 0
+};
+
+///One entry of the block index
+struct Store_Block_Index
+{
+    uint64_t Offset;            ///< The position of the block in the file
+    uint32_t N_Equations;       ///< The number of equations in the block
+    uint32_t N_Roots;           ///< The number of values in each of the columns "x_1" and "x_2"
+    uint32_t Totals[4];         ///< The numbers of equations with n_roots - Infinite = 0, 1, 2 and 3
+    double Min_X_1;             ///< The smallest number of the column "x_1" (INFINITY if there are none but NAN)
+    double Max_X_1;             ///< The largest number of the column "x_1" (-INFINITY if there are none but NAN)
+    double Min_X_2;             ///< The same for the column "x_2"
+    double Max_X_2;             ///< The same for the column "x_2"
+};
+
+///The end of a result store
+struct Store_Footer
+{
+    uint64_t Index_Offset;      ///< The position of the block index in the file
+    uint64_t N_Blocks;          ///< The number of blocks
+    uint64_t N_Equations;       ///< The number of equations in all the blocks
+    char Magic[STORE_MAGIC_LENGTH];     ///< STORE_MAGIC
+};
+
+///A result store that is being written
+struct Store_Writer
+{
+    FILE *Stream;               ///< The output file or stdout
+    uint32_t Flags;             ///< The flags of the header
+    uint8_t *Classes;           ///< The classes of the current block, 2 bits per equation
+    double *X_1;                ///< The column "x_1" of the current block
+    double *X_2;                ///< The column "x_2" of the current block
+    struct Store_Block_Index Current;   ///< The index entry of the current block
+    struct Store_Block_Index *Index;    ///< The index entries of the blocks that have been written
+    size_t N_Blocks;            ///< The number of entries in "Index"
+    size_t Index_Capacity;      ///< The size of "Index"
+    uint64_t Offset;            ///< The number of bytes that have been written
+    uint64_t N_Equations;       ///< The number of equations that have been written
+};
+
+///A block of a mapped result store
+struct Store_Block
+{
+    const uint8_t *Classes;     ///< The classes of the equations, 2 bits per equation
+    const double *X_1;          ///< The column "x_1"
+    const double *X_2;          ///< The column "x_2"
+    const struct Store_Block_Index *Entry;  ///< The index entry of the block
+    uint64_t First;             ///< The number of the first equation of the block in the store
+};
+
+///A result store mapped into memory
+struct Store_Reader
+{
+    void *Mapping;              ///< The beginning of the mapping
+    size_t Mapping_Size;        ///< The size of the file
+    const struct Store_Header *Header;      ///< The header of the store
+    const struct Store_Block_Index *Index;  ///< The block index
+    const struct Store_Footer *Footer;      ///< The footer of the store
+};
+
+///Takes one equation that meets the conditions of a query; returns 0 if everything is OK
+typedef int (*Match_Writer) (void *sink, const uint64_t number, const enum N_Roots n_roots, const double x_1, const double x_2);
+
+bool Is_Store_Name (const char *path);
+int  Open_Store_Writer (struct Store_Writer *writer, const char *path, const bool classes_only);
+int  Write_Store_Chunk (void *writer, const double *x_1, const double *x_2, const enum N_Roots *n_roots,
+                        const size_t n_equations);
+int  Close_Store_Writer (struct Store_Writer *writer);
+int  Open_Store_Reader (struct Store_Reader *reader, const char *path);
+void Close_Store_Reader (struct Store_Reader *reader);
+int  Get_Store_Block (const struct Store_Reader *reader, const size_t n_block, struct Store_Block *block);
+void Decode_Store_Block (const struct Store_Block *block, double *x_1, double *x_2, enum N_Roots *n_roots);
+void Get_Store_Totals (const struct Store_Reader *reader, size_t totals[4]);
+bool Block_May_Match (const struct Store_Block_Index *entry, const struct Scan_Filter *filter);
+int  Query_Store (const struct Store_Reader *reader, const struct Scan_Filter *filter, struct Equation_Block *block,
+                  Match_Writer write, void *sink, size_t *n_read_blocks);
+int  Run_Scan_Mode (const struct Options *options);
+int  Store_Unit_Test (void);
+int  Query_Unit_Test (void);
+
+#endif
@@ -0,0 +1,355 @@
+#include "Root_Cache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define EMPTY_KEY UINT64_MAX        ///Key[0] of a free entry (a NAN that is never looked for)
+#define MAX_CACHED_EXPONENT 250     ///Only coefficients with binary exponents within +-this value are cached
+#define EXPONENT_BIAS 1023          ///The bias of the exponent of the "double" type
+
+/*
+    Triples are normalized by a power of two: the leading coefficient ("a", or "b" for linear equations)
+    gets an exponent of 0. While every coefficient keeps its exponent within +-MAX_CACHED_EXPONENT,
+    neither the original nor the normalized triple overflows or loses bits to subnormal numbers,
+    so the roots of both of them are the same bit for bit. Other multiples, such as (3, -9, 6) and (1, -3, 2),
+    are not merged because their roots may differ in the last bit.
+    The number of roots is always found from the original coefficients, because Compare_Double ()
+    compares with an absolute EPSILON; the cache only saves the square root and the divisions.
+*/
+
+/**
+    \brief Gets the bits of a number of the "double" type
+
+    \param [in] value {The number}
+    \return The bits of the number
+*/
+static uint64_t Get_Bits (const double value)
+{
+    uint64_t bits = 0;
+    memcpy (&bits, &value, sizeof (bits));
+
+    return bits;
+}
+
+/**
+    \brief Gets the binary exponent of a number of the "double" type
+
+    \param [in] value {The number}
+    \return The unbiased exponent (-1023 for 0 and subnormal numbers, 1024 for infinity and NAN)
+*/
+static int Get_Exponent (const double value)
+{
+    return (int)((Get_Bits (value) >> 52) & 0x7FF) - EXPONENT_BIAS;
+}
+
+/**
+    \brief Checks if a coefficient can be normalized without changing the roots
+
+    \param [in] value {The coefficient}
+    \return True if the coefficient is 0 or its exponent is within +-MAX_CACHED_EXPONENT
+*/
+static bool Is_Cacheable (const double value)
+{
+    int exponent = Get_Exponent (value);
+
+    return value == 0.0 || (exponent >= -MAX_CACHED_EXPONENT && exponent <= MAX_CACHED_EXPONENT);
+}
+
+/**
+    \brief Finds the power of two that gives a number an exponent of 0
+
+    \param [in] value {A number that has passed Is_Cacheable () and is not 0}
+    \return 2^-exponent
+*/
+static double Get_Scale (const double value)
+{
+    uint64_t bits = (uint64_t)(EXPONENT_BIAS - Get_Exponent (value)) << 52;
+    double scale = 0.0;
+    memcpy (&scale, &bits, sizeof (scale));
+
+    return scale;
+}
+
+/**
+    \brief Finds the index of an integer coefficient in the small table
+
+    \param [in] value {The coefficient}
+    \param [out] index {Pointer on the variable in which the function puts the index}
+    \return True if the coefficient is an integer from -SMALL_COEFF_RANGE to SMALL_COEFF_RANGE (but not -0.0)
+*/
+static bool Get_Small_Index (const double value, int *index)
+{
+    if (!(fabs (value) <= SMALL_COEFF_RANGE))
+        return false;
+
+    int integer = (int)value;
+
+    if ((double)integer != value || (integer == 0 && signbit (value)))
+        return false;
+
+    *index = integer + SMALL_COEFF_RANGE;
+    return true;
+}
+
+/**
+    \brief Finds the entry of a normalized triple
+
+    \param [in] cache {Pointer on the cache}
+    \param [in] key {Bits of the normalized triple}
+    \param [out] hit {Pointer on the variable that shows if the entry holds this triple}
+    \return Pointer on the entry the triple is or should be kept in
+*/
+static struct Cache_Entry *Find_Entry (struct Root_Cache *cache, const uint64_t key[3], bool *hit)
+{
+    uint64_t hash = key[0] * 0x9E3779B97F4A7C15ULL;
+    hash = (hash ^ key[1] ^ (hash >> 29)) * 0xBF58476D1CE4E5B9ULL;
+    hash = (hash ^ key[2] ^ (hash >> 31)) * 0x94D049BB133111EBULL;
+
+    struct Cache_Entry *entry = &cache->Entries[(hash ^ (hash >> 32)) & cache->Mask];
+
+    cache->N_Lookups++;
+    *hit = entry->Key[0] == key[0] && entry->Key[1] == key[1] && entry->Key[2] == key[2];
+    if (*hit)
+        cache->N_Hits++;
+
+    return entry;
+}
+
+/**
+    \brief Allocates a cache
+
+    \param [out] cache {Pointer on the cache}
+    \param [in] n_entries {The number of normalized triples the cache keeps, it is rounded up to a power of two}
+    \param [in] small_table {True if all equations with small integer coefficients should be solved in advance}
+    \return 0 if the cache has been allocated
+    \return -1 if there is not enough memory
+*/
+int Init_Root_Cache (struct Root_Cache *cache, const size_t n_entries, const bool small_table)
+{
+    if (cache == NULL)
+        return -1;
+
+    size_t capacity = 1;
+    while (capacity < n_entries)
+        capacity *= 2;
+
+    cache->Entries      = malloc (capacity * sizeof (struct Cache_Entry));
+    cache->Mask         = capacity - 1;
+    cache->Small_Table  = small_table ? malloc (SMALL_TABLE_SIDE * SMALL_TABLE_SIDE * SMALL_TABLE_SIDE * sizeof (struct Small_Entry)) : NULL;
+    cache->N_Lookups    = 0;
+    cache->N_Hits       = 0;
+    cache->N_Small_Hits = 0;
+
+    if (cache->Entries == NULL || (small_table && cache->Small_Table == NULL))
+    {
+        Free_Root_Cache (cache);
+        return -1;
+    }
+
+    for (size_t i = 0; i < capacity; i++)
+        cache->Entries[i].Key[0] = EMPTY_KEY;
+
+    if (small_table)
+        for (int i = 0; i < SMALL_TABLE_SIDE * SMALL_TABLE_SIDE * SMALL_TABLE_SIDE; i++)
+        {
+            struct Small_Entry *entry = &cache->Small_Table[i];
+
+            entry->X_1 = NAN;
+            entry->X_2 = NAN;
+            entry->N_Roots = Get_Number_Of_Roots_And_Solve_Equation (i / (SMALL_TABLE_SIDE * SMALL_TABLE_SIDE) - SMALL_COEFF_RANGE,
+                                                                     i / SMALL_TABLE_SIDE % SMALL_TABLE_SIDE - SMALL_COEFF_RANGE,
+                                                                     i % SMALL_TABLE_SIDE - SMALL_COEFF_RANGE,
+                                                                     &entry->X_1, &entry->X_2);
+        }
+
+    return 0;
+}
+
+/**
+    \brief Frees a cache
+
+    \param [in] cache {Pointer on the cache}
+*/
+void Free_Root_Cache (struct Root_Cache *cache)
+{
+    if (cache == NULL)
+        return;
+
+    free (cache->Entries);
+    free (cache->Small_Table);
+    cache->Entries = NULL;
+    cache->Small_Table = NULL;
+}
+
+/**
+    \brief Solves an equation with the roots of the same normalized triple if they are in the cache
+
+    The results are the same as the ones of Get_Number_Of_Roots_And_Solve_Equation () bit for bit,
+             root-variables that do not get a value keep their values.
+    Calls Get_Number_Of_Roots_And_Solve_Equation () if "cache" is NULL.
+
+    \param [in,out] cache {Pointer on the cache}
+    \param [in] a {Quadratic coefficient}
+    \param [in] b {Linear coefficient}
+    \param [in] c {Free term}
+    \param [out] *first_root {Pointer on the variable that contains the value of the first root (may be NULL)}
+    \param [out] *second_root {Pointer on the variable that contains the value of the second root (may be NULL)}
+    \return The number of roots like Get_Number_Of_Roots_And_Solve_Equation ()
+*/
+enum N_Roots Solve_Equation_Cached (struct Root_Cache *cache, const double a, const double b, const double c,
+                                    double *first_root, double *second_root)
+{
+    if (cache == NULL)
+        return Get_Number_Of_Roots_And_Solve_Equation (a, b, c, first_root, second_root);
+
+    int i_a = 0, i_b = 0, i_c = 0;
+
+    if (cache->Small_Table != NULL && Get_Small_Index (a, &i_a) && Get_Small_Index (b, &i_b) && Get_Small_Index (c, &i_c))
+    {
+        const struct Small_Entry *entry = &cache->Small_Table[(i_a * SMALL_TABLE_SIDE + i_b) * SMALL_TABLE_SIDE + i_c];
+
+        cache->N_Lookups++;
+        cache->N_Small_Hits++;
+
+        if (i_a == SMALL_COEFF_RANGE)
+            STATS_ADD (N_Linear, 1);
+        else if (entry->N_Roots == One)
+            STATS_ADD (N_Near_Degenerate, 1);
+
+        if (entry->N_Roots >= One)
+        {
+            if (first_root != NULL)
+                *first_root = entry->X_1;
+            if (second_root != NULL && i_a != SMALL_COEFF_RANGE)
+                *second_root = entry->X_2;
+        }
+
+        return STATS_ROOTS (entry->N_Roots);
+    }
+
+    bool hit = false;
+
+    if (Compare_Double (a, 0.0) == Equal)
+    {
+        if (Compare_Double (b, 0.0) == Equal)
+            return Solve_Linear_Equation (b, c, first_root);
+        if (!Is_Cacheable (b) || !Is_Cacheable (c))
+            return Solve_Linear_Equation (b, c, first_root);
+
+        double scale = Get_Scale (b);
+        double b_norm = b * scale, c_norm = c * scale;
+        const uint64_t key[3] = {0, Get_Bits (b_norm), Get_Bits (c_norm)};
+        struct Cache_Entry *entry = Find_Entry (cache, key, &hit);
+
+        if (!hit)
+        {
+            memcpy (entry->Key, key, sizeof (key));
+            entry->X_1 = -c_norm / b_norm;
+            entry->X_2 = NAN;
+        }
+        if (first_root != NULL)
+            *first_root = entry->X_1;
+
+        return STATS_ADD (N_Linear, 1), STATS_ROOTS (One);
+    }
+
+    double D = Calc_Discriminant (a, b, c);
+
+    if (Compare_Double (D, 0.0) == Less)
+        return STATS_ROOTS (Zero);
+
+    enum N_Roots n_roots = (Compare_Double (D, 0.0) == Equal) ? One : Two;
+
+    if (n_roots == One)
+        STATS_ADD (N_Near_Degenerate, 1);
+    (void)STATS_ROOTS (n_roots);
+
+    if (!Is_Cacheable (a) || !Is_Cacheable (b) || !Is_Cacheable (c))
+    {
+        Calc_Roots_Of_Quadratic_Equation (a, b, sqrt ((D < 0.0) ? 0.0 : D), first_root, second_root);
+        return n_roots;
+    }
+
+    double scale = Get_Scale (a);
+    double a_norm = a * scale, b_norm = b * scale, c_norm = c * scale;
+    const uint64_t key[3] = {Get_Bits (a_norm), Get_Bits (b_norm), Get_Bits (c_norm)};
+    struct Cache_Entry *entry = Find_Entry (cache, key, &hit);
+
+    if (!hit)
+    {
+        double D_norm = Calc_Discriminant (a_norm, b_norm, c_norm);
+
+        memcpy (entry->Key, key, sizeof (key));
+        Calc_Roots_Of_Quadratic_Equation (a_norm, b_norm, sqrt ((D_norm < 0.0) ? 0.0 : D_norm), &entry->X_1, &entry->X_2);
+    }
+    if (first_root != NULL)
+        *first_root = entry->X_1;
+    if (second_root != NULL)
+        *second_root = entry->X_2;
+
+    return n_roots;
+}
+
+/**
+    \brief Solves a batch of equations stored as structure of arrays with a cache
+
+    Calls Solve_Equation_Cached () for every triple, so the results are the same as the ones of Solve_Batch ().
+    Nothing is solved if an array of coefficients or the array for the numbers of roots is NULL;
+             the arrays for the roots may be NULL if the roots are not needed.
+
+    \param [in,out] cache {Pointer on the cache}
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] x_1 {Array for the first roots}
+    \param [out] x_2 {Array for the second roots}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+void Solve_Batch_Cached (struct Root_Cache *cache, const double *a, const double *b, const double *c,
+                         double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (a == NULL || b == NULL || c == NULL || n_roots == NULL)
+        return;
+
+    for (size_t i = 0; i < n_equations; i++)
+    {
+        double first_root = NAN, second_root = NAN;
+
+        n_roots[i] = Solve_Equation_Cached (cache, a[i], b[i], c[i], &first_root, &second_root);
+
+        if (x_1 != NULL)
+            x_1[i] = first_root;
+        if (x_2 != NULL)
+            x_2[i] = second_root;
+    }
+}
+
+/**
+    \brief Finds the share of lookups that have not needed a square root or a division
+
+    \param [in] cache {Pointer on the cache}
+    \return Hits of the cache and of the small table divided by the number of lookups (0 if there are none)
+*/
+double Get_Cache_Hit_Rate (const struct Root_Cache *cache)
+{
+    if (cache == NULL || cache->N_Lookups == 0)
+        return 0.0;
+
+    return (double)(cache->N_Hits + cache->N_Small_Hits) / (double)cache->N_Lookups;
+}
+
+/**
+    \brief Prints the counters of a cache
+
+    \param [in] stream {The stream the counters are printed to}
+    \param [in] cache {Pointer on the cache}
+*/
+void Print_Cache_Statistics (FILE *stream, const struct Root_Cache *cache)
+{
+    if (stream == NULL || cache == NULL)
+        return;
+
+    fprintf (stream, "cache: %zu lookups, %zu hits (%.2f%%), %zu of them in the table of small coefficients\n",
+             cache->N_Lookups, cache->N_Hits + cache->N_Small_Hits, 100.0 * Get_Cache_Hit_Rate (cache), cache->N_Small_Hits);
+}
@@ -0,0 +1,50 @@
+#ifndef ROOT_CACHE_H_INCLUDED
+#define ROOT_CACHE_H_INCLUDED
+
+#include "Quadratic_Solver.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SMALL_COEFF_RANGE 10    ///Equations with integer coefficients from -SMALL_COEFF_RANGE to SMALL_COEFF_RANGE are solved in advance
+#define SMALL_TABLE_SIDE (2 * SMALL_COEFF_RANGE + 1)    ///The number of values of one coefficient in the small table
+
+///Roots of one normalized triple
+struct Cache_Entry
+{
+    uint64_t Key[3];    ///< Bits of the normalized "a", "b" and "c" (Key[0] is EMPTY_KEY in a free entry)
+    double X_1;         ///< The first root
+    double X_2;         ///< The second root
+};
+
+///Result of one equation of the small table
+struct Small_Entry
+{
+    double X_1;         ///< The first root or NAN
+    double X_2;         ///< The second root or NAN
+    enum N_Roots N_Roots;   ///< The number of roots
+};
+
+///Bounded cache of roots; one cache should be used by one thread at a time
+struct Root_Cache
+{
+    struct Cache_Entry *Entries;    ///< Direct-mapped table of normalized triples
+    size_t Mask;                    ///< The number of entries minus 1
+    struct Small_Entry *Small_Table;    ///< SMALL_TABLE_SIDE^3 results or NULL
+    size_t N_Lookups;       ///< Equations with roots whose roots have been looked for
+    size_t N_Hits;          ///< Equations whose roots have been found in "Entries"
+    size_t N_Small_Hits;    ///< Equations whose results have been found in "Small_Table"
+};
+
+int  Init_Root_Cache (struct Root_Cache *cache, const size_t n_entries, const bool small_table);
+void Free_Root_Cache (struct Root_Cache *cache);
+enum N_Roots Solve_Equation_Cached (struct Root_Cache *cache, const double a, const double b, const double c,
+                                    double *first_root, double *second_root);
+void Solve_Batch_Cached (struct Root_Cache *cache, const double *a, const double *b, const double *c,
+                         double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations);
+double Get_Cache_Hit_Rate (const struct Root_Cache *cache);
+void Print_Cache_Statistics (FILE *stream, const struct Root_Cache *cache);
+int  Cache_Unit_Test (void);
+
+#endif
@@ -0,0 +1,683 @@
+#include "Root_Formatter.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#define MAX_FAST_FIXED_DIGITS 22    ///m * 10^digits fits in 128 bits for any 53-bit m
+#define MAX_SHORTEST_DIGITS 17      ///Any "double" is read back exactly from 17 significant digits
+#define MAX_SCALE_POWER 27          ///5^27 is the greatest power of 5 that fits in 64 bits
+
+typedef unsigned __int128 uint128_t;
+
+///A number of the "double" type split into m * 2^e
+struct Double_Parts
+{
+    uint64_t Mantissa;  ///< m (53 bits, the hidden one included, for normal numbers)
+    int Exponent;       ///< e
+    bool Negative;      ///< The sign
+    bool Lower_Closer;  ///< True if m is a power of 2, so the previous "double" is closer than the next one
+};
+
+///A number multiplied by a power of 10: Integer + Remainder / Denominator
+struct Scaled_Number
+{
+    uint64_t  Integer;      ///< The integer part
+    uint128_t Remainder;    ///< The numerator of the fraction
+    uint128_t Denominator;  ///< The denominator of the fraction (a power of 2 or 10)
+};
+
+///Powers of 5 from 5^0 to 5^MAX_SCALE_POWER
+static const uint64_t Powers_Of_5[MAX_SCALE_POWER + 1] =
+{
+    1ULL, 5ULL, 25ULL, 125ULL, 625ULL, 3125ULL, 15625ULL, 78125ULL, 390625ULL, 1953125ULL,
+    9765625ULL, 48828125ULL, 244140625ULL, 1220703125ULL, 6103515625ULL, 30517578125ULL,
+    152587890625ULL, 762939453125ULL, 3814697265625ULL, 19073486328125ULL, 95367431640625ULL,
+    476837158203125ULL, 2384185791015625ULL, 11920928955078125ULL, 59604644775390625ULL,
+    298023223876953125ULL, 1490116119384765625ULL, 7450580596923828125ULL
+};
+
+/**
+    \brief Splits a finite number of the "double" type into its mantissa and exponent
+
+    \param [in] value {The number}
+    \return The mantissa, the exponent and the sign
+*/
+static struct Double_Parts Split_Double (const double value)
+{
+    uint64_t bits = 0;
+    memcpy (&bits, &value, sizeof (bits));
+
+    uint64_t fraction = bits & ((1ULL << 52) - 1);
+    int biased_exponent = (int)((bits >> 52) & 0x7FF);
+    struct Double_Parts parts = {fraction, -1074, (bits >> 63) != 0, false};
+
+    if (biased_exponent != 0)
+    {
+        parts.Mantissa     = fraction | (1ULL << 52);
+        parts.Exponent     = biased_exponent - 1075;
+        parts.Lower_Closer = (fraction == 0 && biased_exponent > 1);
+    }
+
+    return parts;
+}
+
+/**
+    \brief Returns the number of significant bits of a 128-bit number
+
+    \param [in] number {The number}
+    \return The number of bits (0 for 0)
+*/
+static int Bit_Length (const uint128_t number)
+{
+    uint64_t high = (uint64_t)(number >> 64);
+
+    if (high != 0)
+        return 128 - __builtin_clzll (high);
+    else if ((uint64_t)number != 0)
+        return 64 - __builtin_clzll ((uint64_t)number);
+    else
+        return 0;
+}
+
+/**
+    \brief Returns 10^power as a 128-bit number
+
+    \param [in] power {The power, from 0 to 38}
+    \return 10^power
+*/
+static uint128_t Power_Of_10 (int power)
+{
+    uint128_t result = 1;
+
+    while (power-- > 0)
+        result *= 10;
+
+    return result;
+}
+
+/**
+    \brief Writes decimal digits of a 128-bit number
+
+    \param [out] dest {Pointer on the first symbol}
+    \param [in] number {The number}
+    \param [in] min_digits {The minimal number of digits, the number is padded with leading zeros}
+    \return The number of symbols that have been written
+*/
+static size_t Write_Integer (char *dest, uint128_t number, const int min_digits)
+{
+    char digits[48] = "";
+    int n_digits = 0;
+
+    while (number > UINT64_MAX)
+    {
+        digits[n_digits++] = (char)('0' + (int)(number % 10));
+        number /= 10;
+    }
+    for (uint64_t small = (uint64_t)number; small != 0; small /= 10)
+        digits[n_digits++] = (char)('0' + (int)(small % 10));
+    while (n_digits < min_digits)
+        digits[n_digits++] = '0';
+
+    for (int i = 0; i < n_digits; i++)
+        dest[i] = digits[n_digits - 1 - i];
+
+    return (size_t)n_digits;
+}
+
+/**
+    \brief Writes "nan", "inf" or their negative versions the way printf () does
+
+    \param [out] dest {Array of at least 5 symbols}
+    \param [in] value {NAN or an infinite number}
+    \return The number of symbols that have been written
+*/
+static size_t Write_Not_Finite (char *dest, const double value)
+{
+    const char *string = isnan (value) ? (signbit (value) ? "-nan" : "nan")
+                                       : (signbit (value) ? "-inf" : "inf");
+    size_t length = strlen (string);
+
+    memcpy (dest, string, length + 1);
+
+    return length;
+}
+
+/**
+    \brief Writes a number with a certain number of digits after the decimal point
+
+    The result is the same as the one of printf ("%.*f", digits, value): the exact value of the number
+             is rounded to the nearest, ties to even.
+    If "digits" is at most MAX_FAST_FIXED_DIGITS and the number is less than about 2^70, the rounding is done
+             with 128-bit integers: m * 10^digits / 2^(-e). Otherwise snprintf () is called.
+
+    \param [out] dest {Array of at least FIXED_LENGTH (digits) symbols}
+    \param [in] value {The number}
+    \param [in] digits {The number of digits after the decimal point}
+    \return The number of symbols that have been written (the terminating '\\0' is written but not counted)
+*/
+size_t Format_Fixed (char *dest, const double value, const int digits)
+{
+    assert (dest != NULL);
+    assert (digits >= 0);
+
+    if (!isfinite (value))
+        return Write_Not_Finite (dest, value);
+
+    struct Double_Parts parts = Split_Double (value);
+    uint128_t scaled = (uint128_t)parts.Mantissa * Power_Of_10 (digits <= MAX_FAST_FIXED_DIGITS ? digits : 0);
+
+    if (digits > MAX_FAST_FIXED_DIGITS || (parts.Exponent > 0 && Bit_Length (scaled) + parts.Exponent > 127))
+        return (size_t)snprintf (dest, FIXED_LENGTH (digits), "%.*f", digits, value);
+
+    if (parts.Exponent >= 0)
+        scaled <<= parts.Exponent;
+    else if (parts.Exponent <= -128)
+        scaled = 0;
+    else
+    {
+        int shift = -parts.Exponent;
+        uint128_t remainder = scaled & (((uint128_t)1 << shift) - 1);
+        uint128_t half = (uint128_t)1 << (shift - 1);
+
+        scaled >>= shift;
+        if (remainder > half || (remainder == half && (scaled & 1)))
+            scaled++;
+    }
+
+    char *symbol = dest;
+
+    if (parts.Negative)
+        *symbol++ = '-';
+
+    size_t length = Write_Integer (symbol, scaled, digits + 1);
+
+    if (digits > 0)
+    {
+        memmove (symbol + length - digits + 1, symbol + length - digits, (size_t)digits);
+        symbol[length - digits] = '.';
+        length++;
+    }
+
+    symbol += length;
+    *symbol = '\0';
+
+    return (size_t)(symbol - dest);
+}
+
+/**
+    \brief Multiplies x * 2^e by 10^q exactly
+
+    \param [in] x {The mantissa}
+    \param [in] e {The binary exponent}
+    \param [in] q {The decimal exponent, at most MAX_SCALE_POWER}
+    \param [out] scaled {Pointer on the structure in which the function puts the integer part and the fraction}
+    \return False if the integer part does not fit in 64 bits or the numbers do not fit in 128 bits
+    \return True otherwise
+*/
+static bool Scale_By_Power_Of_10 (const uint64_t x, const int e, const int q, struct Scaled_Number *scaled)
+{
+    uint128_t numerator = 0;
+
+    if (q >= 0)
+    {
+        numerator = (uint128_t)x * Powers_Of_5[q];
+
+        int shift = e + q;
+
+        if (shift >= 0)
+        {
+            if (Bit_Length (numerator) + shift > 64)
+                return false;
+            scaled->Integer     = (uint64_t)(numerator << shift);
+            scaled->Remainder   = 0;
+            scaled->Denominator = 1;
+            return true;
+        }
+        if (-shift > 127 || (numerator >> -shift) > UINT64_MAX)
+            return false;
+
+        scaled->Denominator = (uint128_t)1 << -shift;
+        scaled->Integer     = (uint64_t)(numerator >> -shift);
+        scaled->Remainder   = numerator & (scaled->Denominator - 1);
+        return true;
+    }
+
+    if (e < 0 || Bit_Length (x) + e > 127 || -q > 38)
+        return false;
+
+    numerator = (uint128_t)x << e;
+    scaled->Denominator = Power_Of_10 (-q);
+
+    uint128_t integer = numerator / scaled->Denominator;
+
+    if (integer > UINT64_MAX)
+        return false;
+
+    scaled->Integer   = (uint64_t)integer;
+    scaled->Remainder = numerator % scaled->Denominator;
+
+    return true;
+}
+
+/**
+    \brief Finds the shortest digits that are read back as the same number with integer arithmetic
+
+    The number and the bounds of the interval of numbers that are read back as it are multiplied by 10^q,
+             so that they have 17-19 digits before the decimal point, and rounded inwards to integers L and H.
+    Then L and H are divided by 10 while there is still an integer between them:
+             the remaining digits are the shortest ones, and the number closest to the exact value is taken.
+
+    \param [in] parts {The number split by Split_Double ()}
+    \param [out] digits {Array of at least MAX_SHORTEST_DIGITS symbols}
+    \param [out] n_digits {Pointer on the variable in which the function puts the number of digits}
+    \param [out] exponent {Pointer on the variable in which the function puts k: value = 0.d1d2d3... * 10^k}
+    \return False if the number is too small or too big for 128-bit integers
+    \return True otherwise
+*/
+static bool Shortest_Digits_Fast (const struct Double_Parts parts, char *digits, int *n_digits, int *exponent)
+{
+    uint64_t middle = parts.Mantissa << (parts.Lower_Closer ? 2 : 1);
+    uint64_t upper_gap = parts.Lower_Closer ? 2 : 1;
+    int e = parts.Exponent - (parts.Lower_Closer ? 2 : 1);
+
+    int k = (int)floor ((parts.Exponent + 63 - __builtin_clzll (parts.Mantissa)) * 0.30102999566398120);
+    int q = MAX_SHORTEST_DIGITS - k;
+
+    struct Scaled_Number lower = {0}, value = {0}, upper = {0};
+
+    if (q > MAX_SCALE_POWER ||
+        !Scale_By_Power_Of_10 (middle - 1,         e, q, &lower) ||
+        !Scale_By_Power_Of_10 (middle,             e, q, &value) ||
+        !Scale_By_Power_Of_10 (middle + upper_gap, e, q, &upper))
+        return false;
+
+    bool even = (parts.Mantissa & 1) == 0;
+    uint64_t low  = lower.Integer + ((lower.Remainder != 0 || !even) ? 1 : 0);
+    uint64_t high = upper.Integer - ((upper.Remainder == 0 && !even) ? 1 : 0);
+    uint64_t power = 1;
+    int n_removed = 0;
+
+    for (;;)
+    {
+        uint64_t next_low = (low + 9) / 10, next_high = high / 10;
+
+        if (next_low > next_high)
+            break;
+
+        low  = next_low;
+        high = next_high;
+        power *= 10;
+        n_removed++;
+    }
+
+    uint64_t candidate = value.Integer / power;
+    uint64_t dropped   = value.Integer % power;
+    bool round_up = false;
+
+    if (n_removed == 0)
+        round_up = 2 * value.Remainder > value.Denominator ||
+                  (2 * value.Remainder == value.Denominator && (candidate & 1));
+    else
+        round_up = 2 * dropped > power ||
+                  (2 * dropped == power && (value.Remainder != 0 || (candidate & 1)));
+
+    candidate += round_up ? 1 : 0;
+    if (candidate < low)
+        candidate = low;
+    if (candidate > high)
+        candidate = high;
+
+    char reversed[24] = "";
+    int length = 0;
+
+    for (; candidate != 0; candidate /= 10)
+        reversed[length++] = (char)('0' + (int)(candidate % 10));
+
+    if (length > MAX_SHORTEST_DIGITS)
+        return false;
+
+    for (int i = 0; i < length; i++)
+        digits[i] = reversed[length - 1 - i];
+
+    *n_digits = length;
+    *exponent = length + n_removed - q;
+
+    return true;
+}
+
+/**
+    \brief Finds the shortest digits that are read back as the same number with snprintf () and strtod ()
+
+    Tries 1, 2, ..., 17 significant digits until the number is read back exactly.
+
+    \param [in] value {The number, positive and finite}
+    \param [out] digits {Array of at least MAX_SHORTEST_DIGITS symbols}
+    \param [out] n_digits {Pointer on the variable in which the function puts the number of digits}
+    \param [out] exponent {Pointer on the variable in which the function puts k: value = 0.d1d2d3... * 10^k}
+*/
+static void Shortest_Digits_Slow (const double value, char *digits, int *n_digits, int *exponent)
+{
+    char string[MAX_SHORTEST_LENGTH] = "";
+
+    for (int precision = 1; precision <= MAX_SHORTEST_DIGITS; precision++)
+    {
+        snprintf (string, sizeof (string), "%.*e", precision - 1, value);
+        if (strtod (string, NULL) == value)
+            break;
+    }
+
+    const char *symbol = string;
+
+    *n_digits = 0;
+    for (; *symbol != 'e'; symbol++)
+        if (isdigit ((unsigned char)*symbol))
+            digits[(*n_digits)++] = *symbol;
+
+    *exponent = atoi (symbol + 1) + 1;
+
+    while (*n_digits > 1 && digits[*n_digits - 1] == '0')
+        (*n_digits)--;
+}
+
+/**
+    \brief Writes the shortest number that is read back as the same "double"
+
+    Calls Shortest_Digits_Fast (), and Shortest_Digits_Slow () for numbers that are too big or too small for it.
+    The number is written without an exponent if 1e-4 <= |value| < 1e17 and in the form "d.ddde+XX" otherwise,
+             the way "%.17g" does.
+
+    \param [out] dest {Array of at least MAX_SHORTEST_LENGTH symbols}
+    \param [in] value {The number}
+    \return The number of symbols that have been written (the terminating '\\0' is written but not counted)
+*/
+size_t Format_Shortest (char *dest, const double value)
+{
+    assert (dest != NULL);
+
+    if (!isfinite (value))
+        return Write_Not_Finite (dest, value);
+
+    char *symbol = dest;
+
+    if (signbit (value))
+        *symbol++ = '-';
+
+    if (value == 0.0)
+    {
+        *symbol++ = '0';
+        *symbol = '\0';
+        return (size_t)(symbol - dest);
+    }
+
+    char digits[MAX_SHORTEST_DIGITS] = "";
+    int n_digits = 0, k = 0;
+
+    if (!Shortest_Digits_Fast (Split_Double (value), digits, &n_digits, &k))
+        Shortest_Digits_Slow (fabs (value), digits, &n_digits, &k);
+
+    int sci_exponent = k - 1;
+
+    if (sci_exponent >= -4 && sci_exponent < MAX_SHORTEST_DIGITS)
+    {
+        if (k <= 0)
+        {
+            *symbol++ = '0';
+            *symbol++ = '.';
+            for (int i = 0; i < -k; i++)
+                *symbol++ = '0';
+            memcpy (symbol, digits, (size_t)n_digits);
+            symbol += n_digits;
+        }
+        else
+        {
+            for (int i = 0; i < k; i++)
+                *symbol++ = (i < n_digits) ? digits[i] : '0';
+            if (n_digits > k)
+            {
+                *symbol++ = '.';
+                memcpy (symbol, digits + k, (size_t)(n_digits - k));
+                symbol += n_digits - k;
+            }
+        }
+    }
+    else
+    {
+        *symbol++ = digits[0];
+        if (n_digits > 1)
+        {
+            *symbol++ = '.';
+            memcpy (symbol, digits + 1, (size_t)(n_digits - 1));
+            symbol += n_digits - 1;
+        }
+
+        *symbol++ = 'e';
+        *symbol++ = (sci_exponent < 0) ? '-' : '+';
+        symbol += Write_Integer (symbol, (uint128_t)abs (sci_exponent), 2);
+    }
+
+    *symbol = '\0';
+
+    return (size_t)(symbol - dest);
+}
+
+/**
+    \brief Allocates the buffer of an Output_Buffer
+
+    \param [out] buffer {Pointer on the buffer}
+    \param [in] stream {The output}
+    \param [in] format {The way roots are written in}
+    \param [in] digits {The number of digits after the decimal point in the fixed format (at most MAX_FIXED_DIGITS)}
+    \return 0 if the buffer has been allocated
+    \return -1 otherwise
+*/
+int Init_Output_Buffer (struct Output_Buffer *buffer, FILE *stream, const enum Root_Format format, const int digits)
+{
+    assert (buffer != NULL);
+    assert (stream != NULL);
+    assert (digits >= 0 && digits <= MAX_FIXED_DIGITS);
+
+    buffer->Stream   = stream;
+    buffer->Length   = 0;
+    buffer->Capacity = OUTPUT_BUFFER_SIZE + 4 * FIXED_LENGTH (digits) + 16;     // room for a line of Write_Complex_Result ()
+    buffer->Data     = malloc (buffer->Capacity);
+    buffer->Format   = format;
+    buffer->Digits   = digits;
+
+    return (buffer->Data == NULL) ? -1 : 0;
+}
+
+/**
+    \brief Writes the contents of the buffer to its stream
+
+    \param [in] buffer {Pointer on the buffer}
+    \return 0 if everything has been written
+    \return -1 otherwise
+*/
+int Flush_Output_Buffer (struct Output_Buffer *buffer)
+{
+    assert (buffer != NULL);
+
+    size_t n_written = fwrite (buffer->Data, 1, buffer->Length, buffer->Stream);
+    int status = (n_written == buffer->Length) ? 0 : -1;
+
+    buffer->Length = 0;
+
+    return status;
+}
+
+/**
+    \brief Frees the buffer of an Output_Buffer (it should be flushed before)
+
+    \param [in] buffer {Pointer on the buffer}
+*/
+void Free_Output_Buffer (struct Output_Buffer *buffer)
+{
+    assert (buffer != NULL);
+
+    free (buffer->Data);
+    buffer->Data = NULL;
+}
+
+/**
+    \brief Writes one result as the line "n_roots x_1 x_2"
+
+    Calls Format_Shortest () or Format_Fixed () for the roots and Flush_Output_Buffer () if the buffer is full.
+
+    \param [in] buffer {Pointer on the buffer}
+    \param [in] n_roots {The number of roots}
+    \param [in] x_1 {The first root}
+    \param [in] x_2 {The second root}
+    \return 0 if everything is OK
+    \return -1 if the buffer has been flushed and writing has failed
+*/
+int Write_Result (struct Output_Buffer *buffer, const enum N_Roots n_roots, const double x_1, const double x_2)
+{
+    assert (buffer != NULL);
+
+    int status = 0;
+
+    if (buffer->Length >= OUTPUT_BUFFER_SIZE)
+        status = Flush_Output_Buffer (buffer);
+
+    char *symbol = buffer->Data + buffer->Length;
+
+    if (n_roots < 0)
+        *symbol++ = '-';
+    *symbol++ = (char)('0' + abs (n_roots));
+    *symbol++ = ' ';
+
+    if (buffer->Format == Fixed_Format)
+    {
+        symbol += Format_Fixed (symbol, x_1, buffer->Digits);
+        *symbol++ = ' ';
+        symbol += Format_Fixed (symbol, x_2, buffer->Digits);
+    }
+    else
+    {
+        symbol += Format_Shortest (symbol, x_1);
+        *symbol++ = ' ';
+        symbol += Format_Shortest (symbol, x_2);
+    }
+
+    *symbol++ = '\n';
+    buffer->Length = (size_t)(symbol - buffer->Data);
+
+    return status;
+}
+
+/**
+    \brief Adds one line "n_roots re_1 im_1 re_2 im_2" to the buffer
+
+    Flushes the buffer first if it holds OUTPUT_BUFFER_SIZE bytes or more.
+    The parts are written in the format of the buffer, as Write_Result () writes the roots.
+
+    \param [in] buffer {Pointer on the buffer}
+    \param [in] n_roots {The number of real roots}
+    \param [in] re_1 {The real part of the first root}
+    \param [in] im_1 {The imaginary part of the first root}
+    \param [in] re_2 {The real part of the second root}
+    \param [in] im_2 {The imaginary part of the second root}
+    \return 0 if everything is OK
+    \return -1 if flushing has failed
+*/
+int Write_Complex_Result (struct Output_Buffer *buffer, const enum N_Roots n_roots,
+                          const double re_1, const double im_1, const double re_2, const double im_2)
+{
+    assert (buffer != NULL);
+
+    int status = 0;
+
+    if (buffer->Length >= OUTPUT_BUFFER_SIZE)
+        status = Flush_Output_Buffer (buffer);
+
+    const double parts[4] = {re_1, im_1, re_2, im_2};
+    char *symbol = buffer->Data + buffer->Length;
+
+    if (n_roots < 0)
+        *symbol++ = '-';
+    *symbol++ = (char)('0' + abs (n_roots));
+
+    for (int i = 0; i < 4; i++)
+    {
+        *symbol++ = ' ';
+        symbol += (buffer->Format == Fixed_Format) ? Format_Fixed (symbol, parts[i], buffer->Digits)
+                                                   : Format_Shortest (symbol, parts[i]);
+    }
+
+    *symbol++ = '\n';
+    buffer->Length = (size_t)(symbol - buffer->Data);
+
+    return status;
+}
+
+/**
+    \brief Writes only the number of roots as one line
+
+    Calls Flush_Output_Buffer () if the buffer is full.
+
+    \param [in] buffer {Pointer on the buffer}
+    \param [in] n_roots {The number of roots}
+    \return 0 if everything is OK
+    \return -1 if the buffer has been flushed and writing has failed
+*/
+int Write_Root_Count (struct Output_Buffer *buffer, const enum N_Roots n_roots)
+{
+    assert (buffer != NULL);
+
+    int status = 0;
+
+    if (buffer->Length >= OUTPUT_BUFFER_SIZE)
+        status = Flush_Output_Buffer (buffer);
+
+    char *symbol = buffer->Data + buffer->Length;
+
+    if (n_roots < 0)
+        *symbol++ = '-';
+    *symbol++ = (char)('0' + abs (n_roots));
+    *symbol++ = '\n';
+
+    buffer->Length = (size_t)(symbol - buffer->Data);
+
+    return status;
+}
+
+/**
+    \brief Writes the number of an equation and a space before its result
+
+    Calls Flush_Output_Buffer () if the buffer is full.
+
+    \param [in] buffer {Pointer on the buffer}
+    \param [in] number {The number of the equation}
+    \return 0 if everything is OK
+    \return -1 if the buffer has been flushed and writing has failed
+*/
+int Write_Equation_Number (struct Output_Buffer *buffer, const uint64_t number)
+{
+    assert (buffer != NULL);
+
+    int status = 0;
+
+    if (buffer->Length >= OUTPUT_BUFFER_SIZE)
+        status = Flush_Output_Buffer (buffer);
+
+    char digits[20] = "";
+    int n_digits = 0;
+    uint64_t rest = number;
+
+    do
+    {
+        digits[n_digits++] = (char)('0' + rest % 10);
+        rest /= 10;
+    }
+    while (rest != 0);
+
+    char *symbol = buffer->Data + buffer->Length;
+
+    while (n_digits > 0)
+        *symbol++ = digits[--n_digits];
+    *symbol++ = ' ';
+
+    buffer->Length = (size_t)(symbol - buffer->Data);
+
+    return status;
+}
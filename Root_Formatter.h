@@ -0,0 +1,41 @@
+#ifndef ROOT_FORMATTER_H_INCLUDED
+#define ROOT_FORMATTER_H_INCLUDED
+
+#include "Quadratic_Equation.h"
+
+#define MAX_FIXED_DIGITS 1100       ///The maximal number of digits after the decimal point in the fixed format
+#define MAX_SHORTEST_LENGTH 32      ///The maximal length of a number in the shortest format
+#define FIXED_LENGTH(digits) (312 + (size_t)(digits))   ///The maximal length of a number in the fixed format
+#define OUTPUT_BUFFER_SIZE (1 << 20)    ///The size of the buffer of Output_Buffer
+
+///Ways roots can be written in
+enum Root_Format
+{
+    Shortest_Format,    ///< The shortest number that is read back as the same "double"
+    Fixed_Format        ///< A certain number of digits after the decimal point, like "%.*f"
+};
+
+///Buffer that collects formatted results and writes them to a stream when it is full
+struct Output_Buffer
+{
+    FILE *Stream;       ///< The output
+    char *Data;         ///< The buffer
+    size_t Length;      ///< The number of bytes in the buffer
+    size_t Capacity;    ///< The size of the buffer
+    enum Root_Format Format;    ///< The way roots are written in
+    int Digits;         ///< The number of digits after the decimal point in the fixed format
+};
+
+size_t Format_Fixed    (char *dest, const double value, const int digits);
+size_t Format_Shortest (char *dest, const double value);
+int  Init_Output_Buffer  (struct Output_Buffer *buffer, FILE *stream, const enum Root_Format format, const int digits);
+int  Flush_Output_Buffer (struct Output_Buffer *buffer);
+void Free_Output_Buffer  (struct Output_Buffer *buffer);
+int  Write_Result (struct Output_Buffer *buffer, const enum N_Roots n_roots, const double x_1, const double x_2);
+int  Write_Complex_Result (struct Output_Buffer *buffer, const enum N_Roots n_roots,
+                           const double re_1, const double im_1, const double re_2, const double im_2);
+int  Write_Root_Count (struct Output_Buffer *buffer, const enum N_Roots n_roots);
+int  Write_Equation_Number (struct Output_Buffer *buffer, const uint64_t number);
+int  Formatter_Unit_Test (void);
+
+#endif
@@ -0,0 +1,659 @@
+#include "Service_Mode.h"
+#include "Simd_Solver.h"
+
+#include <stdlib.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define SERVICE_READ_SIZE 65536     ///The number of bytes that are read from a socket at a time
+#define TCP_PREFIX "tcp:"           ///The address of a loopback TCP port starts with this prefix
+
+///Set by the handler of SIGINT and SIGTERM
+static volatile sig_atomic_t Stop_Service = 0;
+
+/**
+    \brief Asks the event loop to stop
+
+    \param [in] signal_number {The number of the signal}
+*/
+static void Handle_Stop_Signal (int signal_number)
+{
+    (void)signal_number;
+    Stop_Service = 1;
+}
+
+/**
+    \brief Returns the time of a monotonic clock
+
+    \return The time in seconds
+*/
+static double Get_Service_Time (void)
+{
+    struct timespec time = {0};
+    clock_gettime (CLOCK_MONOTONIC, &time);
+
+    return (double)time.tv_sec + 1E-9 * (double)time.tv_nsec;
+}
+
+/**
+    \brief Makes sure that a buffer has room for some more bytes
+
+    The bytes before "Begin" are dropped if the buffer has to grow.
+
+    \param [in] buffer {Pointer on the buffer}
+    \param [in] size {The number of bytes that should fit after "Length"}
+    \return 0 if there is enough room
+    \return -1 if there is not enough memory
+*/
+static int Reserve_Bytes (struct Byte_Buffer *buffer, const size_t size)
+{
+    if (buffer->Length + size <= buffer->Capacity)
+        return 0;
+
+    if (buffer->Begin > 0)
+    {
+        memmove (buffer->Data, buffer->Data + buffer->Begin, buffer->Length - buffer->Begin);
+        buffer->Length -= buffer->Begin;
+        buffer->Begin = 0;
+
+        if (buffer->Length + size <= buffer->Capacity)
+            return 0;
+    }
+
+    size_t capacity = (buffer->Capacity == 0) ? SERVICE_READ_SIZE : buffer->Capacity;
+    while (capacity < buffer->Length + size)
+        capacity *= 2;
+
+    unsigned char *data = realloc (buffer->Data, capacity);
+    if (data == NULL)
+        return -1;
+
+    buffer->Data = data;
+    buffer->Capacity = capacity;
+
+    return 0;
+}
+
+/**
+    \brief Makes sure that the arrays of the scratch block have room for a request
+
+    \param [in] stats {Pointer on the counters that own the scratch block}
+    \param [in] n_equations {The number of equations of the request}
+    \return 0 if there is enough room
+    \return -1 if there is not enough memory
+*/
+static int Reserve_Scratch (struct Service_Stats *stats, const size_t n_equations)
+{
+    if (n_equations <= stats->Scratch.Capacity)
+        return 0;
+
+    Free_Equation_Block (&stats->Scratch);
+    if (Allocate_Equation_Block (&stats->Scratch, n_equations) == 0)
+        return 0;
+
+    Free_Equation_Block (&stats->Scratch);
+    stats->Scratch = (struct Equation_Block){0};
+    return -1;
+}
+
+/**
+    \brief Answers every complete request in the input buffer of a connection
+
+    The coefficients of a request are split into the arrays of the scratch block and solved by Solve_Block (),
+             so "--threads", "--precise", "--scaled", "--cache" and "--isa" work as in the other modes;
+             without them the results are the same as the ones of Get_Number_Of_Roots_And_Solve_Equation ().
+    The responses are put into the output buffer; a request that has not come completely stays in the input buffer.
+    When Reserve_Bytes () drops the sent bytes of the output buffer, the ends of the responses in "Pending"
+             are moved down by the same number of bytes, so they still point after the right responses.
+
+    \param [in] options {Pointer on the settings}
+    \param [in,out] cache {Pointer on the cache or NULL}
+    \param [in] connection {Pointer on the connection}
+    \param [in] stats {Pointer on the counters and the scratch block}
+    \param [in] now {The time the requests have been received}
+    \return 0 if everything is OK
+    \return -1 if a request is too long or there is not enough memory (the connection should be closed)
+*/
+int Process_Requests (const struct Options *options, struct Root_Cache *cache,
+                      struct Service_Connection *connection, struct Service_Stats *stats, const double now)
+{
+    assert (options != NULL);
+    assert (connection != NULL);
+    assert (stats != NULL);
+
+    struct Byte_Buffer *in = &connection->In, *out = &connection->Out;
+
+    while (in->Length - in->Begin >= SERVICE_HEADER_SIZE)
+    {
+        uint32_t n_equations = 0;
+        memcpy (&n_equations, in->Data + in->Begin, SERVICE_HEADER_SIZE);
+
+        if (n_equations > SERVICE_MAX_BATCH)
+            return -1;
+
+        size_t request_size  = SERVICE_HEADER_SIZE + (size_t)n_equations * 3 * sizeof (double);
+        size_t response_size = SERVICE_HEADER_SIZE + (size_t)n_equations * sizeof (struct Root_Record);
+
+        if (in->Length - in->Begin < request_size)
+            break;
+
+        size_t out_begin = out->Begin;
+        if (Reserve_Scratch (stats, n_equations) != 0 || Reserve_Bytes (out, response_size) != 0)
+            return -1;
+
+        size_t n_dropped = out_begin - out->Begin;
+        for (size_t i = 0; i < connection->N_Pending && n_dropped > 0; i++)
+            connection->Pending[i].End = (connection->Pending[i].End > n_dropped) ? connection->Pending[i].End - n_dropped : 0;
+
+        if (connection->N_Pending == connection->Pending_Capacity)
+        {
+            size_t capacity = (connection->Pending_Capacity == 0) ? 16 : 2 * connection->Pending_Capacity;
+            struct Pending_Response *pending = realloc (connection->Pending, capacity * sizeof (struct Pending_Response));
+
+            if (pending == NULL)
+                return -1;
+
+            connection->Pending = pending;
+            connection->Pending_Capacity = capacity;
+        }
+
+        const unsigned char *triples = in->Data + in->Begin + SERVICE_HEADER_SIZE;
+        struct Equation_Block *block = &stats->Scratch;
+
+        for (size_t i = 0; i < n_equations; i++)
+        {
+            memcpy (&block->A[i], triples + (3 * i)     * sizeof (double), sizeof (double));
+            memcpy (&block->B[i], triples + (3 * i + 1) * sizeof (double), sizeof (double));
+            memcpy (&block->C[i], triples + (3 * i + 2) * sizeof (double), sizeof (double));
+        }
+
+        Solve_Block (options, cache, block->A, block->B, block->C, block->X_1, block->X_2, block->N_Roots, n_equations);
+
+        unsigned char *response = out->Data + out->Length;
+        memcpy (response, &n_equations, SERVICE_HEADER_SIZE);
+
+        for (size_t i = 0; i < n_equations; i++)
+        {
+            struct Root_Record record = {block->X_1[i], block->X_2[i], block->N_Roots[i]};
+            memcpy (response + SERVICE_HEADER_SIZE + i * sizeof (record), &record, sizeof (record));
+        }
+
+        out->Length += response_size;
+        in->Begin   += request_size;
+
+        connection->Pending[connection->N_Pending++] = (struct Pending_Response){out->Length, now};
+        stats->N_Requests++;
+        stats->N_Equations += n_equations;
+    }
+
+    return 0;
+}
+
+/**
+    \brief Records the latencies of the responses that have been sent completely
+
+    \param [in] connection {Pointer on the connection}
+    \param [in] stats {Pointer on the counters}
+    \param [in] now {The time the bytes have been sent}
+*/
+void Record_Sent_Responses (struct Service_Connection *connection, struct Service_Stats *stats, const double now)
+{
+    assert (connection != NULL);
+    assert (stats != NULL);
+
+    size_t n_sent = 0;
+
+    while (n_sent < connection->N_Pending && connection->Pending[n_sent].End <= connection->Out.Begin)
+    {
+        if (stats->Latencies != NULL)
+            stats->Latencies[stats->N_Latencies % SERVICE_LATENCY_SAMPLES] = now - connection->Pending[n_sent].Start;
+        stats->N_Latencies++;
+        n_sent++;
+    }
+
+    memmove (connection->Pending, connection->Pending + n_sent, (connection->N_Pending - n_sent) * sizeof (struct Pending_Response));
+    connection->N_Pending -= n_sent;
+
+    if (connection->Out.Begin == connection->Out.Length)
+    {
+        connection->Out.Begin  = 0;
+        connection->Out.Length = 0;
+    }
+}
+
+/**
+    \brief Closes the socket of a connection and frees its buffers
+
+    \param [in] connection {Pointer on the connection}
+*/
+void Free_Service_Connection (struct Service_Connection *connection)
+{
+    if (connection == NULL)
+        return;
+
+    if (connection->Fd >= 0)
+        close (connection->Fd);
+
+    free (connection->In.Data);
+    free (connection->Out.Data);
+    free (connection->Pending);
+    free (connection);
+}
+
+/**
+    \brief Compares two numbers of the "double" type for qsort ()
+*/
+static int Compare_Latencies (const void *first, const void *second)
+{
+    double x = *(const double *)first, y = *(const double *)second;
+
+    return (x > y) - (x < y);
+}
+
+/**
+    \brief Finds a percentile of the latest latencies
+
+    \param [in] stats {Pointer on the counters}
+    \param [in] percent {The percentile, from 0 to 100}
+    \return The latency in seconds (0 if there are none)
+*/
+double Get_Latency_Percentile (const struct Service_Stats *stats, const double percent)
+{
+    assert (stats != NULL);
+
+    size_t n_samples = (stats->N_Latencies < SERVICE_LATENCY_SAMPLES) ? stats->N_Latencies : SERVICE_LATENCY_SAMPLES;
+    if (n_samples == 0 || stats->Latencies == NULL)
+        return 0.0;
+
+    double *sorted = malloc (n_samples * sizeof (double));
+    if (sorted == NULL)
+        return 0.0;
+
+    memcpy (sorted, stats->Latencies, n_samples * sizeof (double));
+    qsort (sorted, n_samples, sizeof (double), Compare_Latencies);
+
+    size_t index = (size_t)(percent / 100.0 * (double)(n_samples - 1) + 0.5);
+    double latency = sorted[index];
+
+    free (sorted);
+    return latency;
+}
+
+/**
+    \brief Prints the counters and the latency percentiles to stderr
+
+    \param [in] stats {Pointer on the counters}
+*/
+static void Print_Service_Stats (const struct Service_Stats *stats)
+{
+    fprintf (stderr, "service: %zu requests, %zu equations, latency p50 %.1f us, p99 %.1f us\n",
+             stats->N_Requests, stats->N_Equations,
+             1E6 * Get_Latency_Percentile (stats, 50.0), 1E6 * Get_Latency_Percentile (stats, 99.0));
+}
+
+/**
+    \brief Removes the socket file bound by this process
+
+    Nothing is removed for a TCP port, or when the path now names another file.
+
+    \param [in] address {The address the service listens on}
+    \param [in] bound {The status of the socket file right after bind ()}
+*/
+static void Remove_Listening_Socket (const char *address, const struct stat *bound)
+{
+    struct stat current = {0};
+
+    if (bound->st_ino == 0 || lstat (address, &current) == -1)
+        return;
+
+    if (S_ISSOCK (current.st_mode) && current.st_dev == bound->st_dev && current.st_ino == bound->st_ino)
+        unlink (address);
+}
+
+/**
+    \brief Opens the listening socket
+
+    A stale socket left at the path by an earlier run is replaced,
+             but any other file there is kept and the address is reported in use.
+
+    \param [in] address {The path of a Unix-domain socket or "tcp:<port>" for a port of 127.0.0.1}
+    \param [out] bound {The status of the socket file that has been bound, st_ino is 0 for a TCP port}
+    \return The socket or -1 with errno set if it cannot be opened
+*/
+static int Open_Listening_Socket (const char *address, struct stat *bound)
+{
+    int fd = -1;
+
+    memset (bound, 0, sizeof (*bound));
+
+    if (strncmp (address, TCP_PREFIX, strlen (TCP_PREFIX)) == 0)
+    {
+        char *end = NULL;
+        unsigned long port = strtoul (address + strlen (TCP_PREFIX), &end, 10);
+        struct sockaddr_in socket_address = {0};
+        int reuse = 1;
+
+        if (*end != '\0' || port == 0 || port > 65535)
+        {
+            errno = EINVAL;
+            return -1;
+        }
+
+        socket_address.sin_family = AF_INET;
+        socket_address.sin_port = htons ((uint16_t)port);
+        socket_address.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+
+        if ((fd = socket (AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) == -1 ||
+            setsockopt (fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof (reuse)) == -1 ||
+            bind (fd, (struct sockaddr *)&socket_address, sizeof (socket_address)) == -1)
+        {
+            int error = errno;
+            if (fd != -1)
+                close (fd);
+            errno = error;
+            return -1;
+        }
+    }
+    else
+    {
+        struct sockaddr_un socket_address = {0};
+
+        struct stat existing = {0};
+
+        if (strlen (address) >= sizeof (socket_address.sun_path))
+        {
+            errno = ENAMETOOLONG;
+            return -1;
+        }
+
+        if (lstat (address, &existing) == 0)
+        {
+            if (!S_ISSOCK (existing.st_mode))
+            {
+                errno = EADDRINUSE;
+                return -1;
+            }
+            unlink (address);
+        }
+
+        socket_address.sun_family = AF_UNIX;
+        strcpy (socket_address.sun_path, address);
+
+        if ((fd = socket (AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) == -1 ||
+            bind (fd, (struct sockaddr *)&socket_address, sizeof (socket_address)) == -1)
+        {
+            int error = errno;
+            if (fd != -1)
+                close (fd);
+            errno = error;
+            return -1;
+        }
+
+        if (lstat (address, bound) == -1)
+            memset (bound, 0, sizeof (*bound));
+    }
+
+    if (listen (fd, SOMAXCONN) == -1)
+    {
+        int error = errno;
+        close (fd);
+        Remove_Listening_Socket (address, bound);
+        errno = error;
+        return -1;
+    }
+
+    return fd;
+}
+
+/**
+    \brief Tells epoll which events of a connection are needed now
+
+    The connection is not read while it has more than SERVICE_MAX_OUTPUT bytes to send,
+             and it is waited to become writable while it has any.
+
+    \param [in] epoll_fd {The epoll instance}
+    \param [in] connection {Pointer on the connection}
+    \return The result of epoll_ctl ()
+*/
+static int Update_Events (const int epoll_fd, struct Service_Connection *connection)
+{
+    size_t n_unsent = connection->Out.Length - connection->Out.Begin;
+    struct epoll_event event = {0};
+
+    event.events   = ((n_unsent <= SERVICE_MAX_OUTPUT) ? EPOLLIN : 0) | ((n_unsent > 0) ? EPOLLOUT : 0);
+    event.data.ptr = connection;
+
+    return epoll_ctl (epoll_fd, EPOLL_CTL_MOD, connection->Fd, &event);
+}
+
+/**
+    \brief Sends as many bytes of the output buffer as the socket takes
+
+    \param [in] connection {Pointer on the connection}
+    \param [in] stats {Pointer on the counters}
+    \return 0 if everything is OK
+    \return -1 if the connection is broken
+*/
+static int Send_Responses (struct Service_Connection *connection, struct Service_Stats *stats)
+{
+    struct Byte_Buffer *out = &connection->Out;
+
+    while (out->Begin < out->Length)
+    {
+        ssize_t n_sent = send (connection->Fd, out->Data + out->Begin, out->Length - out->Begin, MSG_NOSIGNAL);
+
+        if (n_sent > 0)
+            out->Begin += (size_t)n_sent;
+        else if (n_sent == -1 && errno == EINTR)
+            continue;
+        else if (n_sent == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        else
+            return -1;
+    }
+
+    Record_Sent_Responses (connection, stats, Get_Service_Time ());
+
+    return 0;
+}
+
+/**
+    \brief Reads everything the socket has, answers the complete requests and sends the responses
+
+    \param [in] options {Pointer on the settings}
+    \param [in,out] cache {Pointer on the cache or NULL}
+    \param [in] connection {Pointer on the connection}
+    \param [in] stats {Pointer on the counters}
+    \return 0 if everything is OK
+    \return -1 if the connection should be closed
+*/
+static int Receive_Requests (const struct Options *options, struct Root_Cache *cache,
+                             struct Service_Connection *connection, struct Service_Stats *stats)
+{
+    struct Byte_Buffer *in = &connection->In;
+    bool closed = false;
+
+    while (connection->Out.Length - connection->Out.Begin <= SERVICE_MAX_OUTPUT)
+    {
+        if (Reserve_Bytes (in, SERVICE_READ_SIZE) != 0)
+            return -1;
+
+        ssize_t n_read = recv (connection->Fd, in->Data + in->Length, in->Capacity - in->Length, 0);
+
+        if (n_read > 0)
+        {
+            in->Length += (size_t)n_read;
+            if (Process_Requests (options, cache, connection, stats, Get_Service_Time ()) != 0)
+                return -1;
+        }
+        else if (n_read == 0)
+        {
+            closed = true;
+            break;
+        }
+        else if (errno == EINTR)
+            continue;
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            break;
+        else
+            return -1;
+    }
+
+    if (Send_Responses (connection, stats) != 0)
+        return -1;
+
+    return (closed && connection->Out.Begin == connection->Out.Length) ? -1 : 0;
+}
+
+/**
+    \brief Accepts all the clients that are waiting
+
+    \param [in] epoll_fd {The epoll instance}
+    \param [in] listen_fd {The listening socket}
+*/
+static void Accept_Clients (const int epoll_fd, const int listen_fd)
+{
+    int fd = -1;
+
+    while ((fd = accept (listen_fd, NULL, NULL)) != -1)
+    {
+        struct Service_Connection *connection = calloc (1, sizeof (struct Service_Connection));
+        struct epoll_event event = {0};
+
+        event.events   = EPOLLIN;
+        event.data.ptr = connection;
+
+        if (connection == NULL || fcntl (fd, F_SETFL, fcntl (fd, F_GETFL) | O_NONBLOCK) == -1)
+        {
+            free (connection);
+            close (fd);
+            continue;
+        }
+
+        connection->Fd = fd;
+        if (epoll_ctl (epoll_fd, EPOLL_CTL_ADD, fd, &event) == -1)
+            Free_Service_Connection (connection);
+    }
+}
+
+/**
+    \brief Serves batches of equations over a Unix-domain socket or a loopback TCP port until SIGINT or SIGTERM
+
+    Calls Accept_Clients (), Receive_Requests () and Send_Responses () from an epoll event loop in one thread;
+             the requests are solved by Solve_Block () with the cache of "--cache" if it has been given.
+    The counters and the p50/p99 latencies (from the moment a request has come completely
+             to the moment its response has been sent) are printed to stderr every SERVICE_REPORT_INTERVAL seconds
+             and at the end.
+
+    \param [in] options {Pointer on the settings, options->Input is the address}
+    \return 0 if the service has been stopped by a signal
+    \return 2 if it cannot be started
+*/
+int Run_Service_Mode (const struct Options *options)
+{
+    assert (options != NULL);
+
+    struct stat bound = {0};
+    int listen_fd = Open_Listening_Socket (options->Input, &bound);
+    if (listen_fd == -1)
+    {
+        fprintf (stderr, "Cannot listen on \"%s\": %s\n", options->Input, strerror (errno));
+        return 2;
+    }
+
+    int epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+    struct epoll_event listen_event = {0};
+    struct Service_Stats stats = {0};
+    struct Root_Cache cache = {0};
+
+    listen_event.events   = EPOLLIN;
+    listen_event.data.ptr = NULL;
+    stats.Latencies = malloc (SERVICE_LATENCY_SAMPLES * sizeof (double));
+
+    if (epoll_fd == -1 || epoll_ctl (epoll_fd, EPOLL_CTL_ADD, listen_fd, &listen_event) == -1 || stats.Latencies == NULL ||
+        (options->Cache_Size != 0 && Init_Root_Cache (&cache, options->Cache_Size, true) != 0))
+    {
+        fprintf (stderr, "Cannot start the service\n");
+        if (epoll_fd != -1)
+            close (epoll_fd);
+        close (listen_fd);
+        Remove_Listening_Socket (options->Input, &bound);
+        free (stats.Latencies);
+        Free_Root_Cache (&cache);
+        return 2;
+    }
+
+    struct sigaction action = {0};
+    action.sa_handler = Handle_Stop_Signal;
+    sigaction (SIGINT, &action, NULL);
+    sigaction (SIGTERM, &action, NULL);
+
+    fprintf (stderr, "Listening on \"%s\"\n", options->Input);
+
+    struct epoll_event events[SERVICE_MAX_EVENTS];
+    double last_report = Get_Service_Time ();
+    size_t last_requests = 0;
+
+    while (!Stop_Service)
+    {
+        int n_events = epoll_wait (epoll_fd, events, SERVICE_MAX_EVENTS, 1000);
+
+        for (int i = 0; i < n_events; i++)
+        {
+            struct Service_Connection *connection = events[i].data.ptr;
+
+            if (connection == NULL)
+            {
+                Accept_Clients (epoll_fd, listen_fd);
+                continue;
+            }
+
+            int status = 0;
+
+            if (events[i].events & (EPOLLERR | EPOLLHUP) && !(events[i].events & EPOLLIN))
+                status = -1;
+            if (status == 0 && (events[i].events & EPOLLOUT))
+                status = Send_Responses (connection, &stats);
+            if (status == 0 && (events[i].events & EPOLLIN))
+                status = Receive_Requests (options, (cache.Entries != NULL) ? &cache : NULL, connection, &stats);
+            if (status == 0)
+                status = Update_Events (epoll_fd, connection);
+
+            if (status != 0)
+            {
+                epoll_ctl (epoll_fd, EPOLL_CTL_DEL, connection->Fd, NULL);
+                Free_Service_Connection (connection);
+            }
+        }
+
+        double now = Get_Service_Time ();
+        if (now - last_report >= SERVICE_REPORT_INTERVAL && stats.N_Requests != last_requests)
+        {
+            Print_Service_Stats (&stats);
+            last_report = now;
+            last_requests = stats.N_Requests;
+        }
+    }
+
+    Print_Service_Stats (&stats);
+
+    close (epoll_fd);
+    close (listen_fd);
+    Remove_Listening_Socket (options->Input, &bound);
+    if (cache.Entries != NULL)
+        Print_Cache_Statistics (stderr, &cache);
+    free (stats.Latencies);
+    Free_Equation_Block (&stats.Scratch);
+    Free_Root_Cache (&cache);
+
+    return 0;
+}
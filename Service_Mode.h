@@ -0,0 +1,66 @@
+#ifndef SERVICE_MODE_H_INCLUDED
+#define SERVICE_MODE_H_INCLUDED
+
+#include "Command_Line.h"
+#include "Binary_Mode.h"
+#include "Stream_Mode.h"
+
+#define SERVICE_MAX_BATCH (1 << 20)         ///The maximal number of equations in one request
+#define SERVICE_MAX_OUTPUT (64 << 20)       ///A connection is not read while it has more bytes than this to send
+#define SERVICE_MAX_EVENTS 64               ///The number of events epoll_wait () returns at a time
+#define SERVICE_LATENCY_SAMPLES 65536       ///The number of the latest latencies the percentiles are found from
+#define SERVICE_REPORT_INTERVAL 10.0        ///Statistics are printed to stderr every this number of seconds
+#define SERVICE_HEADER_SIZE 4               ///The size of the header of requests and responses
+
+/*
+    Protocol: a request is a little-endian uint32_t N followed by N (a, b, c) triples of the "double" type;
+    the response is the same N followed by N struct Root_Record. Any number of requests can be sent
+    without waiting for the responses; they are answered in the order they have come in.
+*/
+
+///Growable array of bytes
+struct Byte_Buffer
+{
+    unsigned char *Data;    ///< The bytes
+    size_t Begin;           ///< Index of the first byte that has not been used yet
+    size_t Length;          ///< Index of the byte after the last one
+    size_t Capacity;        ///< The size of "Data"
+};
+
+///A response that has not been sent completely
+struct Pending_Response
+{
+    size_t End;         ///< Index of the byte after the response in the output buffer
+    double Start;       ///< The time the request has been received completely
+};
+
+///One client
+struct Service_Connection
+{
+    int Fd;                         ///< The socket
+    struct Byte_Buffer In;          ///< Bytes of requests that have not been processed yet
+    struct Byte_Buffer Out;         ///< Bytes of responses that have not been sent yet
+    struct Pending_Response *Pending;   ///< Responses in the output buffer in the order of the requests
+    size_t N_Pending;               ///< The number of responses in "Pending"
+    size_t Pending_Capacity;        ///< The size of "Pending"
+};
+
+///Counters of the service
+struct Service_Stats
+{
+    size_t N_Requests;      ///< The number of requests that have been answered
+    size_t N_Equations;     ///< The number of equations that have been solved
+    double *Latencies;      ///< The latest SERVICE_LATENCY_SAMPLES latencies in seconds
+    size_t N_Latencies;     ///< The number of latencies that have been recorded
+    struct Equation_Block Scratch;  ///< Arrays the coefficients of a request are split into
+};
+
+int  Process_Requests (const struct Options *options, struct Root_Cache *cache,
+                       struct Service_Connection *connection, struct Service_Stats *stats, const double now);
+void Record_Sent_Responses (struct Service_Connection *connection, struct Service_Stats *stats, const double now);
+void Free_Service_Connection (struct Service_Connection *connection);
+double Get_Latency_Percentile (const struct Service_Stats *stats, const double percent);
+int  Run_Service_Mode (const struct Options *options);
+int  Service_Unit_Test (void);
+
+#endif
@@ -0,0 +1,556 @@
+#include "Shm_Mode.h"
+
+#include <stdlib.h>
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#define SHM_BATCH_WINDOW 4      ///The number of slots Solve_Shm_Batch () keeps submitted at a time
+
+///States of a slot added to 4 times its ring position
+enum Shm_Slot_Step
+{
+    Slot_Free      = 0,     ///< A producer can claim the slot
+    Slot_Submitted = 1,     ///< The solver can solve the request
+    Slot_Solved    = 2      ///< The producer can read the results
+};
+
+///Set by the handler of SIGINT and SIGTERM
+static volatile sig_atomic_t Stop_Shm_Mode = 0;
+
+/**
+    \brief Asks the solver loop to stop
+
+    \param [in] signal_number {The number of the signal}
+*/
+static void Handle_Stop_Signal (int signal_number)
+{
+    (void)signal_number;
+    Stop_Shm_Mode = 1;
+}
+
+/**
+    \brief Finds the value of "Sequence" of a slot in a state
+
+    \param [in] position {The ring position of the slot}
+    \param [in] step {The state}
+    \return The value
+*/
+static inline uint32_t Get_Sequence (const uint32_t position, const enum Shm_Slot_Step step)
+{
+    return 4 * position + (uint32_t)step;
+}
+
+/**
+    \brief Finds the number of bytes of a slot
+
+    \param [in] slot_capacity {The maximal number of equations in the slot}
+    \return The size rounded up to 64 bytes
+*/
+static size_t Get_Slot_Size (const uint32_t slot_capacity)
+{
+    size_t size = sizeof (struct Shm_Slot_State) + (size_t)slot_capacity * (5 * sizeof (double) + sizeof (enum N_Roots));
+
+    return (size + 63) & ~(size_t)63;
+}
+
+/**
+    \brief Changes the state of a slot and wakes the processes that sleep on it
+
+    \param [in] state {Pointer on the state of the slot}
+    \param [in] sequence {The new value of "Sequence"}
+*/
+static void Set_Slot_Sequence (struct Shm_Slot_State *state, const uint32_t sequence)
+{
+    atomic_store (&state->Sequence, sequence);
+
+    if (atomic_load (&state->N_Waiting) != 0)
+        syscall (SYS_futex, &state->Sequence, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+/**
+    \brief Waits until the state of a slot is not "sequence" any more
+
+    Spins SHM_SPIN_COUNT times, then sleeps in futex () for up to SHM_WAIT_TIMEOUT nanoseconds.
+    The counter "N_Waiting" is increased before "Sequence" is checked for the last time,
+             so Set_Slot_Sequence () cannot miss the sleeper.
+
+    \param [in] state {Pointer on the state of the slot}
+    \param [in] sequence {The value of "Sequence" the caller has seen}
+    \return The value of "Sequence" (it can still be "sequence" after the timeout or a signal)
+*/
+static uint32_t Wait_Slot_Sequence (struct Shm_Slot_State *state, const uint32_t sequence)
+{
+    uint32_t current = atomic_load_explicit (&state->Sequence, memory_order_acquire);
+
+    for (int i = 0; i < SHM_SPIN_COUNT && current == sequence; i++)
+        current = atomic_load_explicit (&state->Sequence, memory_order_acquire);
+
+    if (current != sequence)
+        return current;
+
+    const struct timespec timeout = {0, SHM_WAIT_TIMEOUT};
+
+    atomic_fetch_add (&state->N_Waiting, 1);
+    if ((current = atomic_load (&state->Sequence)) == sequence)
+    {
+        syscall (SYS_futex, &state->Sequence, FUTEX_WAIT, sequence, &timeout, NULL, 0);
+        current = atomic_load (&state->Sequence);
+    }
+    atomic_fetch_sub (&state->N_Waiting, 1);
+
+    return current;
+}
+
+/**
+    \brief Maps a shared-memory object and finds the slots in it
+
+    \param [in] queue {Pointer on the queue}
+    \param [in] fd {The shared-memory object}
+    \param [in] size {The number of bytes of the object}
+    \return 0 if everything is OK
+    \return -1 if the object cannot be mapped or there is not enough memory
+*/
+static int Map_Shm_Queue (struct Shm_Queue *queue, const int fd, const size_t size)
+{
+    void *memory = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED)
+        return -1;
+
+    queue->Header = memory;
+    queue->Size   = size;
+    queue->Slots  = NULL;
+
+    return 0;
+}
+
+/**
+    \brief Points the slots of a queue at their places in the mapping
+
+    \param [in] queue {Pointer on the queue whose header has been filled}
+    \return 0 if everything is OK
+    \return -1 if there is not enough memory
+*/
+static int Find_Shm_Slots (struct Shm_Queue *queue)
+{
+    const struct Shm_Header *header = queue->Header;
+
+    queue->Slots = calloc (header->N_Slots, sizeof (struct Shm_Slot));
+    if (queue->Slots == NULL)
+        return -1;
+
+    for (uint32_t i = 0; i < header->N_Slots; i++)
+    {
+        unsigned char *slot = (unsigned char *)queue->Header + sizeof (struct Shm_Header) + i * header->Slot_Size;
+        size_t capacity = header->Slot_Capacity;
+        struct Equation_Block *block = &queue->Slots[i].Block;
+
+        queue->Slots[i].State = (struct Shm_Slot_State *)slot;
+        block->A   = (double *)(slot + sizeof (struct Shm_Slot_State));
+        block->B   = block->A + capacity;
+        block->C   = block->B + capacity;
+        block->X_1 = block->C + capacity;
+        block->X_2 = block->X_1 + capacity;
+        block->N_Roots  = (enum N_Roots *)(block->X_2 + capacity);
+        block->Capacity = capacity;
+    }
+
+    return 0;
+}
+
+/**
+    \brief Creates a named shared-memory queue
+
+    An object with the same name is never removed, because another solver may be serving it.
+
+    \param [out] queue {Pointer on the queue}
+    \param [in] name {The name of the object, for example "/quadratic"}
+    \param [in] n_slots {The number of slots (a power of two)}
+    \param [in] slot_capacity {The maximal number of equations in one slot}
+    \return 0 if everything is OK
+    \return -1 with errno set if the object cannot be created (EEXIST if an object with this name exists already)
+*/
+int Create_Shm_Queue (struct Shm_Queue *queue, const char *name, const uint32_t n_slots, const uint32_t slot_capacity)
+{
+    assert (queue != NULL);
+    assert (name != NULL);
+
+    if (n_slots == 0 || (n_slots & (n_slots - 1)) != 0 || n_slots > (1U << 20) || slot_capacity == 0)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    size_t slot_size = Get_Slot_Size (slot_capacity);
+    size_t size = sizeof (struct Shm_Header) + n_slots * slot_size;
+
+    int fd = shm_open (name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd == -1)
+        return -1;
+
+    if (ftruncate (fd, (off_t)size) == -1 || Map_Shm_Queue (queue, fd, size) != 0)
+    {
+        int error = errno;
+        close (fd);
+        shm_unlink (name);
+        errno = error;
+        return -1;
+    }
+    close (fd);
+
+    struct Shm_Header *header = queue->Header;
+    header->N_Slots       = n_slots;
+    header->Slot_Capacity = slot_capacity;
+    header->Slot_Size     = slot_size;
+
+    if (Find_Shm_Slots (queue) != 0)
+    {
+        Close_Shm_Queue (queue);
+        shm_unlink (name);
+        errno = EINVAL;
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < n_slots; i++)
+        atomic_init (&queue->Slots[i].State->Sequence, Get_Sequence (i, Slot_Free));
+
+    atomic_store_explicit (&header->Magic, SHM_MAGIC, memory_order_release);
+
+    return 0;
+}
+
+/**
+    \brief Maps a queue another process has created
+
+    \param [out] queue {Pointer on the queue}
+    \param [in] name {The name of the object}
+    \return 0 if everything is OK
+    \return -1 if there is no ready queue with this name
+*/
+int Open_Shm_Queue (struct Shm_Queue *queue, const char *name)
+{
+    assert (queue != NULL);
+    assert (name != NULL);
+
+    int fd = shm_open (name, O_RDWR, 0);
+    if (fd == -1)
+        return -1;
+
+    struct stat file_stat = {0};
+    if (fstat (fd, &file_stat) == -1 || (size_t)file_stat.st_size < sizeof (struct Shm_Header) ||
+        Map_Shm_Queue (queue, fd, (size_t)file_stat.st_size) != 0)
+    {
+        close (fd);
+        return -1;
+    }
+    close (fd);
+
+    const struct Shm_Header *header = queue->Header;
+
+    if (atomic_load_explicit (&queue->Header->Magic, memory_order_acquire) != SHM_MAGIC ||
+        header->N_Slots == 0 || (header->N_Slots & (header->N_Slots - 1)) != 0 || header->Slot_Capacity == 0 ||
+        header->Slot_Size != Get_Slot_Size (header->Slot_Capacity) ||
+        sizeof (struct Shm_Header) + header->N_Slots * header->Slot_Size > queue->Size ||
+        Find_Shm_Slots (queue) != 0)
+    {
+        Close_Shm_Queue (queue);
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+    \brief Unmaps a queue (the shared-memory object stays until shm_unlink ())
+
+    \param [in] queue {Pointer on the queue}
+*/
+void Close_Shm_Queue (struct Shm_Queue *queue)
+{
+    assert (queue != NULL);
+
+    if (queue->Header != NULL)
+        munmap (queue->Header, queue->Size);
+
+    free (queue->Slots);
+    *queue = (struct Shm_Queue){0};
+}
+
+/**
+    \brief Takes the next slot of the ring for a request
+
+    Waits while the slot is used by the request of the previous round.
+
+    \param [in] queue {Pointer on the queue}
+    \param [out] position {Pointer on the variable in which the function puts the ring position of the slot}
+    \return Pointer on the arrays of the slot ("Capacity" is the maximal number of equations)
+    \return NULL if the queue has been stopped
+*/
+struct Equation_Block *Claim_Shm_Slot (struct Shm_Queue *queue, uint32_t *position)
+{
+    assert (queue != NULL);
+    assert (position != NULL);
+
+    struct Shm_Header *header = queue->Header;
+    uint32_t tail = atomic_load_explicit (&header->Tail, memory_order_relaxed);
+
+    while (atomic_load_explicit (&header->Stop, memory_order_relaxed) == 0)
+    {
+        struct Shm_Slot *slot = &queue->Slots[tail & (header->N_Slots - 1)];
+        uint32_t sequence = atomic_load_explicit (&slot->State->Sequence, memory_order_acquire);
+        int32_t difference = (int32_t)(sequence - Get_Sequence (tail, Slot_Free));
+
+        if (difference == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit (&header->Tail, &tail, tail + 1,
+                                                       memory_order_relaxed, memory_order_relaxed))
+            {
+                *position = tail;
+                return &slot->Block;
+            }
+        }
+        else if (difference < 0)
+        {
+            Wait_Slot_Sequence (slot->State, sequence);
+            tail = atomic_load_explicit (&header->Tail, memory_order_relaxed);
+        }
+        else
+            tail = atomic_load_explicit (&header->Tail, memory_order_relaxed);
+    }
+
+    return NULL;
+}
+
+/**
+    \brief Gives a filled slot to the solver
+
+    \param [in] queue {Pointer on the queue}
+    \param [in] position {The position Claim_Shm_Slot () has given}
+    \param [in] n_equations {The number of equations in the arrays (not more than their capacity)}
+*/
+void Submit_Shm_Slot (struct Shm_Queue *queue, const uint32_t position, const size_t n_equations)
+{
+    assert (queue != NULL);
+
+    struct Shm_Slot *slot = &queue->Slots[position & (queue->Header->N_Slots - 1)];
+    assert (n_equations <= slot->Block.Capacity);
+
+    slot->State->N_Equations = (uint32_t)n_equations;
+    Set_Slot_Sequence (slot->State, Get_Sequence (position, Slot_Submitted));
+}
+
+/**
+    \brief Waits until the request of a slot has been solved
+
+    \param [in] queue {Pointer on the queue}
+    \param [in] position {The position of the submitted slot}
+    \return 0 if the results are in the arrays of the slot
+    \return -1 if the queue has been stopped before
+*/
+int Wait_Shm_Slot (struct Shm_Queue *queue, const uint32_t position)
+{
+    assert (queue != NULL);
+
+    struct Shm_Slot *slot = &queue->Slots[position & (queue->Header->N_Slots - 1)];
+    uint32_t sequence = atomic_load_explicit (&slot->State->Sequence, memory_order_acquire);
+
+    while (sequence != Get_Sequence (position, Slot_Solved))
+    {
+        if (atomic_load_explicit (&queue->Header->Stop, memory_order_relaxed) != 0)
+            return -1;
+
+        sequence = Wait_Slot_Sequence (slot->State, sequence);
+    }
+
+    return 0;
+}
+
+/**
+    \brief Gives a slot whose results have been read back to the producers
+
+    \param [in] queue {Pointer on the queue}
+    \param [in] position {The position of the solved slot}
+*/
+void Release_Shm_Slot (struct Shm_Queue *queue, const uint32_t position)
+{
+    assert (queue != NULL);
+
+    uint32_t n_slots = queue->Header->N_Slots;
+
+    Set_Slot_Sequence (queue->Slots[position & (n_slots - 1)].State, Get_Sequence (position + n_slots, Slot_Free));
+}
+
+/**
+    \brief Solves a batch of any size through the queue
+
+    The batch is split into slots; up to SHM_BATCH_WINDOW of them are submitted at a time,
+             so the solver works on one while the next is being filled.
+
+    \param [in] queue {Pointer on the queue}
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] x_1 {Array for the first roots}
+    \param [out] x_2 {Array for the second roots}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+    \return 0 if everything has been solved
+    \return -1 if the queue has been stopped
+*/
+int Solve_Shm_Batch (struct Shm_Queue *queue, const double *a, const double *b, const double *c,
+                     double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    assert (queue != NULL);
+
+    const size_t capacity = queue->Header->Slot_Capacity;
+    const size_t window = (queue->Header->N_Slots < SHM_BATCH_WINDOW) ? queue->Header->N_Slots : SHM_BATCH_WINDOW;
+    uint32_t positions[SHM_BATCH_WINDOW] = {0};
+    size_t firsts[SHM_BATCH_WINDOW] = {0};
+    size_t n_submitted = 0, n_done = 0;
+
+    for (size_t first = 0; first < n_equations || n_done < n_submitted; )
+    {
+        if (first < n_equations && n_submitted - n_done < window)
+        {
+            size_t count = (n_equations - first < capacity) ? n_equations - first : capacity;
+            struct Equation_Block *block = Claim_Shm_Slot (queue, &positions[n_submitted % window]);
+
+            if (block == NULL)
+                return -1;
+
+            memcpy (block->A, a + first, count * sizeof (double));
+            memcpy (block->B, b + first, count * sizeof (double));
+            memcpy (block->C, c + first, count * sizeof (double));
+            Submit_Shm_Slot (queue, positions[n_submitted % window], count);
+
+            firsts[n_submitted % window] = first;
+            first += count;
+            n_submitted++;
+            continue;
+        }
+
+        if (n_done == n_submitted)
+            break;
+
+        uint32_t position = positions[n_done % window];
+        if (Wait_Shm_Slot (queue, position) != 0)
+            return -1;
+
+        const struct Shm_Slot *slot = &queue->Slots[position & (queue->Header->N_Slots - 1)];
+        size_t from = firsts[n_done % window], count = slot->State->N_Equations;
+
+        memcpy (x_1 + from, slot->Block.X_1, count * sizeof (double));
+        memcpy (x_2 + from, slot->Block.X_2, count * sizeof (double));
+        memcpy (n_roots + from, slot->Block.N_Roots, count * sizeof (enum N_Roots));
+        Release_Shm_Slot (queue, position);
+        n_done++;
+    }
+
+    return 0;
+}
+
+/**
+    \brief Asks the solver to stop; the waiting producers get -1 or NULL
+
+    \param [in] queue {Pointer on the queue}
+*/
+void Stop_Shm_Queue (struct Shm_Queue *queue)
+{
+    assert (queue != NULL);
+
+    atomic_store (&queue->Header->Stop, 1);
+}
+
+/**
+    \brief Solves the requests of the queue in the order of their positions until the queue is stopped
+
+    Every request is solved in place by Solve_Block (), so "--threads", "--precise", "--scaled" and "--isa" work here too.
+
+    \param [in] queue {Pointer on the queue}
+    \param [in] options {Pointer on the settings}
+*/
+void Serve_Shm_Queue (struct Shm_Queue *queue, const struct Options *options)
+{
+    assert (queue != NULL);
+    assert (options != NULL);
+
+    struct Shm_Header *header = queue->Header;
+    uint32_t head = 0;
+
+    while (atomic_load_explicit (&header->Stop, memory_order_relaxed) == 0 && !Stop_Shm_Mode)
+    {
+        struct Shm_Slot *slot = &queue->Slots[head & (header->N_Slots - 1)];
+        uint32_t sequence = atomic_load_explicit (&slot->State->Sequence, memory_order_acquire);
+
+        if (sequence != Get_Sequence (head, Slot_Submitted))
+        {
+            Wait_Slot_Sequence (slot->State, sequence);
+            continue;
+        }
+
+        struct Equation_Block *block = &slot->Block;
+        size_t n_equations = slot->State->N_Equations;
+        if (n_equations > block->Capacity)
+            n_equations = block->Capacity;
+
+        Solve_Block (options, NULL, block->A, block->B, block->C, block->X_1, block->X_2, block->N_Roots, n_equations);
+
+        atomic_fetch_add_explicit (&header->N_Requests, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit (&header->N_Equations, n_equations, memory_order_relaxed);
+        Set_Slot_Sequence (slot->State, Get_Sequence (head, Slot_Solved));
+        head++;
+    }
+
+    atomic_store (&header->Stop, 1);
+}
+
+/**
+    \brief Creates the shared-memory queue "--shm" names and solves its requests until SIGINT or SIGTERM
+
+    The queue has SHM_QUEUE_SLOTS slots of SHM_SLOT_CAPACITY equations; it is removed at the end.
+
+    \param [in] options {Pointer on the settings, options->Input is the name of the queue}
+    \return 0 if the solver has been stopped
+    \return 2 if the queue cannot be created
+*/
+int Run_Shm_Mode (const struct Options *options)
+{
+    assert (options != NULL);
+
+    struct Shm_Queue queue = {0};
+
+    if (Create_Shm_Queue (&queue, options->Input, SHM_QUEUE_SLOTS, SHM_SLOT_CAPACITY) != 0)
+    {
+        if (errno == EEXIST)
+            fprintf (stderr, "The shared-memory queue \"%s\" exists already; "
+                             "another solver may be using it, otherwise remove it from /dev/shm\n", options->Input);
+        else
+            fprintf (stderr, "Cannot create the shared-memory queue \"%s\": %s\n", options->Input, strerror (errno));
+        return 2;
+    }
+
+    struct sigaction action = {0};
+    action.sa_handler = Handle_Stop_Signal;
+    sigaction (SIGINT, &action, NULL);
+    sigaction (SIGTERM, &action, NULL);
+
+    fprintf (stderr, "Solving requests of the shared-memory queue \"%s\"\n", options->Input);
+
+    Serve_Shm_Queue (&queue, options);
+
+    fprintf (stderr, "shm: %llu requests, %llu equations\n",
+             (unsigned long long)atomic_load (&queue.Header->N_Requests),
+             (unsigned long long)atomic_load (&queue.Header->N_Equations));
+
+    Close_Shm_Queue (&queue);
+    shm_unlink (options->Input);
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+#ifndef SHM_MODE_H_INCLUDED
+#define SHM_MODE_H_INCLUDED
+
+#include "Command_Line.h"
+#include "Stream_Mode.h"
+
+#include <stdatomic.h>
+
+#define SHM_QUEUE_SLOTS 64          ///The number of request slots of the queue "--shm" creates (a power of two)
+#define SHM_SLOT_CAPACITY 8192      ///The maximal number of equations in one slot of the queue "--shm" creates
+#define SHM_SPIN_COUNT 2000         ///The number of times a slot is checked before its waiter sleeps in futex ()
+#define SHM_WAIT_TIMEOUT 100000000  ///Nanoseconds a waiter sleeps before it checks if the queue has been stopped
+#define SHM_MAGIC 0x314D48534441555FULL     ///Written into the header after the queue has been set up
+
+/*
+    Shared-memory queue: a named POSIX shared-memory object holds struct Shm_Header and a ring of slots.
+    Every slot has the arrays of one request ("A", "B", "C") and of its results ("X_1", "X_2", "N_Roots"),
+    so a producer writes coefficients and reads roots in place. A slot of the ring position p goes through
+             "Sequence" = 4p (free) -> 4p + 1 (submitted) -> 4p + 2 (solved) -> 4 (p + N_Slots) (free again).
+    Producers take positions with a compare-and-swap of "Tail", the solver takes them one by one in order.
+    Nobody makes a system call while the other side keeps up: a waiter spins SHM_SPIN_COUNT times,
+             then counts itself in "N_Waiting" and sleeps in futex (); the side that changes "Sequence"
+             calls futex () only if "N_Waiting" is not 0.
+    A producer that dies between Claim_Shm_Slot () and Submit_Shm_Slot () stops the queue, so it is meant
+             for cooperating processes of one user.
+*/
+
+///The beginning of the shared memory
+struct Shm_Header
+{
+    _Atomic uint64_t Magic;     ///< SHM_MAGIC when the queue is ready
+    uint32_t N_Slots;           ///< The number of slots (a power of two)
+    uint32_t Slot_Capacity;     ///< The maximal number of equations in one slot
+    uint64_t Slot_Size;         ///< The number of bytes of one slot
+    _Alignas (64) atomic_uint Tail;     ///< The ring position the next producer takes
+    _Alignas (64) atomic_uint Stop;     ///< Not 0 if the solver has stopped or has to stop
+    _Atomic uint64_t N_Requests;        ///< The number of requests that have been solved
+    _Atomic uint64_t N_Equations;       ///< The number of equations that have been solved
+};
+
+///The beginning of every slot in the shared memory, the arrays follow it
+struct Shm_Slot_State
+{
+    _Alignas (64) atomic_uint Sequence; ///< The state of the slot (see above)
+    atomic_uint N_Waiting;              ///< The number of processes that sleep in futex () on "Sequence"
+    uint32_t N_Equations;               ///< The number of equations of the request
+};
+
+///A slot as one process sees it
+struct Shm_Slot
+{
+    struct Shm_Slot_State *State;   ///< The state in the shared memory
+    struct Equation_Block Block;    ///< The arrays of the slot in the shared memory
+};
+
+///A queue mapped into this process
+struct Shm_Queue
+{
+    struct Shm_Header *Header;  ///< The beginning of the mapping
+    size_t Size;                ///< The number of bytes of the mapping
+    struct Shm_Slot *Slots;     ///< Array of "N_Slots" slots
+};
+
+int  Create_Shm_Queue (struct Shm_Queue *queue, const char *name, const uint32_t n_slots, const uint32_t slot_capacity);
+int  Open_Shm_Queue (struct Shm_Queue *queue, const char *name);
+void Close_Shm_Queue (struct Shm_Queue *queue);
+struct Equation_Block *Claim_Shm_Slot (struct Shm_Queue *queue, uint32_t *position);
+void Submit_Shm_Slot (struct Shm_Queue *queue, const uint32_t position, const size_t n_equations);
+int  Wait_Shm_Slot (struct Shm_Queue *queue, const uint32_t position);
+void Release_Shm_Slot (struct Shm_Queue *queue, const uint32_t position);
+int  Solve_Shm_Batch (struct Shm_Queue *queue, const double *a, const double *b, const double *c,
+                      double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations);
+void Stop_Shm_Queue (struct Shm_Queue *queue);
+void Serve_Shm_Queue (struct Shm_Queue *queue, const struct Options *options);
+int  Run_Shm_Mode (const struct Options *options);
+int  Shm_Unit_Test (void);
+
+#endif
@@ -0,0 +1,1807 @@
+#include "Simd_Solver.h"
+#include <stdint.h>
+#include <float.h>
+
+#if defined (__x86_64__) || defined (__i386__)
+#include <immintrin.h>
+#define SIMD_X86
+#endif
+
+#define SIMD_SCRATCH_SIZE 256   ///The number of roots a kernel puts on the stack at a time if the caller does not need them
+#define ZERO_EXPONENT (-(1 << 20))      ///The exponent the SSE2 and AVX2 scaling kernels give to 0, so it drops out of every maximum
+#define MAX_SCALE_EXPONENT (1 << 18)    ///Exponents k and s beyond it come from ZERO_EXPONENT, not from real coefficients
+#define MIN_LDEXP_EXPONENT (-2150)      ///ldexp () of any "double" by a smaller power of two is 0
+
+/*
+    Every kernel below repeats the decisions of Solve_Linear_Equation (), Solve_Quadratic_Equation ()
+    and Compare_Double () lane by lane:
+        Compare_Double (x, 0.0) == Equal  <=>  |x| <= EPSILON (false for NAN)
+        Compare_Double (D, 0.0) == Less   <=>  D < -EPSILON   (false for NAN)
+    Both branches are computed for all lanes and the outcome is chosen with masks.
+    max (0, D) keeps NAN and -0.0 as they are, the same as (D < 0.0) ? 0.0 : D in the scalar code.
+    The arithmetic is done in the same order as in the scalar code, so the results are equal bit for bit.
+    The AVX2 kernels are compiled for AVX2 and FMA, but -ffp-contract=off keeps the compiler from fusing
+    multiplications and additions, because a fused operation is rounded once and would change the results.
+    The complex-root kernels compute sqrt (|D|) for every lane and put it into the real or the imaginary parts
+    with masks, as Solve_Equation_Complex () does, so lanes with D < 0 cost the same as the others.
+    Every public kernel takes NULL arrays like its scalar twin: nothing is solved without the coefficients
+    or the numbers of roots, and the roots nobody needs go to arrays on the stack.
+*/
+
+#ifdef SIMD_X86
+
+#ifdef SOLVER_STATS
+/**
+    \brief Counts the decisions a kernel has made for one vector the same way the scalar functions count them
+
+    A NAN "a" is compared by Compare_Double () once and gives a NAN discriminant, which is compared twice;
+             "b" and "c" are compared only by Solve_Linear_Equation (), "c" only if "b" is 0.
+
+    \param [in] n_roots {The numbers of roots of the vector}
+    \param [in] n_lanes {The number of equations in the vector}
+    \param [in] a_zero {Bit mask of the lanes where "a" is 0 within EPSILON}
+    \param [in] b_zero {Bit mask of the lanes where "b" is 0 within EPSILON}
+    \param [in] D_zero {Bit mask of the lanes where the discriminant is 0 within EPSILON}
+    \param [in] a_nan {Bit mask of the lanes where "a" is NAN}
+    \param [in] b_nan {Bit mask of the lanes where "b" is NAN}
+    \param [in] c_nan {Bit mask of the lanes where "c" is NAN}
+    \param [in] D_nan {Bit mask of the lanes where the discriminant is NAN}
+*/
+static void Count_Vector_Stats (const enum N_Roots *n_roots, const int n_lanes,
+                                const unsigned a_zero, const unsigned b_zero, const unsigned D_zero,
+                                const unsigned a_nan, const unsigned b_nan, const unsigned c_nan, const unsigned D_nan)
+{
+    for (int lane = 0; lane < n_lanes; lane++)
+        (void)STATS_ROOTS (n_roots[lane]);
+
+    STATS_ADD (N_Linear, __builtin_popcount (a_zero));
+    STATS_ADD (N_Near_Degenerate, __builtin_popcount (D_zero & ~a_zero));
+    STATS_ADD (N_NAN_Compares, __builtin_popcount (a_nan) + 2 * __builtin_popcount (D_nan & ~a_zero) +
+                               __builtin_popcount (b_nan & a_zero) + __builtin_popcount (c_nan & b_zero & a_zero));
+}
+#endif
+
+/**
+    \brief Gives a kernel the contract of Solve_Batch () for NULL arrays
+
+    Nothing is solved if an array of coefficients or the array for the numbers of roots is NULL.
+    If an array for the roots is NULL, the kernel is called again for blocks of SIMD_SCRATCH_SIZE equations
+             with an array on the stack instead of it, so the kernels themselves always get all the arrays.
+
+    \param [in] kernel {The kernel that calls this function}
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] x_1 {Array for the first roots or NULL}
+    \param [out] x_2 {Array for the second roots or NULL}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+    \return True if the batch has been dealt with here
+    \return False if all the arrays are there and the kernel should solve the batch itself
+*/
+static bool Solve_Without_Roots (Batch_Solver kernel, const double *a, const double *b, const double *c,
+                                 double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (a == NULL || b == NULL || c == NULL || n_roots == NULL)
+        return true;
+    if (x_1 != NULL && x_2 != NULL)
+        return false;
+
+    double unused_1[SIMD_SCRATCH_SIZE], unused_2[SIMD_SCRATCH_SIZE];
+
+    for (size_t i = 0; i < n_equations; i += SIMD_SCRATCH_SIZE)
+    {
+        size_t count = (n_equations - i < SIMD_SCRATCH_SIZE) ? n_equations - i : SIMD_SCRATCH_SIZE;
+
+        kernel (a + i, b + i, c + i, (x_1 != NULL) ? x_1 + i : unused_1, (x_2 != NULL) ? x_2 + i : unused_2,
+                n_roots + i, count);
+    }
+
+    return true;
+}
+
+/**
+    \brief Gives a complex-root kernel the contract of Solve_Batch_Complex () for NULL arrays
+
+    Does for the four arrays of the parts of the roots what Solve_Without_Roots () does for "x_1" and "x_2".
+
+    \param [in] kernel {The kernel that calls this function}
+    \return True if the batch has been dealt with here
+    \return False if all the arrays are there and the kernel should solve the batch itself
+*/
+static bool Solve_Complex_Without_Roots (Complex_Batch_Solver kernel, const double *a, const double *b, const double *c,
+                                         double *re_1, double *im_1, double *re_2, double *im_2,
+                                         enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (a == NULL || b == NULL || c == NULL || n_roots == NULL)
+        return true;
+    if (re_1 != NULL && im_1 != NULL && re_2 != NULL && im_2 != NULL)
+        return false;
+
+    double unused[4][SIMD_SCRATCH_SIZE];
+
+    for (size_t i = 0; i < n_equations; i += SIMD_SCRATCH_SIZE)
+    {
+        size_t count = (n_equations - i < SIMD_SCRATCH_SIZE) ? n_equations - i : SIMD_SCRATCH_SIZE;
+
+        kernel (a + i, b + i, c + i, (re_1 != NULL) ? re_1 + i : unused[0], (im_1 != NULL) ? im_1 + i : unused[1],
+                (re_2 != NULL) ? re_2 + i : unused[2], (im_2 != NULL) ? im_2 + i : unused[3], n_roots + i, count);
+    }
+
+    return true;
+}
+
+/**
+    \brief Solves equations two at a time with SSE2 instructions
+
+    Calls Solve_Batch () or Solve_Batch_Stable () for the last equation if "n_equations" is odd.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] x_1 {Array for the first roots}
+    \param [out] x_2 {Array for the second roots}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+    \param [in] stable {Find the roots as Solve_Batch_Stable () does instead of Solve_Batch ()}
+*/
+__attribute__ ((target ("sse2"), always_inline))
+static inline void Solve_Vectors_SSE2 (const double *a, const double *b, const double *c,
+                                       double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations,
+                                       const bool stable)
+{
+    assert (a != NULL && b != NULL && c != NULL);
+    assert (x_1 != NULL && x_2 != NULL && n_roots != NULL);
+
+    const __m128d sign_bit  = _mm_set1_pd (-0.0);
+    const __m128d epsilon   = _mm_set1_pd (EPSILON);
+    const __m128d minus_eps = _mm_set1_pd (-EPSILON);
+    const __m128d nan       = _mm_set1_pd (NAN);
+    const __m128d two       = _mm_set1_pd (2.0);
+    const __m128d four      = _mm_set1_pd (4.0);
+
+    size_t i = 0;
+
+    for (; i + 2 <= n_equations; i += 2)
+    {
+        __m128d va = _mm_loadu_pd (a + i);
+        __m128d vb = _mm_loadu_pd (b + i);
+        __m128d vc = _mm_loadu_pd (c + i);
+
+        __m128d a_zero = _mm_cmple_pd (_mm_andnot_pd (sign_bit, va), epsilon);
+        __m128d b_zero = _mm_cmple_pd (_mm_andnot_pd (sign_bit, vb), epsilon);
+        __m128d c_zero = _mm_cmple_pd (_mm_andnot_pd (sign_bit, vc), epsilon);
+
+        __m128d D      = _mm_sub_pd (_mm_mul_pd (vb, vb), _mm_mul_pd (_mm_mul_pd (four, va), vc));
+        __m128d D_less = _mm_cmplt_pd (D, minus_eps);
+        __m128d D_zero = _mm_cmple_pd (_mm_andnot_pd (sign_bit, D), epsilon);
+
+        __m128d sqrt_D   = _mm_sqrt_pd (_mm_max_pd (_mm_setzero_pd (), D));
+        __m128d double_a = _mm_mul_pd (two, va);
+        __m128d minus_b  = _mm_xor_pd (vb, sign_bit);
+        __m128d quad_x_1 = _mm_div_pd (_mm_sub_pd (minus_b, sqrt_D), double_a);
+        __m128d quad_x_2 = _mm_div_pd (_mm_add_pd (minus_b, sqrt_D), double_a);
+
+        if (stable)
+        {
+            __m128d signed_sqrt = _mm_or_pd (_mm_andnot_pd (sign_bit, sqrt_D), _mm_and_pd (sign_bit, vb));
+            __m128d q           = _mm_mul_pd (_mm_add_pd (vb, signed_sqrt), _mm_set1_pd (-0.5));
+            __m128d q_zero      = _mm_cmpeq_pd (q, _mm_setzero_pd ());
+            __m128d root_from_a = _mm_div_pd (q, va);
+            __m128d root_from_c = _mm_div_pd (vc, q);
+            __m128d b_negative  = _mm_castsi128_pd (_mm_shuffle_epi32 (_mm_srai_epi32 (_mm_castpd_si128 (vb), 31),
+                                                                       _MM_SHUFFLE (3, 3, 1, 1)));
+
+            root_from_c = _mm_or_pd (_mm_and_pd (q_zero, root_from_a), _mm_andnot_pd (q_zero, root_from_c));
+            quad_x_1 = _mm_or_pd (_mm_and_pd (b_negative, root_from_c), _mm_andnot_pd (b_negative, root_from_a));
+            quad_x_2 = _mm_or_pd (_mm_and_pd (b_negative, root_from_a), _mm_andnot_pd (b_negative, root_from_c));
+        }
+        __m128d lin_x_1  = _mm_div_pd (_mm_xor_pd (vc, sign_bit), vb);
+
+        quad_x_1 = _mm_or_pd (_mm_and_pd (D_less, nan), _mm_andnot_pd (D_less, quad_x_1));
+        quad_x_2 = _mm_or_pd (_mm_and_pd (D_less, nan), _mm_andnot_pd (D_less, quad_x_2));
+        lin_x_1  = _mm_or_pd (_mm_and_pd (b_zero, nan), _mm_andnot_pd (b_zero, lin_x_1));
+
+        __m128d vx_1 = _mm_or_pd (_mm_and_pd (a_zero, lin_x_1), _mm_andnot_pd (a_zero, quad_x_1));
+        __m128d vx_2 = _mm_or_pd (_mm_and_pd (a_zero, nan),     _mm_andnot_pd (a_zero, quad_x_2));
+
+        __m128d quad_n = _mm_set1_pd (Two);
+        quad_n = _mm_or_pd (_mm_and_pd (D_zero, _mm_set1_pd (One)),  _mm_andnot_pd (D_zero, quad_n));
+        quad_n = _mm_or_pd (_mm_and_pd (D_less, _mm_set1_pd (Zero)), _mm_andnot_pd (D_less, quad_n));
+
+        __m128d lin_n = _mm_or_pd (_mm_and_pd (c_zero, _mm_set1_pd (Infinite)),
+                                   _mm_andnot_pd (c_zero, _mm_set1_pd (Zero)));
+        lin_n = _mm_or_pd (_mm_and_pd (b_zero, lin_n), _mm_andnot_pd (b_zero, _mm_set1_pd (One)));
+
+        __m128d vn = _mm_or_pd (_mm_and_pd (a_zero, lin_n), _mm_andnot_pd (a_zero, quad_n));
+
+        _mm_storeu_pd (x_1 + i, vx_1);
+        _mm_storeu_pd (x_2 + i, vx_2);
+        _mm_storel_epi64 ((__m128i *)(n_roots + i), _mm_cvtpd_epi32 (vn));
+
+#ifdef SOLVER_STATS
+        Count_Vector_Stats (n_roots + i, 2, _mm_movemask_pd (a_zero), _mm_movemask_pd (b_zero), _mm_movemask_pd (D_zero),
+                            _mm_movemask_pd (_mm_cmpunord_pd (va, va)), _mm_movemask_pd (_mm_cmpunord_pd (vb, vb)),
+                            _mm_movemask_pd (_mm_cmpunord_pd (vc, vc)), _mm_movemask_pd (_mm_cmpunord_pd (D, D)));
+#endif
+    }
+
+    (stable ? Solve_Batch_Stable : Solve_Batch) (a + i, b + i, c + i, x_1 + i, x_2 + i, n_roots + i, n_equations - i);
+}
+
+/**
+    \brief Solves equations two at a time with SSE2 instructions
+
+    Calls Solve_Vectors_SSE2 (). The results are the same as the ones of Solve_Batch ().
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] x_1 {Array for the first roots}
+    \param [out] x_2 {Array for the second roots}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+__attribute__ ((target ("sse2")))
+void Solve_Batch_SSE2 (const double *a, const double *b, const double *c,
+                      double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (!Solve_Without_Roots (Solve_Batch_SSE2, a, b, c, x_1, x_2, n_roots, n_equations))
+        Solve_Vectors_SSE2 (a, b, c, x_1, x_2, n_roots, n_equations, false);
+}
+
+/**
+    \brief Solves equations two at a time with SSE2 instructions without losing the smaller root
+
+    Calls Solve_Vectors_SSE2 (). The results are the same as the ones of Solve_Batch_Stable ().
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] x_1 {Array for the first roots}
+    \param [out] x_2 {Array for the second roots}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+__attribute__ ((target ("sse2")))
+void Solve_Batch_Stable_SSE2 (const double *a, const double *b, const double *c,
+                             double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (!Solve_Without_Roots (Solve_Batch_Stable_SSE2, a, b, c, x_1, x_2, n_roots, n_equations))
+        Solve_Vectors_SSE2 (a, b, c, x_1, x_2, n_roots, n_equations, true);
+}
+
+/**
+    \brief Solves equations four at a time with AVX2 instructions
+
+    Calls Solve_Batch () or Solve_Batch_Stable () for the last (n_equations % 4) equations.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] x_1 {Array for the first roots}
+    \param [out] x_2 {Array for the second roots}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+    \param [in] stable {Find the roots as Solve_Batch_Stable () does instead of Solve_Batch ()}
+*/
+__attribute__ ((target ("avx2,fma"), always_inline))
+static inline void Solve_Vectors_AVX2 (const double *a, const double *b, const double *c,
+                                       double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations,
+                                       const bool stable)
+{
+    assert (a != NULL && b != NULL && c != NULL);
+    assert (x_1 != NULL && x_2 != NULL && n_roots != NULL);
+
+    const __m256d sign_bit  = _mm256_set1_pd (-0.0);
+    const __m256d epsilon   = _mm256_set1_pd (EPSILON);
+    const __m256d minus_eps = _mm256_set1_pd (-EPSILON);
+    const __m256d nan       = _mm256_set1_pd (NAN);
+    const __m256d two       = _mm256_set1_pd (2.0);
+    const __m256d four      = _mm256_set1_pd (4.0);
+
+    size_t i = 0;
+
+    for (; i + 4 <= n_equations; i += 4)
+    {
+        __m256d va = _mm256_loadu_pd (a + i);
+        __m256d vb = _mm256_loadu_pd (b + i);
+        __m256d vc = _mm256_loadu_pd (c + i);
+
+        __m256d a_zero = _mm256_cmp_pd (_mm256_andnot_pd (sign_bit, va), epsilon, _CMP_LE_OQ);
+        __m256d b_zero = _mm256_cmp_pd (_mm256_andnot_pd (sign_bit, vb), epsilon, _CMP_LE_OQ);
+        __m256d c_zero = _mm256_cmp_pd (_mm256_andnot_pd (sign_bit, vc), epsilon, _CMP_LE_OQ);
+
+        __m256d D      = _mm256_sub_pd (_mm256_mul_pd (vb, vb), _mm256_mul_pd (_mm256_mul_pd (four, va), vc));
+        __m256d D_less = _mm256_cmp_pd (D, minus_eps, _CMP_LT_OQ);
+        __m256d D_zero = _mm256_cmp_pd (_mm256_andnot_pd (sign_bit, D), epsilon, _CMP_LE_OQ);
+
+        __m256d sqrt_D   = _mm256_sqrt_pd (_mm256_max_pd (_mm256_setzero_pd (), D));
+        __m256d double_a = _mm256_mul_pd (two, va);
+        __m256d minus_b  = _mm256_xor_pd (vb, sign_bit);
+        __m256d quad_x_1 = _mm256_div_pd (_mm256_sub_pd (minus_b, sqrt_D), double_a);
+        __m256d quad_x_2 = _mm256_div_pd (_mm256_add_pd (minus_b, sqrt_D), double_a);
+
+        if (stable)
+        {
+            __m256d signed_sqrt = _mm256_or_pd (_mm256_andnot_pd (sign_bit, sqrt_D), _mm256_and_pd (sign_bit, vb));
+            __m256d q           = _mm256_mul_pd (_mm256_add_pd (vb, signed_sqrt), _mm256_set1_pd (-0.5));
+            __m256d root_from_a = _mm256_div_pd (q, va);
+            __m256d root_from_c = _mm256_div_pd (vc, q);
+
+            root_from_c = _mm256_blendv_pd (root_from_c, root_from_a, _mm256_cmp_pd (q, _mm256_setzero_pd (), _CMP_EQ_OQ));
+            quad_x_1 = _mm256_blendv_pd (root_from_a, root_from_c, vb);    // blendv takes the sign bits of "b"
+            quad_x_2 = _mm256_blendv_pd (root_from_c, root_from_a, vb);
+        }
+        __m256d lin_x_1  = _mm256_div_pd (_mm256_xor_pd (vc, sign_bit), vb);
+
+        quad_x_1 = _mm256_blendv_pd (quad_x_1, nan, D_less);
+        quad_x_2 = _mm256_blendv_pd (quad_x_2, nan, D_less);
+        lin_x_1  = _mm256_blendv_pd (lin_x_1,  nan, b_zero);
+
+        __m256d vx_1 = _mm256_blendv_pd (quad_x_1, lin_x_1, a_zero);
+        __m256d vx_2 = _mm256_blendv_pd (quad_x_2, nan,     a_zero);
+
+        __m256d quad_n = _mm256_blendv_pd (_mm256_set1_pd (Two), _mm256_set1_pd (One), D_zero);
+        quad_n = _mm256_blendv_pd (quad_n, _mm256_set1_pd (Zero), D_less);
+
+        __m256d lin_n = _mm256_blendv_pd (_mm256_set1_pd (Zero), _mm256_set1_pd (Infinite), c_zero);
+        lin_n = _mm256_blendv_pd (_mm256_set1_pd (One), lin_n, b_zero);
+
+        __m256d vn = _mm256_blendv_pd (quad_n, lin_n, a_zero);
+
+        _mm256_storeu_pd (x_1 + i, vx_1);
+        _mm256_storeu_pd (x_2 + i, vx_2);
+        _mm_storeu_si128 ((__m128i *)(n_roots + i), _mm256_cvtpd_epi32 (vn));
+
+#ifdef SOLVER_STATS
+        Count_Vector_Stats (n_roots + i, 4, _mm256_movemask_pd (a_zero), _mm256_movemask_pd (b_zero), _mm256_movemask_pd (D_zero),
+                            _mm256_movemask_pd (_mm256_cmp_pd (va, va, _CMP_UNORD_Q)),
+                            _mm256_movemask_pd (_mm256_cmp_pd (vb, vb, _CMP_UNORD_Q)),
+                            _mm256_movemask_pd (_mm256_cmp_pd (vc, vc, _CMP_UNORD_Q)),
+                            _mm256_movemask_pd (_mm256_cmp_pd (D, D, _CMP_UNORD_Q)));
+#endif
+    }
+
+    (stable ? Solve_Batch_Stable : Solve_Batch) (a + i, b + i, c + i, x_1 + i, x_2 + i, n_roots + i, n_equations - i);
+}
+
+/**
+    \brief Solves equations four at a time with AVX2 instructions
+
+    Calls Solve_Vectors_AVX2 (). The results are the same as the ones of Solve_Batch ().
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] x_1 {Array for the first roots}
+    \param [out] x_2 {Array for the second roots}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+__attribute__ ((target ("avx2,fma")))
+void Solve_Batch_AVX2 (const double *a, const double *b, const double *c,
+                      double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (!Solve_Without_Roots (Solve_Batch_AVX2, a, b, c, x_1, x_2, n_roots, n_equations))
+        Solve_Vectors_AVX2 (a, b, c, x_1, x_2, n_roots, n_equations, false);
+}
+
+/**
+    \brief Solves equations four at a time with AVX2 instructions without losing the smaller root
+
+    Calls Solve_Vectors_AVX2 (). The results are the same as the ones of Solve_Batch_Stable ().
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] x_1 {Array for the first roots}
+    \param [out] x_2 {Array for the second roots}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+__attribute__ ((target ("avx2,fma")))
+void Solve_Batch_Stable_AVX2 (const double *a, const double *b, const double *c,
+                             double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (!Solve_Without_Roots (Solve_Batch_Stable_AVX2, a, b, c, x_1, x_2, n_roots, n_equations))
+        Solve_Vectors_AVX2 (a, b, c, x_1, x_2, n_roots, n_equations, true);
+}
+
+/**
+    \brief Solves equations eight at a time with AVX-512 instructions
+
+    Calls Solve_Batch () or Solve_Batch_Stable () for the last (n_equations % 8) equations.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] x_1 {Array for the first roots}
+    \param [out] x_2 {Array for the second roots}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+    \param [in] stable {Find the roots as Solve_Batch_Stable () does instead of Solve_Batch ()}
+*/
+__attribute__ ((target ("avx512f"), always_inline))
+static inline void Solve_Vectors_AVX512 (const double *a, const double *b, const double *c,
+                                         double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations,
+                                         const bool stable)
+{
+    assert (a != NULL && b != NULL && c != NULL);
+    assert (x_1 != NULL && x_2 != NULL && n_roots != NULL);
+
+    const __m512d epsilon   = _mm512_set1_pd (EPSILON);
+    const __m512d minus_eps = _mm512_set1_pd (-EPSILON);
+    const __m512d nan       = _mm512_set1_pd (NAN);
+    const __m512d two       = _mm512_set1_pd (2.0);
+    const __m512d four      = _mm512_set1_pd (4.0);
+    const __m512i sign_bit  = _mm512_set1_epi64 (INT64_MIN);
+
+    size_t i = 0;
+
+    for (; i + 8 <= n_equations; i += 8)
+    {
+        __m512d va = _mm512_loadu_pd (a + i);
+        __m512d vb = _mm512_loadu_pd (b + i);
+        __m512d vc = _mm512_loadu_pd (c + i);
+
+        __mmask8 a_zero = _mm512_cmp_pd_mask (_mm512_abs_pd (va), epsilon, _CMP_LE_OQ);
+        __mmask8 b_zero = _mm512_cmp_pd_mask (_mm512_abs_pd (vb), epsilon, _CMP_LE_OQ);
+        __mmask8 c_zero = _mm512_cmp_pd_mask (_mm512_abs_pd (vc), epsilon, _CMP_LE_OQ);
+
+        __m512d D       = _mm512_sub_pd (_mm512_mul_pd (vb, vb), _mm512_mul_pd (_mm512_mul_pd (four, va), vc));
+        __mmask8 D_less = _mm512_cmp_pd_mask (D, minus_eps, _CMP_LT_OQ);
+        __mmask8 D_zero = _mm512_cmp_pd_mask (_mm512_abs_pd (D), epsilon, _CMP_LE_OQ);
+
+        __m512d sqrt_D   = _mm512_sqrt_pd (_mm512_max_pd (_mm512_setzero_pd (), D));
+        __m512d double_a = _mm512_mul_pd (two, va);
+        __m512d minus_b  = _mm512_castsi512_pd (_mm512_xor_epi64 (_mm512_castpd_si512 (vb), sign_bit));
+        __m512d minus_c  = _mm512_castsi512_pd (_mm512_xor_epi64 (_mm512_castpd_si512 (vc), sign_bit));
+        __m512d quad_x_1 = _mm512_div_pd (_mm512_sub_pd (minus_b, sqrt_D), double_a);
+        __m512d quad_x_2 = _mm512_div_pd (_mm512_add_pd (minus_b, sqrt_D), double_a);
+        __m512d lin_x_1  = _mm512_div_pd (minus_c, vb);
+
+        if (stable)
+        {
+            __m512i b_sign      = _mm512_and_epi64 (_mm512_castpd_si512 (vb), sign_bit);
+            __m512d signed_sqrt = _mm512_castsi512_pd (_mm512_or_epi64 (_mm512_andnot_epi64 (sign_bit, _mm512_castpd_si512 (sqrt_D)),
+                                                                        b_sign));
+            __m512d q           = _mm512_mul_pd (_mm512_add_pd (vb, signed_sqrt), _mm512_set1_pd (-0.5));
+            __m512d root_from_a = _mm512_div_pd (q, va);
+            __m512d root_from_c = _mm512_div_pd (vc, q);
+            __mmask8 b_negative = _mm512_test_epi64_mask (_mm512_castpd_si512 (vb), sign_bit);
+
+            root_from_c = _mm512_mask_blend_pd (_mm512_cmp_pd_mask (q, _mm512_setzero_pd (), _CMP_EQ_OQ), root_from_c, root_from_a);
+            quad_x_1 = _mm512_mask_blend_pd (b_negative, root_from_a, root_from_c);
+            quad_x_2 = _mm512_mask_blend_pd (b_negative, root_from_c, root_from_a);
+        }
+
+        quad_x_1 = _mm512_mask_blend_pd (D_less, quad_x_1, nan);
+        quad_x_2 = _mm512_mask_blend_pd (D_less, quad_x_2, nan);
+        lin_x_1  = _mm512_mask_blend_pd (b_zero, lin_x_1,  nan);
+
+        __m512d vx_1 = _mm512_mask_blend_pd (a_zero, quad_x_1, lin_x_1);
+        __m512d vx_2 = _mm512_mask_blend_pd (a_zero, quad_x_2, nan);
+
+        __m512i quad_n = _mm512_set1_epi64 (Two);
+        quad_n = _mm512_mask_blend_epi64 (D_zero, quad_n, _mm512_set1_epi64 (One));
+        quad_n = _mm512_mask_blend_epi64 (D_less, quad_n, _mm512_set1_epi64 (Zero));
+
+        __m512i lin_n = _mm512_mask_blend_epi64 (c_zero, _mm512_set1_epi64 (Zero), _mm512_set1_epi64 (Infinite));
+        lin_n = _mm512_mask_blend_epi64 (b_zero, _mm512_set1_epi64 (One), lin_n);
+
+        __m256i vn = _mm512_cvtepi64_epi32 (_mm512_mask_blend_epi64 (a_zero, quad_n, lin_n));
+
+        _mm512_storeu_pd (x_1 + i, vx_1);
+        _mm512_storeu_pd (x_2 + i, vx_2);
+        _mm256_storeu_si256 ((__m256i *)(n_roots + i), vn);
+
+#ifdef SOLVER_STATS
+        Count_Vector_Stats (n_roots + i, 8, a_zero, b_zero, D_zero,
+                            _mm512_cmp_pd_mask (va, va, _CMP_UNORD_Q), _mm512_cmp_pd_mask (vb, vb, _CMP_UNORD_Q),
+                            _mm512_cmp_pd_mask (vc, vc, _CMP_UNORD_Q), _mm512_cmp_pd_mask (D, D, _CMP_UNORD_Q));
+#endif
+    }
+
+    (stable ? Solve_Batch_Stable : Solve_Batch) (a + i, b + i, c + i, x_1 + i, x_2 + i, n_roots + i, n_equations - i);
+}
+
+/**
+    \brief Solves equations eight at a time with AVX-512 instructions
+
+    Calls Solve_Vectors_AVX512 (). The results are the same as the ones of Solve_Batch ().
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] x_1 {Array for the first roots}
+    \param [out] x_2 {Array for the second roots}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+__attribute__ ((target ("avx512f")))
+void Solve_Batch_AVX512 (const double *a, const double *b, const double *c,
+                        double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (!Solve_Without_Roots (Solve_Batch_AVX512, a, b, c, x_1, x_2, n_roots, n_equations))
+        Solve_Vectors_AVX512 (a, b, c, x_1, x_2, n_roots, n_equations, false);
+}
+
+/**
+    \brief Solves equations eight at a time with AVX-512 instructions without losing the smaller root
+
+    Calls Solve_Vectors_AVX512 (). The results are the same as the ones of Solve_Batch_Stable ().
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] x_1 {Array for the first roots}
+    \param [out] x_2 {Array for the second roots}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+__attribute__ ((target ("avx512f")))
+void Solve_Batch_Stable_AVX512 (const double *a, const double *b, const double *c,
+                               double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (!Solve_Without_Roots (Solve_Batch_Stable_AVX512, a, b, c, x_1, x_2, n_roots, n_equations))
+        Solve_Vectors_AVX512 (a, b, c, x_1, x_2, n_roots, n_equations, true);
+}
+
+/**
+    \brief Finds the numbers of roots of equations two at a time with SSE2 instructions
+
+    Makes the decisions of Solve_Batch_SSE2 () without the square roots and the divisions.
+    Calls Classify_Batch () for the last equation if "n_equations" is odd.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+__attribute__ ((target ("sse2")))
+void Classify_Batch_SSE2 (const double *a, const double *b, const double *c, enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (a == NULL || b == NULL || c == NULL || n_roots == NULL)
+        return;
+
+    const __m128d sign_bit  = _mm_set1_pd (-0.0);
+    const __m128d epsilon   = _mm_set1_pd (EPSILON);
+    const __m128d minus_eps = _mm_set1_pd (-EPSILON);
+    const __m128d four      = _mm_set1_pd (4.0);
+
+    size_t i = 0;
+
+    for (; i + 2 <= n_equations; i += 2)
+    {
+        __m128d va = _mm_loadu_pd (a + i);
+        __m128d vb = _mm_loadu_pd (b + i);
+        __m128d vc = _mm_loadu_pd (c + i);
+
+        __m128d a_zero = _mm_cmple_pd (_mm_andnot_pd (sign_bit, va), epsilon);
+        __m128d b_zero = _mm_cmple_pd (_mm_andnot_pd (sign_bit, vb), epsilon);
+        __m128d c_zero = _mm_cmple_pd (_mm_andnot_pd (sign_bit, vc), epsilon);
+
+        __m128d D      = _mm_sub_pd (_mm_mul_pd (vb, vb), _mm_mul_pd (_mm_mul_pd (four, va), vc));
+        __m128d D_less = _mm_cmplt_pd (D, minus_eps);
+        __m128d D_zero = _mm_cmple_pd (_mm_andnot_pd (sign_bit, D), epsilon);
+
+        __m128d quad_n = _mm_set1_pd (Two);
+        quad_n = _mm_or_pd (_mm_and_pd (D_zero, _mm_set1_pd (One)),  _mm_andnot_pd (D_zero, quad_n));
+        quad_n = _mm_or_pd (_mm_and_pd (D_less, _mm_set1_pd (Zero)), _mm_andnot_pd (D_less, quad_n));
+
+        __m128d lin_n = _mm_or_pd (_mm_and_pd (c_zero, _mm_set1_pd (Infinite)),
+                                   _mm_andnot_pd (c_zero, _mm_set1_pd (Zero)));
+        lin_n = _mm_or_pd (_mm_and_pd (b_zero, lin_n), _mm_andnot_pd (b_zero, _mm_set1_pd (One)));
+
+        __m128d vn = _mm_or_pd (_mm_and_pd (a_zero, lin_n), _mm_andnot_pd (a_zero, quad_n));
+
+        _mm_storel_epi64 ((__m128i *)(n_roots + i), _mm_cvtpd_epi32 (vn));
+    }
+
+    Classify_Batch (a + i, b + i, c + i, n_roots + i, n_equations - i);
+}
+
+/**
+    \brief Finds the numbers of roots of equations four at a time with AVX2 instructions
+
+    Makes the decisions of Solve_Batch_AVX2 () without the square roots and the divisions.
+    Calls Classify_Batch () for the last (n_equations % 4) equations.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+__attribute__ ((target ("avx2,fma")))
+void Classify_Batch_AVX2 (const double *a, const double *b, const double *c, enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (a == NULL || b == NULL || c == NULL || n_roots == NULL)
+        return;
+
+    const __m256d sign_bit  = _mm256_set1_pd (-0.0);
+    const __m256d epsilon   = _mm256_set1_pd (EPSILON);
+    const __m256d minus_eps = _mm256_set1_pd (-EPSILON);
+    const __m256d four      = _mm256_set1_pd (4.0);
+
+    size_t i = 0;
+
+    for (; i + 4 <= n_equations; i += 4)
+    {
+        __m256d va = _mm256_loadu_pd (a + i);
+        __m256d vb = _mm256_loadu_pd (b + i);
+        __m256d vc = _mm256_loadu_pd (c + i);
+
+        __m256d a_zero = _mm256_cmp_pd (_mm256_andnot_pd (sign_bit, va), epsilon, _CMP_LE_OQ);
+        __m256d b_zero = _mm256_cmp_pd (_mm256_andnot_pd (sign_bit, vb), epsilon, _CMP_LE_OQ);
+        __m256d c_zero = _mm256_cmp_pd (_mm256_andnot_pd (sign_bit, vc), epsilon, _CMP_LE_OQ);
+
+        __m256d D      = _mm256_sub_pd (_mm256_mul_pd (vb, vb), _mm256_mul_pd (_mm256_mul_pd (four, va), vc));
+        __m256d D_less = _mm256_cmp_pd (D, minus_eps, _CMP_LT_OQ);
+        __m256d D_zero = _mm256_cmp_pd (_mm256_andnot_pd (sign_bit, D), epsilon, _CMP_LE_OQ);
+
+        __m256d quad_n = _mm256_blendv_pd (_mm256_set1_pd (Two), _mm256_set1_pd (One), D_zero);
+        quad_n = _mm256_blendv_pd (quad_n, _mm256_set1_pd (Zero), D_less);
+
+        __m256d lin_n = _mm256_blendv_pd (_mm256_set1_pd (Zero), _mm256_set1_pd (Infinite), c_zero);
+        lin_n = _mm256_blendv_pd (_mm256_set1_pd (One), lin_n, b_zero);
+
+        __m256d vn = _mm256_blendv_pd (quad_n, lin_n, a_zero);
+
+        _mm_storeu_si128 ((__m128i *)(n_roots + i), _mm256_cvtpd_epi32 (vn));
+    }
+
+    Classify_Batch (a + i, b + i, c + i, n_roots + i, n_equations - i);
+}
+
+/**
+    \brief Finds the numbers of roots of equations eight at a time with AVX-512 instructions
+
+    Makes the decisions of Solve_Batch_AVX512 () without the square roots and the divisions.
+    Calls Classify_Batch () for the last (n_equations % 8) equations.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+__attribute__ ((target ("avx512f")))
+void Classify_Batch_AVX512 (const double *a, const double *b, const double *c, enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (a == NULL || b == NULL || c == NULL || n_roots == NULL)
+        return;
+
+    const __m512d epsilon   = _mm512_set1_pd (EPSILON);
+    const __m512d minus_eps = _mm512_set1_pd (-EPSILON);
+    const __m512d four      = _mm512_set1_pd (4.0);
+
+    size_t i = 0;
+
+    for (; i + 8 <= n_equations; i += 8)
+    {
+        __m512d va = _mm512_loadu_pd (a + i);
+        __m512d vb = _mm512_loadu_pd (b + i);
+        __m512d vc = _mm512_loadu_pd (c + i);
+
+        __mmask8 a_zero = _mm512_cmp_pd_mask (_mm512_abs_pd (va), epsilon, _CMP_LE_OQ);
+        __mmask8 b_zero = _mm512_cmp_pd_mask (_mm512_abs_pd (vb), epsilon, _CMP_LE_OQ);
+        __mmask8 c_zero = _mm512_cmp_pd_mask (_mm512_abs_pd (vc), epsilon, _CMP_LE_OQ);
+
+        __m512d D       = _mm512_sub_pd (_mm512_mul_pd (vb, vb), _mm512_mul_pd (_mm512_mul_pd (four, va), vc));
+        __mmask8 D_less = _mm512_cmp_pd_mask (D, minus_eps, _CMP_LT_OQ);
+        __mmask8 D_zero = _mm512_cmp_pd_mask (_mm512_abs_pd (D), epsilon, _CMP_LE_OQ);
+
+        __m512i quad_n = _mm512_set1_epi64 (Two);
+        quad_n = _mm512_mask_blend_epi64 (D_zero, quad_n, _mm512_set1_epi64 (One));
+        quad_n = _mm512_mask_blend_epi64 (D_less, quad_n, _mm512_set1_epi64 (Zero));
+
+        __m512i lin_n = _mm512_mask_blend_epi64 (c_zero, _mm512_set1_epi64 (Zero), _mm512_set1_epi64 (Infinite));
+        lin_n = _mm512_mask_blend_epi64 (b_zero, _mm512_set1_epi64 (One), lin_n);
+
+        __m256i vn = _mm512_cvtepi64_epi32 (_mm512_mask_blend_epi64 (a_zero, quad_n, lin_n));
+
+        _mm256_storeu_si256 ((__m256i *)(n_roots + i), vn);
+    }
+
+    Classify_Batch (a + i, b + i, c + i, n_roots + i, n_equations - i);
+}
+
+/**
+    \brief Solves equations two at a time with SSE2 instructions and gives complex roots
+
+    Computes the roots the way Solve_Equation_Complex () does: sqrt (|D|) is found for all lanes
+             and is put into the real or the imaginary parts with masks.
+    Calls Solve_Batch_Complex () for the last equation if "n_equations" is odd.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] re_1 {Array for the real parts of the first roots}
+    \param [out] im_1 {Array for the imaginary parts of the first roots}
+    \param [out] re_2 {Array for the real parts of the second roots}
+    \param [out] im_2 {Array for the imaginary parts of the second roots}
+    \param [out] n_roots {Array for the numbers of real roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+__attribute__ ((target ("sse2")))
+void Solve_Batch_Complex_SSE2 (const double *a, const double *b, const double *c,
+                               double *re_1, double *im_1, double *re_2, double *im_2,
+                               enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (Solve_Complex_Without_Roots (Solve_Batch_Complex_SSE2, a, b, c, re_1, im_1, re_2, im_2, n_roots, n_equations))
+        return;
+
+    const __m128d sign_bit  = _mm_set1_pd (-0.0);
+    const __m128d epsilon   = _mm_set1_pd (EPSILON);
+    const __m128d minus_eps = _mm_set1_pd (-EPSILON);
+    const __m128d nan       = _mm_set1_pd (NAN);
+    const __m128d two       = _mm_set1_pd (2.0);
+    const __m128d four      = _mm_set1_pd (4.0);
+
+    size_t i = 0;
+
+    for (; i + 2 <= n_equations; i += 2)
+    {
+        __m128d va = _mm_loadu_pd (a + i);
+        __m128d vb = _mm_loadu_pd (b + i);
+        __m128d vc = _mm_loadu_pd (c + i);
+
+        __m128d a_zero = _mm_cmple_pd (_mm_andnot_pd (sign_bit, va), epsilon);
+        __m128d b_zero = _mm_cmple_pd (_mm_andnot_pd (sign_bit, vb), epsilon);
+        __m128d c_zero = _mm_cmple_pd (_mm_andnot_pd (sign_bit, vc), epsilon);
+
+        __m128d D      = _mm_sub_pd (_mm_mul_pd (vb, vb), _mm_mul_pd (_mm_mul_pd (four, va), vc));
+        __m128d D_less = _mm_cmplt_pd (D, minus_eps);
+        __m128d D_zero = _mm_cmple_pd (_mm_andnot_pd (sign_bit, D), epsilon);
+        __m128d D_neg  = _mm_cmplt_pd (D, _mm_setzero_pd ());
+
+        __m128d sqrt_D    = _mm_sqrt_pd (_mm_andnot_pd (sign_bit, D));
+        __m128d real_part = _mm_andnot_pd (D_neg, _mm_or_pd (sqrt_D, _mm_and_pd (sign_bit, D)));
+        __m128d double_a  = _mm_mul_pd (two, va);
+        __m128d imag_part = _mm_div_pd (sqrt_D, double_a);
+        __m128d minus_b   = _mm_xor_pd (vb, sign_bit);
+        __m128d quad_re_1 = _mm_div_pd (_mm_sub_pd (minus_b, real_part), double_a);
+        __m128d quad_re_2 = _mm_div_pd (_mm_add_pd (minus_b, real_part), double_a);
+        __m128d quad_im_1 = _mm_and_pd (D_less, _mm_xor_pd (imag_part, sign_bit));
+        __m128d quad_im_2 = _mm_and_pd (D_less, imag_part);
+        __m128d lin_re_1  = _mm_div_pd (_mm_xor_pd (vc, sign_bit), vb);
+
+        lin_re_1 = _mm_or_pd (_mm_and_pd (b_zero, nan), _mm_andnot_pd (b_zero, lin_re_1));
+
+        __m128d vre_1 = _mm_or_pd (_mm_and_pd (a_zero, lin_re_1), _mm_andnot_pd (a_zero, quad_re_1));
+        __m128d vim_1 = _mm_or_pd (_mm_and_pd (a_zero, _mm_and_pd (b_zero, nan)), _mm_andnot_pd (a_zero, quad_im_1));
+        __m128d vre_2 = _mm_or_pd (_mm_and_pd (a_zero, nan), _mm_andnot_pd (a_zero, quad_re_2));
+        __m128d vim_2 = _mm_or_pd (_mm_and_pd (a_zero, nan), _mm_andnot_pd (a_zero, quad_im_2));
+
+        __m128d quad_n = _mm_set1_pd (Two);
+        quad_n = _mm_or_pd (_mm_and_pd (D_zero, _mm_set1_pd (One)),  _mm_andnot_pd (D_zero, quad_n));
+        quad_n = _mm_or_pd (_mm_and_pd (D_less, _mm_set1_pd (Zero)), _mm_andnot_pd (D_less, quad_n));
+
+        __m128d lin_n = _mm_or_pd (_mm_and_pd (c_zero, _mm_set1_pd (Infinite)),
+                                   _mm_andnot_pd (c_zero, _mm_set1_pd (Zero)));
+        lin_n = _mm_or_pd (_mm_and_pd (b_zero, lin_n), _mm_andnot_pd (b_zero, _mm_set1_pd (One)));
+
+        __m128d vn = _mm_or_pd (_mm_and_pd (a_zero, lin_n), _mm_andnot_pd (a_zero, quad_n));
+
+        _mm_storeu_pd (re_1 + i, vre_1);
+        _mm_storeu_pd (im_1 + i, vim_1);
+        _mm_storeu_pd (re_2 + i, vre_2);
+        _mm_storeu_pd (im_2 + i, vim_2);
+        _mm_storel_epi64 ((__m128i *)(n_roots + i), _mm_cvtpd_epi32 (vn));
+    }
+
+    Solve_Batch_Complex (a + i, b + i, c + i, re_1 + i, im_1 + i, re_2 + i, im_2 + i, n_roots + i, n_equations - i);
+}
+
+/**
+    \brief Solves equations four at a time with AVX2 instructions and gives complex roots
+
+    Computes the roots the way Solve_Batch_Complex_SSE2 () does.
+    Calls Solve_Batch_Complex () for the last (n_equations % 4) equations.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] re_1 {Array for the real parts of the first roots}
+    \param [out] im_1 {Array for the imaginary parts of the first roots}
+    \param [out] re_2 {Array for the real parts of the second roots}
+    \param [out] im_2 {Array for the imaginary parts of the second roots}
+    \param [out] n_roots {Array for the numbers of real roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+__attribute__ ((target ("avx2,fma")))
+void Solve_Batch_Complex_AVX2 (const double *a, const double *b, const double *c,
+                               double *re_1, double *im_1, double *re_2, double *im_2,
+                               enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (Solve_Complex_Without_Roots (Solve_Batch_Complex_AVX2, a, b, c, re_1, im_1, re_2, im_2, n_roots, n_equations))
+        return;
+
+    const __m256d sign_bit  = _mm256_set1_pd (-0.0);
+    const __m256d epsilon   = _mm256_set1_pd (EPSILON);
+    const __m256d minus_eps = _mm256_set1_pd (-EPSILON);
+    const __m256d nan       = _mm256_set1_pd (NAN);
+    const __m256d two       = _mm256_set1_pd (2.0);
+    const __m256d four      = _mm256_set1_pd (4.0);
+
+    size_t i = 0;
+
+    for (; i + 4 <= n_equations; i += 4)
+    {
+        __m256d va = _mm256_loadu_pd (a + i);
+        __m256d vb = _mm256_loadu_pd (b + i);
+        __m256d vc = _mm256_loadu_pd (c + i);
+
+        __m256d a_zero = _mm256_cmp_pd (_mm256_andnot_pd (sign_bit, va), epsilon, _CMP_LE_OQ);
+        __m256d b_zero = _mm256_cmp_pd (_mm256_andnot_pd (sign_bit, vb), epsilon, _CMP_LE_OQ);
+        __m256d c_zero = _mm256_cmp_pd (_mm256_andnot_pd (sign_bit, vc), epsilon, _CMP_LE_OQ);
+
+        __m256d D      = _mm256_sub_pd (_mm256_mul_pd (vb, vb), _mm256_mul_pd (_mm256_mul_pd (four, va), vc));
+        __m256d D_less = _mm256_cmp_pd (D, minus_eps, _CMP_LT_OQ);
+        __m256d D_zero = _mm256_cmp_pd (_mm256_andnot_pd (sign_bit, D), epsilon, _CMP_LE_OQ);
+        __m256d D_neg  = _mm256_cmp_pd (D, _mm256_setzero_pd (), _CMP_LT_OQ);
+
+        __m256d sqrt_D    = _mm256_sqrt_pd (_mm256_andnot_pd (sign_bit, D));
+        __m256d real_part = _mm256_andnot_pd (D_neg, _mm256_or_pd (sqrt_D, _mm256_and_pd (sign_bit, D)));
+        __m256d double_a  = _mm256_mul_pd (two, va);
+        __m256d imag_part = _mm256_div_pd (sqrt_D, double_a);
+        __m256d minus_b   = _mm256_xor_pd (vb, sign_bit);
+        __m256d quad_re_1 = _mm256_div_pd (_mm256_sub_pd (minus_b, real_part), double_a);
+        __m256d quad_re_2 = _mm256_div_pd (_mm256_add_pd (minus_b, real_part), double_a);
+        __m256d quad_im_1 = _mm256_and_pd (D_less, _mm256_xor_pd (imag_part, sign_bit));
+        __m256d quad_im_2 = _mm256_and_pd (D_less, imag_part);
+        __m256d lin_re_1  = _mm256_div_pd (_mm256_xor_pd (vc, sign_bit), vb);
+
+        lin_re_1 = _mm256_blendv_pd (lin_re_1, nan, b_zero);
+
+        __m256d vre_1 = _mm256_blendv_pd (quad_re_1, lin_re_1, a_zero);
+        __m256d vim_1 = _mm256_blendv_pd (quad_im_1, _mm256_and_pd (b_zero, nan), a_zero);
+        __m256d vre_2 = _mm256_blendv_pd (quad_re_2, nan, a_zero);
+        __m256d vim_2 = _mm256_blendv_pd (quad_im_2, nan, a_zero);
+
+        __m256d quad_n = _mm256_blendv_pd (_mm256_set1_pd (Two), _mm256_set1_pd (One), D_zero);
+        quad_n = _mm256_blendv_pd (quad_n, _mm256_set1_pd (Zero), D_less);
+
+        __m256d lin_n = _mm256_blendv_pd (_mm256_set1_pd (Zero), _mm256_set1_pd (Infinite), c_zero);
+        lin_n = _mm256_blendv_pd (_mm256_set1_pd (One), lin_n, b_zero);
+
+        __m256d vn = _mm256_blendv_pd (quad_n, lin_n, a_zero);
+
+        _mm256_storeu_pd (re_1 + i, vre_1);
+        _mm256_storeu_pd (im_1 + i, vim_1);
+        _mm256_storeu_pd (re_2 + i, vre_2);
+        _mm256_storeu_pd (im_2 + i, vim_2);
+        _mm_storeu_si128 ((__m128i *)(n_roots + i), _mm256_cvtpd_epi32 (vn));
+    }
+
+    Solve_Batch_Complex (a + i, b + i, c + i, re_1 + i, im_1 + i, re_2 + i, im_2 + i, n_roots + i, n_equations - i);
+}
+
+/**
+    \brief Solves equations eight at a time with AVX-512 instructions and gives complex roots
+
+    Computes the roots the way Solve_Batch_Complex_SSE2 () does.
+    Calls Solve_Batch_Complex () for the last (n_equations % 8) equations.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] re_1 {Array for the real parts of the first roots}
+    \param [out] im_1 {Array for the imaginary parts of the first roots}
+    \param [out] re_2 {Array for the real parts of the second roots}
+    \param [out] im_2 {Array for the imaginary parts of the second roots}
+    \param [out] n_roots {Array for the numbers of real roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+__attribute__ ((target ("avx512f")))
+void Solve_Batch_Complex_AVX512 (const double *a, const double *b, const double *c,
+                                 double *re_1, double *im_1, double *re_2, double *im_2,
+                                 enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (Solve_Complex_Without_Roots (Solve_Batch_Complex_AVX512, a, b, c, re_1, im_1, re_2, im_2, n_roots, n_equations))
+        return;
+
+    const __m512d epsilon   = _mm512_set1_pd (EPSILON);
+    const __m512d minus_eps = _mm512_set1_pd (-EPSILON);
+    const __m512d nan       = _mm512_set1_pd (NAN);
+    const __m512d two       = _mm512_set1_pd (2.0);
+    const __m512d four      = _mm512_set1_pd (4.0);
+    const __m512i sign_bit  = _mm512_set1_epi64 (INT64_MIN);
+
+    size_t i = 0;
+
+    for (; i + 8 <= n_equations; i += 8)
+    {
+        __m512d va = _mm512_loadu_pd (a + i);
+        __m512d vb = _mm512_loadu_pd (b + i);
+        __m512d vc = _mm512_loadu_pd (c + i);
+
+        __mmask8 a_zero = _mm512_cmp_pd_mask (_mm512_abs_pd (va), epsilon, _CMP_LE_OQ);
+        __mmask8 b_zero = _mm512_cmp_pd_mask (_mm512_abs_pd (vb), epsilon, _CMP_LE_OQ);
+        __mmask8 c_zero = _mm512_cmp_pd_mask (_mm512_abs_pd (vc), epsilon, _CMP_LE_OQ);
+
+        __m512d D       = _mm512_sub_pd (_mm512_mul_pd (vb, vb), _mm512_mul_pd (_mm512_mul_pd (four, va), vc));
+        __mmask8 D_less = _mm512_cmp_pd_mask (D, minus_eps, _CMP_LT_OQ);
+        __mmask8 D_zero = _mm512_cmp_pd_mask (_mm512_abs_pd (D), epsilon, _CMP_LE_OQ);
+        __mmask8 D_neg  = _mm512_cmp_pd_mask (D, _mm512_setzero_pd (), _CMP_LT_OQ);
+
+        __m512d sqrt_D    = _mm512_sqrt_pd (_mm512_abs_pd (D));
+        __m512d signed_sq = _mm512_castsi512_pd (_mm512_or_epi64 (_mm512_castpd_si512 (sqrt_D),
+                                                                  _mm512_and_epi64 (_mm512_castpd_si512 (D), sign_bit)));
+        __m512d real_part = _mm512_maskz_mov_pd ((__mmask8)~D_neg, signed_sq);
+        __m512d double_a  = _mm512_mul_pd (two, va);
+        __m512d imag_part = _mm512_div_pd (sqrt_D, double_a);
+        __m512d minus_b   = _mm512_castsi512_pd (_mm512_xor_epi64 (_mm512_castpd_si512 (vb), sign_bit));
+        __m512d minus_c   = _mm512_castsi512_pd (_mm512_xor_epi64 (_mm512_castpd_si512 (vc), sign_bit));
+        __m512d minus_im  = _mm512_castsi512_pd (_mm512_xor_epi64 (_mm512_castpd_si512 (imag_part), sign_bit));
+        __m512d quad_re_1 = _mm512_div_pd (_mm512_sub_pd (minus_b, real_part), double_a);
+        __m512d quad_re_2 = _mm512_div_pd (_mm512_add_pd (minus_b, real_part), double_a);
+        __m512d quad_im_1 = _mm512_maskz_mov_pd (D_less, minus_im);
+        __m512d quad_im_2 = _mm512_maskz_mov_pd (D_less, imag_part);
+        __m512d lin_re_1  = _mm512_mask_blend_pd (b_zero, _mm512_div_pd (minus_c, vb), nan);
+
+        __m512d vre_1 = _mm512_mask_blend_pd (a_zero, quad_re_1, lin_re_1);
+        __m512d vim_1 = _mm512_mask_blend_pd (a_zero, quad_im_1, _mm512_maskz_mov_pd (b_zero, nan));
+        __m512d vre_2 = _mm512_mask_blend_pd (a_zero, quad_re_2, nan);
+        __m512d vim_2 = _mm512_mask_blend_pd (a_zero, quad_im_2, nan);
+
+        __m512i quad_n = _mm512_set1_epi64 (Two);
+        quad_n = _mm512_mask_blend_epi64 (D_zero, quad_n, _mm512_set1_epi64 (One));
+        quad_n = _mm512_mask_blend_epi64 (D_less, quad_n, _mm512_set1_epi64 (Zero));
+
+        __m512i lin_n = _mm512_mask_blend_epi64 (c_zero, _mm512_set1_epi64 (Zero), _mm512_set1_epi64 (Infinite));
+        lin_n = _mm512_mask_blend_epi64 (b_zero, _mm512_set1_epi64 (One), lin_n);
+
+        __m256i vn = _mm512_cvtepi64_epi32 (_mm512_mask_blend_epi64 (a_zero, quad_n, lin_n));
+
+        _mm512_storeu_pd (re_1 + i, vre_1);
+        _mm512_storeu_pd (im_1 + i, vim_1);
+        _mm512_storeu_pd (re_2 + i, vre_2);
+        _mm512_storeu_pd (im_2 + i, vim_2);
+        _mm256_storeu_si256 ((__m256i *)(n_roots + i), vn);
+    }
+
+    Solve_Batch_Complex (a + i, b + i, c + i, re_1 + i, im_1 + i, re_2 + i, im_2 + i, n_roots + i, n_equations - i);
+}
+
+/*
+    The SSE2 and AVX2 kernels below find the exponents of Find_Scale_Exponents () (Quadratic_Solver.c) as 32-bit integers
+    from the exponent fields of the coefficients: ilogb (x) is the field minus 1023, a subnormal number is multiplied
+    by 2^54 first, 0 gets ZERO_EXPONENT and a number that is not finite gets 1024, which no finite number has.
+    ldexp () is done by multiplications by powers of two built in the exponent field: a power of two less than 2^-1022
+    is applied as 2^-969 first, so a product is rounded only once, the same as by ldexp ().
+*/
+
+/**
+    \brief Chooses 32-bit integers by a mask with SSE2 instructions
+
+    \param [in] mask {All ones in the lanes where "if_true" is taken, 0 in the others}
+    \param [in] if_true {The numbers for the lanes of the mask}
+    \param [in] if_false {The numbers for the other lanes}
+    \return The chosen numbers
+*/
+__attribute__ ((target ("sse2"), always_inline))
+static inline __m128i Select_Epi32_SSE2 (const __m128i mask, const __m128i if_true, const __m128i if_false)
+{
+    return _mm_or_si128 (_mm_and_si128 (mask, if_true), _mm_andnot_si128 (mask, if_false));
+}
+
+/** \brief Finds the maxima of 32-bit integers with SSE2 instructions, which have no _mm_max_epi32 () */
+__attribute__ ((target ("sse2"), always_inline))
+static inline __m128i Max_Epi32_SSE2 (const __m128i x, const __m128i y)
+{
+    return Select_Epi32_SSE2 (_mm_cmpgt_epi32 (x, y), x, y);
+}
+
+/** \brief Finds the minima of 32-bit integers with SSE2 instructions */
+__attribute__ ((target ("sse2"), always_inline))
+static inline __m128i Min_Epi32_SSE2 (const __m128i x, const __m128i y)
+{
+    return Select_Epi32_SSE2 (_mm_cmplt_epi32 (x, y), x, y);
+}
+
+/** \brief Puts the high 32 bits of the two numbers into the lanes 0 and 1 (and 2 and 3) with SSE2 instructions */
+__attribute__ ((target ("sse2"), always_inline))
+static inline __m128i High_Words_SSE2 (const __m128d x)
+{
+    return _mm_shuffle_epi32 (_mm_castpd_si128 (x), _MM_SHUFFLE (3, 1, 3, 1));
+}
+
+/**
+    \brief Finds ilogb () of two numbers with SSE2 instructions
+
+    \param [in] x {The numbers}
+    \return The exponents in the lanes 0 and 1, ZERO_EXPONENT for 0 and 1024 for a number that is not finite
+*/
+__attribute__ ((target ("sse2"), always_inline))
+static inline __m128i Get_Exponents_SSE2 (const __m128d x)
+{
+    const __m128i field_mask = _mm_set1_epi32 (0x7FF);
+
+    __m128i field     = _mm_and_si128 (_mm_srli_epi32 (High_Words_SSE2 (x), 20), field_mask);
+    __m128i sub_field = _mm_and_si128 (_mm_srli_epi32 (High_Words_SSE2 (_mm_mul_pd (x, _mm_set1_pd (0x1p54))), 20), field_mask);
+    __m128i exponent  = Select_Epi32_SSE2 (_mm_cmpeq_epi32 (field, _mm_setzero_si128 ()),
+                                           _mm_sub_epi32 (sub_field, _mm_set1_epi32 (1023 + 54)),
+                                           _mm_sub_epi32 (field, _mm_set1_epi32 (1023)));
+
+    return Select_Epi32_SSE2 (High_Words_SSE2 (_mm_cmpeq_pd (x, _mm_setzero_pd ())), _mm_set1_epi32 (ZERO_EXPONENT), exponent);
+}
+
+/**
+    \brief Multiplies two numbers by powers of two like ldexp () with SSE2 instructions
+
+    \param [in] x {The numbers}
+    \param [in] n {The powers in the lanes 0 and 1}
+    \return x * 2^n
+*/
+__attribute__ ((target ("sse2"), always_inline))
+static inline __m128d Ldexp_SSE2 (__m128d x, __m128i n)
+{
+    n = Max_Epi32_SSE2 (n, _mm_set1_epi32 (MIN_LDEXP_EXPONENT));
+
+    for (int step = 0; step < 3; step++)    // -2150 -> -1181 -> -212 -> 0 or 2150 -> 1127 -> 104 -> 0
+    {
+        __m128i power = Select_Epi32_SSE2 (_mm_cmplt_epi32 (n, _mm_set1_epi32 (DBL_MIN_EXP - 1)),
+                                           _mm_set1_epi32 (DBL_MIN_EXP - 1 + DBL_MANT_DIG),
+                                           Min_Epi32_SSE2 (n, _mm_set1_epi32 (DBL_MAX_EXP - 1)));
+        __m128i field = _mm_unpacklo_epi32 (_mm_add_epi32 (power, _mm_set1_epi32 (1023)), _mm_setzero_si128 ());
+
+        x = _mm_mul_pd (x, _mm_castsi128_pd (_mm_slli_epi64 (field, 52)));
+        n = _mm_sub_epi32 (n, power);
+    }
+
+    return x;
+}
+
+/**
+    \brief Scales equations two at a time with SSE2 instructions
+
+    The results are the same as the ones of Scale_Coefficients ().
+    Calls Scale_Coefficients () for the last equation if "n_equations" is odd.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] scaled_a {Array for the scaled quadratic coefficients}
+    \param [out] scaled_b {Array for the scaled linear coefficients}
+    \param [out] scaled_c {Array for the scaled free terms}
+    \param [out] exponent {Array for the powers of two the roots have to be multiplied by}
+    \param [in] n_equations {The number of equations in every array}
+*/
+__attribute__ ((target ("sse2")))
+void Scale_Coefficients_SSE2 (const double *a, const double *b, const double *c,
+                              double *scaled_a, double *scaled_b, double *scaled_c, int *exponent, const size_t n_equations)
+{
+    assert (a != NULL && b != NULL && c != NULL);
+    assert (scaled_a != NULL && scaled_b != NULL && scaled_c != NULL && exponent != NULL);
+
+    const __m128i not_finite = _mm_set1_epi32 (DBL_MAX_EXP);
+    const __m128i zero       = _mm_set1_epi32 (ZERO_EXPONENT);
+    const __m128i max_scale  = _mm_set1_epi32 (MAX_SCALE_EXPONENT);
+    const __m128i min_scale  = _mm_set1_epi32 (-MAX_SCALE_EXPONENT);
+
+    size_t i = 0;
+
+    for (; i + 2 <= n_equations; i += 2)
+    {
+        __m128d va = _mm_loadu_pd (a + i);
+        __m128d vb = _mm_loadu_pd (b + i);
+        __m128d vc = _mm_loadu_pd (c + i);
+
+        __m128i e_a = Get_Exponents_SSE2 (va);
+        __m128i e_b = Get_Exponents_SSE2 (vb);
+        __m128i e_c = Get_Exponents_SSE2 (vc);
+
+        __m128i infinite = _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi32 (e_a, not_finite), _mm_cmpeq_epi32 (e_b, not_finite)),
+                                         _mm_cmpeq_epi32 (e_c, not_finite));
+
+        __m128i k_quad = Max_Epi32_SSE2 (_mm_sub_epi32 (e_b, e_a), _mm_srai_epi32 (_mm_sub_epi32 (e_c, e_a), 1));
+        __m128i k_lin  = _mm_sub_epi32 (e_c, e_b);
+        __m128i k      = Select_Epi32_SSE2 (_mm_cmpeq_epi32 (e_a, zero), k_lin, k_quad);
+
+        k = _mm_andnot_si128 (_mm_or_si128 (infinite, _mm_or_si128 (_mm_cmpgt_epi32 (k, max_scale), _mm_cmplt_epi32 (k, min_scale))), k);
+
+        __m128i s = Max_Epi32_SSE2 (Max_Epi32_SSE2 (_mm_add_epi32 (e_a, _mm_add_epi32 (k, k)), _mm_add_epi32 (e_b, k)), e_c);
+
+        s = _mm_andnot_si128 (_mm_or_si128 (infinite, _mm_cmplt_epi32 (s, min_scale)), s);
+
+        _mm_storeu_pd (scaled_a + i, Ldexp_SSE2 (va, _mm_sub_epi32 (_mm_add_epi32 (k, k), s)));
+        _mm_storeu_pd (scaled_b + i, Ldexp_SSE2 (vb, _mm_sub_epi32 (k, s)));
+        _mm_storeu_pd (scaled_c + i, Ldexp_SSE2 (vc, _mm_sub_epi32 (_mm_setzero_si128 (), s)));
+        _mm_storel_epi64 ((__m128i *)(exponent + i), k);
+    }
+
+    Scale_Coefficients (a + i, b + i, c + i, scaled_a + i, scaled_b + i, scaled_c + i, exponent + i, n_equations - i);
+}
+
+/**
+    \brief Multiplies the roots of scaled equations by powers of two two at a time with SSE2 instructions
+
+    The results are the same as the ones of Unscale_Roots ().
+    Calls Unscale_Roots () for the last equation if "n_equations" is odd or for all of them if an array for the roots is NULL.
+
+    \param [in,out] x_1 {Array of the first roots}
+    \param [in,out] x_2 {Array of the second roots}
+    \param [in] exponent {Array of the powers of two}
+    \param [in] n_equations {The number of equations in every array}
+*/
+__attribute__ ((target ("sse2")))
+void Unscale_Roots_SSE2 (double *x_1, double *x_2, const int *exponent, const size_t n_equations)
+{
+    assert (exponent != NULL);
+
+    size_t i = 0;
+
+    for (; x_1 != NULL && x_2 != NULL && i + 2 <= n_equations; i += 2)
+    {
+        __m128i k = _mm_loadl_epi64 ((const __m128i *)(exponent + i));
+
+        _mm_storeu_pd (x_1 + i, Ldexp_SSE2 (_mm_loadu_pd (x_1 + i), k));
+        _mm_storeu_pd (x_2 + i, Ldexp_SSE2 (_mm_loadu_pd (x_2 + i), k));
+    }
+
+    Unscale_Roots (x_1 + i, x_2 + i, exponent + i, n_equations - i);
+}
+
+/** \brief Puts the high 32 bits of the four numbers into the four lanes with AVX2 instructions */
+__attribute__ ((target ("avx2,fma"), always_inline))
+static inline __m128i High_Words_AVX2 (const __m256d x)
+{
+    return _mm256_castsi256_si128 (_mm256_permutevar8x32_epi32 (_mm256_castpd_si256 (x), _mm256_setr_epi32 (1, 3, 5, 7, 1, 3, 5, 7)));
+}
+
+/**
+    \brief Finds ilogb () of four numbers with AVX2 instructions
+
+    \param [in] x {The numbers}
+    \return The exponents, ZERO_EXPONENT for 0 and 1024 for a number that is not finite
+*/
+__attribute__ ((target ("avx2,fma"), always_inline))
+static inline __m128i Get_Exponents_AVX2 (const __m256d x)
+{
+    const __m128i field_mask = _mm_set1_epi32 (0x7FF);
+
+    __m128i field     = _mm_and_si128 (_mm_srli_epi32 (High_Words_AVX2 (x), 20), field_mask);
+    __m128i sub_field = _mm_and_si128 (_mm_srli_epi32 (High_Words_AVX2 (_mm256_mul_pd (x, _mm256_set1_pd (0x1p54))), 20), field_mask);
+    __m128i exponent  = _mm_blendv_epi8 (_mm_sub_epi32 (field, _mm_set1_epi32 (1023)),
+                                         _mm_sub_epi32 (sub_field, _mm_set1_epi32 (1023 + 54)),
+                                         _mm_cmpeq_epi32 (field, _mm_setzero_si128 ()));
+
+    return _mm_blendv_epi8 (exponent, _mm_set1_epi32 (ZERO_EXPONENT),
+                            High_Words_AVX2 (_mm256_cmp_pd (x, _mm256_setzero_pd (), _CMP_EQ_OQ)));
+}
+
+/**
+    \brief Multiplies four numbers by powers of two like ldexp () with AVX2 instructions
+
+    \param [in] x {The numbers}
+    \param [in] n {The powers}
+    \return x * 2^n
+*/
+__attribute__ ((target ("avx2,fma"), always_inline))
+static inline __m256d Ldexp_AVX2 (__m256d x, __m128i n)
+{
+    n = _mm_max_epi32 (n, _mm_set1_epi32 (MIN_LDEXP_EXPONENT));
+
+    for (int step = 0; step < 3; step++)    // -2150 -> -1181 -> -212 -> 0 or 2150 -> 1127 -> 104 -> 0
+    {
+        __m128i power = _mm_blendv_epi8 (_mm_min_epi32 (n, _mm_set1_epi32 (DBL_MAX_EXP - 1)),
+                                         _mm_set1_epi32 (DBL_MIN_EXP - 1 + DBL_MANT_DIG),
+                                         _mm_cmplt_epi32 (n, _mm_set1_epi32 (DBL_MIN_EXP - 1)));
+        __m256i field = _mm256_cvtepu32_epi64 (_mm_add_epi32 (power, _mm_set1_epi32 (1023)));
+
+        x = _mm256_mul_pd (x, _mm256_castsi256_pd (_mm256_slli_epi64 (field, 52)));
+        n = _mm_sub_epi32 (n, power);
+    }
+
+    return x;
+}
+
+/**
+    \brief Scales equations four at a time with AVX2 instructions
+
+    The results are the same as the ones of Scale_Coefficients ().
+    Calls Scale_Coefficients () for the last (n_equations % 4) equations.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] scaled_a {Array for the scaled quadratic coefficients}
+    \param [out] scaled_b {Array for the scaled linear coefficients}
+    \param [out] scaled_c {Array for the scaled free terms}
+    \param [out] exponent {Array for the powers of two the roots have to be multiplied by}
+    \param [in] n_equations {The number of equations in every array}
+*/
+__attribute__ ((target ("avx2,fma")))
+void Scale_Coefficients_AVX2 (const double *a, const double *b, const double *c,
+                              double *scaled_a, double *scaled_b, double *scaled_c, int *exponent, const size_t n_equations)
+{
+    assert (a != NULL && b != NULL && c != NULL);
+    assert (scaled_a != NULL && scaled_b != NULL && scaled_c != NULL && exponent != NULL);
+
+    const __m128i not_finite = _mm_set1_epi32 (DBL_MAX_EXP);
+    const __m128i zero       = _mm_set1_epi32 (ZERO_EXPONENT);
+    const __m128i max_scale  = _mm_set1_epi32 (MAX_SCALE_EXPONENT);
+    const __m128i min_scale  = _mm_set1_epi32 (-MAX_SCALE_EXPONENT);
+
+    size_t i = 0;
+
+    for (; i + 4 <= n_equations; i += 4)
+    {
+        __m256d va = _mm256_loadu_pd (a + i);
+        __m256d vb = _mm256_loadu_pd (b + i);
+        __m256d vc = _mm256_loadu_pd (c + i);
+
+        __m128i e_a = Get_Exponents_AVX2 (va);
+        __m128i e_b = Get_Exponents_AVX2 (vb);
+        __m128i e_c = Get_Exponents_AVX2 (vc);
+
+        __m128i infinite = _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi32 (e_a, not_finite), _mm_cmpeq_epi32 (e_b, not_finite)),
+                                         _mm_cmpeq_epi32 (e_c, not_finite));
+
+        __m128i k_quad = _mm_max_epi32 (_mm_sub_epi32 (e_b, e_a), _mm_srai_epi32 (_mm_sub_epi32 (e_c, e_a), 1));
+        __m128i k_lin  = _mm_sub_epi32 (e_c, e_b);
+        __m128i k      = _mm_blendv_epi8 (k_quad, k_lin, _mm_cmpeq_epi32 (e_a, zero));
+
+        k = _mm_andnot_si128 (_mm_or_si128 (infinite, _mm_or_si128 (_mm_cmpgt_epi32 (k, max_scale), _mm_cmplt_epi32 (k, min_scale))), k);
+
+        __m128i s = _mm_max_epi32 (_mm_max_epi32 (_mm_add_epi32 (e_a, _mm_add_epi32 (k, k)), _mm_add_epi32 (e_b, k)), e_c);
+
+        s = _mm_andnot_si128 (_mm_or_si128 (infinite, _mm_cmplt_epi32 (s, min_scale)), s);
+
+        _mm256_storeu_pd (scaled_a + i, Ldexp_AVX2 (va, _mm_sub_epi32 (_mm_add_epi32 (k, k), s)));
+        _mm256_storeu_pd (scaled_b + i, Ldexp_AVX2 (vb, _mm_sub_epi32 (k, s)));
+        _mm256_storeu_pd (scaled_c + i, Ldexp_AVX2 (vc, _mm_sub_epi32 (_mm_setzero_si128 (), s)));
+        _mm_storeu_si128 ((__m128i *)(exponent + i), k);
+    }
+
+    Scale_Coefficients (a + i, b + i, c + i, scaled_a + i, scaled_b + i, scaled_c + i, exponent + i, n_equations - i);
+}
+
+/**
+    \brief Multiplies the roots of scaled equations by powers of two four at a time with AVX2 instructions
+
+    The results are the same as the ones of Unscale_Roots ().
+    Calls Unscale_Roots () for the last (n_equations % 4) equations or for all of them if an array for the roots is NULL.
+
+    \param [in,out] x_1 {Array of the first roots}
+    \param [in,out] x_2 {Array of the second roots}
+    \param [in] exponent {Array of the powers of two}
+    \param [in] n_equations {The number of equations in every array}
+*/
+__attribute__ ((target ("avx2,fma")))
+void Unscale_Roots_AVX2 (double *x_1, double *x_2, const int *exponent, const size_t n_equations)
+{
+    assert (exponent != NULL);
+
+    size_t i = 0;
+
+    for (; x_1 != NULL && x_2 != NULL && i + 4 <= n_equations; i += 4)
+    {
+        __m128i k = _mm_loadu_si128 ((const __m128i *)(exponent + i));
+
+        _mm256_storeu_pd (x_1 + i, Ldexp_AVX2 (_mm256_loadu_pd (x_1 + i), k));
+        _mm256_storeu_pd (x_2 + i, Ldexp_AVX2 (_mm256_loadu_pd (x_2 + i), k));
+    }
+
+    Unscale_Roots (x_1 + i, x_2 + i, exponent + i, n_equations - i);
+}
+
+/**
+    \brief Scales equations eight at a time with AVX-512 instructions
+
+    Finds the exponents of Find_Scale_Exponents () (Quadratic_Solver.c) with "getexp", which gives ilogb () as a "double"
+             and -infinity for 0, so a coefficient equal to 0 drops out of every maximum; the products are found with
+             "scalef", which rounds like ldexp (). The results are the same as the ones of Scale_Coefficients ().
+    Calls Scale_Coefficients () for the last (n_equations % 8) equations.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] scaled_a {Array for the scaled quadratic coefficients}
+    \param [out] scaled_b {Array for the scaled linear coefficients}
+    \param [out] scaled_c {Array for the scaled free terms}
+    \param [out] exponent {Array for the powers of two the roots have to be multiplied by}
+    \param [in] n_equations {The number of equations in every array}
+*/
+__attribute__ ((target ("avx512f")))
+void Scale_Coefficients_AVX512 (const double *a, const double *b, const double *c,
+                                double *scaled_a, double *scaled_b, double *scaled_c, int *exponent, const size_t n_equations)
+{
+    assert (a != NULL && b != NULL && c != NULL);
+    assert (scaled_a != NULL && scaled_b != NULL && scaled_c != NULL && exponent != NULL);
+
+    const __m512d infinity = _mm512_set1_pd (INFINITY);
+    const __m512d half     = _mm512_set1_pd (0.5);
+    const __m512d two      = _mm512_set1_pd (2.0);
+
+    size_t i = 0;
+
+    for (; i + 8 <= n_equations; i += 8)
+    {
+        __m512d va = _mm512_loadu_pd (a + i);
+        __m512d vb = _mm512_loadu_pd (b + i);
+        __m512d vc = _mm512_loadu_pd (c + i);
+
+        __mmask8 finite = _mm512_cmp_pd_mask (_mm512_abs_pd (va), infinity, _CMP_LT_OQ) &
+                          _mm512_cmp_pd_mask (_mm512_abs_pd (vb), infinity, _CMP_LT_OQ) &
+                          _mm512_cmp_pd_mask (_mm512_abs_pd (vc), infinity, _CMP_LT_OQ);
+        __mmask8 a_zero = _mm512_cmp_pd_mask (va, _mm512_setzero_pd (), _CMP_EQ_OQ);
+
+        __m512d e_a = _mm512_getexp_pd (va);
+        __m512d e_b = _mm512_getexp_pd (vb);
+        __m512d e_c = _mm512_getexp_pd (vc);
+
+        __m512d k_quad = _mm512_max_pd (_mm512_sub_pd (e_b, e_a),
+                                        _mm512_roundscale_pd (_mm512_mul_pd (_mm512_sub_pd (e_c, e_a), half),
+                                                              _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+        __m512d k_lin  = _mm512_sub_pd (e_c, e_b);
+        __m512d k      = _mm512_mask_blend_pd (a_zero, k_quad, k_lin);
+
+        k = _mm512_maskz_mov_pd (finite & _mm512_cmp_pd_mask (_mm512_abs_pd (k), infinity, _CMP_LT_OQ), k);
+
+        __m512d s = _mm512_max_pd (_mm512_max_pd (_mm512_add_pd (e_a, _mm512_mul_pd (two, k)), _mm512_add_pd (e_b, k)), e_c);
+
+        s = _mm512_maskz_mov_pd (finite & _mm512_cmp_pd_mask (s, _mm512_set1_pd (-INFINITY), _CMP_NEQ_OQ), s);
+
+        _mm512_storeu_pd (scaled_a + i, _mm512_scalef_pd (va, _mm512_sub_pd (_mm512_mul_pd (two, k), s)));
+        _mm512_storeu_pd (scaled_b + i, _mm512_scalef_pd (vb, _mm512_sub_pd (k, s)));
+        _mm512_storeu_pd (scaled_c + i, _mm512_scalef_pd (vc, _mm512_sub_pd (_mm512_setzero_pd (), s)));
+        _mm256_storeu_si256 ((__m256i *)(exponent + i), _mm512_cvtpd_epi32 (k));
+    }
+
+    Scale_Coefficients (a + i, b + i, c + i, scaled_a + i, scaled_b + i, scaled_c + i, exponent + i, n_equations - i);
+}
+
+/**
+    \brief Multiplies the roots of scaled equations by powers of two eight at a time with AVX-512 instructions
+
+    The results are the same as the ones of Unscale_Roots ().
+    Calls Unscale_Roots () for the last (n_equations % 8) equations or for all of them if an array for the roots is NULL.
+
+    \param [in,out] x_1 {Array of the first roots}
+    \param [in,out] x_2 {Array of the second roots}
+    \param [in] exponent {Array of the powers of two}
+    \param [in] n_equations {The number of equations in every array}
+*/
+__attribute__ ((target ("avx512f")))
+void Unscale_Roots_AVX512 (double *x_1, double *x_2, const int *exponent, const size_t n_equations)
+{
+    assert (exponent != NULL);
+
+    size_t i = 0;
+
+    for (; x_1 != NULL && x_2 != NULL && i + 8 <= n_equations; i += 8)
+    {
+        __m512d k = _mm512_cvtepi32_pd (_mm256_loadu_si256 ((const __m256i *)(exponent + i)));
+
+        _mm512_storeu_pd (x_1 + i, _mm512_scalef_pd (_mm512_loadu_pd (x_1 + i), k));
+        _mm512_storeu_pd (x_2 + i, _mm512_scalef_pd (_mm512_loadu_pd (x_2 + i), k));
+    }
+
+    Unscale_Roots (x_1 + i, x_2 + i, exponent + i, n_equations - i);
+}
+
+/**
+    \brief Finds the widest instruction set supported by the processor
+
+    Reads the results of cpuid that __builtin_cpu_init () has collected (it can be called before main ()).
+
+    \return Simd_AVX512, Simd_AVX2 (with FMA) or Simd_SSE2
+*/
+enum Simd_Level Get_Simd_Level (void)
+{
+    __builtin_cpu_init ();
+
+    if (__builtin_cpu_supports ("avx512f"))
+        return Simd_AVX512;
+    else if (__builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma"))
+        return Simd_AVX2;
+    else if (__builtin_cpu_supports ("sse2"))
+        return Simd_SSE2;
+    else
+        return Simd_None;
+}
+
+#else
+
+void Solve_Batch_SSE2 (const double *a, const double *b, const double *c,
+                       double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    Solve_Batch (a, b, c, x_1, x_2, n_roots, n_equations);
+}
+
+void Solve_Batch_AVX2 (const double *a, const double *b, const double *c,
+                       double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    Solve_Batch (a, b, c, x_1, x_2, n_roots, n_equations);
+}
+
+void Solve_Batch_AVX512 (const double *a, const double *b, const double *c,
+                         double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    Solve_Batch (a, b, c, x_1, x_2, n_roots, n_equations);
+}
+
+void Solve_Batch_Stable_SSE2 (const double *a, const double *b, const double *c,
+                              double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    Solve_Batch_Stable (a, b, c, x_1, x_2, n_roots, n_equations);
+}
+
+void Solve_Batch_Stable_AVX2 (const double *a, const double *b, const double *c,
+                              double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    Solve_Batch_Stable (a, b, c, x_1, x_2, n_roots, n_equations);
+}
+
+void Solve_Batch_Stable_AVX512 (const double *a, const double *b, const double *c,
+                                double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    Solve_Batch_Stable (a, b, c, x_1, x_2, n_roots, n_equations);
+}
+
+void Classify_Batch_SSE2 (const double *a, const double *b, const double *c, enum N_Roots *n_roots, const size_t n_equations)
+{
+    Classify_Batch (a, b, c, n_roots, n_equations);
+}
+
+void Classify_Batch_AVX2 (const double *a, const double *b, const double *c, enum N_Roots *n_roots, const size_t n_equations)
+{
+    Classify_Batch (a, b, c, n_roots, n_equations);
+}
+
+void Classify_Batch_AVX512 (const double *a, const double *b, const double *c, enum N_Roots *n_roots, const size_t n_equations)
+{
+    Classify_Batch (a, b, c, n_roots, n_equations);
+}
+
+void Solve_Batch_Complex_SSE2 (const double *a, const double *b, const double *c,
+                               double *re_1, double *im_1, double *re_2, double *im_2,
+                               enum N_Roots *n_roots, const size_t n_equations)
+{
+    Solve_Batch_Complex (a, b, c, re_1, im_1, re_2, im_2, n_roots, n_equations);
+}
+
+void Solve_Batch_Complex_AVX2 (const double *a, const double *b, const double *c,
+                               double *re_1, double *im_1, double *re_2, double *im_2,
+                               enum N_Roots *n_roots, const size_t n_equations)
+{
+    Solve_Batch_Complex (a, b, c, re_1, im_1, re_2, im_2, n_roots, n_equations);
+}
+
+void Solve_Batch_Complex_AVX512 (const double *a, const double *b, const double *c,
+                                 double *re_1, double *im_1, double *re_2, double *im_2,
+                                 enum N_Roots *n_roots, const size_t n_equations)
+{
+    Solve_Batch_Complex (a, b, c, re_1, im_1, re_2, im_2, n_roots, n_equations);
+}
+
+void Scale_Coefficients_SSE2 (const double *a, const double *b, const double *c,
+                              double *scaled_a, double *scaled_b, double *scaled_c, int *exponent, const size_t n_equations)
+{
+    Scale_Coefficients (a, b, c, scaled_a, scaled_b, scaled_c, exponent, n_equations);
+}
+
+void Scale_Coefficients_AVX2 (const double *a, const double *b, const double *c,
+                              double *scaled_a, double *scaled_b, double *scaled_c, int *exponent, const size_t n_equations)
+{
+    Scale_Coefficients (a, b, c, scaled_a, scaled_b, scaled_c, exponent, n_equations);
+}
+
+void Scale_Coefficients_AVX512 (const double *a, const double *b, const double *c,
+                                double *scaled_a, double *scaled_b, double *scaled_c, int *exponent, const size_t n_equations)
+{
+    Scale_Coefficients (a, b, c, scaled_a, scaled_b, scaled_c, exponent, n_equations);
+}
+
+void Unscale_Roots_SSE2 (double *x_1, double *x_2, const int *exponent, const size_t n_equations)
+{
+    Unscale_Roots (x_1, x_2, exponent, n_equations);
+}
+
+void Unscale_Roots_AVX2 (double *x_1, double *x_2, const int *exponent, const size_t n_equations)
+{
+    Unscale_Roots (x_1, x_2, exponent, n_equations);
+}
+
+void Unscale_Roots_AVX512 (double *x_1, double *x_2, const int *exponent, const size_t n_equations)
+{
+    Unscale_Roots (x_1, x_2, exponent, n_equations);
+}
+
+enum Simd_Level Get_Simd_Level (void)
+{
+    return Simd_None;
+}
+
+#endif
+
+///The instruction set of the kernels the dispatchers call
+static enum Simd_Level Active_Simd_Level = Simd_None;
+
+/**
+    \brief Chooses the widest instruction set the processor supports for the dispatchers before main () runs
+
+    Calls Get_Simd_Level ().
+*/
+__attribute__ ((constructor))
+static void Select_Simd_Level (void)
+{
+    Active_Simd_Level = Get_Simd_Level ();
+}
+
+/**
+    \brief Returns the instruction set of the kernels Solve_Batch_Simd () and the other dispatchers call
+
+    \return The level chosen at startup or the one forced by Set_Simd_Level ()
+*/
+enum Simd_Level Get_Active_Simd_Level (void)
+{
+    return Active_Simd_Level;
+}
+
+/**
+    \brief Makes the dispatchers call the kernels of a certain instruction set
+
+    Is meant for benchmarks and for comparing the kernels: it has to be called before other threads
+             start solving, because the level is not protected by a lock.
+
+    \param [in] level {Instruction set (Simd_None means Solve_Batch () and the other scalar functions)}
+    \return 0 if the level has been set
+    \return -1 if the processor does not support the instruction set
+*/
+int Set_Simd_Level (const enum Simd_Level level)
+{
+    if (level < Simd_None || level > Get_Simd_Level ())
+        return -1;
+
+    Active_Simd_Level = level;
+
+    return 0;
+}
+
+/**
+    \brief Returns the name of an instruction set as "--isa" takes it
+
+    \param [in] level {Instruction set}
+    \return "none", "sse2", "avx2", "avx512" or NULL for an unknown level
+*/
+const char *Get_Simd_Level_Name (const enum Simd_Level level)
+{
+    static const char *names[] = {"none", "sse2", "avx2", "avx512"};
+
+    return (level >= Simd_None && level <= Simd_AVX512) ? names[level] : NULL;
+}
+
+/**
+    \brief Returns the kernel written for a certain instruction set
+
+    \param [in] level {Instruction set}
+    \return Pointer on the kernel (Solve_Batch () for Simd_None)
+*/
+Batch_Solver Get_Simd_Batch_Solver (const enum Simd_Level level)
+{
+    switch (level)
+    {
+        case Simd_SSE2:
+            return Solve_Batch_SSE2;
+        case Simd_AVX2:
+            return Solve_Batch_AVX2;
+        case Simd_AVX512:
+            return Solve_Batch_AVX512;
+        default:
+            return Solve_Batch;
+    }
+}
+
+/**
+    \brief Solves a batch of equations with the kernel chosen at startup
+
+    Calls the kernel Get_Simd_Batch_Solver () gives for Get_Active_Simd_Level ().
+    The results are the same as the ones of Solve_Batch ().
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] x_1 {Array for the first roots}
+    \param [out] x_2 {Array for the second roots}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+void Solve_Batch_Simd (const double *a, const double *b, const double *c,
+                       double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    Get_Simd_Batch_Solver (Active_Simd_Level) (a, b, c, x_1, x_2, n_roots, n_equations);
+}
+
+/**
+    \brief Returns the kernel of Solve_Batch_Stable () written for a certain instruction set
+
+    \param [in] level {Instruction set}
+    \return Pointer on the kernel (Solve_Batch_Stable () for Simd_None)
+*/
+Batch_Solver Get_Simd_Stable_Solver (const enum Simd_Level level)
+{
+    switch (level)
+    {
+        case Simd_SSE2:
+            return Solve_Batch_Stable_SSE2;
+        case Simd_AVX2:
+            return Solve_Batch_Stable_AVX2;
+        case Simd_AVX512:
+            return Solve_Batch_Stable_AVX512;
+        default:
+            return Solve_Batch_Stable;
+    }
+}
+
+/**
+    \brief Returns the classification kernel written for a certain instruction set
+
+    \param [in] level {Instruction set}
+    \return Pointer on the kernel (Classify_Batch () for Simd_None)
+*/
+Batch_Classifier Get_Simd_Batch_Classifier (const enum Simd_Level level)
+{
+    switch (level)
+    {
+        case Simd_SSE2:
+            return Classify_Batch_SSE2;
+        case Simd_AVX2:
+            return Classify_Batch_AVX2;
+        case Simd_AVX512:
+            return Classify_Batch_AVX512;
+        default:
+            return Classify_Batch;
+    }
+}
+
+/**
+    \brief Finds the numbers of roots of a batch of equations with the kernel chosen at startup
+
+    Calls the kernel Get_Simd_Batch_Classifier () gives for Get_Active_Simd_Level ().
+    The results are the same as the numbers of roots Solve_Batch () finds.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+void Classify_Batch_Simd (const double *a, const double *b, const double *c, enum N_Roots *n_roots, const size_t n_equations)
+{
+    Get_Simd_Batch_Classifier (Active_Simd_Level) (a, b, c, n_roots, n_equations);
+}
+
+/**
+    \brief Returns the complex-root kernel written for a certain instruction set
+
+    \param [in] level {Instruction set}
+    \return Pointer on the kernel (Solve_Batch_Complex () for Simd_None)
+*/
+Complex_Batch_Solver Get_Simd_Complex_Solver (const enum Simd_Level level)
+{
+    switch (level)
+    {
+        case Simd_SSE2:
+            return Solve_Batch_Complex_SSE2;
+        case Simd_AVX2:
+            return Solve_Batch_Complex_AVX2;
+        case Simd_AVX512:
+            return Solve_Batch_Complex_AVX512;
+        default:
+            return Solve_Batch_Complex;
+    }
+}
+
+/**
+    \brief Solves a batch of equations and gives complex roots with the kernel chosen at startup
+
+    Calls the kernel Get_Simd_Complex_Solver () gives for Get_Active_Simd_Level ().
+    The results are the same as the ones of Solve_Batch_Complex ().
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] re_1 {Array for the real parts of the first roots}
+    \param [out] im_1 {Array for the imaginary parts of the first roots}
+    \param [out] re_2 {Array for the real parts of the second roots}
+    \param [out] im_2 {Array for the imaginary parts of the second roots}
+    \param [out] n_roots {Array for the numbers of real roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+void Solve_Batch_Complex_Simd (const double *a, const double *b, const double *c,
+                               double *re_1, double *im_1, double *re_2, double *im_2,
+                               enum N_Roots *n_roots, const size_t n_equations)
+{
+    Get_Simd_Complex_Solver (Active_Simd_Level) (a, b, c, re_1, im_1, re_2, im_2, n_roots, n_equations);
+}
+
+/**
+    \brief Returns the kernel of Scale_Coefficients () written for a certain instruction set
+
+    \param [in] level {Instruction set}
+    \return Pointer on the kernel (Scale_Coefficients () for Simd_None)
+*/
+Coefficient_Scaler Get_Simd_Scaler (const enum Simd_Level level)
+{
+    switch (level)
+    {
+        case Simd_SSE2:
+            return Scale_Coefficients_SSE2;
+        case Simd_AVX2:
+            return Scale_Coefficients_AVX2;
+        case Simd_AVX512:
+            return Scale_Coefficients_AVX512;
+        default:
+            return Scale_Coefficients;
+    }
+}
+
+/**
+    \brief Returns the kernel of Unscale_Roots () written for a certain instruction set
+
+    \param [in] level {Instruction set}
+    \return Pointer on the kernel (Unscale_Roots () for Simd_None)
+*/
+Root_Unscaler Get_Simd_Unscaler (const enum Simd_Level level)
+{
+    switch (level)
+    {
+        case Simd_SSE2:
+            return Unscale_Roots_SSE2;
+        case Simd_AVX2:
+            return Unscale_Roots_AVX2;
+        case Simd_AVX512:
+            return Unscale_Roots_AVX512;
+        default:
+            return Unscale_Roots;
+    }
+}
+
+/**
+    \brief Solves a batch of equations whose coefficients may be of any size with the kernel chosen at startup
+
+    Does what Solve_Batch_Scaled () does: for blocks of SCALED_BLOCK_SIZE equations the coefficients are scaled,
+             the block is solved by the kernel Get_Simd_Stable_Solver () gives for Get_Active_Simd_Level ()
+             and the roots are unscaled and refined. The scaling is done by the kernels of the same instruction set.
+    The results are the same as the ones of Solve_Batch_Scaled (), and so is the treatment of NULL arrays.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] x_1 {Array for the first roots}
+    \param [out] x_2 {Array for the second roots}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+void Solve_Batch_Scaled_Simd (const double *a, const double *b, const double *c,
+                              double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    if (a == NULL || b == NULL || c == NULL || n_roots == NULL)
+        return;
+
+    double scaled_a[SCALED_BLOCK_SIZE], scaled_b[SCALED_BLOCK_SIZE], scaled_c[SCALED_BLOCK_SIZE];
+    double unused_1[SCALED_BLOCK_SIZE], unused_2[SCALED_BLOCK_SIZE];    // the roots the caller does not need
+    int exponent[SCALED_BLOCK_SIZE];
+
+    Batch_Solver solver = Get_Simd_Stable_Solver (Active_Simd_Level);
+    Coefficient_Scaler scale = Get_Simd_Scaler (Active_Simd_Level);
+    Root_Unscaler unscale = Get_Simd_Unscaler (Active_Simd_Level);
+
+    for (size_t i = 0; i < n_equations; i += SCALED_BLOCK_SIZE)
+    {
+        size_t count = (n_equations - i < SCALED_BLOCK_SIZE) ? n_equations - i : SCALED_BLOCK_SIZE;
+        double *root_1 = (x_1 != NULL) ? x_1 + i : unused_1;
+        double *root_2 = (x_2 != NULL) ? x_2 + i : unused_2;
+
+        scale (a + i, b + i, c + i, scaled_a, scaled_b, scaled_c, exponent, count);
+        solver (scaled_a, scaled_b, scaled_c, root_1, root_2, n_roots + i, count);
+        unscale (root_1, root_2, exponent, count);
+        Refine_Underflowed_Roots (a + i, b + i, c + i, scaled_c, root_1, root_2, n_roots + i, count);
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef SIMD_SOLVER_H_INCLUDED
+#define SIMD_SOLVER_H_INCLUDED
+
+#include "Quadratic_Equation.h"
+
+///Signature of every function that solves a batch of equations stored as structure of arrays
+typedef void (*Batch_Solver) (const double *a, const double *b, const double *c,
+                              double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations);
+
+///Signature of every function that finds the numbers of roots of a batch of equations without solving them
+typedef void (*Batch_Classifier) (const double *a, const double *b, const double *c,
+                                  enum N_Roots *n_roots, const size_t n_equations);
+
+///Signature of every function that solves a batch of equations and gives the real and imaginary parts of the roots
+typedef void (*Complex_Batch_Solver) (const double *a, const double *b, const double *c,
+                                      double *re_1, double *im_1, double *re_2, double *im_2,
+                                      enum N_Roots *n_roots, const size_t n_equations);
+
+///Signature of every function that scales equations like Scale_Coefficients ()
+typedef void (*Coefficient_Scaler) (const double *a, const double *b, const double *c,
+                                    double *scaled_a, double *scaled_b, double *scaled_c, int *exponent, const size_t n_equations);
+
+///Signature of every function that multiplies the roots of scaled equations back like Unscale_Roots ()
+typedef void (*Root_Unscaler) (double *x_1, double *x_2, const int *exponent, const size_t n_equations);
+
+///Instruction sets the vectorized kernels are written for
+enum Simd_Level
+{
+    Simd_None,      ///< No vector kernel can run, Solve_Batch () is used
+    Simd_SSE2,      ///< 2 lanes of the "double" type
+    Simd_AVX2,      ///< 4 lanes of the "double" type (AVX2 and FMA)
+    Simd_AVX512     ///< 8 lanes of the "double" type
+};
+
+enum Simd_Level Get_Simd_Level (void);
+enum Simd_Level Get_Active_Simd_Level (void);
+int  Set_Simd_Level (const enum Simd_Level level);
+const char *Get_Simd_Level_Name (const enum Simd_Level level);
+Batch_Solver Get_Simd_Batch_Solver (const enum Simd_Level level);
+void Solve_Batch_Simd   (const double *a, const double *b, const double *c,
+                         double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations);
+void Solve_Batch_SSE2   (const double *a, const double *b, const double *c,
+                         double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations);
+void Solve_Batch_AVX2   (const double *a, const double *b, const double *c,
+                         double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations);
+void Solve_Batch_AVX512 (const double *a, const double *b, const double *c,
+                         double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations);
+Batch_Solver Get_Simd_Stable_Solver (const enum Simd_Level level);
+void Solve_Batch_Stable_SSE2   (const double *a, const double *b, const double *c,
+                                double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations);
+void Solve_Batch_Stable_AVX2   (const double *a, const double *b, const double *c,
+                                double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations);
+void Solve_Batch_Stable_AVX512 (const double *a, const double *b, const double *c,
+                                double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations);
+Batch_Classifier Get_Simd_Batch_Classifier (const enum Simd_Level level);
+void Classify_Batch_Simd   (const double *a, const double *b, const double *c, enum N_Roots *n_roots, const size_t n_equations);
+void Classify_Batch_SSE2   (const double *a, const double *b, const double *c, enum N_Roots *n_roots, const size_t n_equations);
+void Classify_Batch_AVX2   (const double *a, const double *b, const double *c, enum N_Roots *n_roots, const size_t n_equations);
+void Classify_Batch_AVX512 (const double *a, const double *b, const double *c, enum N_Roots *n_roots, const size_t n_equations);
+Complex_Batch_Solver Get_Simd_Complex_Solver (const enum Simd_Level level);
+void Solve_Batch_Complex_Simd   (const double *a, const double *b, const double *c,
+                                 double *re_1, double *im_1, double *re_2, double *im_2,
+                                 enum N_Roots *n_roots, const size_t n_equations);
+void Solve_Batch_Complex_SSE2   (const double *a, const double *b, const double *c,
+                                 double *re_1, double *im_1, double *re_2, double *im_2,
+                                 enum N_Roots *n_roots, const size_t n_equations);
+void Solve_Batch_Complex_AVX2   (const double *a, const double *b, const double *c,
+                                 double *re_1, double *im_1, double *re_2, double *im_2,
+                                 enum N_Roots *n_roots, const size_t n_equations);
+void Solve_Batch_Complex_AVX512 (const double *a, const double *b, const double *c,
+                                 double *re_1, double *im_1, double *re_2, double *im_2,
+                                 enum N_Roots *n_roots, const size_t n_equations);
+Coefficient_Scaler Get_Simd_Scaler (const enum Simd_Level level);
+Root_Unscaler Get_Simd_Unscaler (const enum Simd_Level level);
+void Scale_Coefficients_SSE2   (const double *a, const double *b, const double *c,
+                                double *scaled_a, double *scaled_b, double *scaled_c, int *exponent, const size_t n_equations);
+void Scale_Coefficients_AVX2   (const double *a, const double *b, const double *c,
+                                double *scaled_a, double *scaled_b, double *scaled_c, int *exponent, const size_t n_equations);
+void Scale_Coefficients_AVX512 (const double *a, const double *b, const double *c,
+                                double *scaled_a, double *scaled_b, double *scaled_c, int *exponent, const size_t n_equations);
+void Unscale_Roots_SSE2   (double *x_1, double *x_2, const int *exponent, const size_t n_equations);
+void Unscale_Roots_AVX2   (double *x_1, double *x_2, const int *exponent, const size_t n_equations);
+void Unscale_Roots_AVX512 (double *x_1, double *x_2, const int *exponent, const size_t n_equations);
+void Solve_Batch_Scaled_Simd (const double *a, const double *b, const double *c,
+                              double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations);
+int  Simd_Unit_Test (void);
+int  Classify_Unit_Test (void);
+int  Complex_Unit_Test (void);
+int  Scaled_Unit_Test (void);
+
+#endif
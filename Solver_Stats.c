@@ -0,0 +1,142 @@
+#include "Quadratic_Solver.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <time.h>
+
+#ifdef SOLVER_STATS
+
+_Thread_local struct Solver_Stats Thread_Solver_Stats = {0};
+
+///Counters of the threads that have called Merge_Thread_Stats ()
+static struct Solver_Stats Total_Stats = {0};
+static pthread_mutex_t Total_Stats_Mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+    \brief Returns the time of a monotonic clock
+
+    \return The time in nanoseconds
+*/
+uint64_t Get_Stats_Time (void)
+{
+    struct timespec time = {0};
+    clock_gettime (CLOCK_MONOTONIC, &time);
+
+    return (uint64_t)time.tv_sec * 1000000000u + (uint64_t)time.tv_nsec;
+}
+
+/**
+    \brief Puts a batch into the latency histogram of the calling thread
+
+    \param [in] nanoseconds {The time the batch has been solved in}
+    \param [in] n_equations {The number of equations in the batch}
+*/
+void Record_Batch_Latency (const uint64_t nanoseconds, const size_t n_equations)
+{
+    int bucket = 0;
+
+    while (bucket < STATS_LATENCY_BUCKETS - 1 && (nanoseconds >> bucket) != 0)
+        bucket++;
+
+    Thread_Solver_Stats.Latency_Histogram[bucket]++;
+    Thread_Solver_Stats.N_Batches++;
+    Thread_Solver_Stats.N_Batch_Equations += n_equations;
+}
+
+/**
+    \brief Adds the counters of one thread to others
+
+    \param [in,out] total {Pointer on the counters that get the sums}
+    \param [in] stats {Pointer on the counters that are added}
+*/
+static void Add_Solver_Stats (struct Solver_Stats *total, const struct Solver_Stats *stats)
+{
+    for (int i = 0; i < 4; i++)
+        total->N_Outcomes[i] += stats->N_Outcomes[i];
+
+    total->N_Linear          += stats->N_Linear;
+    total->N_NAN_Compares    += stats->N_NAN_Compares;
+    total->N_Near_Degenerate += stats->N_Near_Degenerate;
+    total->N_Batches         += stats->N_Batches;
+    total->N_Batch_Equations += stats->N_Batch_Equations;
+
+    for (int i = 0; i < STATS_LATENCY_BUCKETS; i++)
+        total->Latency_Histogram[i] += stats->Latency_Histogram[i];
+}
+
+#endif
+
+/**
+    \brief Adds the counters of the calling thread to the totals of the process and resets them
+
+    Every thread that solves equations calls it before it ends. Does nothing without SOLVER_STATS.
+*/
+void Merge_Thread_Stats (void)
+{
+#ifdef SOLVER_STATS
+    pthread_mutex_lock (&Total_Stats_Mutex);
+    Add_Solver_Stats (&Total_Stats, &Thread_Solver_Stats);
+    pthread_mutex_unlock (&Total_Stats_Mutex);
+
+    Thread_Solver_Stats = (struct Solver_Stats){0};
+#endif
+}
+
+/**
+    \brief Gets the totals of the process after merging the counters of the calling thread
+
+    \param [out] stats {Pointer on the structure in which the function puts the counters (all 0 without SOLVER_STATS)}
+*/
+void Get_Solver_Stats (struct Solver_Stats *stats)
+{
+    assert (stats != NULL);
+
+    *stats = (struct Solver_Stats){0};
+
+#ifdef SOLVER_STATS
+    Merge_Thread_Stats ();
+
+    pthread_mutex_lock (&Total_Stats_Mutex);
+    *stats = Total_Stats;
+    pthread_mutex_unlock (&Total_Stats_Mutex);
+#endif
+}
+
+/**
+    \brief Prints the totals of the process as one JSON object
+
+    Calls Get_Solver_Stats (). Only non-empty buckets of the latency histogram are printed;
+             "below_ns" is the upper bound of a bucket.
+
+    \param [in] stream {The stream to print to}
+*/
+void Print_Solver_Stats (FILE *stream)
+{
+    assert (stream != NULL);
+
+    struct Solver_Stats stats = {0};
+    Get_Solver_Stats (&stats);
+
+    fprintf (stream, "{\"outcomes\": {\"infinite\": %llu, \"zero\": %llu, \"one\": %llu, \"two\": %llu}, "
+                     "\"linear\": %llu, \"nan_compares\": %llu, \"near_degenerate\": %llu, "
+                     "\"batches\": %llu, \"batch_equations\": %llu, \"batch_latency\": [",
+             (unsigned long long)stats.N_Outcomes[Infinite - Infinite], (unsigned long long)stats.N_Outcomes[Zero - Infinite],
+             (unsigned long long)stats.N_Outcomes[One - Infinite],      (unsigned long long)stats.N_Outcomes[Two - Infinite],
+             (unsigned long long)stats.N_Linear, (unsigned long long)stats.N_NAN_Compares,
+             (unsigned long long)stats.N_Near_Degenerate, (unsigned long long)stats.N_Batches,
+             (unsigned long long)stats.N_Batch_Equations);
+
+    const char *separator = "";
+
+    for (int i = 0; i < STATS_LATENCY_BUCKETS; i++)
+    {
+        if (stats.Latency_Histogram[i] == 0)
+            continue;
+
+        fprintf (stream, "%s{\"below_ns\": %llu, \"count\": %llu}", separator,
+                 1ull << i, (unsigned long long)stats.Latency_Histogram[i]);
+        separator = ", ";
+    }
+
+    fprintf (stream, "]}\n");
+}
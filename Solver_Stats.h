@@ -0,0 +1,59 @@
+#ifndef SOLVER_STATS_H_INCLUDED
+#define SOLVER_STATS_H_INCLUDED
+
+/*
+    Counters of the solver. They are compiled in only if SOLVER_STATS is defined ("make STATS=1",
+    quadratic.out is built without them by default); otherwise every macro below expands to nothing or to its argument,
+    so the solver functions are the same as without the counters. Every thread counts into its own
+    copy of struct Solver_Stats without any synchronization, and Merge_Thread_Stats () adds the copy
+    to the totals of the process before the thread ends.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define STATS_LATENCY_BUCKETS 40    ///Bucket k of the latency histogram counts batches of 2^(k-1) .. 2^k - 1 nanoseconds
+
+///Counters of the solver functions
+struct Solver_Stats
+{
+    uint64_t N_Outcomes[4];         ///< The numbers of Infinite, Zero, One and Two results
+    uint64_t N_Linear;              ///< The number of equations passed to Solve_Linear_Equation ()
+    uint64_t N_NAN_Compares;        ///< The number of calls of Compare_Double () with a NAN argument
+    uint64_t N_Near_Degenerate;     ///< The number of quadratic equations whose discriminant is 0 within EPSILON
+    uint64_t N_Batches;             ///< The number of timed batches
+    uint64_t N_Batch_Equations;     ///< The number of equations in the timed batches
+    uint64_t Latency_Histogram[STATS_LATENCY_BUCKETS];     ///< Batches by the time they have been solved in
+};
+
+#ifdef SOLVER_STATS
+
+extern _Thread_local struct Solver_Stats Thread_Solver_Stats;
+
+///Adds "value" to a counter of the calling thread
+#define STATS_ADD(field, value) (Thread_Solver_Stats.field += (value))
+///Counts a result of a solver and evaluates to it
+#define STATS_ROOTS(n_roots) (Thread_Solver_Stats.N_Outcomes[(n_roots) - Infinite]++, (n_roots))
+///Evaluates to the time a batch starts at
+#define STATS_TIMER_START() Get_Stats_Time ()
+///Puts the time since "start" into the latency histogram
+#define STATS_TIMER_STOP(start, n_equations) Record_Batch_Latency (Get_Stats_Time () - (start), (n_equations))
+
+uint64_t Get_Stats_Time (void);
+void Record_Batch_Latency (const uint64_t nanoseconds, const size_t n_equations);
+
+#else
+
+#define STATS_ADD(field, value) ((void)0)
+#define STATS_ROOTS(n_roots) (n_roots)
+#define STATS_TIMER_START() ((uint64_t)0)
+#define STATS_TIMER_STOP(start, n_equations) ((void)(start), (void)(n_equations))
+
+#endif
+
+void Merge_Thread_Stats (void);
+void Get_Solver_Stats (struct Solver_Stats *stats);
+void Print_Solver_Stats (FILE *stream);
+int  Stats_Unit_Test (void);
+
+#endif
@@ -0,0 +1,342 @@
+#include "Stream_Mode.h"
+#include "Coeff_Reader.h"
+#include "Parallel_Solver.h"
+#include "Root_Formatter.h"
+#include "Precise_Solver.h"
+#include "Pipeline.h"
+
+#include <stdlib.h>
+
+/**
+    \brief Allocates the arrays of a block of equations
+
+    \param [out] block {Pointer on the block}
+    \param [in] capacity {The number of equations in every array}
+    \return 0 if all the arrays have been allocated
+    \return -1 otherwise (the arrays that have been allocated should be freed with Free_Equation_Block ())
+*/
+int Allocate_Equation_Block (struct Equation_Block *block, const size_t capacity)
+{
+    assert (block != NULL);
+
+    block->A        = malloc (capacity * sizeof (double));
+    block->B        = malloc (capacity * sizeof (double));
+    block->C        = malloc (capacity * sizeof (double));
+    block->X_1      = malloc (capacity * sizeof (double));
+    block->X_2      = malloc (capacity * sizeof (double));
+    block->N_Roots  = malloc (capacity * sizeof (enum N_Roots));
+    block->Capacity = capacity;
+
+    if (block->A == NULL || block->B == NULL || block->C == NULL ||
+        block->X_1 == NULL || block->X_2 == NULL || block->N_Roots == NULL)
+        return -1;
+
+    return 0;
+}
+
+/**
+    \brief Frees the arrays of a block
+
+    \param [in] block {Pointer on the block}
+*/
+void Free_Equation_Block (struct Equation_Block *block)
+{
+    assert (block != NULL);
+
+    free (block->A);
+    free (block->B);
+    free (block->C);
+    free (block->X_1);
+    free (block->X_2);
+    free (block->N_Roots);
+}
+
+/**
+    \brief Chooses the kernel the headless modes solve blocks with
+
+    \param [in] options {Pointer on the settings}
+    \return Solve_Batch_Precise () if "--precise" has been given
+    \return Solve_Batch_Scaled_Simd () if "--scaled" has been given
+    \return NULL otherwise, so Solve_Batch_Parallel () takes the widest vectorized kernel
+*/
+Batch_Solver Get_Batch_Solver (const struct Options *options)
+{
+    assert (options != NULL);
+
+    if (options->Precise)
+        return Solve_Batch_Precise;
+
+    return options->Scaled ? Solve_Batch_Scaled_Simd : NULL;
+}
+
+/**
+    \brief Solves a block of equations in the headless modes
+
+    Calls Solve_Batch_Cached () if there is a cache and Solve_Batch_Parallel () otherwise.
+    The time of the block goes into the latency histogram of Solver_Stats.h.
+
+    \param [in] options {Pointer on the settings}
+    \param [in,out] cache {Pointer on the cache or NULL}
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] x_1 {Array for the first roots}
+    \param [out] x_2 {Array for the second roots}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+void Solve_Block (const struct Options *options, struct Root_Cache *cache,
+                  const double *a, const double *b, const double *c,
+                  double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    assert (options != NULL);
+
+    uint64_t start = STATS_TIMER_START ();
+
+    if (cache != NULL)
+        Solve_Batch_Cached (cache, a, b, c, x_1, x_2, n_roots, n_equations);
+    else
+        Solve_Batch_Parallel (a, b, c, x_1, x_2, n_roots, n_equations, options->N_Threads, 0, Get_Batch_Solver (options));
+
+    STATS_TIMER_STOP (start, n_equations);
+}
+
+/**
+    \brief Finds the numbers of roots of a block of equations in the classification modes
+
+    Calls Classify_Batch_Simd () and Count_Root_Classes (). The time of the block goes into the latency histogram
+             and the classes go into the counters of results of Solver_Stats.h.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_equations {The number of equations in every array}
+    \param [in,out] totals {The numbers of equations with Infinite, Zero, One and Two roots; they are increased}
+*/
+void Classify_Block (const double *a, const double *b, const double *c,
+                     enum N_Roots *n_roots, const size_t n_equations, size_t totals[4])
+{
+    assert (totals != NULL);
+
+    uint64_t start = STATS_TIMER_START ();
+    size_t block_totals[4] = {0};
+
+    Classify_Batch_Simd (a, b, c, n_roots, n_equations);
+    Count_Root_Classes (n_roots, n_equations, block_totals);
+
+    STATS_TIMER_STOP (start, n_equations);
+
+    for (int i = 0; i < 4; i++)
+    {
+        STATS_ADD (N_Outcomes[i], block_totals[i]);
+        totals[i] += block_totals[i];
+    }
+}
+
+/**
+    \brief Solves a block of equations in the complex-root mode
+
+    Calls Solve_Batch_Complex_Simd (). The time of the block goes into the latency histogram
+             and the numbers of real roots go into the counters of results of Solver_Stats.h.
+
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [out] re_1 {Array for the real parts of the first roots}
+    \param [out] im_1 {Array for the imaginary parts of the first roots}
+    \param [out] re_2 {Array for the real parts of the second roots}
+    \param [out] im_2 {Array for the imaginary parts of the second roots}
+    \param [out] n_roots {Array for the numbers of real roots}
+    \param [in] n_equations {The number of equations in every array}
+*/
+void Solve_Complex_Block (const double *a, const double *b, const double *c,
+                          double *re_1, double *im_1, double *re_2, double *im_2,
+                          enum N_Roots *n_roots, const size_t n_equations)
+{
+    uint64_t start = STATS_TIMER_START ();
+
+    Solve_Batch_Complex_Simd (a, b, c, re_1, im_1, re_2, im_2, n_roots, n_equations);
+
+    STATS_TIMER_STOP (start, n_equations);
+
+#ifdef SOLVER_STATS
+    size_t block_totals[4] = {0};
+    Count_Root_Classes (n_roots, n_equations, block_totals);
+
+    for (int i = 0; i < 4; i++)
+        STATS_ADD (N_Outcomes[i], block_totals[i]);
+#endif
+}
+
+/**
+    \brief Writes the numbers of equations of every class and the share of equations with real roots
+
+    \param [in] stream {The output}
+    \param [in] totals {The numbers of equations with Infinite, Zero, One and Two roots}
+    \return 0 if everything is OK
+    \return -1 if writing has failed
+*/
+int Write_Class_Totals (FILE *stream, const size_t totals[4])
+{
+    assert (stream != NULL);
+    assert (totals != NULL);
+
+    size_t n_equations = totals[0] + totals[1] + totals[2] + totals[3];
+    size_t n_real = totals[Infinite - Infinite] + totals[One - Infinite] + totals[Two - Infinite];
+
+    int status = fprintf (stream, "equations: %zu\ninfinite: %zu\nzero: %zu\none: %zu\ntwo: %zu\nwith real roots: %.3f%%\n",
+                          n_equations, totals[Infinite - Infinite], totals[Zero - Infinite],
+                          totals[One - Infinite], totals[Two - Infinite],
+                          (n_equations > 0) ? 100.0 * (double)n_real / (double)n_equations : 0.0);
+
+    return (status < 0) ? -1 : 0;
+}
+
+/**
+    \brief Writes the results of a block, one line "n_roots x_1 x_2" per equation
+
+    \param [in] output {The output buffer}
+    \param [in] block {Pointer on the block}
+    \param [in] n_equations {The number of equations in the block}
+    \return 0 if everything is OK
+    \return -1 if writing has failed
+*/
+static int Write_Stream_Block (struct Output_Buffer *output, const struct Equation_Block *block, const size_t n_equations)
+{
+    int status = 0;
+
+    for (size_t i = 0; i < n_equations; i++)
+        status |= Write_Result (output, block->N_Roots[i], block->X_1[i], block->X_2[i]);
+
+    return status;
+}
+
+/**
+    \brief Solves all the coefficient triples of the input without any prompts
+
+    Calls Run_Pipeline (), so reading, solving and writing run at the same time.
+    If the pipeline cannot be started, calls Read_Triples (), Solve_Block (), Write_Stream_Block ()
+             for blocks of STREAM_BLOCK_SIZE equations one after another.
+    Roots are written by Write_Result (), roots that do not exist are written as "nan".
+    With "--classify" or "--totals" the blocks are read one after another and passed to Classify_Block ()
+             instead, because finding the classes takes much less time than parsing;
+             only the numbers of roots or only Write_Class_Totals () are written then.
+    With "--complex" the blocks are passed to Solve_Complex_Block () and written by Write_Complex_Result ().
+
+    \param [in] options {Pointer on the settings}
+    \return 0 if all the lines of the input are correct
+    \return 1 if there are malformed lines (they are reported to stderr and skipped)
+    \return 2 if the input or the output cannot be opened or written
+*/
+int Run_Stream_Mode (const struct Options *options)
+{
+    assert (options != NULL);
+
+    struct Coeff_Reader reader  = {0};
+    struct Equation_Block block = {0};
+    struct Output_Buffer output = {0};
+    struct Root_Cache cache     = {0};
+
+    if (Open_Coeff_Reader (&reader, options->Input) != 0)
+    {
+        fprintf (stderr, "Cannot open \"%s\"\n", options->Input);
+        return 2;
+    }
+
+    FILE *stream = (strcmp (options->Output, "-") == 0) ? stdout : fopen (options->Output, "w");
+
+    if (stream == NULL)
+    {
+        fprintf (stderr, "Cannot open \"%s\"\n", options->Output);
+        Close_Coeff_Reader (&reader);
+        return 2;
+    }
+    if (Init_Output_Buffer (&output, stream, options->Format, options->Digits) != 0 ||
+        (options->Cache_Size != 0 && Init_Root_Cache (&cache, options->Cache_Size, true) != 0))
+    {
+        fprintf (stderr, "Not enough memory\n");
+        if (stream != stdout)
+            fclose (stream);
+        Free_Output_Buffer (&output);
+        Free_Equation_Block (&block);
+        Free_Root_Cache (&cache);
+        Close_Coeff_Reader (&reader);
+        return 2;
+    }
+
+    size_t n_equations = 0, totals[4] = {0};
+    double *imag_parts = NULL;  // the imaginary parts of the first and the second roots in the complex-root mode
+    int write_status = 0;
+    bool no_memory = false;
+
+    if (options->Classify || options->Complex ||
+        Run_Pipeline (options, &reader, &output, (cache.Entries != NULL) ? &cache : NULL, &write_status) != 0)
+    {
+        if (options->Complex)
+            imag_parts = malloc (2 * STREAM_BLOCK_SIZE * sizeof (double));
+
+        if (Allocate_Equation_Block (&block, STREAM_BLOCK_SIZE) != 0 || (options->Complex && imag_parts == NULL))
+        {
+            fprintf (stderr, "Not enough memory\n");
+            no_memory = true;
+        }
+        else
+            while ((n_equations = Read_Triples (&reader, block.A, block.B, block.C, STREAM_BLOCK_SIZE)) > 0)
+            {
+                if (options->Classify)
+                {
+                    Classify_Block (block.A, block.B, block.C, block.N_Roots, n_equations, totals);
+
+                    for (size_t i = 0; i < n_equations && !options->Totals; i++)
+                        write_status |= Write_Root_Count (&output, block.N_Roots[i]);
+                    continue;
+                }
+                if (options->Complex)
+                {
+                    double *im_1 = imag_parts, *im_2 = imag_parts + STREAM_BLOCK_SIZE;
+
+                    Solve_Complex_Block (block.A, block.B, block.C, block.X_1, im_1, block.X_2, im_2, block.N_Roots, n_equations);
+
+                    for (size_t i = 0; i < n_equations; i++)
+                        write_status |= Write_Complex_Result (&output, block.N_Roots[i], block.X_1[i], im_1[i], block.X_2[i], im_2[i]);
+                    continue;
+                }
+
+                Solve_Block (options, (cache.Entries != NULL) ? &cache : NULL,
+                             block.A, block.B, block.C, block.X_1, block.X_2, block.N_Roots, n_equations);
+                write_status |= Write_Stream_Block (&output, &block, n_equations);
+            }
+    }
+
+    write_status |= Flush_Output_Buffer (&output);
+
+    if (options->Totals && !no_memory)
+        write_status |= Write_Class_Totals (stream, totals);
+
+    if (stream != stdout)
+        write_status |= fclose (stream);
+    else
+        write_status |= fflush (stream);
+
+    int status = (reader.N_Errors == 0) ? 0 : 1;
+
+    if (write_status != 0)
+    {
+        fprintf (stderr, "Cannot write to \"%s\"\n", options->Output);
+        status = 2;
+    }
+    if (no_memory)
+        status = 2;
+
+    if (cache.Entries != NULL)
+        Print_Cache_Statistics (stderr, &cache);
+
+    free (imag_parts);
+    Free_Output_Buffer (&output);
+    Free_Equation_Block (&block);
+    Free_Root_Cache (&cache);
+    Close_Coeff_Reader (&reader);
+
+    return status;
+}
@@ -0,0 +1,37 @@
+#ifndef STREAM_MODE_H_INCLUDED
+#define STREAM_MODE_H_INCLUDED
+
+#include "Command_Line.h"
+#include "Simd_Solver.h"
+#include "Root_Cache.h"
+
+#define STREAM_BLOCK_SIZE 65536     ///The number of equations that are read, solved and written at a time
+
+///Arrays of one block of equations
+struct Equation_Block
+{
+    double *A;      ///< Quadratic coefficients
+    double *B;      ///< Linear coefficients
+    double *C;      ///< Free terms
+    double *X_1;    ///< First roots
+    double *X_2;    ///< Second roots
+    enum N_Roots *N_Roots;  ///< Numbers of roots
+    size_t Capacity;        ///< The number of equations in every array
+};
+
+int  Allocate_Equation_Block (struct Equation_Block *block, const size_t capacity);
+void Free_Equation_Block (struct Equation_Block *block);
+Batch_Solver Get_Batch_Solver (const struct Options *options);
+void Solve_Block (const struct Options *options, struct Root_Cache *cache,
+                  const double *a, const double *b, const double *c,
+                  double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations);
+void Classify_Block (const double *a, const double *b, const double *c,
+                     enum N_Roots *n_roots, const size_t n_equations, size_t totals[4]);
+void Solve_Complex_Block (const double *a, const double *b, const double *c,
+                          double *re_1, double *im_1, double *re_2, double *im_2,
+                          enum N_Roots *n_roots, const size_t n_equations);
+int  Write_Class_Totals (FILE *stream, const size_t totals[4]);
+int  Run_Stream_Mode (const struct Options *options);
+int  Stream_Unit_Test (void);
+
+#endif
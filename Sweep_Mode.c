@@ -0,0 +1,286 @@
+#include "Sweep_Mode.h"
+#include "Stream_Mode.h"
+#include "Root_Formatter.h"
+
+/*
+    The discriminant of step k is a polynomial of the second degree in k, so it is updated with
+    two additions per step: D += Delta_D, Delta_D += Delta2_D. Its rounding errors grow with the number
+    of steps, so it is computed from the coefficients again every SWEEP_RESYNC_INTERVAL steps and whenever
+    it is within Guard of a border of Compare_Double (); then the number of roots is always the one
+    Get_Number_Of_Roots_And_Solve_Equation () finds. While the number of roots stays two, the roots of
+    the previous step are refined with Newton corrections instead of the square root. The equation is solved
+    from scratch when the number of roots changes, when "a" is equal to 0 within EPSILON and when
+    the corrections do not converge, for example near a root of multiplicity two.
+*/
+
+/**
+    \brief Gets the coefficients of a step
+
+    \param [in] sweep {Pointer on the state}
+    \param [in] step {The number of the step}
+    \param [out] a {Pointer on the quadratic coefficient}
+    \param [out] b {Pointer on the linear coefficient}
+    \param [out] c {Pointer on the free term}
+*/
+static void Get_Sweep_Coefficients (const struct Sweep_State *sweep, const size_t step, double *a, double *b, double *c)
+{
+    *a = sweep->A_0 + (double)step * sweep->Delta_A;
+    *b = sweep->B_0 + (double)step * sweep->Delta_B;
+    *c = sweep->C_0 + (double)step * sweep->Delta_C;
+}
+
+/**
+    \brief Computes the discriminant of the current step and its finite differences from the coefficients
+
+    Guard is a bound of the error that D collects during the next SWEEP_RESYNC_INTERVAL steps:
+             the rounding errors of D, Delta_D and Delta2_D and of every addition.
+
+    \param [in,out] sweep {Pointer on the state}
+    \param [in] a {Quadratic coefficient of the current step}
+    \param [in] b {Linear coefficient of the current step}
+    \param [in] c {Free term of the current step}
+*/
+static void Resync_Discriminant (struct Sweep_State *sweep, const double a, const double b, const double c)
+{
+    const double da = sweep->Delta_A, db = sweep->Delta_B, dc = sweep->Delta_C;
+    const double n = SWEEP_RESYNC_INTERVAL;
+
+    sweep->D        = Calc_Discriminant (a, b, c);
+    sweep->Delta_D  = 2 * b * db + db * db - 4 * (a * dc + c * da + da * dc);
+    sweep->Delta2_D = 2 * (db * db - 4 * da * dc);
+
+    double a_end = a + n * da, b_end = b + n * db, c_end = c + n * dc;
+    double terms_D   = fmax (b * b, b_end * b_end) + 4 * fmax (fabs (a), fabs (a_end)) * fmax (fabs (c), fabs (c_end));
+    double terms_dD  = fabs (2 * b * db) + db * db + 4 * (fabs (a * dc) + fabs (c * da) + fabs (da * dc));
+    double terms_ddD = 2 * (db * db + 4 * fabs (da * dc));
+    double max_dD    = fmax (fabs (sweep->Delta_D), fabs (sweep->Delta_D + n * sweep->Delta2_D));
+
+    sweep->Guard = 2 * DBL_EPSILON * ((n + 1) * terms_D + n * terms_dD + n * n * (terms_ddD + max_dD));
+    sweep->Next_Resync = sweep->Step + SWEEP_RESYNC_INTERVAL;
+    sweep->N_Resyncs++;
+}
+
+/**
+    \brief Refines a root of the previous step with Newton corrections
+
+    \param [in] a {Quadratic coefficient}
+    \param [in] b {Linear coefficient}
+    \param [in] c {Free term}
+    \param [in,out] root {Pointer on the root of the previous step that becomes the root of this step}
+    \return True if the error left after the last correction is not greater than SWEEP_TOLERANCE relative to the root
+             or the value of the polynomial is lost in its rounding errors
+    \return False if the corrections do not converge (the root is not changed then)
+*/
+static bool Refine_Root (const double a, const double b, const double c, double *root)
+{
+    double x = *root;
+
+    for (int i = 0; i < SWEEP_MAX_NEWTON; i++)
+    {
+        double derivative = 2 * a * x + b;
+        double value = (a * x + b) * x + c;
+
+        if (fabs (value) <= 2 * DBL_EPSILON * ((fabs (a * x) + fabs (b)) * fabs (x) + fabs (c)))
+        {
+            *root = x;
+            return true;
+        }
+        if (derivative == 0.0)
+            return false;
+
+        double correction = value / derivative;
+        x -= correction;
+
+        // the error after a Newton correction is about a * correction^2 / derivative
+        if (fabs (a * correction * correction / derivative) <= SWEEP_TOLERANCE * fabs (x))
+        {
+            *root = x;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+    \brief Starts a family of equations a + k * da, b + k * db, c + k * dc
+
+    \param [out] sweep {Pointer on the state}
+    \param [in] a {Quadratic coefficient of step 0}
+    \param [in] b {Linear coefficient of step 0}
+    \param [in] c {Free term of step 0}
+    \param [in] delta_a {Change of "a" per step}
+    \param [in] delta_b {Change of "b" per step}
+    \param [in] delta_c {Change of "c" per step}
+*/
+void Init_Sweep (struct Sweep_State *sweep, const double a, const double b, const double c,
+                 const double delta_a, const double delta_b, const double delta_c)
+{
+    assert (sweep != NULL);
+
+    *sweep = (struct Sweep_State){0};
+
+    sweep->A_0 = a;
+    sweep->B_0 = b;
+    sweep->C_0 = c;
+    sweep->Delta_A = delta_a;
+    sweep->Delta_B = delta_b;
+    sweep->Delta_C = delta_c;
+    sweep->N_Roots = Zero;
+    sweep->X_1 = NAN;
+    sweep->X_2 = NAN;
+}
+
+/**
+    \brief Solves the next steps of a family of equations
+
+    The numbers of roots are the same as the ones of Get_Number_Of_Roots_And_Solve_Equation ();
+             the roots may differ from its ones in the last bits. Root-variables that do not get a value keep NAN value.
+
+    \param [in,out] sweep {Pointer on the state, sweep->Step is moved by n_steps}
+    \param [out] x_1 {Array for the first roots}
+    \param [out] x_2 {Array for the second roots}
+    \param [out] n_roots {Array for the numbers of roots}
+    \param [in] n_steps {The number of steps}
+*/
+void Solve_Sweep (struct Sweep_State *sweep, double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_steps)
+{
+    assert (sweep != NULL);
+    assert (x_1 != NULL && x_2 != NULL && n_roots != NULL);
+
+    for (size_t i = 0; i < n_steps; i++, sweep->Step++)
+    {
+        double a = NAN, b = NAN, c = NAN;
+        Get_Sweep_Coefficients (sweep, sweep->Step, &a, &b, &c);
+
+        x_1[i] = NAN;
+        x_2[i] = NAN;
+
+        if (Compare_Double (a, 0.0) == Equal)
+        {
+            n_roots[i] = Solve_Linear_Equation (b, c, &x_1[i]);
+            sweep->N_Full_Solves++;
+            sweep->Warm = false;
+            continue;
+        }
+
+        if (!sweep->Warm || sweep->Step >= sweep->Next_Resync ||
+            fabs (sweep->D - EPSILON) <= sweep->Guard || fabs (sweep->D + EPSILON) <= sweep->Guard)
+            Resync_Discriminant (sweep, a, b, c);
+
+        enum N_Roots expected = (Compare_Double (sweep->D, 0.0) == Less)  ? Zero :
+                                (Compare_Double (sweep->D, 0.0) == Equal) ? One  : Two;
+        bool solved = false;
+
+        if (sweep->Warm && expected == Zero && sweep->N_Roots == Zero)
+        {
+            n_roots[i] = STATS_ROOTS (Zero);
+            sweep->N_Warm_Starts++;
+            solved = true;
+        }
+        else if (sweep->Warm && expected == Two && sweep->N_Roots == Two)
+        {
+            double root_1 = sweep->X_1, root_2 = sweep->X_2;
+
+            if (Refine_Root (a, b, c, &root_1) && Refine_Root (a, b, c, &root_2) && root_1 != root_2)
+            {
+                x_1[i] = root_1;
+                x_2[i] = root_2;
+                n_roots[i] = STATS_ROOTS (Two);
+                sweep->N_Warm_Starts++;
+                solved = true;
+            }
+        }
+
+        if (!solved)
+        {
+            n_roots[i] = Solve_Quadratic_Equation (a, b, c, &x_1[i], &x_2[i]);
+            sweep->N_Full_Solves++;
+        }
+
+        sweep->N_Roots = n_roots[i];
+        sweep->X_1 = x_1[i];
+        sweep->X_2 = x_2[i];
+        sweep->Warm = true;
+        sweep->D += sweep->Delta_D;
+        sweep->Delta_D += sweep->Delta2_D;
+    }
+}
+
+/**
+    \brief Solves a family of equations given on the command line
+
+    Calls Init_Sweep (), Solve_Sweep () for blocks of SWEEP_BLOCK_SIZE steps and Write_Result () for every step.
+    The counters of the sweep are printed to stderr.
+
+    \param [in] options {Pointer on the settings}
+    \return 0 if all the steps have been solved and written
+    \return 2 if the output cannot be opened or written
+*/
+int Run_Sweep_Mode (const struct Options *options)
+{
+    assert (options != NULL);
+
+    FILE *stream = (strcmp (options->Output, "-") == 0) ? stdout : fopen (options->Output, "w");
+
+    if (stream == NULL)
+    {
+        fprintf (stderr, "Cannot open \"%s\"\n", options->Output);
+        return 2;
+    }
+
+    struct Output_Buffer output = {0};
+    struct Equation_Block block = {0};
+
+    if (Allocate_Equation_Block (&block, SWEEP_BLOCK_SIZE) != 0 ||
+        Init_Output_Buffer (&output, stream, options->Format, options->Digits) != 0)
+    {
+        fprintf (stderr, "Not enough memory\n");
+        if (stream != stdout)
+            fclose (stream);
+        Free_Output_Buffer (&output);
+        Free_Equation_Block (&block);
+        return 2;
+    }
+
+    struct Sweep_State sweep = {0};
+    Init_Sweep (&sweep, options->Sweep_Start[0], options->Sweep_Start[1], options->Sweep_Start[2],
+                options->Sweep_Delta[0], options->Sweep_Delta[1], options->Sweep_Delta[2]);
+
+    int write_status = 0;
+
+    for (size_t first = 0; first < options->Sweep_Steps; first += SWEEP_BLOCK_SIZE)
+    {
+        size_t count = options->Sweep_Steps - first;
+        if (count > SWEEP_BLOCK_SIZE)
+            count = SWEEP_BLOCK_SIZE;
+
+        uint64_t start = STATS_TIMER_START ();
+        Solve_Sweep (&sweep, block.X_1, block.X_2, block.N_Roots, count);
+        STATS_TIMER_STOP (start, count);
+
+        for (size_t i = 0; i < count; i++)
+            write_status |= Write_Result (&output, block.N_Roots[i], block.X_1[i], block.X_2[i]);
+    }
+
+    write_status |= Flush_Output_Buffer (&output);
+
+    if (stream != stdout)
+        write_status |= fclose (stream);
+    else
+        write_status |= fflush (stream);
+
+    fprintf (stderr, "sweep: %zu steps, %zu warm starts, %zu full solves, %zu resynchronizations of the discriminant\n",
+             sweep.Step, sweep.N_Warm_Starts, sweep.N_Full_Solves, sweep.N_Resyncs);
+
+    Free_Output_Buffer (&output);
+    Free_Equation_Block (&block);
+
+    if (write_status != 0)
+    {
+        fprintf (stderr, "Cannot write to \"%s\"\n", options->Output);
+        return 2;
+    }
+
+    return 0;
+}
@@ -0,0 +1,38 @@
+#ifndef SWEEP_MODE_H_INCLUDED
+#define SWEEP_MODE_H_INCLUDED
+
+#include "Command_Line.h"
+
+#include <float.h>
+
+#define SWEEP_BLOCK_SIZE 65536      ///The number of steps that are solved and written at a time
+#define SWEEP_RESYNC_INTERVAL 256   ///The discriminant is computed from the coefficients again after this number of steps
+#define SWEEP_MAX_NEWTON 3          ///The maximal number of Newton corrections of one root
+#define SWEEP_TOLERANCE (4 * DBL_EPSILON)   ///A root is refined when its relative error is not greater than this
+
+///State of a family of equations a + k * da, b + k * db, c + k * dc, where k is the number of the step
+struct Sweep_State
+{
+    double A_0, B_0, C_0;       ///< Coefficients of step 0
+    double Delta_A, Delta_B, Delta_C;   ///< Changes of the coefficients per step
+    size_t Step;                ///< The number of the next step
+    double D;                   ///< The discriminant of the next step
+    double Delta_D;             ///< The first finite difference of the discriminant
+    double Delta2_D;            ///< The second finite difference of the discriminant (constant)
+    double Guard;               ///< A bound of the error of D since the last resynchronization
+    size_t Next_Resync;         ///< The step at which D is computed from the coefficients again
+    bool Warm;                  ///< True if the previous step has been a quadratic equation and D follows it
+    enum N_Roots N_Roots;       ///< The number of roots of the previous step
+    double X_1, X_2;            ///< The roots of the previous step
+    size_t N_Full_Solves;       ///< Steps solved by Get_Number_Of_Roots_And_Solve_Equation ()
+    size_t N_Warm_Starts;       ///< Steps whose roots have been refined from the previous ones
+    size_t N_Resyncs;           ///< The number of times D has been computed from the coefficients
+};
+
+void Init_Sweep (struct Sweep_State *sweep, const double a, const double b, const double c,
+                 const double delta_a, const double delta_b, const double delta_c);
+void Solve_Sweep (struct Sweep_State *sweep, double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_steps);
+int  Run_Sweep_Mode (const struct Options *options);
+int  Sweep_Unit_Test (void);
+
+#endif
@@ -1,6 +1,32 @@
 #include "Quadratic_Equation.h"
+#include "Simd_Solver.h"
+#include "Parallel_Solver.h"
+#include "Root_Formatter.h"
+#include "Precise_Solver.h"
+#include "Generic_Solver.h"
+#include "Root_Cache.h"
+#include "Sweep_Mode.h"
+#include "Pipeline.h"
+#include "Service_Mode.h"
+#include "Shm_Mode.h"
+#include "Solver_Stats.h"
+#include "Chunked_Mode.h"
+#include "Result_Store.h"
+#include "Coeff_Reader.h"
+#include <stdlib.h>
+#include <errno.h>
+#include <float.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #define NUMBER_OF_TESTS 10     ///The number of unit tests
+#define NUMBER_OF_EDGE_CASES 13     ///The number of equations that are only used to test batch solvers
+#define MAX_BATCH_TEST (NUMBER_OF_TESTS + NUMBER_OF_EDGE_CASES)     ///The maximal number of equations in one batch test
+#define NUMBER_OF_PRECISE_TESTS 6   ///The number of equations whose roots the textbook formula loses
+#define NUMBER_OF_GENERIC_TESTS 7   ///The number of equations that are solved in every floating-point type
 
 ///Data for one unit test
 struct Equation
@@ -46,8 +72,8 @@ static const struct Equation Tests[NUMBER_OF_TESTS] =
     { Two, 207.53, -1054.72, 385.03, 4.686359, 0.395893 },
     
     ///Unit test 8
-    // a = 0.00043, b = -0.00021, c = 0.00028
-    { Zero, 0.00043, -0.00021, 0.00028, NAN, NAN },
+    // a = 0.00043, b = -0.00021, c = 0.00028: discriminant -4.375E-7 is equal to 0 within EPSILON
+    { One, 0.00043, -0.00021, 0.00028, 0.244186, 0.244186 },
 
     ///Unit test 9
     // a = 34.0, b = 0.0, c = 0.0
@@ -58,32 +84,2228 @@ static const struct Equation Tests[NUMBER_OF_TESTS] =
     { Zero, 20.78, 3.74, 8.23, NAN, NAN }
 };
 
+///Coefficients "a", "b" and "c" of equations on the borders of the branches of the solvers
+static const double Edge_Cases[NUMBER_OF_EDGE_CASES][3] =
+{
+    { 1.0,    2.0,   1.0000001 },  // discriminant is a bit less than 0 but equal to 0 within EPSILON
+    { 1.0,    2.0,   0.9999999 },  // discriminant is a bit greater than 0 but equal to 0 within EPSILON
+    { 1.0,    2.0,   1.001     },  // discriminant is less than 0
+    { 1E-7,   2.0,   1.0       },  // "a" is equal to 0 within EPSILON
+    { 1E-5,   2.0,   1.0       },  // "a" is not equal to 0
+    { 0.0,    1E-7,  1.0       },  // "b" is equal to 0 within EPSILON
+    { 0.0,    1E-7,  1E-7      },  // "b" and "c" are equal to 0 within EPSILON
+    { -2.0,   3.0,  -1.0       },
+    { NAN,    1.0,   1.0       },
+    { 0.0,    NAN,   1.0       },
+    { 0.0,    1.0,   NAN       },
+    { 1.0,    INFINITY, 1.0    },
+    { -0.0,  -0.0,  -0.0       }
+};
+
+///Equations with catastrophic cancellation; their roots are exact up to rounding to the "double" type
+static const struct Equation Precise_Tests[NUMBER_OF_PRECISE_TESTS] =
+{
+    // x^2 - 1E8 x + 1: the textbook formula gives 7.45E-9 instead of 1E-8
+    { Two, 1.0, -1E8, 1.0, 1E-8, 1E8 },
+
+    // (x - 1) (x - 1 - 2^-52 * 2): discriminant 2^-102 is lost in b * b - 4 * a * c
+    { One, 1.0, -(2.0 + 0x1p-51), 1.0 + 0x1p-51, 1.0, 1.0 + 0x1p-51 },
+
+    // (x + 3E-9) (x + 1E9) scaled by 1E-3
+    { Two, 1E-3, 1E-3 * (1E9 + 3E-9), 3E-3, -1E9, -3E-9 },
+
+    // (x - 1) (x - 2) scaled by 1E200: b * b and 4 * a * c overflow
+    { Two, 1E200, -3E200, 2E200, 1.0, 2.0 },
+
+    // (x - 1)^2 scaled by 1E200
+    { One, 1E200, -2E200, 1E200, 1.0, 1.0 },
+
+    // x^2 - 1E-290 scaled by 1E300: only 4 * a * c overflows
+    { Two, 1E300, 0.0, -1E10, -1E-145, 1E-145 }
+};
+
+///Equations with roots that are exact in every floating-point type
+static const struct Equation Generic_Tests[NUMBER_OF_GENERIC_TESTS] =
+{
+    { Two,      1.0, -3.0,  2.0,  1.0, 2.0 },
+    { One,      1.0, -2.0,  1.0,  1.0, 1.0 },
+    { Zero,     1.0,  0.0,  1.0,  NAN, NAN },
+    { Infinite, 0.0,  0.0,  0.0,  NAN, NAN },
+    { One,      0.0,  2.0, -3.0,  1.5, NAN },
+    { Two,      2.0,  1.0, -1.0, -1.0, 0.5 },
+    { Zero,     0.0,  0.0,  5.0,  NAN, NAN }
+};
+
 /**
     \brief Runs all unit tests.
 
     Calls Yes_No (). Asks user if he/she wants to run unit tests.
-    If the answer is yes, the function calls Unit_Test ().
+    If the answer is yes, the function calls Run_All_Unit_Tests ().
 
     \return The number of failed unit tests
 */
 int Run_Unit_Test (void)
 {
-    int failed = 0, n_test = 0;
+    int failed = 0;
 
     if (Yes_No ("Do you want to run unit test?\n") == Yes)
+        failed = Run_All_Unit_Tests ();
+
+    putchar ('\n');
+
+    return failed;
+}
+
+/**
+    \brief Runs all unit tests without asking the user
+
+    Calls Unit_Test () for every equation of the array "Tests" and the unit tests of every solver.
+
+    \return The number of failed unit tests
+*/
+int Run_All_Unit_Tests (void)
+{
+    int failed = 0;
+
+    for (int n_test = 0; n_test < NUMBER_OF_TESTS; n_test++)
+        if (Unit_Test (n_test,
+                       Tests[n_test].N_Roots_Ref,
+                       Tests[n_test].Coeff_A, Tests[n_test].Coeff_B, Tests[n_test].Coeff_C,
+                       Tests[n_test].X_1_Ref, Tests[n_test].X_2_Ref) == 0)
+            failed++;
+
+    failed += Batch_Unit_Test ();
+    failed += Simd_Unit_Test ();
+    failed += Classify_Unit_Test ();
+    failed += Complex_Unit_Test ();
+    failed += Scaled_Unit_Test ();
+    failed += Parallel_Unit_Test ();
+    failed += Formatter_Unit_Test ();
+    failed += Reader_Unit_Test ();
+    failed += Stream_Unit_Test ();
+    failed += Precise_Unit_Test ();
+    failed += Generic_Unit_Test ();
+    failed += Cache_Unit_Test ();
+    failed += Sweep_Unit_Test ();
+    failed += Pipeline_Unit_Test ();
+    failed += Service_Unit_Test ();
+    failed += Shm_Unit_Test ();
+    failed += Stats_Unit_Test ();
+    failed += Binary_Unit_Test ();
+    failed += Chunked_Unit_Test ();
+    failed += Store_Unit_Test ();
+    failed += Query_Unit_Test ();
+
+    if (!failed)
+        printf ("There are no errors\n");
+
+    return failed;
+}
+
+/**
+    \brief Compares the results of a batch solver with the results of the scalar one
+
+    Calls "solver" for all the equations at once and Get_Number_Of_Roots_And_Solve_Equation () for each of them.
+    The roots are compared bit for bit, so NAN is equal only to NAN.
+
+    \param [in] solver {Pointer on the batch solver}
+    \param [in] name {The name of the solver that is printed if a test fails}
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [in] n_equations {The number of equations in every array, not more than MAX_BATCH_TEST}
+    \return The number of equations with different results
+*/
+static int Compare_Batch_With_Scalar (Batch_Solver solver, const char *name,
+                                      const double *a, const double *b, const double *c, const int n_equations)
+{
+    assert (n_equations <= MAX_BATCH_TEST);
+
+    double x_1[MAX_BATCH_TEST] = {0}, x_2[MAX_BATCH_TEST] = {0};
+    enum N_Roots n_roots[MAX_BATCH_TEST] = {0};
+    int failed = 0;
+
+    solver (a, b, c, x_1, x_2, n_roots, n_equations);
+
+    for (int n_test = 0; n_test < n_equations; n_test++)
+    {
+        double x_1_ref = NAN, x_2_ref = NAN;
+        enum N_Roots n_roots_ref = Get_Number_Of_Roots_And_Solve_Equation (a[n_test], b[n_test], c[n_test],
+                                                                           &x_1_ref, &x_2_ref);
+
+        if (n_roots[n_test] != n_roots_ref || memcmp (&x_1[n_test], &x_1_ref, sizeof (double)) != 0
+                                           || memcmp (&x_2[n_test], &x_2_ref, sizeof (double)) != 0)
+        {
+            printf ("%s test %d FAILED\n"
+                    "x_1 = %f, x_2 =  %f, n_roots = %d\n"
+                    "Should be: x_1 = %f, x_2 = %f and %d roots\n\n",
+                    name, n_test + 1, x_1[n_test], x_2[n_test], n_roots[n_test], x_1_ref, x_2_ref, n_roots_ref);
+            failed++;
+        }
+    }
+
+    return failed;
+}
+
+/**
+    \brief Checks that the batch solver gives the same results as the scalar one
+
+    Calls Compare_Batch_With_Scalar () for Solve_Batch () and all the equations from the array "Tests".
+
+    \return The number of equations with different results
+*/
+int Batch_Unit_Test (void)
+{
+    double a[NUMBER_OF_TESTS] = {0}, b[NUMBER_OF_TESTS] = {0}, c[NUMBER_OF_TESTS] = {0};
+
+    for (int n_test = 0; n_test < NUMBER_OF_TESTS; n_test++)
+    {
+        a[n_test] = Tests[n_test].Coeff_A;
+        b[n_test] = Tests[n_test].Coeff_B;
+        c[n_test] = Tests[n_test].Coeff_C;
+    }
+
+    return Compare_Batch_With_Scalar (Solve_Batch, "Batch", a, b, c, NUMBER_OF_TESTS);
+}
+
+/**
+    \brief Puts the equations from the arrays "Tests" and "Edge_Cases" into three arrays of coefficients
+
+    \param [out] a {Array of quadratic coefficients of MAX_BATCH_TEST elements}
+    \param [out] b {Array of linear coefficients of MAX_BATCH_TEST elements}
+    \param [out] c {Array of free terms of MAX_BATCH_TEST elements}
+    \return The number of equations (MAX_BATCH_TEST)
+*/
+static int Get_Batch_Test_Equations (double *a, double *b, double *c)
+{
+    int n_equations = 0;
+
+    for (int n_test = 0; n_test < NUMBER_OF_TESTS; n_test++, n_equations++)
+    {
+        a[n_equations] = Tests[n_test].Coeff_A;
+        b[n_equations] = Tests[n_test].Coeff_B;
+        c[n_equations] = Tests[n_test].Coeff_C;
+    }
+    for (int n_test = 0; n_test < NUMBER_OF_EDGE_CASES; n_test++, n_equations++)
+    {
+        a[n_equations] = Edge_Cases[n_test][0];
+        b[n_equations] = Edge_Cases[n_test][1];
+        c[n_equations] = Edge_Cases[n_test][2];
+    }
+
+    return n_equations;
+}
+
+/**
+    \brief Checks that a batch solver treats NULL arrays the same way as its scalar twin
+
+    "solver" and "reference" are called with "x_1" and then with "x_2" equal to NULL, and the other roots
+             and the numbers of roots should be the same bit for bit. A NULL array of coefficients should leave
+             the array for the numbers of roots as it is.
+
+    \param [in] solver {Pointer on the batch solver}
+    \param [in] reference {Pointer on the scalar solver that gives the same results}
+    \param [in] name {The name of the solver that is printed if a test fails}
+    \param [in] a {Array of quadratic coefficients}
+    \param [in] b {Array of linear coefficients}
+    \param [in] c {Array of free terms}
+    \param [in] n_equations {The number of equations in every array, not more than MAX_BATCH_TEST}
+    \return The number of failed checks
+*/
+static int Compare_Null_Roots (Batch_Solver solver, Batch_Solver reference, const char *name,
+                               const double *a, const double *b, const double *c, const int n_equations)
+{
+    assert (n_equations <= MAX_BATCH_TEST);
+
+    double roots[MAX_BATCH_TEST] = {0}, roots_ref[MAX_BATCH_TEST] = {0};
+    enum N_Roots n_roots[MAX_BATCH_TEST] = {0}, n_roots_ref[MAX_BATCH_TEST] = {0};
+    int failed = 0;
+
+    for (int null_root = 1; null_root <= 2; null_root++)
+    {
+        solver    (a, b, c, (null_root == 1) ? NULL : roots, (null_root == 2) ? NULL : roots, n_roots, n_equations);
+        reference (a, b, c, (null_root == 1) ? NULL : roots_ref, (null_root == 2) ? NULL : roots_ref, n_roots_ref, n_equations);
+
+        if (memcmp (roots, roots_ref, n_equations * sizeof (double)) != 0 ||
+            memcmp (n_roots, n_roots_ref, n_equations * sizeof (enum N_Roots)) != 0)
+        {
+            printf ("%s test FAILED: the results differ from the ones of the scalar solver if x_%d is NULL\n\n", name, null_root);
+            failed++;
+        }
+    }
+
+    memcpy (n_roots_ref, n_roots, n_equations * sizeof (enum N_Roots));
+    solver (NULL, b, c, roots, roots, n_roots, n_equations);
+
+    if (memcmp (n_roots, n_roots_ref, n_equations * sizeof (enum N_Roots)) != 0)
+    {
+        printf ("%s test FAILED: equations without the array \"a\" have been solved\n\n", name);
+        failed++;
+    }
+
+    return failed;
+}
+
+/**
+    \brief Checks that every vectorized kernel gives the same results as the scalar solver
+
+    Calls Compare_Batch_With_Scalar () for every kernel the processor supports
+             and for Solve_Batch_Simd () after forcing every level with Set_Simd_Level ().
+    Compare_Null_Roots () checks that the kernels, their stable variants and Solve_Batch_Scaled_Simd ()
+             take NULL arrays like Solve_Batch (), Solve_Batch_Stable () and Solve_Batch_Scaled ().
+    The equations are the ones from the array "Tests" and the ones from the array "Edge_Cases",
+             so every lane meets every outcome and the tail of the batch is solved too.
+    The level chosen at startup (or by "--isa") is restored at the end.
+
+    \return The number of equations with different results
+*/
+int Simd_Unit_Test (void)
+{
+    double a[MAX_BATCH_TEST] = {0}, b[MAX_BATCH_TEST] = {0}, c[MAX_BATCH_TEST] = {0};
+    int n_equations = Get_Batch_Test_Equations (a, b, c);
+
+    const char *names[] = {"SSE2", "AVX2", "AVX-512"};
+    int failed = 0;
+
+    for (enum Simd_Level level = Simd_SSE2; level <= Get_Simd_Level (); level++)
+    {
+        failed += Compare_Batch_With_Scalar (Get_Simd_Batch_Solver (level), names[level - Simd_SSE2],
+                                             a, b, c, n_equations);
+        failed += Compare_Null_Roots (Get_Simd_Batch_Solver (level), Solve_Batch, names[level - Simd_SSE2],
+                                      a, b, c, n_equations);
+        failed += Compare_Null_Roots (Get_Simd_Stable_Solver (level), Solve_Batch_Stable, names[level - Simd_SSE2],
+                                      a, b, c, n_equations);
+    }
+
+    enum Simd_Level active = Get_Active_Simd_Level ();
+
+    for (enum Simd_Level level = Simd_None; level <= Get_Simd_Level (); level++)
+    {
+        if (Set_Simd_Level (level) != 0 || Get_Active_Simd_Level () != level)
+        {
+            printf ("Dispatch test FAILED: level \"%s\" cannot be forced\n\n", Get_Simd_Level_Name (level));
+            failed++;
+        }
+        failed += Compare_Batch_With_Scalar (Solve_Batch_Simd, "Dispatched", a, b, c, n_equations);
+        failed += Compare_Null_Roots (Solve_Batch_Scaled_Simd, Solve_Batch_Scaled, "Dispatched scaled", a, b, c, n_equations);
+    }
+
+    if (Set_Simd_Level ((enum Simd_Level)(Simd_AVX512 + 1)) == 0)
+    {
+        printf ("Dispatch test FAILED: an unknown level has been accepted\n\n");
+        failed++;
+    }
+
+    Set_Simd_Level (active);
+
+    return failed;
+}
+
+/**
+    \brief Calls Solve_Batch_Parallel () with 4 threads and chunks of 3 equations
+
+    The chunks are this small to make the workers steal them from each other.
+*/
+static void Solve_Batch_Four_Threads (const double *a, const double *b, const double *c,
+                                      double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    Solve_Batch_Parallel (a, b, c, x_1, x_2, n_roots, n_equations, 4, 3, NULL);
+}
+
+/**
+    \brief Calls Solve_Batch_Parallel () with 2 threads and chunks of 5 equations
+
+    The third and the fourth threads of the pool should sit this batch out.
+*/
+static void Solve_Batch_Two_Threads (const double *a, const double *b, const double *c,
+                                     double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    Solve_Batch_Parallel (a, b, c, x_1, x_2, n_roots, n_equations, 2, 5, NULL);
+}
+
+/**
+    \brief Checks that the multi-threaded solver gives the same results as the scalar one
+
+    Calls Compare_Batch_With_Scalar () for Solve_Batch_Four_Threads (), Solve_Batch_Two_Threads ()
+             and Solve_Batch_Four_Threads () again, so the threads of the pool solve several batches of different sizes.
+    Compare_Null_Roots () checks that NULL arrays are taken like in Solve_Batch ().
+
+    \return The number of equations with different results
+*/
+int Parallel_Unit_Test (void)
+{
+    double a[MAX_BATCH_TEST] = {0}, b[MAX_BATCH_TEST] = {0}, c[MAX_BATCH_TEST] = {0};
+    int n_equations = Get_Batch_Test_Equations (a, b, c);
+
+    int failed = Compare_Batch_With_Scalar (Solve_Batch_Four_Threads, "Parallel", a, b, c, n_equations);
+    failed += Compare_Batch_With_Scalar (Solve_Batch_Two_Threads, "Parallel", a, b, c, n_equations);
+    failed += Compare_Batch_With_Scalar (Solve_Batch_Four_Threads, "Parallel", a, b, c, n_equations);
+    failed += Compare_Null_Roots (Solve_Batch_Four_Threads, Solve_Batch, "Parallel", a, b, c, n_equations);
+
+    return failed;
+}
+
+/**
+    \brief Checks Format_Fixed () and Format_Shortest ()
+
+    Every root of the array "Tests", the coefficients of the array "Edge_Cases" and a few numbers
+             with tricky rounding are written with Format_Fixed () with 0-25 digits after the decimal point
+             and compared with snprintf (). Format_Shortest () is checked to be read back as the same number.
+
+    \return The number of numbers that have been written incorrectly
+*/
+int Formatter_Unit_Test (void)
+{
+    const double tricky[] = {0.5, 1.5, 2.5, 0.125, -0.0, 1E23, 5E-324, 1.7976931348623157E308, 0.1, 9007199254740993.0};
+    const int n_tricky = sizeof (tricky) / sizeof (tricky[0]);
+    double numbers[2 * NUMBER_OF_TESTS + 3 * NUMBER_OF_EDGE_CASES + sizeof (tricky) / sizeof (tricky[0])] = {0};
+    int n_numbers = 0, failed = 0;
+
+    for (int n_test = 0; n_test < NUMBER_OF_TESTS; n_test++)
+    {
+        numbers[n_numbers++] = Tests[n_test].X_1_Ref;
+        numbers[n_numbers++] = Tests[n_test].X_2_Ref;
+    }
+    for (int n_test = 0; n_test < NUMBER_OF_EDGE_CASES; n_test++)
+        for (int coeff = 0; coeff < 3; coeff++)
+            numbers[n_numbers++] = Edge_Cases[n_test][coeff];
+    for (int i = 0; i < n_tricky; i++)
+        numbers[n_numbers++] = tricky[i];
+
+    char result[FIXED_LENGTH (25)] = "", reference[FIXED_LENGTH (25)] = "";
+
+    for (int i = 0; i < n_numbers; i++)
     {
-        for (n_test = 0; n_test < NUMBER_OF_TESTS; n_test++)
-            if (Unit_Test (n_test,
-                           Tests[n_test].N_Roots_Ref,
-                           Tests[n_test].Coeff_A, Tests[n_test].Coeff_B, Tests[n_test].Coeff_C,
-                           Tests[n_test].X_1_Ref, Tests[n_test].X_2_Ref) == 0)
+        for (int digits = 0; digits <= 25; digits++)
+        {
+            Format_Fixed (result, numbers[i], digits);
+            snprintf (reference, sizeof (reference), "%.*f", digits, numbers[i]);
+
+            if (strcmp (result, reference) != 0)
+            {
+                printf ("Formatter test FAILED\n"
+                        "Format_Fixed () has written %s, should be %s\n\n", result, reference);
                 failed++;
+            }
+        }
+
+        Format_Shortest (result, numbers[i]);
+        double read_back = strtod (result, NULL);
 
-        if (!failed)
-            printf ("There are no errors\n");
+        if (memcmp (&read_back, &numbers[i], sizeof (double)) != 0 && !(IsNAN (read_back) && IsNAN (numbers[i])))
+        {
+            printf ("Formatter test FAILED\n"
+                    "Format_Shortest () has written %s for %.17g\n\n", result, numbers[i]);
+            failed++;
+        }
     }
 
-    putchar ('\n');
+    return failed;
+}
+
+/**
+    \brief Checks if a root is equal to the expected one within a few units in the last place
+
+    \param [in] root {The root}
+    \param [in] root_ref {The expected root}
+    \return True if the relative difference is not greater than 4 * DBL_EPSILON
+*/
+static bool Is_Close_Root (const double root, const double root_ref)
+{
+    return fabs (root - root_ref) <= 4 * DBL_EPSILON * fabs (root_ref);
+}
+
+/**
+    \brief Checks Solve_Batch_Precise () and Solve_Quadratic_Equation_Precise ()
+
+    The number of roots of every equation of the arrays "Tests" and "Edge_Cases" should be the same
+             as the one found by Get_Number_Of_Roots_And_Solve_Equation (), also when the arrays for the roots are NULL.
+    The roots of the array "Precise_Tests" should be accurate to a few units in the last place.
+
+    \return The number of failed tests
+*/
+int Precise_Unit_Test (void)
+{
+    double a[MAX_BATCH_TEST] = {0}, b[MAX_BATCH_TEST] = {0}, c[MAX_BATCH_TEST] = {0};
+    double x_1[MAX_BATCH_TEST] = {0}, x_2[MAX_BATCH_TEST] = {0};
+    enum N_Roots n_roots[MAX_BATCH_TEST] = {0};
+    int n_equations = Get_Batch_Test_Equations (a, b, c), failed = 0;
+
+    enum N_Roots n_roots_only[MAX_BATCH_TEST] = {0};
+
+    Solve_Batch_Precise (a, b, c, x_1, x_2, n_roots, n_equations);
+    Solve_Batch_Precise (a, b, c, NULL, NULL, n_roots_only, n_equations);
+
+    for (int n_test = 0; n_test < n_equations; n_test++)
+    {
+        double x_1_ref = NAN, x_2_ref = NAN;
+        enum N_Roots n_roots_ref = Get_Number_Of_Roots_And_Solve_Equation (a[n_test], b[n_test], c[n_test],
+                                                                           &x_1_ref, &x_2_ref);
+
+        if (n_roots[n_test] != n_roots_ref || n_roots_only[n_test] != n_roots_ref)
+        {
+            printf ("Precise test %d FAILED\n"
+                    "n_roots = %d, should be %d\n\n", n_test + 1, n_roots[n_test], n_roots_ref);
+            failed++;
+        }
+    }
+
+    for (int n_test = 0; n_test < NUMBER_OF_PRECISE_TESTS; n_test++)
+    {
+        const struct Equation *test = &Precise_Tests[n_test];
+        double x_1_test = NAN, x_2_test = NAN;
+        enum N_Roots n_roots_test = Solve_Quadratic_Equation_Precise (test->Coeff_A, test->Coeff_B, test->Coeff_C,
+                                                                      &x_1_test, &x_2_test, NULL);
+
+        if (n_roots_test != test->N_Roots_Ref ||
+            !((Is_Close_Root (x_1_test, test->X_1_Ref) && Is_Close_Root (x_2_test, test->X_2_Ref)) ||
+              (Is_Close_Root (x_1_test, test->X_2_Ref) && Is_Close_Root (x_2_test, test->X_1_Ref))))
+        {
+            printf ("Precise accuracy test %d FAILED\n"
+                    "x_1 = %.17g, x_2 = %.17g, n_roots = %d\n"
+                    "Should be: x_1 = %.17g, x_2 = %.17g and %d roots\n\n",
+                    n_test + 1, x_1_test, x_2_test, n_roots_test, test->X_1_Ref, test->X_2_Ref, test->N_Roots_Ref);
+            failed++;
+        }
+    }
+
+    return failed;
+}
+
+/**
+    \brief Checks if a root of any floating-point type is equal to the expected one
+
+    \param [in] root {The root converted to the "long double" type}
+    \param [in] root_ref {The expected root}
+    \return True if both numbers are NAN or they are bitwise equal after the conversion
+*/
+static bool Is_Exact_Root (const long double root, const double root_ref)
+{
+    return (isnan (root) && isnan (root_ref)) || root == root_ref;
+}
+
+/**
+    \brief Checks the float and long double solvers generated by DEFINE_QUADRATIC_SOLVER ()
+
+    Solve_Batch_F () and Solve_Batch_L () are called through Solve_Batch_Generic () for the array "Generic_Tests".
+    Then they are called with NULL arrays for the roots, which should give the same numbers of roots,
+             and with a NULL array "a", which should leave the numbers of roots as they are, like Solve_Batch () does.
+
+    \return The number of failed tests
+*/
+int Generic_Unit_Test (void)
+{
+    int failed = 0;
+
+    float a_f[NUMBER_OF_GENERIC_TESTS] = {0}, b_f[NUMBER_OF_GENERIC_TESTS] = {0}, c_f[NUMBER_OF_GENERIC_TESTS] = {0};
+    float x_1_f[NUMBER_OF_GENERIC_TESTS] = {0}, x_2_f[NUMBER_OF_GENERIC_TESTS] = {0};
+    long double a_l[NUMBER_OF_GENERIC_TESTS] = {0}, b_l[NUMBER_OF_GENERIC_TESTS] = {0}, c_l[NUMBER_OF_GENERIC_TESTS] = {0};
+    long double x_1_l[NUMBER_OF_GENERIC_TESTS] = {0}, x_2_l[NUMBER_OF_GENERIC_TESTS] = {0};
+    enum N_Roots n_roots_f[NUMBER_OF_GENERIC_TESTS] = {0}, n_roots_l[NUMBER_OF_GENERIC_TESTS] = {0};
+
+    for (int n_test = 0; n_test < NUMBER_OF_GENERIC_TESTS; n_test++)
+    {
+        a_f[n_test] = (float)Generic_Tests[n_test].Coeff_A;
+        b_f[n_test] = (float)Generic_Tests[n_test].Coeff_B;
+        c_f[n_test] = (float)Generic_Tests[n_test].Coeff_C;
+        a_l[n_test] = Generic_Tests[n_test].Coeff_A;
+        b_l[n_test] = Generic_Tests[n_test].Coeff_B;
+        c_l[n_test] = Generic_Tests[n_test].Coeff_C;
+    }
+
+    Solve_Batch_Generic (a_f, b_f, c_f, x_1_f, x_2_f, n_roots_f, NUMBER_OF_GENERIC_TESTS);
+    Solve_Batch_Generic (a_l, b_l, c_l, x_1_l, x_2_l, n_roots_l, NUMBER_OF_GENERIC_TESTS);
+
+    for (int n_test = 0; n_test < NUMBER_OF_GENERIC_TESTS; n_test++)
+    {
+        const struct Equation *test = &Generic_Tests[n_test];
+
+        if (n_roots_f[n_test] != test->N_Roots_Ref ||
+            !Is_Exact_Root (x_1_f[n_test], test->X_1_Ref) || !Is_Exact_Root (x_2_f[n_test], test->X_2_Ref))
+        {
+            printf ("Float test %d FAILED\n"
+                    "x_1 = %f, x_2 =  %f, n_roots = %d\n"
+                    "Should be: x_1 = %f, x_2 = %f and %d roots\n\n",
+                    n_test + 1, x_1_f[n_test], x_2_f[n_test], n_roots_f[n_test],
+                    test->X_1_Ref, test->X_2_Ref, test->N_Roots_Ref);
+            failed++;
+        }
+
+        if (n_roots_l[n_test] != test->N_Roots_Ref ||
+            !Is_Exact_Root (x_1_l[n_test], test->X_1_Ref) || !Is_Exact_Root (x_2_l[n_test], test->X_2_Ref))
+        {
+            printf ("Long double test %d FAILED\n"
+                    "x_1 = %Lf, x_2 =  %Lf, n_roots = %d\n"
+                    "Should be: x_1 = %f, x_2 = %f and %d roots\n\n",
+                    n_test + 1, x_1_l[n_test], x_2_l[n_test], n_roots_l[n_test],
+                    test->X_1_Ref, test->X_2_Ref, test->N_Roots_Ref);
+            failed++;
+        }
+    }
+
+    enum N_Roots n_roots_only_f[NUMBER_OF_GENERIC_TESTS] = {0}, n_roots_only_l[NUMBER_OF_GENERIC_TESTS] = {0};
+
+    Solve_Batch_F (a_f, b_f, c_f, NULL, NULL, n_roots_only_f, NUMBER_OF_GENERIC_TESTS);
+    Solve_Batch_L (a_l, b_l, c_l, NULL, x_2_l, n_roots_only_l, NUMBER_OF_GENERIC_TESTS);
+    Solve_Batch_F (NULL, b_f, c_f, x_1_f, x_2_f, n_roots_only_f, NUMBER_OF_GENERIC_TESTS);
+    Solve_Batch_L (a_l, b_l, NULL, x_1_l, x_2_l, n_roots_only_l, NUMBER_OF_GENERIC_TESTS);
+
+    if (memcmp (n_roots_only_f, n_roots_f, sizeof (n_roots_f)) != 0 ||
+        memcmp (n_roots_only_l, n_roots_l, sizeof (n_roots_l)) != 0)
+    {
+        printf ("Generic test FAILED: NULL arrays are not taken like in Solve_Batch ()\n\n");
+        failed++;
+    }
+
+    return failed;
+}
+
+///The cache of Solve_Batch_Small_Cache (), it is kept between the calls
+static struct Root_Cache Test_Cache = {0};
+
+/**
+    \brief Solves every batch twice with Test_Cache, so the second results come from the cache
+*/
+static void Solve_Batch_Small_Cache (const double *a, const double *b, const double *c,
+                                     double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    Solve_Batch_Cached (&Test_Cache, a, b, c, x_1, x_2, n_roots, n_equations);
+    Solve_Batch_Cached (&Test_Cache, a, b, c, x_1, x_2, n_roots, n_equations);
+}
+
+/**
+    \brief Checks that the cache gives the same results as the scalar solver
+
+    Calls Compare_Batch_With_Scalar () for the arrays "Tests" and "Edge_Cases" and for the same equations
+             multiplied by powers of two and by -1, so most of them are found in the cache.
+    The cache has 4 entries, so the entries are also replaced.
+
+    \return The number of equations with different results
+*/
+int Cache_Unit_Test (void)
+{
+    double a[MAX_BATCH_TEST] = {0}, b[MAX_BATCH_TEST] = {0}, c[MAX_BATCH_TEST] = {0};
+    int n_equations = Get_Batch_Test_Equations (a, b, c), failed = 0;
+    const double scales[] = {1.0, 2.0, 0x1p-40, -4.0, 3.0};
+
+    if (Init_Root_Cache (&Test_Cache, 4, true) != 0)
+    {
+        printf ("Cache test FAILED: not enough memory\n\n");
+        return 1;
+    }
+
+    for (int n_scale = 0; n_scale < (int)(sizeof (scales) / sizeof (scales[0])); n_scale++)
+    {
+        double a_scaled[MAX_BATCH_TEST] = {0}, b_scaled[MAX_BATCH_TEST] = {0}, c_scaled[MAX_BATCH_TEST] = {0};
+
+        for (int i = 0; i < n_equations; i++)
+        {
+            a_scaled[i] = scales[n_scale] * a[i];
+            b_scaled[i] = scales[n_scale] * b[i];
+            c_scaled[i] = scales[n_scale] * c[i];
+        }
+
+        failed += Compare_Batch_With_Scalar (Solve_Batch_Small_Cache, "Cache", a_scaled, b_scaled, c_scaled, n_equations);
+    }
+
+    if (Test_Cache.N_Hits == 0 || Test_Cache.N_Small_Hits == 0)
+    {
+        printf ("Cache test FAILED: %zu hits and %zu hits in the small table\n\n", Test_Cache.N_Hits, Test_Cache.N_Small_Hits);
+        failed++;
+    }
+
+    Free_Root_Cache (&Test_Cache);
+
+    return failed;
+}
+
+/**
+    \brief Checks Solve_Sweep () on families that go through all numbers of roots
+
+    Every step is compared with Get_Number_Of_Roots_And_Solve_Equation (): the numbers of roots should be equal
+             and the roots should be equal within EPSILON. The families are solved by blocks of 100 steps,
+             and most of the steps should be refined from the previous ones.
+
+    \return The number of steps with different results
+*/
+int Sweep_Unit_Test (void)
+{
+    // {a, b, c, da, db, dc}: "b" goes from -10 to 10 with c = 1, "a" goes through 0, "c" goes from -5 to 5
+    const double families[][6] =
+    {
+        {1.0, -10.0,  1.0, 0.0,    0.001, 0.0  },
+        {-1.0,  3.0,  2.0, 0.0002, 0.0,   0.0  },
+        {2.0,   1.0, -5.0, 0.0,    0.0,   0.0005}
+    };
+    const size_t n_steps = 20000, block_size = 100;
+    int failed = 0;
+
+    for (int n_family = 0; n_family < (int)(sizeof (families) / sizeof (families[0])); n_family++)
+    {
+        const double *family = families[n_family];
+        struct Sweep_State sweep = {0};
+        double x_1[100] = {0}, x_2[100] = {0};
+        enum N_Roots n_roots[100] = {0};
+
+        Init_Sweep (&sweep, family[0], family[1], family[2], family[3], family[4], family[5]);
+
+        for (size_t first = 0; first < n_steps; first += block_size)
+        {
+            Solve_Sweep (&sweep, x_1, x_2, n_roots, block_size);
+
+            for (size_t i = 0; i < block_size; i++)
+            {
+                double k = (double)(first + i);
+                double x_1_ref = NAN, x_2_ref = NAN;
+                enum N_Roots n_roots_ref = Get_Number_Of_Roots_And_Solve_Equation (family[0] + k * family[3],
+                                                                                   family[1] + k * family[4],
+                                                                                   family[2] + k * family[5],
+                                                                                   &x_1_ref, &x_2_ref);
+
+                if (n_roots[i] != n_roots_ref || Compare_Double (x_1[i], x_1_ref) != Equal ||
+                                                 Compare_Double (x_2[i], x_2_ref) != Equal)
+                {
+                    printf ("Sweep test %d FAILED at step %zu\n"
+                            "x_1 = %f, x_2 =  %f, n_roots = %d\n"
+                            "Should be: x_1 = %f, x_2 = %f and %d roots\n\n",
+                            n_family + 1, first + i, x_1[i], x_2[i], n_roots[i], x_1_ref, x_2_ref, n_roots_ref);
+                    failed++;
+                }
+            }
+        }
+
+        if (sweep.N_Warm_Starts < n_steps / 2)
+        {
+            printf ("Sweep test %d FAILED: only %zu of %zu steps have been refined\n\n",
+                    n_family + 1, sweep.N_Warm_Starts, n_steps);
+            failed++;
+        }
+    }
+
+    return failed;
+}
+
+/**
+    \brief Checks that the pipeline writes the same results in the same order as the sequential solver
+
+    Writes 5 * PIPELINE_CHUNK_SIZE + 7 equations (the ones of the arrays "Tests" and "Edge_Cases" one after another)
+             into a temporary file and solves it with Run_Pipeline () and 3 workers. The output is compared
+             with the one of Solve_Batch () and Write_Result ().
+
+    \return 1 if the outputs differ or the test cannot be run
+    \return 0 otherwise
+*/
+int Pipeline_Unit_Test (void)
+{
+    double a[MAX_BATCH_TEST] = {0}, b[MAX_BATCH_TEST] = {0}, c[MAX_BATCH_TEST] = {0};
+    int n_equations = Get_Batch_Test_Equations (a, b, c);
+    const size_t n_lines = 5 * PIPELINE_CHUNK_SIZE + 7;
+
+    char path[] = "/tmp/quadratic_pipeline_XXXXXX";
+    int fd = mkstemp (path);
+    FILE *input = (fd == -1) ? NULL : fdopen (fd, "w");
+    FILE *expected = tmpfile (), *actual = tmpfile ();
+    struct Output_Buffer expected_output = {0}, actual_output = {0};
+    struct Coeff_Reader reader = {0};
+    int failed = 1, write_status = 0;
+
+    if (input != NULL && expected != NULL && actual != NULL &&
+        Init_Output_Buffer (&expected_output, expected, Shortest_Format, 0) == 0 &&
+        Init_Output_Buffer (&actual_output, actual, Shortest_Format, 0) == 0)
+    {
+        for (size_t line = 0; line < n_lines; line++)
+        {
+            int i = (int)(line % (size_t)n_equations);
+            double x_1 = NAN, x_2 = NAN;
+            enum N_Roots n_roots = Get_Number_Of_Roots_And_Solve_Equation (a[i], b[i], c[i], &x_1, &x_2);
+
+            fprintf (input, "%.17g %.17g %.17g\n", a[i], b[i], c[i]);
+            Write_Result (&expected_output, n_roots, x_1, x_2);
+        }
+        fclose (input);
+        input = NULL;
+
+        struct Options options = {.N_Threads = 3, .Format = Shortest_Format};
+
+        if (Open_Coeff_Reader (&reader, path) == 0 &&
+            Run_Pipeline (&options, &reader, &actual_output, NULL, &write_status) == 0 && write_status == 0)
+        {
+            Flush_Output_Buffer (&expected_output);
+            Flush_Output_Buffer (&actual_output);
+
+            long length = ftell (expected);
+            failed = (length != ftell (actual));
+
+            rewind (expected);
+            rewind (actual);
+            for (long i = 0; !failed && i < length; i++)
+                failed = (fgetc (expected) != fgetc (actual));
+        }
+        Close_Coeff_Reader (&reader);
+    }
+
+    if (failed)
+        printf ("Pipeline test FAILED: its output differs from the one of the sequential solver\n\n");
+
+    if (input != NULL)
+        fclose (input);
+    if (expected != NULL)
+        fclose (expected);
+    if (actual != NULL)
+        fclose (actual);
+    if (fd != -1)
+        unlink (path);
+    Free_Output_Buffer (&expected_output);
+    Free_Output_Buffer (&actual_output);
+
+    return failed;
+}
+
+/**
+    \brief Checks that the service answers pipelined requests that come in pieces
+
+    Three requests (the equations of the arrays "Tests" and "Edge_Cases", an empty one and the first three equations)
+             are put into the input buffer of a connection 7 bytes at a time, and Process_Requests () is called
+             after every piece. The responses are compared with Get_Number_Of_Roots_And_Solve_Equation () bit by bit.
+             The ends of the pending responses should follow the output buffer when it is compacted,
+             and a request of more than SERVICE_MAX_BATCH equations should be refused.
+
+    \return The number of failed checks
+*/
+int Service_Unit_Test (void)
+{
+    double a[MAX_BATCH_TEST] = {0}, b[MAX_BATCH_TEST] = {0}, c[MAX_BATCH_TEST] = {0};
+    const uint32_t sizes[] = {(uint32_t)Get_Batch_Test_Equations (a, b, c), 0, 3};
+    const int n_requests = sizeof (sizes) / sizeof (sizes[0]);
+
+    size_t request_size = 0, response_size = 0;
+    for (int i = 0; i < n_requests; i++)
+    {
+        request_size  += SERVICE_HEADER_SIZE + sizes[i] * 3 * sizeof (double);
+        response_size += SERVICE_HEADER_SIZE + sizes[i] * sizeof (struct Root_Record);
+    }
+
+    unsigned char *requests = calloc (request_size, 1), *responses = calloc (response_size, 1);
+    const struct Options options = {.N_Threads = 1};
+    struct Service_Connection connection = {.Fd = -1};
+    struct Service_Stats stats = {0};
+    int failed = 0;
+
+    connection.In.Data = requests;
+    connection.In.Capacity = request_size;
+    stats.Latencies = calloc (SERVICE_LATENCY_SAMPLES, sizeof (double));
+
+    if (requests == NULL || responses == NULL || stats.Latencies == NULL)
+    {
+        printf ("Service test FAILED: not enough memory\n\n");
+        free (requests);
+        free (responses);
+        free (stats.Latencies);
+        return 1;
+    }
+
+    unsigned char *request = requests, *response = responses;
+    for (int n_request = 0; n_request < n_requests; n_request++)
+    {
+        memcpy (request, &sizes[n_request], SERVICE_HEADER_SIZE);
+        memcpy (response, &sizes[n_request], SERVICE_HEADER_SIZE);
+        request  += SERVICE_HEADER_SIZE;
+        response += SERVICE_HEADER_SIZE;
+
+        for (uint32_t i = 0; i < sizes[n_request]; i++)
+        {
+            struct Root_Record record = {NAN, NAN, 0};
+            record.N_Roots = Get_Number_Of_Roots_And_Solve_Equation (a[i], b[i], c[i], &record.X_1, &record.X_2);
+
+            memcpy (request, &a[i], sizeof (double));
+            memcpy (request + sizeof (double), &b[i], sizeof (double));
+            memcpy (request + 2 * sizeof (double), &c[i], sizeof (double));
+            memcpy (response, &record, sizeof (record));
+            request  += 3 * sizeof (double);
+            response += sizeof (record);
+        }
+    }
+
+    for (size_t length = 0; length < request_size && failed == 0; )
+    {
+        length = (length + 7 < request_size) ? length + 7 : request_size;
+        connection.In.Length = length;
+
+        if (Process_Requests (&options, NULL, &connection, &stats, 0.0) != 0)
+            failed++;
+    }
+
+    if (failed || connection.In.Begin != request_size || connection.Out.Length != response_size ||
+        memcmp (connection.Out.Data, responses, response_size) != 0 || connection.N_Pending != (size_t)n_requests)
+    {
+        printf ("Service test FAILED: the responses differ from the ones of Get_Number_Of_Roots_And_Solve_Equation ()\n\n");
+        failed++;
+    }
+
+    connection.Out.Begin = connection.Out.Length;
+    Record_Sent_Responses (&connection, &stats, 1.0);
+
+    if (connection.N_Pending != 0 || stats.N_Latencies != (size_t)n_requests || Get_Latency_Percentile (&stats, 99.0) != 1.0)
+    {
+        printf ("Service test FAILED: %zu latencies have been recorded instead of %d\n\n", stats.N_Latencies, n_requests);
+        failed++;
+    }
+
+    const size_t last_request  = SERVICE_HEADER_SIZE + sizes[n_requests - 1] * 3 * sizeof (double);
+    const size_t last_response = SERVICE_HEADER_SIZE + sizes[n_requests - 1] * sizeof (struct Root_Record);
+
+    connection.In.Begin   = request_size - last_request;
+    connection.In.Length  = request_size;
+    connection.Out.Length = connection.Out.Capacity - last_response + 1;
+    connection.Out.Begin  = connection.Out.Length - 1;
+    connection.Pending[connection.N_Pending++] = (struct Pending_Response){connection.Out.Length, 0.0};
+
+    if (Process_Requests (&options, NULL, &connection, &stats, 0.0) != 0 || connection.Out.Begin != 0 || connection.N_Pending != 2 ||
+        connection.Pending[0].End != 1 || connection.Pending[1].End != 1 + last_response)
+    {
+        printf ("Service test FAILED: the pending responses have not been moved with the output buffer\n\n");
+        failed++;
+    }
+
+    connection.Out.Begin = 1;
+    Record_Sent_Responses (&connection, &stats, 1.0);
+    connection.Out.Begin = connection.Out.Length;
+    Record_Sent_Responses (&connection, &stats, 1.0);
+
+    if (connection.N_Pending != 0 || stats.N_Latencies != (size_t)n_requests + 2)
+    {
+        printf ("Service test FAILED: %zu latencies have been recorded instead of %d\n\n", stats.N_Latencies, n_requests + 2);
+        failed++;
+    }
+
+    const uint32_t too_many = SERVICE_MAX_BATCH + 1;
+    memcpy (requests, &too_many, SERVICE_HEADER_SIZE);
+    connection.In.Begin  = 0;
+    connection.In.Length = SERVICE_HEADER_SIZE;
+
+    if (Process_Requests (&options, NULL, &connection, &stats, 0.0) != -1)
+    {
+        printf ("Service test FAILED: a request of %u equations has been accepted\n\n", too_many);
+        failed++;
+    }
+
+    free (connection.In.Data);
+    free (connection.Out.Data);
+    free (connection.Pending);
+    free (responses);
+    free (stats.Latencies);
+    Free_Equation_Block (&stats.Scratch);
+
+    return failed;
+}
+
+///The solver side of Shm_Unit_Test ()
+struct Shm_Test_Solver
+{
+    struct Shm_Queue *Queue;        ///< The queue as the solver has mapped it
+    const struct Options *Options;  ///< The settings of the solver
+};
+
+/**
+    \brief Runs Serve_Shm_Queue () in a thread of Shm_Unit_Test ()
+
+    \param [in] argument {Pointer on struct Shm_Test_Solver}
+    \return NULL
+*/
+static void *Run_Shm_Test_Solver (void *argument)
+{
+    struct Shm_Test_Solver *solver = argument;
+
+    Serve_Shm_Queue (solver->Queue, solver->Options);
+
+    return NULL;
+}
+
+/**
+    \brief Checks the shared-memory queue
+
+    A thread solves a queue of 4 slots of 16 equations; the test maps the queue a second time by its name
+             and solves the equations of the arrays "Tests" and "Edge_Cases" repeated 10 times through it,
+             so the ring goes round several times. The results have to be the ones of Solve_Batch_Simd ().
+    After Stop_Shm_Queue () a slot cannot be claimed.
+
+    \return The number of failed checks
+*/
+int Shm_Unit_Test (void)
+{
+    enum {N_Repeats = 10, N_Equations = N_Repeats * MAX_BATCH_TEST};
+
+    double a[N_Equations] = {0}, b[N_Equations] = {0}, c[N_Equations] = {0};
+    double x_1[N_Equations] = {0}, x_2[N_Equations] = {0}, y_1[N_Equations] = {0}, y_2[N_Equations] = {0};
+    enum N_Roots n_roots[N_Equations] = {0}, m_roots[N_Equations] = {0};
+    int n_tests = Get_Batch_Test_Equations (a, b, c);
+    size_t n_equations = (size_t)N_Repeats * (size_t)n_tests;
+
+    for (size_t i = (size_t)n_tests; i < n_equations; i++)
+    {
+        a[i] = a[i % (size_t)n_tests];
+        b[i] = b[i % (size_t)n_tests];
+        c[i] = c[i % (size_t)n_tests];
+    }
+
+    Solve_Batch_Simd (a, b, c, x_1, x_2, n_roots, n_equations);
+
+    char name[64] = "";
+    snprintf (name, sizeof (name), "/quadratic_unit_test_%d", (int)getpid ());
+
+    struct Shm_Queue server = {0}, client = {0};
+    struct Options options = {.Mode = Shared_Memory, .Input = name, .N_Threads = 1};
+    struct Shm_Test_Solver solver = {&server, &options};
+    pthread_t thread;
+
+    if (Create_Shm_Queue (&server, name, 4, 16) != 0 || Open_Shm_Queue (&client, name) != 0 ||
+        pthread_create (&thread, NULL, Run_Shm_Test_Solver, &solver) != 0)
+    {
+        printf ("Shm test FAILED: the queue \"%s\" cannot be created\n\n", name);
+        if (server.Header != NULL)
+            Close_Shm_Queue (&server);
+        if (client.Header != NULL)
+            Close_Shm_Queue (&client);
+        shm_unlink (name);
+        return 1;
+    }
+
+    int failed = 0;
+    struct Shm_Queue twin = {0};
+
+    if (Create_Shm_Queue (&twin, name, 4, 16) != -1 || errno != EEXIST)
+    {
+        printf ("Shm test FAILED: a second queue \"%s\" has been created over the first one\n\n", name);
+        failed++;
+        if (twin.Header != NULL)
+            Close_Shm_Queue (&twin);
+    }
+
+    if (Solve_Shm_Batch (&client, a, b, c, y_1, y_2, m_roots, n_equations) != 0 ||
+        memcmp (m_roots, n_roots, n_equations * sizeof (enum N_Roots)) != 0 ||
+        memcmp (y_1, x_1, n_equations * sizeof (double)) != 0 || memcmp (y_2, x_2, n_equations * sizeof (double)) != 0)
+    {
+        printf ("Shm test FAILED: the results of the queue differ from the ones of Solve_Batch_Simd ()\n\n");
+        failed++;
+    }
+
+    uint32_t position = 0;
+    struct Equation_Block *block = Claim_Shm_Slot (&client, &position);
+
+    if (block == NULL || block->Capacity != 16)
+    {
+        printf ("Shm test FAILED: a slot of 16 equations cannot be claimed\n\n");
+        failed++;
+    }
+    else
+    {
+        Submit_Shm_Slot (&client, position, 0);
+        if (Wait_Shm_Slot (&client, position) != 0)
+        {
+            printf ("Shm test FAILED: an empty request has not been answered\n\n");
+            failed++;
+        }
+        Release_Shm_Slot (&client, position);
+    }
+
+    Stop_Shm_Queue (&client);
+    pthread_join (thread, NULL);
+
+    if (atomic_load (&server.Header->N_Equations) != n_equations || Claim_Shm_Slot (&client, &position) != NULL)
+    {
+        printf ("Shm test FAILED: %llu equations have been solved instead of %zu or the queue has not stopped\n\n",
+                (unsigned long long)atomic_load (&server.Header->N_Equations), n_equations);
+        failed++;
+    }
+
+    Close_Shm_Queue (&client);
+    Close_Shm_Queue (&server);
+    shm_unlink (name);
+
+    return failed;
+}
+
+/**
+    \brief Checks that the vectorized kernels count the same things as the scalar solver
+
+    Solves the equations of the arrays "Tests" and "Edge_Cases" with Solve_Batch () and with every kernel
+             the processor supports and compares the counters of the calling thread.
+             The counters of the thread are restored at the end. Without SOLVER_STATS there is nothing to check.
+
+    \return The number of kernels with different counters
+*/
+int Stats_Unit_Test (void)
+{
+#ifdef SOLVER_STATS
+    double a[MAX_BATCH_TEST] = {0}, b[MAX_BATCH_TEST] = {0}, c[MAX_BATCH_TEST] = {0};
+    double x_1[MAX_BATCH_TEST] = {0}, x_2[MAX_BATCH_TEST] = {0};
+    enum N_Roots n_roots[MAX_BATCH_TEST] = {0};
+    int n_equations = Get_Batch_Test_Equations (a, b, c);
+
+    const char *names[] = {"SSE2", "AVX2", "AVX-512"};
+    const struct Solver_Stats saved = Thread_Solver_Stats;
+    int failed = 0;
+
+    Thread_Solver_Stats = (struct Solver_Stats){0};
+    Solve_Batch (a, b, c, x_1, x_2, n_roots, (size_t)n_equations);
+    const struct Solver_Stats scalar = Thread_Solver_Stats;
+
+    uint64_t n_outcomes = 0;
+    for (int i = 0; i < 4; i++)
+        n_outcomes += scalar.N_Outcomes[i];
+
+    if (n_outcomes != (uint64_t)n_equations || scalar.N_Linear == 0 || scalar.N_NAN_Compares == 0 || scalar.N_Near_Degenerate == 0)
+    {
+        printf ("Stats test FAILED: Solve_Batch () has counted %llu results of %d equations\n\n",
+                (unsigned long long)n_outcomes, n_equations);
+        failed++;
+    }
+
+    for (enum Simd_Level level = Simd_SSE2; level <= Get_Simd_Level (); level++)
+    {
+        Thread_Solver_Stats = (struct Solver_Stats){0};
+        Get_Simd_Batch_Solver (level) (a, b, c, x_1, x_2, n_roots, (size_t)n_equations);
+
+        if (memcmp (Thread_Solver_Stats.N_Outcomes, scalar.N_Outcomes, sizeof (scalar.N_Outcomes)) != 0 ||
+            Thread_Solver_Stats.N_Linear != scalar.N_Linear || Thread_Solver_Stats.N_NAN_Compares != scalar.N_NAN_Compares ||
+            Thread_Solver_Stats.N_Near_Degenerate != scalar.N_Near_Degenerate)
+        {
+            printf ("Stats test FAILED: the %s kernel counts differently from Solve_Batch ()\n\n", names[level - Simd_SSE2]);
+            failed++;
+        }
+    }
+
+    Thread_Solver_Stats = (struct Solver_Stats){0};
+    Record_Batch_Latency (1000, 5);
+
+    if (Thread_Solver_Stats.Latency_Histogram[10] != 1 || Thread_Solver_Stats.N_Batch_Equations != 5)
+    {
+        printf ("Stats test FAILED: a batch of 1000 ns is not in the bucket of 512 .. 1023 ns\n\n");
+        failed++;
+    }
+
+    Thread_Solver_Stats = saved;
+
+    return failed;
+#else
+    return 0;
+#endif
+}
+
+/**
+    \brief Checks that the classification gives the same numbers of roots as the solver
+
+    The equations of the arrays "Tests" and "Edge_Cases" are classified by Classify_Equation (), Classify_Batch ()
+             and every kernel the processor supports, and the classes are compared with the numbers of roots
+             Get_Number_Of_Roots_And_Solve_Equation () finds. The sums of Count_Root_Classes () are checked too.
+
+    \return The number of classifiers with different results
+*/
+int Classify_Unit_Test (void)
+{
+    double a[MAX_BATCH_TEST] = {0}, b[MAX_BATCH_TEST] = {0}, c[MAX_BATCH_TEST] = {0};
+    enum N_Roots expected[MAX_BATCH_TEST] = {0}, n_roots[MAX_BATCH_TEST] = {0};
+    int n_equations = Get_Batch_Test_Equations (a, b, c);
+    size_t expected_totals[4] = {0};
+    int failed = 0;
+
+    for (int i = 0; i < n_equations; i++)
+    {
+        double x_1 = NAN, x_2 = NAN;
+        expected[i] = Get_Number_Of_Roots_And_Solve_Equation (a[i], b[i], c[i], &x_1, &x_2);
+        expected_totals[expected[i] - Infinite]++;
+
+        if (Classify_Equation (a[i], b[i], c[i]) != expected[i])
+        {
+            printf ("Classify test FAILED: Classify_Equation (%g, %g, %g) is not %d\n\n", a[i], b[i], c[i], expected[i]);
+            failed++;
+        }
+    }
+
+    const char *names[] = {"Classify_Batch ()", "SSE2", "AVX2", "AVX-512"};
+
+    for (enum Simd_Level level = Simd_None; level <= Get_Simd_Level (); level++)
+    {
+        size_t totals[4] = {0};
+
+        Get_Simd_Batch_Classifier (level) (a, b, c, n_roots, (size_t)n_equations);
+        Count_Root_Classes (n_roots, (size_t)n_equations, totals);
+
+        if (memcmp (n_roots, expected, (size_t)n_equations * sizeof (enum N_Roots)) != 0 ||
+            memcmp (totals, expected_totals, sizeof (totals)) != 0)
+        {
+            printf ("Classify test FAILED: %s gives other numbers of roots than the solver\n\n", names[level]);
+            failed++;
+        }
+    }
+
+    return failed;
+}
+
+/**
+    \brief Checks one complex result of Solve_Equation_Complex () against the real solver
+
+    The number of roots and the real roots have to be the same bit for bit. The imaginary part of a root is 0
+             (even if the root is NAN because of NAN or infinite coefficients) or NAN if the root does not exist.
+    If the discriminant is less than 0, the roots have to be conjugate and to give a residual
+             a z^2 + b z + c that is small compared to the sizes of its terms.
+
+    \param [in] a {Quadratic coefficient}
+    \param [in] b {Linear coefficient}
+    \param [in] c {Free term}
+    \param [in] root {The real and imaginary parts of the first and the second root}
+    \param [in] n_roots {The number of roots Solve_Equation_Complex () has returned}
+    \return 1 if the result is correct
+    \return 0 otherwise
+*/
+static int Check_Complex_Roots (const double a, const double b, const double c, const double root[4], const enum N_Roots n_roots)
+{
+    double x[2] = {NAN, NAN};
+    enum N_Roots n_roots_ref = Get_Number_Of_Roots_And_Solve_Equation (a, b, c, &x[0], &x[1]);
+
+    if (n_roots != n_roots_ref)
+        return 0;
+
+    int linear   = Compare_Double (a, 0.0) == Equal;
+    int exists_1 = !linear || Compare_Double (b, 0.0) != Equal;
+
+    if (n_roots_ref != Zero || linear)
+        return memcmp (&root[0], &x[0], sizeof (double)) == 0 && memcmp (&root[2], &x[1], sizeof (double)) == 0 &&
+               (exists_1 ? root[1] == 0.0 : IsNAN (root[1])) && (!linear ? root[3] == 0.0 : IsNAN (root[3]));
+
+    if (root[0] != root[2] || root[1] != -root[3] || root[3] == 0.0)
+        return 0;
+
+    for (int i = 0; i < 4; i += 2)
+    {
+        double re = root[i], im = root[i + 1], modulus = hypot (re, im);
+        double residual_re = a * (re * re - im * im) + b * re + c;
+        double residual_im = (2 * a * re + b) * im;
+        double scale = fabs (a) * modulus * modulus + fabs (b) * modulus + fabs (c);
+
+        if (hypot (residual_re, residual_im) > 1E-12 * scale)
+            return 0;
+    }
+
+    return 1;
+}
+
+/**
+    \brief Checks the complex-root mode of the scalar solver and of every kernel
+
+    The equations of the arrays "Tests" and "Edge_Cases" are solved by Solve_Equation_Complex ()
+             and the results are checked by Check_Complex_Roots (). Solve_Batch_Complex () and every kernel
+             the processor supports have to give the same arrays bit for bit.
+    x^2 + 1 = 0 and x^2 + 2x + 5 = 0 have to give exactly -+i and -1 -+ 2i.
+
+    \return The number of wrong results
+*/
+int Complex_Unit_Test (void)
+{
+    double a[MAX_BATCH_TEST] = {0}, b[MAX_BATCH_TEST] = {0}, c[MAX_BATCH_TEST] = {0};
+    double expected[4][MAX_BATCH_TEST] = {{0}}, roots[4][MAX_BATCH_TEST] = {{0}};
+    enum N_Roots expected_n[MAX_BATCH_TEST] = {0}, n_roots[MAX_BATCH_TEST] = {0};
+    int n_equations = Get_Batch_Test_Equations (a, b, c);
+    int failed = 0;
+
+    for (int i = 0; i < n_equations; i++)
+    {
+        double root[4] = {0};
+        expected_n[i] = Solve_Equation_Complex (a[i], b[i], c[i], &root[0], &root[1], &root[2], &root[3]);
+
+        for (int part = 0; part < 4; part++)
+            expected[part][i] = root[part];
+
+        if (!Check_Complex_Roots (a[i], b[i], c[i], root, expected_n[i]))
+        {
+            printf ("Complex test FAILED: Solve_Equation_Complex (%g, %g, %g) gives %d roots (%g %+gi, %g %+gi)\n\n",
+                    a[i], b[i], c[i], expected_n[i], root[0], root[1], root[2], root[3]);
+            failed++;
+        }
+    }
+
+    const double exact[2][7] = {{1.0, 0.0, 1.0, -0.0, -1.0, 0.0, 1.0}, {1.0, 2.0, 5.0, -1.0, -2.0, -1.0, 2.0}};
+
+    for (int i = 0; i < 2; i++)
+    {
+        double root[4] = {0};
+
+        if (Solve_Equation_Complex (exact[i][0], exact[i][1], exact[i][2], &root[0], &root[1], &root[2], &root[3]) != Zero ||
+            root[0] != exact[i][3] || root[1] != exact[i][4] || root[2] != exact[i][5] || root[3] != exact[i][6])
+        {
+            printf ("Complex test FAILED: %gx^2 %+gx %+g = 0 gives %g %+gi, %g %+gi\n\n",
+                    exact[i][0], exact[i][1], exact[i][2], root[0], root[1], root[2], root[3]);
+            failed++;
+        }
+    }
+
+    const char *names[] = {"Solve_Batch_Complex ()", "SSE2", "AVX2", "AVX-512"};
+
+    for (enum Simd_Level level = Simd_None; level <= Get_Simd_Level (); level++)
+    {
+        Get_Simd_Complex_Solver (level) (a, b, c, roots[0], roots[1], roots[2], roots[3], n_roots, (size_t)n_equations);
+
+        if (memcmp (n_roots, expected_n, (size_t)n_equations * sizeof (enum N_Roots)) != 0 ||
+            memcmp (roots, expected, sizeof (roots)) != 0)
+        {
+            printf ("Complex test FAILED: %s gives other roots than Solve_Equation_Complex ()\n\n", names[level]);
+            failed++;
+        }
+    }
+
+    return failed;
+}
+
+/**
+    \brief Checks if a number is 0 or a normal number of the "double" type
+
+    \param [in] value {The number}
+    \return true if it is
+*/
+static bool Is_Normal_Or_Zero (const double value)
+{
+    return value == 0.0 || isnormal (value);
+}
+
+#define N_SCALING_VALUES 12      ///The number of values in the array "values" of Check_Scaling_Kernels ()
+#define N_SCALING_TESTS (N_SCALING_VALUES * N_SCALING_VALUES * N_SCALING_VALUES)    ///All their triples
+
+/**
+    \brief Checks the kernels of Scale_Coefficients () and Unscale_Roots () of every level the processor supports
+
+    All the triples of zeros, subnormal, tiny, ordinary, huge and not finite numbers have to be scaled
+             the same way as by Scale_Coefficients () bit for bit, and the scaled numbers multiplied by powers of two
+             from -2200 to 2200 the same way as by Unscale_Roots (). An odd number of equations leaves a tail
+             for the scalar functions.
+
+    \return The number of wrong results
+*/
+static int Check_Scaling_Kernels (void)
+{
+    const double values[N_SCALING_VALUES] =
+        {0.0, -0.0, DBL_TRUE_MIN, -0x1.8p-1030, DBL_MIN, 1E-300, -1.5, 7.0, 1E300, -DBL_MAX, INFINITY, NAN};
+    static double a[N_SCALING_TESTS], b[N_SCALING_TESTS], c[N_SCALING_TESTS];
+    static double expected[3][N_SCALING_TESTS], scaled[3][N_SCALING_TESTS];
+    static double roots[4][N_SCALING_TESTS];
+    static int expected_exponent[N_SCALING_TESTS], exponent[N_SCALING_TESTS], powers[N_SCALING_TESTS];
+    const size_t n_equations = N_SCALING_TESTS - 1;
+    int failed = 0;
+
+    for (int i = 0; i < N_SCALING_TESTS; i++)
+    {
+        a[i] = values[i / (N_SCALING_VALUES * N_SCALING_VALUES)];
+        b[i] = values[i / N_SCALING_VALUES % N_SCALING_VALUES];
+        c[i] = values[i % N_SCALING_VALUES];
+        powers[i] = i * 4401 / N_SCALING_TESTS - 2200;
+    }
+
+    Scale_Coefficients (a, b, c, expected[0], expected[1], expected[2], expected_exponent, n_equations);
+
+    for (enum Simd_Level level = Simd_SSE2; level <= Get_Simd_Level (); level++)
+    {
+        Get_Simd_Scaler (level) (a, b, c, scaled[0], scaled[1], scaled[2], exponent, n_equations);
+
+        for (size_t i = 0; i < n_equations; i++)
+            if (memcmp (&scaled[0][i], &expected[0][i], sizeof (double)) != 0 ||
+                memcmp (&scaled[1][i], &expected[1][i], sizeof (double)) != 0 ||
+                memcmp (&scaled[2][i], &expected[2][i], sizeof (double)) != 0 || exponent[i] != expected_exponent[i])
+            {
+                printf ("Scaled test FAILED: level \"%s\" scales (%g, %g, %g) to (%g, %g, %g) and 2^%d\n"
+                        "Should be: (%g, %g, %g) and 2^%d\n\n", Get_Simd_Level_Name (level), a[i], b[i], c[i],
+                        scaled[0][i], scaled[1][i], scaled[2][i], exponent[i],
+                        expected[0][i], expected[1][i], expected[2][i], expected_exponent[i]);
+                failed++;
+            }
+
+        const int *power_arrays[2] = {expected_exponent, powers};
+
+        for (int n_array = 0; n_array < 2; n_array++)
+        {
+            memcpy (roots[0], expected[0], sizeof (roots[0]));
+            memcpy (roots[1], c, sizeof (roots[1]));
+            memcpy (roots[2], expected[0], sizeof (roots[2]));
+            memcpy (roots[3], c, sizeof (roots[3]));
+
+            Unscale_Roots (roots[0], roots[1], power_arrays[n_array], n_equations);
+            Get_Simd_Unscaler (level) (roots[2], roots[3], power_arrays[n_array], n_equations);
+
+            for (size_t i = 0; i < n_equations; i++)
+                if (memcmp (&roots[2][i], &roots[0][i], sizeof (double)) != 0 ||
+                    memcmp (&roots[3][i], &roots[1][i], sizeof (double)) != 0)
+                {
+                    printf ("Scaled test FAILED: level \"%s\" multiplies (%g, %g) by 2^%d to (%g, %g)\n"
+                            "Should be: (%g, %g)\n\n", Get_Simd_Level_Name (level), expected[0][i], c[i],
+                            power_arrays[n_array][i], roots[2][i], roots[3][i], roots[0][i], roots[1][i]);
+                    failed++;
+                }
+        }
+    }
+
+    return failed;
+}
+
+/**
+    \brief Checks the solvers for coefficients of any size
+
+    Solve_Batch_Scaled_Simd () has to give the results of Solve_Batch_Scaled () with every level the processor supports,
+             and so have the scaling kernels (Check_Scaling_Kernels ()).
+    The equations of the arrays "Tests" and "Edge_Cases" with the coefficients multiplied by 2^m and the roots by 2^j
+             have to give the roots multiplied by 2^j bit for bit (if all the numbers stay normal).
+    Equations whose discriminants overflow or underflow or whose "a" is less than EPSILON have to give the right roots.
+
+    \return The number of wrong results
+*/
+int Scaled_Unit_Test (void)
+{
+    double a[MAX_BATCH_TEST] = {0}, b[MAX_BATCH_TEST] = {0}, c[MAX_BATCH_TEST] = {0};
+    double x_1[MAX_BATCH_TEST] = {0}, x_2[MAX_BATCH_TEST] = {0}, y_1[MAX_BATCH_TEST] = {0}, y_2[MAX_BATCH_TEST] = {0};
+    enum N_Roots n_roots[MAX_BATCH_TEST] = {0}, m_roots[MAX_BATCH_TEST] = {0};
+    int n_equations = Get_Batch_Test_Equations (a, b, c);
+    int failed = 0;
+
+    Solve_Batch_Scaled (a, b, c, x_1, x_2, n_roots, (size_t)n_equations);
+
+    enum Simd_Level active = Get_Active_Simd_Level ();
+
+    for (enum Simd_Level level = Simd_None; level <= Get_Simd_Level (); level++)
+    {
+        Set_Simd_Level (level);
+        Solve_Batch_Scaled_Simd (a, b, c, y_1, y_2, m_roots, (size_t)n_equations);
+
+        if (memcmp (m_roots, n_roots, (size_t)n_equations * sizeof (enum N_Roots)) != 0 ||
+            memcmp (y_1, x_1, (size_t)n_equations * sizeof (double)) != 0 ||
+            memcmp (y_2, x_2, (size_t)n_equations * sizeof (double)) != 0)
+        {
+            printf ("Scaled test FAILED: level \"%s\" gives other results than Solve_Batch_Scaled ()\n\n",
+                    Get_Simd_Level_Name (level));
+            failed++;
+        }
+    }
+
+    Set_Simd_Level (active);
+
+    const int shifts[][2] = {{-600, 300}, {500, -900}, {-300, -400}, {350, 200}};   // j and m
+
+    for (int n_shift = 0; n_shift < (int)(sizeof (shifts) / sizeof (shifts[0])); n_shift++)
+    {
+        int j = shifts[n_shift][0], m = shifts[n_shift][1];
+        double sa[MAX_BATCH_TEST] = {0}, sb[MAX_BATCH_TEST] = {0}, sc[MAX_BATCH_TEST] = {0};
+
+        for (int i = 0; i < n_equations; i++)
+        {
+            sa[i] = ldexp (a[i], m);
+            sb[i] = ldexp (b[i], j + m);
+            sc[i] = ldexp (c[i], 2 * j + m);
+        }
+
+        Solve_Batch_Scaled (sa, sb, sc, y_1, y_2, m_roots, (size_t)n_equations);
+
+        for (int i = 0; i < n_equations; i++)
+        {
+            double expected[2] = {ldexp (x_1[i], j), ldexp (x_2[i], j)};
+
+            if (!Is_Normal_Or_Zero (a[i])  || !Is_Normal_Or_Zero (b[i])  || !Is_Normal_Or_Zero (c[i]) ||
+                !Is_Normal_Or_Zero (sa[i]) || !Is_Normal_Or_Zero (sb[i]) || !Is_Normal_Or_Zero (sc[i]) ||
+                !(IsNAN (x_1[i]) || (Is_Normal_Or_Zero (x_1[i]) && Is_Normal_Or_Zero (expected[0]))) ||
+                !(IsNAN (x_2[i]) || (Is_Normal_Or_Zero (x_2[i]) && Is_Normal_Or_Zero (expected[1]))))
+                continue;
+
+            if (m_roots[i] != n_roots[i] || memcmp (&y_1[i], &expected[0], sizeof (double)) != 0 ||
+                                            memcmp (&y_2[i], &expected[1], sizeof (double)) != 0)
+            {
+                printf ("Scaled test FAILED: (%g, %g, %g) scaled by 2^%d with roots scaled by 2^%d gives %d roots %g, %g\n"
+                        "Should be: %d roots %g, %g\n\n",
+                        a[i], b[i], c[i], m, j, m_roots[i], y_1[i], y_2[i], n_roots[i], expected[0], expected[1]);
+                failed++;
+            }
+        }
+    }
+
+    const double wide[][7] =    // a, b, c, the number of roots, x_1, x_2, relative tolerance
+    {
+        {1E-200,  3E-200,  2E-200, Two, -2.0,   -1.0,   1E-15},
+        {1E200,  -3E200,   2E200,  Two,  1.0,    2.0,   1E-15},
+        {1E-300,  0.0,    -4E-300, Two, -2.0,    2.0,   1E-15},
+        {1.0,    -8E150,   1.5E301, Two, 3E150,  5E150, 1E-15},
+        {1E-10,  -2E-10,   1E-10,  One,  1.0,    1.0,   0.0  },
+        {0.0,     1E-250, -3E-250, One,  3.0,    NAN,   1E-15},
+        {1E-7,    1.0,     1.0,    Two, -9999998.999999901, -1.00000010000002, 1E-15},
+        {1E-20,   1.0,     1.0,    Two, -1E20,  -1.0,   1E-15},
+        {1.0,     1E200,   1.0,    Two, -1E200, -1E-200, 1E-15},
+        {1E-300,  1.0,     1.0,    Two, -1E300, -1.0,   1E-15},
+        {125.42503804334299, DBL_MAX, -56.313953923607436, Two, -1.4332809165591714E306, 3.1325676686149491E-307, 1E-15}
+    };
+
+    for (int i = 0; i < (int)(sizeof (wide) / sizeof (wide[0])); i++)
+    {
+        double root_1 = NAN, root_2 = NAN;
+        enum N_Roots n = Zero;
+
+        Solve_Batch_Scaled (&wide[i][0], &wide[i][1], &wide[i][2], &root_1, &root_2, &n, 1);
+
+        if (n != (enum N_Roots)wide[i][3] || !(fabs (root_1 - wide[i][4]) <= wide[i][6] * fabs (wide[i][4])) ||
+            !(IsNAN (wide[i][5]) ? IsNAN (root_2) : fabs (root_2 - wide[i][5]) <= wide[i][6] * fabs (wide[i][5])))
+        {
+            printf ("Scaled test FAILED: %g x^2 %+g x %+g = 0 gives %d roots %.17g, %.17g\n"
+                    "Should be: %d roots %.17g, %.17g\n\n",
+                    wide[i][0], wide[i][1], wide[i][2], n, root_1, root_2, (int)wide[i][3], wide[i][4], wide[i][5]);
+            failed++;
+        }
+    }
+
+    failed += Check_Scaling_Kernels ();
+
+    return failed;
+}
+
+/**
+    \brief Writes the equations of the arrays "Tests" and "Edge_Cases" one after another into a binary file
+
+    \param [in] fd {The file}
+    \param [in] npy {Write an .npy array of shape (n_lines, 3) instead of raw triples}
+    \param [in] layout {The order of the coefficients; Packed_Columns is an .npy array in Fortran order}
+    \param [in] n_lines {The number of equations}
+    \return 0 if the file has been written
+    \return -1 otherwise
+*/
+static int Write_Binary_Test_Input (const int fd, const bool npy, const enum Binary_Layout layout, const size_t n_lines)
+{
+    double a[MAX_BATCH_TEST] = {0}, b[MAX_BATCH_TEST] = {0}, c[MAX_BATCH_TEST] = {0};
+    const double *columns[3] = {a, b, c};
+    size_t n_equations = (size_t)Get_Batch_Test_Equations (a, b, c);
+    FILE *file = fdopen (dup (fd), "wb");
+
+    if (file == NULL)
+        return -1;
+
+    if (npy || layout == Packed_Columns)
+    {
+        char header[2 * NPY_ALIGNMENT] = "";
+        int length = snprintf (header + 10, sizeof (header) - 10,
+                               "{'descr': '<f8', 'fortran_order': %s, 'shape': (%zu, 3), }",
+                               (layout == Packed_Columns) ? "True" : "False", n_lines);
+
+        memcpy (header, NPY_MAGIC, NPY_MAGIC_LENGTH);
+        header[6] = 1;
+        header[8] = (char)(sizeof (header) - 10);
+        memset (header + 10 + length, ' ', sizeof (header) - 10 - (size_t)length - 1);
+        header[sizeof (header) - 1] = '\n';
+        fwrite (header, 1, sizeof (header), file);
+    }
+
+    if (layout == Packed_Columns)
+        for (int i = 0; i < 3; i++)
+            for (size_t line = 0; line < n_lines; line++)
+                fwrite (&columns[i][line % n_equations], sizeof (double), 1, file);
+    else
+        for (size_t line = 0; line < n_lines; line++)
+            for (int i = 0; i < 3; i++)
+                fwrite (&columns[i][line % n_equations], sizeof (double), 1, file);
+
+    return fclose (file);
+}
+
+/**
+    \brief Reads a whole file written by a test
+
+    \param [in] path {The name of the file}
+    \param [out] size {Pointer on the variable in which the function puts the size of the file}
+    \return The contents of the file (to be freed) or NULL if it cannot be read
+*/
+static char *Read_Test_File (const char *path, size_t *size)
+{
+    FILE *file = fopen (path, "rb");
+    char *data = NULL;
+    long length = -1;
+
+    if (file != NULL && fseek (file, 0, SEEK_END) == 0 && (length = ftell (file)) >= 0 && fseek (file, 0, SEEK_SET) == 0 &&
+        (data = malloc ((size_t)length + 1)) != NULL && fread (data, 1, (size_t)length, file) != (size_t)length)
+    {
+        free (data);
+        data = NULL;
+    }
+
+    if (file != NULL)
+        fclose (file);
+    *size = (data != NULL) ? (size_t)length : 0;
+
+    return data;
+}
+
+/**
+    \brief Checks that a file written by Run_Binary_Mode () is an .npy array with the expected elements
+
+    The header should be the one of Make_Npy_Header (): a multiple of NPY_ALIGNMENT bytes whose length field
+             is right, ending with a line feed and describing a one-dimensional array of "n_elements" elements of "descr".
+
+    \param [in] path {The name of the file}
+    \param [in] descr {The type of the elements}
+    \param [in] elements {The expected elements}
+    \param [in] element_size {The size of one element in bytes}
+    \param [in] n_elements {The number of elements}
+    \return True if the file is right
+*/
+static bool Check_Npy_Output (const char *path, const char *descr, const void *elements,
+                              const size_t element_size, const size_t n_elements)
+{
+    char header[NPY_MAX_HEADER] = "", fields[NPY_MAX_HEADER] = "";
+    size_t header_size = Make_Npy_Header (header, descr, n_elements), size = 0;
+    char *file = Read_Test_File (path, &size);
+
+    snprintf (fields, sizeof (fields), "{'descr': %s, 'fortran_order': False, 'shape': (%zu,), }", descr, n_elements);
+
+    bool right = file != NULL && header_size % NPY_ALIGNMENT == 0 && size == header_size + n_elements * element_size &&
+                 10 + ((unsigned char)header[8] | (size_t)(unsigned char)header[9] << 8) == header_size &&
+                 header[header_size - 1] == '\n' && strncmp (header + 10, fields, strlen (fields)) == 0 &&
+                 memcmp (file, header, header_size) == 0 &&
+                 memcmp (file + header_size, elements, n_elements * element_size) == 0;
+
+    free (file);
+
+    return right;
+}
+
+/**
+    \brief Checks the mapped binary mode
+
+    Raw triples and .npy arrays in C and Fortran order of 1000 equations (the ones of the arrays "Tests"
+             and "Edge_Cases" one after another) are mapped by Map_Binary_Input () and solved by Run_Binary_Mode ()
+             into an .npy file, and with "--classify" (Classify_Binary_Input ()) into an .npy array of counts.
+             Check_Npy_Output () compares the files with the results of Solve_Batch () bit by bit.
+    An output that is the input file should be refused and leave the input as it is.
+
+    \return The number of inputs with wrong results
+*/
+int Binary_Unit_Test (void)
+{
+    double a[MAX_BATCH_TEST] = {0}, b[MAX_BATCH_TEST] = {0}, c[MAX_BATCH_TEST] = {0};
+    double x_1[MAX_BATCH_TEST] = {0}, x_2[MAX_BATCH_TEST] = {0};
+    enum N_Roots n_roots[MAX_BATCH_TEST] = {0};
+    size_t n_equations = (size_t)Get_Batch_Test_Equations (a, b, c);
+    const size_t n_lines = 1000;
+
+    struct Root_Record *records = calloc (n_lines, sizeof (struct Root_Record));
+    int8_t *counts = calloc (n_lines, sizeof (int8_t));
+
+    if (records == NULL || counts == NULL)
+    {
+        printf ("Binary test FAILED: not enough memory\n\n");
+        free (records);
+        free (counts);
+        return 1;
+    }
+
+    Solve_Batch (a, b, c, x_1, x_2, n_roots, n_equations);
+
+    for (size_t line = 0; line < n_lines; line++)
+    {
+        records[line] = (struct Root_Record){x_1[line % n_equations], x_2[line % n_equations], n_roots[line % n_equations]};
+        counts[line]  = (int8_t)n_roots[line % n_equations];
+    }
+
+    const char *names[] = {"raw triples", "an .npy array in C order", "an .npy array in Fortran order"};
+    int failed = 0;
+
+    for (int format = 0; format < 3; format++)
+    {
+        char input_path[]  = "/tmp/quadratic_binary_in_XXXXXX";
+        char output_path[] = "/tmp/quadratic_binary_out_XXXXXX.npy";
+        int input_fd  = mkstemp (input_path);
+        int output_fd = mkstemps (output_path, 4);
+        enum Binary_Layout layout = (format == 2) ? Packed_Columns : Packed_Triples;
+
+        struct Binary_Input input = {0};
+        struct Options options = {.Mode = Binary, .Input = input_path, .Output = output_path, .N_Threads = 1};
+        bool test_failed = input_fd == -1 || output_fd == -1 ||
+                           Write_Binary_Test_Input (input_fd, format != 0, layout, n_lines) != 0 ||
+                           Map_Binary_Input (input_path, &input) != 0 || input.N_Equations != n_lines || input.Layout != layout;
+
+        Unmap_Binary_Input (&input);
+
+        if (!test_failed)
+            test_failed = Run_Binary_Mode (&options) != 0 ||
+                          !Check_Npy_Output (output_path, NPY_RECORD_DESCR, records, sizeof (struct Root_Record), n_lines);
+        if (!test_failed)
+        {
+            options.Classify = true;
+            test_failed = Run_Binary_Mode (&options) != 0 ||
+                          !Check_Npy_Output (output_path, NPY_COUNT_DESCR, counts, sizeof (int8_t), n_lines);
+        }
+        if (!test_failed)
+        {
+            struct stat before = {0}, after = {0};
+
+            options.Classify = false;
+            options.Output = input_path;
+            test_failed = stat (input_path, &before) != 0 || Run_Binary_Mode (&options) != 2 ||
+                          stat (input_path, &after) != 0 || after.st_size != before.st_size;
+        }
+
+        if (test_failed)
+        {
+            printf ("Binary test FAILED: the results of %s differ from the ones of Solve_Batch ()\n\n", names[format]);
+            failed++;
+        }
+
+        if (input_fd != -1)
+        {
+            close (input_fd);
+            unlink (input_path);
+        }
+        if (output_fd != -1)
+        {
+            close (output_fd);
+            unlink (output_path);
+        }
+    }
+
+    free (records);
+    free (counts);
+
+    return failed;
+}
+
+/**
+    \brief Checks that chunked processing writes the same records as the scalar solver
+
+    Raw triples and an .npy array in Fortran order of 1000 equations (the ones of the arrays "Tests" and "Edge_Cases"
+             one after another) are solved by Solve_Chunked () with Read_Binary_Chunk (), Write_Binary_Chunk ()
+             and an arena of 7 equations, so the last chunk is not full. The records are compared
+             with Get_Number_Of_Roots_And_Solve_Equation () bit by bit.
+
+    \return The number of inputs with different results
+*/
+int Chunked_Unit_Test (void)
+{
+    double a[MAX_BATCH_TEST] = {0}, b[MAX_BATCH_TEST] = {0}, c[MAX_BATCH_TEST] = {0};
+    size_t n_equations = (size_t)Get_Batch_Test_Equations (a, b, c);
+    const size_t n_lines = 1000;
+
+    const char *names[] = {"raw triples", "an .npy array in Fortran order"};
+    int failed = 0;
+
+    for (int fortran_order = 0; fortran_order <= 1; fortran_order++)
+    {
+        char input_path[]  = "/tmp/quadratic_chunked_in_XXXXXX";
+        char output_path[] = "/tmp/quadratic_chunked_out_XXXXXX";
+        int input_fd  = mkstemp (input_path);
+        int output_fd = mkstemp (output_path);
+
+        struct Binary_Source source = {0};
+        struct Binary_Sink sink = {.Fd = -1};
+        struct Equation_Block arena = {0};
+        bool test_failed = true;
+
+        if (input_fd != -1 && output_fd != -1 && Write_Binary_Test_Input (input_fd, fortran_order, fortran_order ? Packed_Columns : Packed_Triples, n_lines) == 0 &&
+            Allocate_Equation_Block (&arena, 7) == 0 &&
+            Open_Binary_Source (&source, input_path) == 0 && Open_Binary_Sink (&sink, output_path, false, source.N_Equations) == 0 &&
+            Solve_Chunked (&arena, Read_Binary_Chunk, &source, Write_Binary_Chunk, &sink, NULL, NULL) == 0 &&
+            !source.Failed && source.N_Read == n_lines && Close_Binary_Sink (&sink) == 0)
+        {
+            test_failed = false;
+
+            for (size_t line = 0; line < n_lines && !test_failed; line++)
+            {
+                size_t i = line % n_equations;
+                struct Root_Record record = {0}, expected = {.X_1 = NAN, .X_2 = NAN};
+
+                expected.N_Roots = Get_Number_Of_Roots_And_Solve_Equation (a[i], b[i], c[i], &expected.X_1, &expected.X_2);
+
+                test_failed = pread (output_fd, &record, sizeof (record), (off_t)(line * sizeof (record))) != sizeof (record) ||
+                              memcmp (&record, &expected, sizeof (record)) != 0;
+            }
+        }
+
+        if (test_failed)
+        {
+            printf ("Chunked test FAILED: the records of %s differ from the ones of the scalar solver\n\n", names[fortran_order]);
+            failed++;
+        }
+
+        Close_Binary_Source (&source);
+        Close_Binary_Sink (&sink);
+        Free_Equation_Block (&arena);
+        if (input_fd != -1)
+        {
+            close (input_fd);
+            unlink (input_path);
+        }
+        if (output_fd != -1)
+        {
+            close (output_fd);
+            unlink (output_path);
+        }
+    }
+
+    return failed;
+}
+
+/**
+    \brief Writes results into a result store, reads them back and compares them
+
+    The equations of the arrays "Tests" and "Edge_Cases" repeated over 2 blocks and a part of the third are solved
+             by Solve_Batch_Simd () and written by chunks of 777 equations, with roots and with only classes.
+    Decode_Store_Block () has to give the same results bit for bit and the index the same totals as Count_Root_Classes ().
+    The store with roots has to be smaller than the records of the binary mode, and a store without its last byte
+             has to be rejected.
+
+    \return The number of failed checks
+*/
+int Store_Unit_Test (void)
+{
+    double a[MAX_BATCH_TEST] = {0}, b[MAX_BATCH_TEST] = {0}, c[MAX_BATCH_TEST] = {0};
+    size_t n_tests = (size_t)Get_Batch_Test_Equations (a, b, c);
+    const size_t n_equations = 2 * STORE_BLOCK_SIZE + 1000, chunk_size = 777;
+
+    struct Equation_Block block = {0}, decoded = {0};
+    if (Allocate_Equation_Block (&block, n_equations) != 0 || Allocate_Equation_Block (&decoded, STORE_BLOCK_SIZE) != 0)
+    {
+        printf ("Store test FAILED: not enough memory\n\n");
+        Free_Equation_Block (&block);
+        Free_Equation_Block (&decoded);
+        return 1;
+    }
+
+    for (size_t i = 0; i < n_equations; i++)
+    {
+        block.A[i] = a[i % n_tests];
+        block.B[i] = b[i % n_tests];
+        block.C[i] = c[i % n_tests];
+    }
+
+    Solve_Batch_Simd (block.A, block.B, block.C, block.X_1, block.X_2, block.N_Roots, n_equations);
+
+    size_t totals[4] = {0};
+    Count_Root_Classes (block.N_Roots, n_equations, totals);
+
+    int failed = 0;
+
+    for (int classes_only = 0; classes_only <= 1; classes_only++)
+    {
+        char path[] = "/tmp/quadratic_store_XXXXXX.qrs";
+        int fd = mkstemps (path, 4);
+        struct Store_Writer writer = {0};
+        struct Store_Reader reader = {0};
+        bool test_failed = (fd == -1 || Open_Store_Writer (&writer, path, classes_only) != 0);
+
+        for (size_t first = 0; first < n_equations && !test_failed; first += chunk_size)
+        {
+            size_t count = (n_equations - first < chunk_size) ? n_equations - first : chunk_size;
+            test_failed = Write_Store_Chunk (&writer, block.X_1 + first, block.X_2 + first, block.N_Roots + first, count) != 0;
+        }
+
+        test_failed |= Close_Store_Writer (&writer) != 0 || Open_Store_Reader (&reader, path) != 0;
+
+        if (!test_failed)
+        {
+            size_t store_totals[4] = {0};
+            Get_Store_Totals (&reader, store_totals);
+
+            test_failed = reader.Footer->N_Blocks != 3 || reader.Footer->N_Equations != n_equations ||
+                          memcmp (store_totals, totals, sizeof (totals)) != 0 ||
+                          (!classes_only && reader.Mapping_Size >= n_equations * sizeof (struct Root_Record));
+
+            struct Store_Block store_block = {0};
+            for (size_t n_block = 0; !test_failed && Get_Store_Block (&reader, n_block, &store_block) == 0; n_block++)
+            {
+                size_t first = store_block.First, count = store_block.Entry->N_Equations;
+                Decode_Store_Block (&store_block, decoded.X_1, decoded.X_2, decoded.N_Roots);
+
+                test_failed = memcmp (decoded.N_Roots, block.N_Roots + first, count * sizeof (enum N_Roots)) != 0 ||
+                              (!classes_only && (memcmp (decoded.X_1, block.X_1 + first, count * sizeof (double)) != 0 ||
+                                                 memcmp (decoded.X_2, block.X_2 + first, count * sizeof (double)) != 0));
+            }
+        }
+
+        if (test_failed)
+        {
+            printf ("Store test FAILED: the results read back from a store %s differ from the ones written\n\n",
+                    classes_only ? "of classes" : "with roots");
+            failed++;
+        }
+
+        Close_Store_Reader (&reader);
+
+        if (fd != -1 && ftruncate (fd, (off_t)(lseek (fd, 0, SEEK_END) - 1)) == 0 && Open_Store_Reader (&reader, path) == 0)
+        {
+            printf ("Store test FAILED: a store without its last byte has been read\n\n");
+            Close_Store_Reader (&reader);
+            failed++;
+        }
+
+        if (fd != -1)
+        {
+            close (fd);
+            unlink (path);
+        }
+    }
+
+    Free_Equation_Block (&block);
+    Free_Equation_Block (&decoded);
+
+    return failed;
+}
+
+///The matches of a query in Query_Unit_Test ()
+struct Query_Test_Sink
+{
+    const struct Equation_Block *Solved;    ///< The results the store has been written from
+    size_t N_Matches;                       ///< The number of matches
+    bool Wrong;                             ///< A match differs from the results or is out of order
+    uint64_t Next;                          ///< The smallest number the next match can have
+};
+
+/**
+    \brief Checks a match of a query against the results the store has been written from (a Match_Writer)
+
+    \param [in] sink {Pointer on struct Query_Test_Sink}
+    \param [in] number {The number of the equation}
+    \param [in] n_roots {The number of roots}
+    \param [in] x_1 {The first root}
+    \param [in] x_2 {The second root}
+    \return 0
+*/
+static int Check_Query_Match (void *sink, const uint64_t number, const enum N_Roots n_roots, const double x_1, const double x_2)
+{
+    struct Query_Test_Sink *query = sink;
+    const struct Equation_Block *solved = query->Solved;
+
+    query->Wrong |= number < query->Next || n_roots != solved->N_Roots[number] ||
+                    memcmp (&x_1, solved->X_1 + number, sizeof (double)) != 0 ||
+                    memcmp (&x_2, solved->X_2 + number, sizeof (double)) != 0;
+    query->Next = number + 1;
+    query->N_Matches++;
+
+    return 0;
+}
+
+/**
+    \brief Runs queries over a result store and compares them with a check of every equation
+
+    The store has 2 blocks and a part of the third of equations (x - r) (x - r - 1) with r growing
+             by 0.001 and every fifth equation without roots. A query has to give the same equations
+             as checking every one of them and skip the blocks it expects: a narrow range of roots reads one block,
+             a range of "x_2" beyond all the roots none, and the class Zero all of them.
+
+    \return The number of failed queries
+*/
+int Query_Unit_Test (void)
+{
+    const size_t n_equations = 2 * STORE_BLOCK_SIZE + 1000;
+
+    struct Equation_Block block = {0}, decoded = {0};
+    if (Allocate_Equation_Block (&block, n_equations) != 0 || Allocate_Equation_Block (&decoded, STORE_BLOCK_SIZE) != 0)
+    {
+        printf ("Query test FAILED: not enough memory\n\n");
+        Free_Equation_Block (&block);
+        Free_Equation_Block (&decoded);
+        return 1;
+    }
+
+    for (size_t i = 0; i < n_equations; i++)
+    {
+        double root = (double)i * 0.001;
+
+        block.A[i] = 1.0;
+        block.B[i] = (i % 5 == 4) ? 0.0 : -(2.0 * root + 1.0);
+        block.C[i] = (i % 5 == 4) ? 1.0 : root * (root + 1.0);
+    }
+
+    Solve_Batch_Simd (block.A, block.B, block.C, block.X_1, block.X_2, block.N_Roots, n_equations);
+
+    char path[] = "/tmp/quadratic_query_XXXXXX.qrs";
+    int fd = mkstemps (path, 4);
+    struct Store_Writer writer = {0};
+    struct Store_Reader reader = {0};
+
+    if (fd == -1 || Open_Store_Writer (&writer, path, false) != 0 ||
+        Write_Store_Chunk (&writer, block.X_1, block.X_2, block.N_Roots, n_equations) != 0 ||
+        Close_Store_Writer (&writer) != 0 || Open_Store_Reader (&reader, path) != 0)
+    {
+        printf ("Query test FAILED: cannot write the store\n\n");
+        if (fd != -1)
+        {
+            close (fd);
+            unlink (path);
+        }
+        Free_Equation_Block (&block);
+        Free_Equation_Block (&decoded);
+        return 1;
+    }
+
+    struct Scan_Filter filters[3] = {{0}, {0}, {0}};
+    const size_t expected_blocks[3] = {1, 0, 3};
+
+    filters[0].By_Root = true;
+    filters[0].Root_Range[0] = 70.0;
+    filters[0].Root_Range[1] = 80.0;
+
+    filters[1].By_X_2 = true;
+    filters[1].X_2_Range[0] = 1000.0;
+    filters[1].X_2_Range[1] = INFINITY;
+
+    filters[2].By_Class = true;
+    filters[2].Class = Zero;
+
+    int failed = 0;
+
+    for (int n_filter = 0; n_filter < 3; n_filter++)
+    {
+        const struct Scan_Filter *filter = filters + n_filter;
+        size_t n_expected = 0;
+
+        for (size_t i = 0; i < n_equations; i++)
+        {
+            double x_1 = block.X_1[i], x_2 = block.X_2[i];
+
+            n_expected += (!filter->By_Class || block.N_Roots[i] == filter->Class) &&
+                          (!filter->By_X_2 || (filter->X_2_Range[0] <= x_2 && x_2 <= filter->X_2_Range[1])) &&
+                          (!filter->By_Root || (filter->Root_Range[0] <= x_1 && x_1 <= filter->Root_Range[1]) ||
+                                               (filter->Root_Range[0] <= x_2 && x_2 <= filter->Root_Range[1]));
+        }
+
+        struct Query_Test_Sink sink = {&block, 0, false, 0};
+        size_t n_read_blocks = 0;
+
+        if (Query_Store (&reader, filter, &decoded, Check_Query_Match, &sink, &n_read_blocks) != 0 ||
+            sink.Wrong || sink.N_Matches != n_expected || n_read_blocks != expected_blocks[n_filter])
+        {
+            printf ("Query test FAILED: query %d has given %zu matches of %zu after reading %zu blocks instead of %zu%s\n\n",
+                    n_filter, sink.N_Matches, n_expected, n_read_blocks, expected_blocks[n_filter],
+                    sink.Wrong ? ", some of them are wrong" : "");
+            failed++;
+        }
+    }
+
+    Close_Store_Reader (&reader);
+    close (fd);
+    unlink (path);
+    Free_Equation_Block (&block);
+    Free_Equation_Block (&decoded);
+
+    return failed;
+}
+
+/**
+    \brief Checks that Parse_Double () gives the same numbers as strtod () bit for bit
+
+    The numbers are hard cases of rounding (halfway between two numbers of the "double" type, 17 to 19 digits,
+             the borders of the fast paths, subnormal and huge numbers) and random numbers written with 6 to 19 digits.
+
+    \return The number of numbers that differ
+*/
+static int Parse_Double_Unit_Test (void)
+{
+    static const char *numbers[] =
+    {
+        "0", "-0", "1", "-1.5", "+2.25", ".5", "5.", "0.1", "1e23", "1E-22", "9007199254740992", "9007199254740993",
+        "9007199254740995", "18446744073709551615", "1844674407370955161.5", "123456789012345678e-27",
+        "3.1415926535897931", "2.7182818284590452354", "0.30000000000000004", "1.7976931348623157e308",
+        "2.2250738585072014e-308", "4.9e-324", "1e-400", "1e400", "00000000000000000000001.25", "1.000000000000000055511151231257827",
+        "7.2057594037927933e16", "8.5e-28", "4.6116860184273879e18", "inf", "-nan"
+    };
+    const int n_numbers = sizeof (numbers) / sizeof (numbers[0]);
+    const char *formats[] = {"%.6f", "%.15g", "%.17g", "%.18e", "%.16e"};
+    uint64_t state = 12345;
+    int failed = 0;
+
+    for (int i = 0; i < n_numbers + 50000 && failed < 10; i++)
+    {
+        char random_number[64] = "";
+        const char *text = (i < n_numbers) ? numbers[i] : random_number;
+
+        if (i >= n_numbers)
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+
+            double number = (double)(state >> 11) * 0x1p-53 * pow (10.0, (double)(state % 61) - 30.0);
+            snprintf (random_number, sizeof (random_number), formats[state % 5], (state & 1) ? number : -number);
+        }
+
+        double value = 0.0, value_ref = strtod (text, NULL);
+        const char *end = Parse_Double (text, text + strlen (text), &value);
+
+        if (end != text + strlen (text) || memcmp (&value, &value_ref, sizeof (double)) != 0)
+        {
+            printf ("Reader test FAILED: Parse_Double (\"%s\") = %.17g, should be %.17g\n\n", text, value, value_ref);
+            failed++;
+        }
+    }
+
+    return failed;
+}
+
+/**
+    \brief Runs the stream mode on a text and compares what it writes with the expected texts
+
+    The messages of stderr are written into a temporary file while the mode runs.
+
+    \param [in] text {The input}
+    \param [in] output_ref {The expected output}
+    \param [in] errors_ref {The expected messages of stderr}
+    \param [in] status_ref {The expected exit code}
+    \return True if the output, the messages and the exit code are the expected ones
+*/
+static bool Check_Stream_Mode (const char *text, const char *output_ref, const char *errors_ref, const int status_ref)
+{
+    char input_path[]  = "/tmp/quadratic_stream_in_XXXXXX";
+    char output_path[] = "/tmp/quadratic_stream_out_XXXXXX";
+    char errors_path[] = "/tmp/quadratic_stream_err_XXXXXX";
+    int input_fd  = mkstemp (input_path);
+    int output_fd = mkstemp (output_path);
+    int errors_fd = mkstemp (errors_path);
+    bool correct = false;
+
+    if (input_fd != -1 && output_fd != -1 && errors_fd != -1 &&
+        write (input_fd, text, strlen (text)) == (ssize_t)strlen (text))
+    {
+        struct Options options = {.Mode = Stream, .Input = input_path, .Output = output_path, .N_Threads = 1,
+                                  .Format = Shortest_Format};
+
+        fflush (stderr);
+        int saved_stderr = dup (STDERR_FILENO);
+        if (saved_stderr != -1)
+            dup2 (errors_fd, STDERR_FILENO);
+
+        int status = Run_Stream_Mode (&options);
+
+        fflush (stderr);
+        if (saved_stderr != -1)
+        {
+            dup2 (saved_stderr, STDERR_FILENO);
+            close (saved_stderr);
+        }
+
+        size_t output_size = 0, errors_size = 0;
+        char *output = Read_Test_File (output_path, &output_size);
+        char *errors = Read_Test_File (errors_path, &errors_size);
+
+        correct = status == status_ref && output != NULL && errors != NULL &&
+                  output_size == strlen (output_ref) && memcmp (output, output_ref, output_size) == 0 &&
+                  errors_size == strlen (errors_ref) && memcmp (errors, errors_ref, errors_size) == 0;
+
+        free (output);
+        free (errors);
+    }
+
+    const char *paths[] = {input_path, output_path, errors_path};
+    const int fds[] = {input_fd, output_fd, errors_fd};
+
+    for (int i = 0; i < 3; i++)
+        if (fds[i] != -1)
+        {
+            close (fds[i]);
+            unlink (paths[i]);
+        }
+
+    return correct;
+}
+
+/**
+    \brief Checks the stream mode from the input file to the output file and the exit code
+
+    Comments, empty lines, commas, semicolons, tabs and "\r\n" should be skipped, a malformed line should be reported
+             with its number and skipped, and the exit code should be 1 if there has been one, 0 otherwise.
+
+    \return The number of failed checks
+*/
+int Stream_Unit_Test (void)
+{
+    int failed = 0;
+
+    if (!Check_Stream_Mode ("# a b c\n1, -3, 2\n\n  4\t5 6\r\n1 2\n0 0 0\n1;2;3;4\n0 2 -1\nx 1 2\n",
+                            "2 1 2\n0 nan nan\n-1 nan nan\n1 0.5 nan\n",
+                            "Line 5: expected three numbers\nLine 7: expected three numbers\nLine 9: expected three numbers\n", 1))
+    {
+        printf ("Stream test FAILED: the results, the malformed lines or the exit code of an input with errors are wrong\n\n");
+        failed++;
+    }
+    if (!Check_Stream_Mode ("# comment\n\n1,-3,2\n1 2 1", "2 1 2\n1 -1 -1\n", "", 0))
+    {
+        printf ("Stream test FAILED: the results or the exit code of a correct input are wrong\n\n");
+        failed++;
+    }
+
+    return failed;
+}
+
+/**
+    \brief Checks that the reader finds the triples and the malformed lines
+
+    Calls Parse_Double_Unit_Test (). The input has a comment, an empty line, all the separators, a line of two numbers,
+             a line of four numbers, more than READER_BUFFER_SIZE bytes of correct lines, so lines cross the end
+             of the buffer, and a last line without '\\n'. The messages about malformed lines are not printed.
+
+    \return The number of failed checks
+*/
+int Reader_Unit_Test (void)
+{
+    const size_t n_repeated = READER_BUFFER_SIZE / 16 + 1000;
+    int failed = Parse_Double_Unit_Test ();
+
+    char path[] = "/tmp/quadratic_reader_XXXXXX";
+    int fd = mkstemp (path);
+    FILE *input = (fd == -1) ? NULL : fdopen (fd, "w");
+    struct Coeff_Reader reader = {0};
+
+    if (input == NULL)
+    {
+        printf ("Reader test FAILED: cannot create a temporary file\n\n");
+        if (fd != -1)
+        {
+            close (fd);
+            unlink (path);
+        }
+        return failed + 1;
+    }
+
+    fprintf (input, "# a b c\n1, -3, 2\n\n  4\t5 6\r\n1 2\n1;2;3;4\n");
+    for (size_t line = 0; line < n_repeated; line++)
+        fprintf (input, "1.25 -2.5 0.125\n");
+    fprintf (input, "-1.5e3 +2 .5");
+    fclose (input);
+
+    static double a[READER_BUFFER_SIZE / 16 + 1003], b[READER_BUFFER_SIZE / 16 + 1003], c[READER_BUFFER_SIZE / 16 + 1003];
+    size_t n_triples = 0, n_read = 0;
+
+    fflush (stderr);
+    int saved_stderr = dup (STDERR_FILENO);
+    int null_fd = open ("/dev/null", O_WRONLY);
+    if (saved_stderr != -1 && null_fd != -1)
+        dup2 (null_fd, STDERR_FILENO);
+
+    if (Open_Coeff_Reader (&reader, path) == 0)
+    {
+        while ((n_read = Read_Triples (&reader, a + n_triples, b + n_triples, c + n_triples, 1000)) > 0)
+            n_triples += n_read;
+    }
+
+    fflush (stderr);
+    if (saved_stderr != -1 && null_fd != -1)
+        dup2 (saved_stderr, STDERR_FILENO);
+    if (saved_stderr != -1)
+        close (saved_stderr);
+    if (null_fd != -1)
+        close (null_fd);
+
+    bool correct = (n_triples == n_repeated + 3 && reader.N_Errors == 2 && reader.Last_Error_Line == 6 &&
+                    a[0] == 1 && b[0] == -3 && c[0] == 2 && a[1] == 4 && b[1] == 5 && c[1] == 6 &&
+                    a[n_triples - 1] == -1500 && b[n_triples - 1] == 2 && c[n_triples - 1] == 0.5);
+
+    for (size_t i = 2; correct && i < n_triples - 1; i++)
+        correct = (a[i] == 1.25 && b[i] == -2.5 && c[i] == 0.125);
+
+    if (!correct)
+    {
+        printf ("Reader test FAILED: %zu triples and %zu malformed lines (the last one is %zu) have been read, "
+                "should be %zu, 2 and 6\n\n", n_triples, reader.N_Errors, reader.Last_Error_Line, n_repeated + 3);
+        failed++;
+    }
+
+    Close_Coeff_Reader (&reader);
+    unlink (path);
 
     return failed;
 }
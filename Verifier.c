@@ -0,0 +1,844 @@
+#include "Verifier.h"
+#include "Stream_Mode.h"
+#include "Simd_Solver.h"
+#include "Parallel_Solver.h"
+#include "Precise_Solver.h"
+#include "Generic_Solver.h"
+#include "Root_Cache.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <float.h>
+#include <time.h>
+
+#ifdef __SIZEOF_FLOAT128__
+typedef __float128 Reference_Float;     ///The type the reference roots are computed in (113 bits of mantissa)
+#else
+typedef long double Reference_Float;    ///The type the reference roots are computed in
+#endif
+
+#define VERIFY_BLOCK_SIZE (1 << 18)     ///The number of equations that are generated and checked at a time
+#define N_TIMING_RUNS 2                 ///Every block is solved this number of times, the fastest run is taken
+#define N_EDGE_VALUES 16                ///The number of values in the array "Edge_Values"
+#define VERIFY_CACHE_SIZE (1 << 16)     ///The number of entries of the cache of the "cached" variant
+#define N_EQUATION_KINDS 6              ///The number of kinds of equations Generate_Equation () makes by turns
+#define NARROW_EXPONENT 20              ///The largest binary exponent of random coefficients
+#define WIDE_EXPONENT 1000              ///The largest binary exponent of random coefficients with wide exponents
+#define WIDE_ROOT_EXPONENT 340          ///The largest binary exponent of "a" and of the roots of equations with wide roots
+
+///Coefficients that are put into random equations now and then
+static const double Edge_Values[N_EDGE_VALUES] =
+{
+    0.0, -0.0, 1.0, -1.0, 10E-7, -10E-7, 5E-7, 1.5E-6,
+    DBL_MIN, DBL_TRUE_MIN, 1E-300, 1E300, DBL_MAX, INFINITY, -INFINITY, NAN
+};
+
+///A floating-point type the solvers work in
+struct Number_Type
+{
+    const char *Name;               ///< The name that is printed in the report
+    int Digits;                     ///< The number of digits of the mantissa
+    int Min_Exponent;               ///< The exponent of the least normal number
+    Reference_Float Tolerance;      ///< The tolerance the solvers of the type compare numbers with
+    Reference_Float Max;            ///< The greatest finite number
+    Reference_Float Min;            ///< The least normal positive number
+    void (*Convert) (const double *from, void *to, const size_t n_numbers);    ///< Converts coefficients to the type
+    Reference_Float (*Read) (const void *numbers, const size_t index);        ///< Reads one number of an array exactly
+    Reference_Float (*Round) (const Reference_Float x);                       ///< Rounds a reference number to the type
+};
+
+/**
+    \brief Defines the functions of struct Number_Type for one type
+
+    \param suffix {The suffix of the names of the functions}
+    \param type {The type}
+*/
+#define DEFINE_NUMBER_TYPE_FUNCTIONS(suffix, type)                                      \
+static void Convert_To##suffix (const double *from, void *to, const size_t n_numbers)  \
+{                                                                                       \
+    for (size_t i = 0; i < n_numbers; i++)                                              \
+        ((type *)to)[i] = (type)from[i];                                                \
+}                                                                                       \
+                                                                                        \
+static Reference_Float Read##suffix (const void *numbers, const size_t index)          \
+{                                                                                       \
+    return ((const type *)numbers)[index];                                              \
+}                                                                                       \
+                                                                                        \
+static Reference_Float Round_To##suffix (const Reference_Float x)                      \
+{                                                                                       \
+    return (type)x;                                                                     \
+}
+
+DEFINE_NUMBER_TYPE_FUNCTIONS (_D, double)
+DEFINE_NUMBER_TYPE_FUNCTIONS (_F, float)
+DEFINE_NUMBER_TYPE_FUNCTIONS (_L, long double)
+
+static const struct Number_Type Double_Type =
+    {"double", DBL_MANT_DIG, DBL_MIN_EXP - 1, SOLVER_EPSILON, DBL_MAX, DBL_MIN, Convert_To_D, Read_D, Round_To_D};
+static const struct Number_Type Float_Type =
+    {"float", FLT_MANT_DIG, FLT_MIN_EXP - 1, FLOAT_EPSILON, FLT_MAX, FLT_MIN, Convert_To_F, Read_F, Round_To_F};
+static const struct Number_Type Long_Double_Type =
+    {"ldouble", LDBL_MANT_DIG, LDBL_MIN_EXP - 1, LONG_DOUBLE_EPSILON, LDBL_MAX, LDBL_MIN, Convert_To_L, Read_L, Round_To_L};
+
+///The references the solvers are judged by
+enum Reference_Kind
+{
+    Double_Reference,       ///< The equation in "double" with EPSILON
+    Float_Reference,        ///< The coefficients rounded to "float" with FLOAT_EPSILON
+    Long_Double_Reference,  ///< The equation in "long double" with LONG_DOUBLE_EPSILON
+    Scaled_Reference,       ///< The decisions for the equation scaled by Scale_Coefficients (), the roots of the original one
+    N_Reference_Kinds       ///< The number of references
+};
+
+///The types of the references
+static const struct Number_Type *const Reference_Types[N_Reference_Kinds] =
+    {&Double_Type, &Float_Type, &Long_Double_Type, &Double_Type};
+
+///Reference results of one block of equations
+struct Reference_Block
+{
+    Reference_Float *X_1;       ///< The first roots
+    Reference_Float *X_2;       ///< The second roots
+    enum N_Roots *N_Roots;      ///< The numbers of roots
+    enum Root_Class *Class;     ///< The classes of the equations
+    bool *Out_Of_Range;         ///< True if the equation overflows or underflows in the type (Is_Out_Of_Range ())
+};
+
+///Coefficients and roots of one block converted to a type other than "double"
+struct Typed_Block
+{
+    void *A;        ///< Quadratic coefficients
+    void *B;        ///< Linear coefficients
+    void *C;        ///< Free terms
+    void *X_1;      ///< First roots
+    void *X_2;      ///< Second roots
+};
+
+///A batch solver of equations of a type other than "double", the arrays are of the type of its reference
+typedef void (*Typed_Batch_Solver) (const void *a, const void *b, const void *c,
+                                    void *x_1, void *x_2, enum N_Roots *n_roots, const size_t n_equations);
+
+///One solver that is checked
+struct Variant
+{
+    const char *Name;                   ///< The name that is printed in the report
+    Batch_Solver Solver;                ///< The function that solves a batch of "double" equations (NULL if Typed_Solver is)
+    Typed_Batch_Solver Typed_Solver;    ///< The function that solves a batch of other equations (NULL if Solver is)
+    Batch_Solver Twin;                  ///< The solver whose results should be the same bit for bit (NULL if there is none)
+    enum Simd_Level Level;              ///< The instruction set the solver needs
+    enum Reference_Kind Reference;      ///< The reference the solver is judged by
+};
+
+///Accumulated results of one solver
+struct Variant_Report
+{
+    double Seconds;             ///< The time all the equations have been solved in
+    size_t Class_Errors;        ///< Equations with another number of roots than the reference one
+    size_t Bit_Errors;          ///< Equations whose results differ from the ones of the twin solver
+    size_t Out_Of_Range;        ///< Equations that overflow or underflow in the type of the solver
+    size_t Lost;                ///< Equations whose roots are wrong even in magnitude (relative error of 1 or more)
+    double Max_Ulp[N_Root_Classes];     ///< The maximal error of the roots in units in the last place
+};
+
+///Names of the classes of equations
+static const char *Class_Names[N_Root_Classes] = {"two", "double", "linear", "none"};
+
+/**
+    \brief Returns the next pseudo-random number (splitmix64)
+
+    \param [in] state {Pointer on the state of the generator}
+    \return A pseudo-random 64-bit number
+*/
+static uint64_t Next_Random_Number (uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+    return z ^ (z >> 31);
+}
+
+/**
+    \brief Returns a random coefficient
+
+    Every 16th coefficient is taken from the array "Edge_Values", the others have a random sign,
+             a random mantissa and a random binary exponent from -max_exponent to max_exponent.
+
+    \param [in] state {Pointer on the state of the generator}
+    \param [in] max_exponent {The largest exponent}
+    \return The coefficient
+*/
+static double Random_Coefficient (uint64_t *state, const int max_exponent)
+{
+    uint64_t random = Next_Random_Number (state);
+
+    if (random % 16 == 0)
+        return Edge_Values[(random >> 4) % N_EDGE_VALUES];
+
+    double mantissa = 1.0 + (double)(random >> 12) * 0x1p-52;
+    int exponent = (int)((random >> 4) % (uint64_t)(2 * max_exponent + 1)) - max_exponent;
+
+    return ((random >> 10) & 1) ? -ldexp (mantissa, exponent) : ldexp (mantissa, exponent);
+}
+
+/**
+    \brief Generates one equation
+
+    Equations go by sixes: three random coefficients, two random roots,
+             a root of multiplicity two with a discriminant perturbed within a few EPSILON,
+             |b| much greater than |a| and |c| (the textbook formula loses the small root),
+             three random coefficients with binary exponents up to WIDE_EXPONENT (b * b and 4ac leave the range of "double")
+             and two random roots with wide exponents.
+
+    \param [in] state {Pointer on the state of the generator}
+    \param [in] index {The number of the equation}
+    \param [out] a {Pointer on the quadratic coefficient}
+    \param [out] b {Pointer on the linear coefficient}
+    \param [out] c {Pointer on the free term}
+*/
+static void Generate_Equation (uint64_t *state, const size_t index, double *a, double *b, double *c)
+{
+    int kind = (int)(index % N_EQUATION_KINDS);
+    int max_exponent = (kind == 4) ? WIDE_EXPONENT : (kind == 5) ? WIDE_ROOT_EXPONENT : NARROW_EXPONENT;
+    double x_1 = Random_Coefficient (state, max_exponent);
+    double x_2 = Random_Coefficient (state, max_exponent);
+
+    *a = Random_Coefficient (state, max_exponent);
+
+    switch (kind)
+    {
+        case 0:
+        case 4:
+            *b = x_1;
+            *c = x_2;
+            break;
+
+        case 1:
+        case 5:
+            *b = -*a * (x_1 + x_2);
+            *c = *a * x_1 * x_2;
+            break;
+
+        case 2:
+            *b = -2 * *a * x_1;
+            *c = *a * x_1 * x_1 + (double)(int64_t)(Next_Random_Number (state) % 9 - 4) * EPSILON / (4 * *a);
+            break;
+
+        case 3:
+            *b = x_1 * 1E8;
+            *c = x_2;
+            break;
+    }
+}
+
+/**
+    \brief Compares a reference number with 0 the same way Compare_Double () does
+
+    \param [in] x {The number}
+    \param [in] tolerance {The tolerance of the type the equation is solved in}
+    \return The result of the comparison
+*/
+static enum Compare Compare_Reference (const Reference_Float x, const Reference_Float tolerance)
+{
+    if (x != x)
+        return Not_Equal;
+    else if (x > tolerance)
+        return Greater;
+    else if (x < -tolerance)
+        return Less;
+    else
+        return Equal;
+}
+
+/**
+    \brief Finds the absolute value of a reference number
+
+    \param [in] x {The number}
+    \return |x|
+*/
+static Reference_Float Abs_Reference (const Reference_Float x)
+{
+    return (x < 0) ? -x : x;
+}
+
+/**
+    \brief Finds the square root of a reference number
+
+    The approximation of sqrtl () is refined with one step of the method of Newton.
+
+    \param [in] x {The number}
+    \return sqrt (x) or x if it is not a positive finite number
+*/
+static Reference_Float Sqrt_Reference (const Reference_Float x)
+{
+    if (!(x > 0) || x - x != 0)
+        return x;
+
+    Reference_Float root = sqrtl ((long double)x);
+
+    return (root + x / root) / 2;
+}
+
+/**
+    \brief Solves an equation with the decisions of Get_Number_Of_Roots_And_Solve_Equation () in high precision
+
+    The products b * b and 4 * a * c are exact in Reference_Float for "double", "float" and "long double" coefficients,
+             so the reference discriminant is the real one and the number of roots is the one an exact solver
+             would find with the tolerance of the type.
+    The roots are found from q = -(b + sign (b) * sqrt (D)) / 2 as q / a and c / q, so no digits are lost
+             in cancellation; they are put in the order of Calc_Roots_Of_Quadratic_Equation ().
+    The decisions may be made for other coefficients than the roots are found from: the ones of the scaled equation
+             Solve_Batch_Scaled () decides for, whose roots are the ones of the original equation divided by 2^k.
+
+    \param [in] decided {The coefficients a, b and c the number of roots is found for}
+    \param [in] exact {The coefficients the roots are found from}
+    \param [in] tolerance {The tolerance of the type the equation is solved in}
+    \param [out] x_1 {Pointer on the first root}
+    \param [out] x_2 {Pointer on the second root}
+    \param [out] root_class {Pointer on the class of the equation}
+    \return The number of roots
+*/
+static enum N_Roots Solve_Reference (const Reference_Float decided[3], const Reference_Float exact[3],
+                                     const Reference_Float tolerance,
+                                     Reference_Float *x_1, Reference_Float *x_2, enum Root_Class *root_class)
+{
+    Reference_Float A = exact[0], B = exact[1], C = exact[2];
+
+    *x_1 = NAN;
+    *x_2 = NAN;
+    *root_class = Class_None;
+
+    if (Compare_Reference (decided[0], tolerance) == Equal)
+    {
+        if (Compare_Reference (decided[1], tolerance) == Equal)
+            return (Compare_Reference (decided[2], tolerance) == Equal) ? Infinite : Zero;
+
+        *x_1 = -C / B;
+        *root_class = Class_Linear;
+        return One;
+    }
+
+    Reference_Float decided_D = decided[1] * decided[1] - 4 * decided[0] * decided[2];
+    Reference_Float D = B * B - 4 * A * C;
+
+    if (Compare_Reference (decided_D, tolerance) == Less)
+        return Zero;
+
+    Reference_Float sqrt_D = Sqrt_Reference ((D < 0) ? 0 : D);
+    Reference_Float q = -(B + ((B < 0) ? -sqrt_D : sqrt_D)) / 2;
+    Reference_Float root_from_a = q / A;
+    Reference_Float root_from_c = (q == 0) ? root_from_a : C / q;
+
+    *x_1 = (B < 0) ? root_from_c : root_from_a;     // (-b - sqrt_D) / 2a without subtraction of close numbers
+    *x_2 = (B < 0) ? root_from_a : root_from_c;
+
+    if (Compare_Reference (decided_D, tolerance) == Equal)
+    {
+        *root_class = Class_Double;
+        return One;
+    }
+
+    *root_class = Class_Two;
+    return Two;
+}
+
+/**
+    \brief Checks if a reference number overflows or underflows to a subnormal number in a type
+
+    \param [in] type {The type}
+    \param [in] x {The number}
+    \return True if the rounded number is not finite or is subnormal
+*/
+static bool Is_Out_Of_Type (const struct Number_Type *type, const Reference_Float x)
+{
+    Reference_Float rounded = Abs_Reference (type->Round (x));
+
+    return !(rounded <= type->Max) || (x != 0 && rounded < type->Min);
+}
+
+/**
+    \brief Checks if an equation cannot be solved accurately in a type because of its range
+
+    That is a coefficient that is not finite, b * b or 4 * a * c that overflows or underflows to a subnormal number
+             (the discriminant is wrong even in magnitude then) or a reference root that does so itself.
+    The errors of such equations tell nothing about the accuracy of a solver, so they are counted apart.
+    The discriminant of an equation scaled by Scale_Coefficients () is right in magnitude even if b * b or 4ac
+             underflows (the largest coefficient is in [1, 2) and one of the others is about as large),
+             so only its coefficients and roots are checked.
+
+    \param [in] type {The type the equation is solved in}
+    \param [in] a {Quadratic coefficient, rounded to the type}
+    \param [in] b {Linear coefficient, rounded to the type}
+    \param [in] c {Free term, rounded to the type}
+    \param [in] x_1 {The first reference root}
+    \param [in] x_2 {The second reference root}
+    \param [in] root_class {The class of the equation}
+    \param [in] scaled {True if the coefficients have been scaled by Scale_Coefficients ()}
+    \return True if the equation is out of the range of the type
+*/
+static bool Is_Out_Of_Range (const struct Number_Type *type, const Reference_Float a, const Reference_Float b, const Reference_Float c,
+                             const Reference_Float x_1, const Reference_Float x_2, const enum Root_Class root_class,
+                             const bool scaled)
+{
+    if (!(Abs_Reference (a) <= type->Max) || !(Abs_Reference (b) <= type->Max) || !(Abs_Reference (c) <= type->Max))
+        return true;
+
+    const Reference_Float roots[2] = {x_1, x_2};
+    int n_roots = 0;
+
+    if (root_class == Class_Linear)
+        n_roots = 1;
+    else if (root_class == Class_Two || root_class == Class_Double)
+    {
+        if (!scaled && (Is_Out_Of_Type (type, b * b) || Is_Out_Of_Type (type, type->Round (4 * a) * c)))   // As the solvers find 4ac
+            return true;
+
+        n_roots = 2;
+    }
+
+    for (int i = 0; i < n_roots; i++)
+        if (Is_Out_Of_Type (type, roots[i]))
+            return true;
+
+    return false;
+}
+
+/**
+    \brief Finds the error of a root in units in the last place of the reference root rounded to a type
+
+    \param [in] type {The type of the root}
+    \param [in] x {The root}
+    \param [in] reference {The reference root}
+    \return The error, 0 if both roots are NAN, INFINITY if only one of them is NAN or infinite
+*/
+static double Ulp_Error (const struct Number_Type *type, const Reference_Float x, const Reference_Float reference)
+{
+    Reference_Float rounded = type->Round (reference);
+
+    if (x != x || rounded != rounded)
+        return (x != x && rounded != rounded) ? 0.0 : INFINITY;
+    if (!(Abs_Reference (x) <= type->Max) || !(Abs_Reference (rounded) <= type->Max))
+        return (x == rounded) ? 0.0 : INFINITY;
+
+    long double magnitude = (long double)Abs_Reference (rounded);
+    int exponent = (magnitude < type->Min) ? type->Min_Exponent : ilogbl (magnitude);
+    Reference_Float ulp = ldexpl (1.0L, exponent - (type->Digits - 1));
+
+    return (double)(Abs_Reference (x - reference) / ulp);
+}
+
+/**
+    \brief Checks if two roots are equal bit for bit
+
+    Any NAN is equal to any NAN: its sign depends on the order of the operands the compiler chooses.
+
+    \param [in] x {The first root}
+    \param [in] y {The second root}
+    \return True if the roots are the same
+*/
+static bool Is_Same_Root (const double x, const double y)
+{
+    return memcmp (&x, &y, sizeof (double)) == 0 || (IsNAN (x) && IsNAN (y));
+}
+
+/**
+    \brief Solves the batch with Solve_Batch_Parallel () on all the cores
+*/
+static void Solve_Batch_All_Cores (const double *a, const double *b, const double *c,
+                                   double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    Solve_Batch_Parallel (a, b, c, x_1, x_2, n_roots, n_equations, 0, 0, NULL);
+}
+
+///The cache of the "cached" variant, it is kept between the blocks
+static struct Root_Cache Verify_Cache = {0};
+
+/**
+    \brief Calls Solve_Batch_Cached () with Verify_Cache
+*/
+static void Solve_Batch_With_Cache (const double *a, const double *b, const double *c,
+                                    double *x_1, double *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    Solve_Batch_Cached (&Verify_Cache, a, b, c, x_1, x_2, n_roots, n_equations);
+}
+
+/**
+    \brief Calls Solve_Batch_F () with arrays of "float"
+*/
+static void Solve_Batch_Float (const void *a, const void *b, const void *c,
+                               void *x_1, void *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    Solve_Batch_F (a, b, c, x_1, x_2, n_roots, n_equations);
+}
+
+/**
+    \brief Calls Solve_Batch_L () with arrays of "long double"
+*/
+static void Solve_Batch_Long_Double (const void *a, const void *b, const void *c,
+                                     void *x_1, void *x_2, enum N_Roots *n_roots, const size_t n_equations)
+{
+    Solve_Batch_L (a, b, c, x_1, x_2, n_roots, n_equations);
+}
+
+/**
+    Every solver of the project is checked by --verify. A solver that is added to the project gets its row here:
+             the name, the function, the solver it promises the results of bit for bit, the instruction set it needs
+             and the reference its numbers of roots and errors are found against.
+*/
+static const struct Variant Variants[] =
+{
+    {"scalar",        Solve_Batch,               NULL,                    NULL,               Simd_None,   Double_Reference     },
+    {"sse2",          Solve_Batch_SSE2,          NULL,                    Solve_Batch,        Simd_SSE2,   Double_Reference     },
+    {"avx2",          Solve_Batch_AVX2,          NULL,                    Solve_Batch,        Simd_AVX2,   Double_Reference     },
+    {"avx512",        Solve_Batch_AVX512,        NULL,                    Solve_Batch,        Simd_AVX512, Double_Reference     },
+    {"parallel",      Solve_Batch_All_Cores,     NULL,                    Solve_Batch,        Simd_None,   Double_Reference     },
+    {"cached",        Solve_Batch_With_Cache,    NULL,                    Solve_Batch,        Simd_None,   Double_Reference     },
+    {"precise",       Solve_Batch_Precise,       NULL,                    NULL,               Simd_None,   Double_Reference     },
+    {"float",         NULL,                      Solve_Batch_Float,       NULL,               Simd_None,   Float_Reference      },
+    {"ldouble",       NULL,                      Solve_Batch_Long_Double, NULL,               Simd_None,   Long_Double_Reference},
+    {"stable",        Solve_Batch_Stable,        NULL,                    NULL,               Simd_None,   Double_Reference     },
+    {"stable_sse2",   Solve_Batch_Stable_SSE2,   NULL,                    Solve_Batch_Stable, Simd_SSE2,   Double_Reference     },
+    {"stable_avx2",   Solve_Batch_Stable_AVX2,   NULL,                    Solve_Batch_Stable, Simd_AVX2,   Double_Reference     },
+    {"stable_avx512", Solve_Batch_Stable_AVX512, NULL,                    Solve_Batch_Stable, Simd_AVX512, Double_Reference     },
+    {"scaled",        Solve_Batch_Scaled,        NULL,                    NULL,               Simd_None,   Scaled_Reference     },
+    {"scaled_simd",   Solve_Batch_Scaled_Simd,   NULL,                    Solve_Batch_Scaled, Simd_None,   Scaled_Reference     }
+};
+
+#define N_VARIANTS (int)(sizeof (Variants) / sizeof (Variants[0]))     ///The number of rows of "Variants"
+
+/**
+    \brief Returns the time of a monotonic clock
+
+    \return The time in seconds
+*/
+static double Get_Seconds (void)
+{
+    struct timespec now = {0};
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec + (double)now.tv_nsec * 1E-9;
+}
+
+/**
+    \brief Allocates the arrays of a reference block
+
+    \param [out] reference {The block}
+    \return 0 on success, -1 if there is not enough memory (the block should be freed anyway)
+*/
+static int Allocate_Reference_Block (struct Reference_Block *reference)
+{
+    reference->X_1 = calloc (VERIFY_BLOCK_SIZE, sizeof (Reference_Float));
+    reference->X_2 = calloc (VERIFY_BLOCK_SIZE, sizeof (Reference_Float));
+    reference->N_Roots = calloc (VERIFY_BLOCK_SIZE, sizeof (enum N_Roots));
+    reference->Class = calloc (VERIFY_BLOCK_SIZE, sizeof (enum Root_Class));
+    reference->Out_Of_Range = calloc (VERIFY_BLOCK_SIZE, sizeof (bool));
+
+    return (reference->X_1 == NULL || reference->X_2 == NULL || reference->N_Roots == NULL ||
+            reference->Class == NULL || reference->Out_Of_Range == NULL) ? -1 : 0;
+}
+
+/**
+    \brief Frees the arrays of a reference block
+
+    \param [in,out] reference {The block}
+*/
+static void Free_Reference_Block (struct Reference_Block *reference)
+{
+    free (reference->X_1);
+    free (reference->X_2);
+    free (reference->N_Roots);
+    free (reference->Class);
+    free (reference->Out_Of_Range);
+}
+
+/**
+    \brief Solves a block of equations in Reference_Float by Solve_Reference ()
+
+    For Scaled_Reference the decisions and the range are the ones of the scaled coefficients.
+
+    \param [in] kind {The reference}
+    \param [in] block {The coefficients}
+    \param [in] scaled {The coefficients scaled by Scale_Coefficients ()}
+    \param [in] n_equations {The number of equations in the block}
+    \param [out] reference {The reference results}
+*/
+static void Solve_Reference_Block (const enum Reference_Kind kind, const struct Equation_Block *block,
+                                   const struct Equation_Block *scaled, const size_t n_equations,
+                                   struct Reference_Block *reference)
+{
+    const struct Number_Type *type = Reference_Types[kind];
+    const struct Equation_Block *decided = (kind == Scaled_Reference) ? scaled : block;
+
+    for (size_t i = 0; i < n_equations; i++)
+    {
+        const Reference_Float exact[3] = {type->Round (block->A[i]), type->Round (block->B[i]), type->Round (block->C[i])};
+        const Reference_Float decided_coefficients[3] =
+            {type->Round (decided->A[i]), type->Round (decided->B[i]), type->Round (decided->C[i])};
+
+        reference->N_Roots[i] = Solve_Reference (decided_coefficients, exact, type->Tolerance,
+                                                 &reference->X_1[i], &reference->X_2[i], &reference->Class[i]);
+        reference->Out_Of_Range[i] = Is_Out_Of_Range (type, decided_coefficients[0], decided_coefficients[1], decided_coefficients[2],
+                                                      reference->X_1[i], reference->X_2[i], reference->Class[i],
+                                                      kind == Scaled_Reference);
+    }
+}
+
+/**
+    \brief Solves a block with one solver and adds its errors to the report
+
+    The roots of a solver of another type than "double" are found from the coefficients converted to the type,
+             their errors are in units in the last place of that type.
+
+    \param [in] variant {The solver}
+    \param [in] block {The coefficients and the arrays for the roots}
+    \param [in] typed {The arrays for the coefficients and the roots of other types}
+    \param [in] twin {The arrays for the roots of the twin solver}
+    \param [in] reference {The reference results of the reference of the solver}
+    \param [in] n_equations {The number of equations in the block}
+    \param [in,out] report {The report of the solver}
+*/
+static void Check_Variant (const struct Variant *variant, struct Equation_Block *block, struct Typed_Block *typed,
+                           struct Equation_Block *twin, const struct Reference_Block *reference,
+                           const size_t n_equations, struct Variant_Report *report)
+{
+    const struct Number_Type *type = Reference_Types[variant->Reference];
+    const void *x_1 = block->X_1, *x_2 = block->X_2;
+    double best_time = INFINITY;
+
+    if (variant->Solver == NULL)
+    {
+        type->Convert (block->A, typed->A, n_equations);
+        type->Convert (block->B, typed->B, n_equations);
+        type->Convert (block->C, typed->C, n_equations);
+        x_1 = typed->X_1;
+        x_2 = typed->X_2;
+    }
+
+    for (int run = 0; run < N_TIMING_RUNS; run++)
+    {
+        double start = Get_Seconds ();
+        if (variant->Solver != NULL)
+            variant->Solver (block->A, block->B, block->C, block->X_1, block->X_2, block->N_Roots, n_equations);
+        else
+            variant->Typed_Solver (typed->A, typed->B, typed->C, typed->X_1, typed->X_2, block->N_Roots, n_equations);
+        best_time = fmin (best_time, Get_Seconds () - start);
+    }
+
+    report->Seconds += best_time;
+
+    if (variant->Twin != NULL)
+    {
+        variant->Twin (block->A, block->B, block->C, twin->X_1, twin->X_2, twin->N_Roots, n_equations);
+
+        for (size_t i = 0; i < n_equations; i++)
+            if (block->N_Roots[i] != twin->N_Roots[i] ||
+                !Is_Same_Root (block->X_1[i], twin->X_1[i]) || !Is_Same_Root (block->X_2[i], twin->X_2[i]))
+                report->Bit_Errors++;
+    }
+
+    double lost_error = ldexp (1.0, type->Digits - 1);
+
+    for (size_t i = 0; i < n_equations; i++)
+    {
+        if (reference->Out_Of_Range[i])
+            report->Out_Of_Range++;
+
+        if (block->N_Roots[i] != reference->N_Roots[i])
+        {
+            report->Class_Errors++;
+            continue;
+        }
+
+        if (reference->Out_Of_Range[i])
+            continue;
+
+        enum Root_Class root_class = reference->Class[i];
+        double error = 0.0;
+
+        if (root_class == Class_Linear)
+            error = Ulp_Error (type, type->Read (x_1, i), reference->X_1[i]);
+        else if (root_class != Class_None)
+            error = fmax (Ulp_Error (type, type->Read (x_1, i), reference->X_1[i]),
+                          Ulp_Error (type, type->Read (x_2, i), reference->X_2[i]));
+
+        if (error >= lost_error)
+            report->Lost++;
+        else if (error > report->Max_Ulp[root_class])
+            report->Max_Ulp[root_class] = error;
+    }
+}
+
+/**
+    \brief Prints the report of every solver
+
+    \param [in] active {True for the solvers of "Variants" that have been checked}
+    \param [in] reports {Array of their reports}
+    \param [in] class_counts {The number of equations of every class in "double"}
+    \param [in] n_equations {The number of equations}
+*/
+static void Print_Verify_Report (const bool *active, const struct Variant_Report *reports,
+                                 const size_t *class_counts, const size_t n_equations)
+{
+    printf ("\n%zu equations:", n_equations);
+    for (int root_class = 0; root_class < N_Root_Classes; root_class++)
+        printf (" %s %zu", Class_Names[root_class], class_counts[root_class]);
+
+    printf ("\n\n%-14s %-7s %9s %11s %12s %10s %12s %9s   %s\n", "variant", "type", "ns/eq", "eq/s",
+            "class errors", "bit errors", "out of range", "lost", "max ulp: two / double / linear");
+
+    for (int i = 0; i < N_VARIANTS; i++)
+    {
+        if (!active[i])
+            continue;
+
+        double ns = reports[i].Seconds * 1E9 / (double)n_equations;
+        char bit_errors[32] = "-";
+
+        if (Variants[i].Twin != NULL)
+            snprintf (bit_errors, sizeof (bit_errors), "%zu", reports[i].Bit_Errors);
+
+        printf ("%-14s %-7s %9.3f %11.4g %12zu %10s %12zu %9zu   %.3g / %.3g / %.3g\n",
+                Variants[i].Name, Reference_Types[Variants[i].Reference]->Name, ns, 1E9 / ns,
+                reports[i].Class_Errors, bit_errors, reports[i].Out_Of_Range, reports[i].Lost,
+                reports[i].Max_Ulp[Class_Two], reports[i].Max_Ulp[Class_Double], reports[i].Max_Ulp[Class_Linear]);
+    }
+
+    printf ("\nclass errors: another number of roots than the exact discriminant gives with the tolerance of the type\n"
+            "bit errors: results that differ from the ones of the solver the variant promises bit for bit\n"
+            "            (Solve_Batch (), Solve_Batch_Stable () or Solve_Batch_Scaled ()),"
+            " - if it promises none\n"
+            "out of range: a coefficient, b * b, 4ac or a root overflows or underflows in the type,\n"
+            "              such equations are not counted in lost and max ulp\n"
+            "lost: roots with a relative error of 1 or more (NAN, wrong sign), they are not counted in max ulp\n"
+            "max ulp: in units in the last place of the type\n"
+            "scaled: the numbers of roots and the range are the ones of the equation Scale_Coefficients () gives,\n"
+            "        the reference roots are the ones of the original equation\n");
+}
+
+/**
+    \brief Checks every solver against a high-precision reference on random and edge-case equations
+
+    Calls Run_All_Unit_Tests () first. Then the equations are generated by blocks of VERIFY_BLOCK_SIZE,
+             solved in Reference_Float by Solve_Reference () for every reference and by every solver of "Variants"
+             the CPU supports, and classified by Classify_Batch_Simd ().
+    The solvers that promise the results of another one bit for bit fail on any difference;
+             the errors in units in the last place are only reported.
+
+    \param [in] options {Pointer on the settings, options->Verify_Size is the number of equations}
+    \return 0 if all the checks have passed
+    \return 1 if some of them have failed
+    \return 2 if there is not enough memory
+*/
+int Run_Verify_Mode (const struct Options *options)
+{
+    assert (options != NULL);
+
+    int failed = Run_All_Unit_Tests ();
+
+    bool active[N_VARIANTS] = {false};
+    bool needed[N_Reference_Kinds] = {false};
+
+    needed[Double_Reference] = true;    // Its classes are counted
+    for (int i = 0; i < N_VARIANTS; i++)
+        if (Variants[i].Level <= Get_Simd_Level ())
+        {
+            active[i] = true;
+            needed[Variants[i].Reference] = true;
+        }
+
+    struct Variant_Report reports[N_VARIANTS] = {0};
+    struct Equation_Block block = {0}, twin = {0}, scaled = {0};
+    int *exponent = calloc (VERIFY_BLOCK_SIZE, sizeof (int));
+    struct Typed_Block typed =      // Big enough for every type
+    {
+        calloc (VERIFY_BLOCK_SIZE, sizeof (long double)),
+        calloc (VERIFY_BLOCK_SIZE, sizeof (long double)),
+        calloc (VERIFY_BLOCK_SIZE, sizeof (long double)),
+        calloc (VERIFY_BLOCK_SIZE, sizeof (long double)),
+        calloc (VERIFY_BLOCK_SIZE, sizeof (long double))
+    };
+    struct Reference_Block references[N_Reference_Kinds] = {{0}};
+    size_t class_counts[N_Root_Classes] = {0}, classify_errors = 0;
+    int status = 0, no_memory = 0;
+
+    for (int kind = 0; kind < N_Reference_Kinds; kind++)
+        if (needed[kind] && Allocate_Reference_Block (&references[kind]) != 0)
+            no_memory = 1;
+
+    if (no_memory || Allocate_Equation_Block (&block, VERIFY_BLOCK_SIZE) != 0 || Allocate_Equation_Block (&twin, VERIFY_BLOCK_SIZE) != 0 ||
+        Allocate_Equation_Block (&scaled, VERIFY_BLOCK_SIZE) != 0 || exponent == NULL ||
+        typed.A == NULL || typed.B == NULL || typed.C == NULL || typed.X_1 == NULL || typed.X_2 == NULL ||
+        Init_Root_Cache (&Verify_Cache, VERIFY_CACHE_SIZE, true) != 0)
+    {
+        fprintf (stderr, "Not enough memory\n");
+        status = 2;
+    }
+    else
+    {
+        uint64_t state = 2021;
+
+        for (size_t first = 0; first < options->Verify_Size; first += VERIFY_BLOCK_SIZE)
+        {
+            size_t count = options->Verify_Size - first;
+            if (count > VERIFY_BLOCK_SIZE)
+                count = VERIFY_BLOCK_SIZE;
+
+            for (size_t i = 0; i < count; i++)
+                Generate_Equation (&state, first + i, &block.A[i], &block.B[i], &block.C[i]);
+
+            Scale_Coefficients (block.A, block.B, block.C, scaled.A, scaled.B, scaled.C, exponent, count);
+
+            for (int kind = 0; kind < N_Reference_Kinds; kind++)
+                if (needed[kind])
+                    Solve_Reference_Block (kind, &block, &scaled, count, &references[kind]);
+
+            for (size_t i = 0; i < count; i++)
+                class_counts[references[Double_Reference].Class[i]]++;
+
+            for (int i = 0; i < N_VARIANTS; i++)
+                if (active[i])
+                    Check_Variant (&Variants[i], &block, &typed, &twin, &references[Variants[i].Reference], count, &reports[i]);
+
+            Solve_Batch (block.A, block.B, block.C, twin.X_1, twin.X_2, twin.N_Roots, count);
+            Classify_Batch_Simd (block.A, block.B, block.C, block.N_Roots, count);
+            for (size_t i = 0; i < count; i++)
+                classify_errors += (block.N_Roots[i] != twin.N_Roots[i]);
+        }
+
+        Print_Verify_Report (active, reports, class_counts, options->Verify_Size);
+        Print_Cache_Statistics (stdout, &Verify_Cache);
+
+        for (int i = 0; i < N_VARIANTS; i++)
+            if (active[i] && Variants[i].Twin != NULL && reports[i].Bit_Errors != 0)
+            {
+                printf ("%s FAILED: %zu results differ from the solver it promises bit for bit\n",
+                        Variants[i].Name, reports[i].Bit_Errors);
+                failed++;
+            }
+
+        if (classify_errors != 0)
+        {
+            printf ("classify FAILED: %zu numbers of roots differ from Solve_Batch ()\n", classify_errors);
+            failed++;
+        }
+
+        status = (failed != 0) ? 1 : 0;
+    }
+
+    Free_Equation_Block (&block);
+    Free_Equation_Block (&twin);
+    Free_Equation_Block (&scaled);
+    free (exponent);
+    Free_Root_Cache (&Verify_Cache);
+    free (typed.A);
+    free (typed.B);
+    free (typed.C);
+    free (typed.X_1);
+    free (typed.X_2);
+    for (int kind = 0; kind < N_Reference_Kinds; kind++)
+        Free_Reference_Block (&references[kind]);
+
+    return status;
+}
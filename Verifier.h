@@ -0,0 +1,18 @@
+#ifndef VERIFIER_H_INCLUDED
+#define VERIFIER_H_INCLUDED
+
+#include "Command_Line.h"
+
+///Classes of equations the accuracy is reported for
+enum Root_Class
+{
+    Class_Two,      ///< Two different roots
+    Class_Double,   ///< Discriminant is equal to 0 within EPSILON
+    Class_Linear,   ///< "a" is equal to 0 within EPSILON and there is one root
+    Class_None,     ///< No roots or infinite number of roots
+    N_Root_Classes  ///< The number of classes
+};
+
+int Run_Verify_Mode (const struct Options *options);
+
+#endif
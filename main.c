@@ -5,8 +5,24 @@
 /// \page 1
 
 #include "Quadratic_Equation.h"
+#include "Command_Line.h"
+#include "Stream_Mode.h"
+#include "Binary_Mode.h"
+#include "Verifier.h"
+#include "Sweep_Mode.h"
+#include "Service_Mode.h"
+#include "Shm_Mode.h"
+#include "Result_Store.h"
+#include "Solver_Stats.h"
+#include "Simd_Solver.h"
 
-int main (void)
+/**
+    \brief Solves equations asking the user for coefficients
+
+    Calls Run_Unit_Test (), Get_Three_Coefficients (), Get_Number_Of_Roots_And_Solve_Equation (),
+             Print_Roots (), Yes_No ().
+*/
+static void Run_Interactive_Mode (void)
 {
     double a = NAN, b = NAN, c = NAN, x_1 = NAN, x_2 = NAN;
 
@@ -33,6 +49,71 @@ int main (void)
     }
 
     printf ("Good bye!\n");
+}
+
+int main (int argc, char *argv[])
+{
+    struct Options options = {0};
+
+    switch (Parse_Command_Line (argc, argv, &options))
+    {
+        case 0:
+            break;
+
+        case 1:
+            Print_Usage (argv[0]);
+            return 0;
+
+        default:
+            Print_Usage (argv[0]);
+            return 2;
+    }
+
+    if (options.Force_Simd && Set_Simd_Level (options.Simd_Level) != 0)
+    {
+        fprintf (stderr, "The processor does not support \"%s\"\n", Get_Simd_Level_Name (options.Simd_Level));
+        return 2;
+    }
+
+    int status = 0;
+
+    switch (options.Mode)
+    {
+        case Stream:
+            status = Run_Stream_Mode (&options);
+            break;
+
+        case Binary:
+            status = Run_Binary_Mode (&options);
+            break;
+
+        case Verify:
+            status = Run_Verify_Mode (&options);
+            break;
+
+        case Sweep:
+            status = Run_Sweep_Mode (&options);
+            break;
+
+        case Serve:
+            status = Run_Service_Mode (&options);
+            break;
+
+        case Scan:
+            status = Run_Scan_Mode (&options);
+            break;
+
+        case Shared_Memory:
+            status = Run_Shm_Mode (&options);
+            break;
+
+        default:
+            Run_Interactive_Mode ();
+            break;
+    }
+
+    if (options.Stats)
+        Print_Solver_Stats (stderr);
 
-    return 0;
+    return status;
 }